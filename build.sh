@@ -1,5 +1,14 @@
 #!/bin/bash
 C_FILE_TO_COMPILE="k15_x11_software_renderer_2d.c"
 EXECUTABLE_FILE_NAME="x11_example"
-GCC_OPTIONS="-ansi -std=c99 -g3 -L/usr/X11/lib -lX11 -o $EXECUTABLE_FILE_NAME"
+GCC_OPTIONS="-ansi -std=c99 -g3 -L/usr/X11/lib -lX11 -lXext -lpthread -lm -o $EXECUTABLE_FILE_NAME"
+
+#FK: ./build.sh benchmark builds the headless benchmark, it doesn't need X11
+#FK: no -m flags, the renderer picks the kernels of the best instruction set the CPU supports at runtime
+if [ "$1" == "benchmark" ]; then
+	C_FILE_TO_COMPILE="k15_benchmark_software_renderer_2d.c"
+	EXECUTABLE_FILE_NAME="benchmark"
+	GCC_OPTIONS="-std=c99 -O2 -g -DK15_RENDERER_2D_NO_ASSERTS -lpthread -lm -o $EXECUTABLE_FILE_NAME"
+fi
+
 gcc $C_FILE_TO_COMPILE $GCC_OPTIONS
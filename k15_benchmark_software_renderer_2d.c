@@ -0,0 +1,1541 @@
+#define _GNU_SOURCE 1
+
+#define K15_SOFTWARE_RENDERER_2D_IMPLEMENTATION
+#include "k15_software_renderer_2d.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include "time.h"
+#	include "pthread.h"
+#endif
+
+//FK: Headless benchmark, replays synthetic scenes into a context that uses caller provided memory.
+//	  Prints one CSV line per scene: time per frame (record + ksr2_blit), pixels written per second and
+//	  draw commands per second. Throughput p99 is the throughput that 99% of the frames reached.
+//
+//	  usage: benchmark [--scene name] [--frames count] [--warmup count] [--width w] [--height h]
+//	  				   [--threads count] [--memory megabytes] [--incremental] [--padded-rows] [--trace prefix]
+//	  				   [--chunk-pool count] [--flush-when-full] [--record-threads count] [--images count] [--async] [--present]
+//	  				   [--format rgba|argb|bgra|rgb565|a8|gray8] [--generic-kernels] [--cpu-level scalar|sse2|avx2|avx512] [--verify]
+//
+//	  --trace enables K15_RENDERER_2D_TRACING_FLAG and writes the trace of every scene to <prefix><scene>.json.
+//	  --chunk-pool records draw commands into a pool of at most count chunks instead of the context memory.
+//	  --record-threads records the panels of the ui_panels scene into one command list per thread, 0 = into the context.
+//	  --images sets the number of swap chain images, 0 = 2 (double buffered).
+//	  --async enables K15_RENDERER_2D_ASYNC_BLIT_FLAG, every frame records, presents the previous frame and hands itself over
+//	  to the render thread, so the time per frame is the sustained frame time of the pipeline.
+//	  --present copies every finished image into a separate buffer, a stand in for presenting it to a window.
+//	  Formats with less than 32 bit per pixel get converted to ARGB instead, like a window would need them.
+//	  --format sets the swap chain format, compare clear and large_rects across formats to see the fill and blend bandwidth.
+//	  --generic-kernels enables K15_RENDERER_2D_GENERIC_KERNELS_FLAG to compare the kernels that branch on the format and
+//	  blend mode of every span against the ones specialized for the format.
+//	  --cpu-level forces the kernels of a lower SIMD level than the best one the CPU supports.
+//	  --verify renders the scenes at every cpu level the CPU supports instead of timing them and fails if the images of a 
+//	  level differ from the ones of the best level. Prints the hash of the images per scene and level, renders 2 frames 
+//	  without warmup unless --frames or --warmup say otherwise.
+//	  The draw command memory high water mark of every scene and the recording time of ui_panels get printed to stderr, so do 
+//	  the lines and sprites per second of the scenes that draw them. lines_1px, lines_4px and lines_16px draw short lines of one 
+//	  thickness, sprites_32 and sprites_256 alpha blended sprites of 32x32 and 256x256 pixels.
+
+#define K15_FALSE 0
+#define K15_TRUE 1
+
+typedef unsigned char bool8;
+typedef unsigned int uint32;
+typedef unsigned long long uint64;
+
+typedef struct
+{
+	uint64 pixelCount;
+	uint64 commandCount;
+	uint64 lineCount;
+	uint64 spriteCount;
+} frame_work;
+
+typedef struct
+{
+	ksr2_contexthandle 		renderer; //FK: context or command list the scene draws into
+	ksr2_fonthandle 		font;
+	ksr2_texturehandle 		smallSprite; //FK: SMALL_SPRITE_SIZE x SMALL_SPRITE_SIZE
+	ksr2_texturehandle 		largeSprite; //FK: LARGE_SPRITE_SIZE x LARGE_SPRITE_SIZE
+	int 					width;
+	int 					height;
+	uint32 					frameIndex;
+	frame_work 				work;
+	ksr2_commandlisthandle* pCommandLists; //FK: one per recording thread of the current frame, see --record-threads
+	uint32 					commandListCount;
+	uint64 					recordTimeInNs; //FK: only measured by scenes that can record on multiple threads
+} scene_context;
+
+typedef void(*scene_fnc)(scene_context*);
+
+//FK: draw command chunks for --chunk-pool, they get allocated on first use and are kept until the benchmark ends
+typedef struct
+{
+	void** 	ppFreeChunks;
+	uint32 	freeChunkCount;
+	uint32 	allocatedChunkCount;
+	uint32 	maxChunkCount;
+} chunk_pool;
+
+typedef struct
+{
+	const char* pName;
+	scene_fnc 	function;
+} scene;
+
+//FK: see --verify
+typedef struct
+{
+	uint64 			imageHash;
+	ksr2_cpu_level 	cpuLevel; //FK: level the context picked, can differ from the requested one without runtime dispatch
+} scene_verification;
+
+enum
+{
+	SMALL_RECT_COUNT 	= 20000,
+	SMALL_RECT_SIZE 	= 16,
+	LONG_LINE_COUNT 	= 1000,
+	CHART_LINE_COUNT 	= 20000,
+	CHART_LINE_LENGTH 	= 100,
+	SMALL_SPRITE_SIZE 	= 32,
+	SMALL_SPRITE_COUNT 	= 20000,
+	LARGE_SPRITE_SIZE 	= 256,
+	LARGE_SPRITE_COUNT 	= 200,
+	UI_PANEL_COUNT 		= 24,
+	UI_BUTTONS_PER_PANEL = 16,
+	UI_PANEL_GRID_WIDTH = 16,
+	UI_PANEL_GRID_HEIGHT = 12,
+	LARGE_RECT_COUNT 	= 8,
+	SMALL_TRIANGLE_COUNT = 100000,
+	SMALL_TRIANGLE_SIZE = 12,
+	TRIANGLE_MESH_CELL_SIZE = 8,
+	MAX_TRIANGLE_VERTEX_COUNT = SMALL_TRIANGLE_COUNT * 3,
+	ROUND_PANEL_GRID_WIDTH = 8,
+	ROUND_PANEL_GRID_HEIGHT = 6,
+	ROUND_MARKER_COUNT 	= 20000,
+	LARGE_CIRCLE_COUNT 	= 4,
+	PATH_ICON_GRID_WIDTH = 24,
+	PATH_ICON_GRID_HEIGHT = 14,
+	PATH_POLYGON_COUNT 	= 12,
+	PATH_POLYGON_POINT_COUNT = 400,
+	PATH_POLYLINE_COUNT = 40,
+	PATH_POLYLINE_POINT_COUNT = 64,
+	MAX_PATH_POINT_COUNT = 1024,
+	MAX_RECORD_THREAD_COUNT = 64,
+	COMMAND_LIST_MEMORY_SIZE_IN_BYTES = ksr2_megabyte(4)
+};
+
+static int 				rectX1[SMALL_RECT_COUNT];
+static int 				rectY1[SMALL_RECT_COUNT];
+static int 				rectX2[SMALL_RECT_COUNT];
+static int 				rectY2[SMALL_RECT_COUNT];
+static ksr2_rgba_color 	rectColors[SMALL_RECT_COUNT];
+
+static float 			vertexX[MAX_TRIANGLE_VERTEX_COUNT];
+static float 			vertexY[MAX_TRIANGLE_VERTEX_COUNT];
+static ksr2_rgba_color 	vertexColors[MAX_TRIANGLE_VERTEX_COUNT];
+static unsigned int 	triangleIndices[MAX_TRIANGLE_VERTEX_COUNT];
+
+static ksr2_rgba_color 	spritePixels[LARGE_SPRITE_SIZE * LARGE_SPRITE_SIZE];
+static unsigned char 	pathVerbs[MAX_PATH_POINT_COUNT];
+static float 			pathPoints[MAX_PATH_POINT_COUNT * 2];
+
+static uint64 getTimeInNs()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (uint64)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64)time.tv_sec * 1000000000ull + (uint64)time.tv_nsec;
+#endif
+}
+
+//FK: xorshift so that every run replays the exact same scenes
+static uint32 nextRandom(uint32* pState)
+{
+	uint32 value = *pState;
+	value ^= value << 13;
+	value ^= value >> 17;
+	value ^= value << 5;
+	*pState = value;
+	return value;
+}
+
+static int clampInt(int value, int min, int max)
+{
+	return value < min ? min : (value > max ? max : value);
+}
+
+static void drawRect(scene_context* pScene, int x1, int y1, int x2, int y2, ksr2_rgba_color color)
+{
+	const int width 	= clampInt(x2, 0, pScene->width) - clampInt(x1, 0, pScene->width);
+	const int height 	= clampInt(y2, 0, pScene->height) - clampInt(y1, 0, pScene->height);
+
+	if (width > 0 && height > 0)
+	{
+		pScene->work.pixelCount += (uint64)width * (uint64)height;
+	}
+
+	pScene->work.commandCount += 1u;
+	ksr2_draw_filled_rect(pScene->renderer, x1, y1, x2, y2, color);
+}
+
+//FK: pixel count is the length of the line times its thickness, good enough for throughput numbers
+static void drawLine(scene_context* pScene, int x1, int y1, int x2, int y2, unsigned int thickness, ksr2_rgba_color color)
+{
+	const int deltaX = abs(x2 - x1);
+	const int deltaY = abs(y2 - y1);
+
+	pScene->work.pixelCount 	+= (uint64)(deltaX > deltaY ? deltaX : deltaY) * thickness;
+	pScene->work.commandCount 	+= 1u;
+	pScene->work.lineCount 		+= 1u;
+	ksr2_draw_line(pScene->renderer, x1, y1, x2, y2, thickness, color);
+}
+
+//FK: pixel count is the area of the triangles, without clipping them to the image
+static void drawTriangles(scene_context* pScene, uint32 vertexCount, uint32 indexCount)
+{
+	for (uint32 index = 0u; index < indexCount; index += 3u)
+	{
+		const unsigned int* pIndices = triangleIndices + index;
+		const float area = (vertexX[pIndices[1]] - vertexX[pIndices[0]]) * (vertexY[pIndices[2]] - vertexY[pIndices[0]]) - 
+						   (vertexY[pIndices[1]] - vertexY[pIndices[0]]) * (vertexX[pIndices[2]] - vertexX[pIndices[0]]);
+		pScene->work.pixelCount += (uint64)(area < 0.0f ? -area * 0.5f : area * 0.5f);
+	}
+
+	pScene->work.commandCount += indexCount / 3u;
+	ksr2_draw_triangles(pScene->renderer, vertexX, vertexY, vertexColors, vertexCount, triangleIndices, indexCount);
+}
+
+//FK: pixel count is the area of the shape, without clipping it to the image
+static void drawEllipse(scene_context* pScene, float x, float y, float radiusX, float radiusY, ksr2_rgba_color color)
+{
+	pScene->work.pixelCount 	+= (uint64)(3.14159265f * radiusX * radiusY);
+	pScene->work.commandCount 	+= 1u;
+	ksr2_draw_filled_ellipse(pScene->renderer, x, y, radiusX, radiusY, color);
+}
+
+static void drawRing(scene_context* pScene, float x, float y, float radius, float thickness, ksr2_rgba_color color)
+{
+	const float innerRadius = radius > thickness ? radius - thickness : 0.0f;
+
+	pScene->work.pixelCount 	+= (uint64)(3.14159265f * (radius * radius - innerRadius * innerRadius));
+	pScene->work.commandCount 	+= 1u;
+	ksr2_draw_ring(pScene->renderer, x, y, radius, thickness, color);
+}
+
+static void drawRoundedRect(scene_context* pScene, float x1, float y1, float x2, float y2, float cornerRadius, ksr2_rgba_color color)
+{
+	pScene->work.pixelCount 	+= (uint64)((x2 - x1) * (y2 - y1) - (4.0f - 3.14159265f) * cornerRadius * cornerRadius);
+	pScene->work.commandCount 	+= 1u;
+	ksr2_draw_filled_rounded_rect(pScene->renderer, x1, y1, x2, y2, cornerRadius, color);
+}
+
+static void drawSprite(scene_context* pScene, ksr2_texturehandle texture, int size, int x, int y)
+{
+	const int width 	= clampInt(x + size, 0, pScene->width) - clampInt(x, 0, pScene->width);
+	const int height 	= clampInt(y + size, 0, pScene->height) - clampInt(y, 0, pScene->height);
+
+	if (width > 0 && height > 0)
+	{
+		pScene->work.pixelCount += (uint64)width * (uint64)height;
+	}
+
+	pScene->work.commandCount 	+= 1u;
+	pScene->work.spriteCount 	+= 1u;
+	ksr2_draw_image(pScene->renderer, texture, 0, 0, size, size, x, y, 1u);
+}
+
+//FK: pixel count is the area of the bounding box of the points of the path grown by margin, without clipping it to the image
+static void addPathWork(scene_context* pScene, const ksr2_path* pPath, float margin)
+{
+	float minX = pPath->pPoints[0];
+	float minY = pPath->pPoints[1];
+	float maxX = minX;
+	float maxY = minY;
+
+	for (uint32 pointIndex = 1u; pointIndex < pPath->pointCount; ++pointIndex)
+	{
+		const float x = pPath->pPoints[pointIndex * 2u + 0u];
+		const float y = pPath->pPoints[pointIndex * 2u + 1u];
+		minX = x < minX ? x : minX;
+		minY = y < minY ? y : minY;
+		maxX = x > maxX ? x : maxX;
+		maxY = y > maxY ? y : maxY;
+	}
+
+	pScene->work.pixelCount 	+= (uint64)((maxX - minX + 2.0f * margin) * (maxY - minY + 2.0f * margin));
+	pScene->work.commandCount 	+= 1u;
+}
+
+static void fillPath(scene_context* pScene, const ksr2_path* pPath, ksr2_fill_rule fillRule, ksr2_rgba_color color)
+{
+	addPathWork(pScene, pPath, 0.0f);
+	ksr2_fill_path(pScene->renderer, pPath, fillRule, color);
+}
+
+static void strokePath(scene_context* pScene, const ksr2_path* pPath, const ksr2_stroke_parameters* pParameters, ksr2_rgba_color color)
+{
+	addPathWork(pScene, pPath, pParameters->width * 0.5f);
+	ksr2_stroke_path(pScene->renderer, pPath, pParameters, color);
+}
+
+static void drawText(scene_context* pScene, int x, int y, const char* pText, ksr2_rgba_color color)
+{
+	ksr2_font_parameters fontParameters;
+	ksr2_get_builtin_font_parameters(&fontParameters);
+
+	pScene->work.pixelCount 	+= (uint64)strlen(pText) * fontParameters.glyphWidth * fontParameters.glyphHeight;
+	pScene->work.commandCount 	+= 1u;
+	ksr2_draw_text(pScene->renderer, pScene->font, x, y, pText, color);
+}
+
+static void clearScreen(scene_context* pScene, ksr2_rgba_color color)
+{
+	pScene->work.pixelCount 	+= (uint64)pScene->width * (uint64)pScene->height;
+	pScene->work.commandCount 	+= 1u;
+	ksr2_clear(pScene->renderer, color);
+}
+
+static void sceneClear(scene_context* pScene)
+{
+	const uint32 value = pScene->frameIndex * 7u;
+	clearScreen(pScene, ksr2_rgb_color_uint8((unsigned char)value, (unsigned char)(value >> 1), (unsigned char)(value >> 2)));
+}
+
+static void generateSmallRects(scene_context* pScene)
+{
+	uint32 randomState = 0x1234567u;
+	const int offset = (int)(pScene->frameIndex % 32u);
+
+	for (uint32 rectIndex = 0u; rectIndex < SMALL_RECT_COUNT; ++rectIndex)
+	{
+		rectX1[rectIndex] 		= (int)(nextRandom(&randomState) % (uint32)pScene->width) + offset - SMALL_RECT_SIZE;
+		rectY1[rectIndex] 		= (int)(nextRandom(&randomState) % (uint32)pScene->height) + offset - SMALL_RECT_SIZE;
+		rectX2[rectIndex] 		= rectX1[rectIndex] + SMALL_RECT_SIZE;
+		rectY2[rectIndex] 		= rectY1[rectIndex] + SMALL_RECT_SIZE;
+		rectColors[rectIndex] 	= ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xFFu);
+	}
+}
+
+static void sceneSmallRects(scene_context* pScene)
+{
+	generateSmallRects(pScene);
+	clearScreen(pScene, ksr2_color_black());
+
+	for (uint32 rectIndex = 0u; rectIndex < SMALL_RECT_COUNT; ++rectIndex)
+	{
+		drawRect(pScene, rectX1[rectIndex], rectY1[rectIndex], rectX2[rectIndex], rectY2[rectIndex], rectColors[rectIndex]);
+	}
+}
+
+static void sceneSmallRectsBatched(scene_context* pScene)
+{
+	generateSmallRects(pScene);
+	clearScreen(pScene, ksr2_color_black());
+
+	for (uint32 rectIndex = 0u; rectIndex < SMALL_RECT_COUNT; ++rectIndex)
+	{
+		const int width 	= clampInt(rectX2[rectIndex], 0, pScene->width) - clampInt(rectX1[rectIndex], 0, pScene->width);
+		const int height 	= clampInt(rectY2[rectIndex], 0, pScene->height) - clampInt(rectY1[rectIndex], 0, pScene->height);
+
+		if (width > 0 && height > 0)
+		{
+			pScene->work.pixelCount += (uint64)width * (uint64)height;
+		}
+	}
+
+	pScene->work.commandCount += SMALL_RECT_COUNT;
+	ksr2_draw_filled_rects(pScene->renderer, rectX1, rectY1, rectX2, rectY2, rectColors, SMALL_RECT_COUNT);
+}
+
+//FK: alpha blended rects that cover half of the screen each, nothing can be culled
+static void sceneLargeRects(scene_context* pScene)
+{
+	const int offset = (int)(pScene->frameIndex % 32u);
+
+	clearScreen(pScene, ksr2_color_black());
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_ALPHA);
+
+	for (uint32 rectIndex = 0u; rectIndex < LARGE_RECT_COUNT; ++rectIndex)
+	{
+		const int x = (int)(rectIndex % 4u) * pScene->width / 8 + offset;
+		const int y = (int)(rectIndex / 4u) * pScene->height / 4 + offset;
+		drawRect(pScene, x, y, x + pScene->width / 2, y + pScene->height / 2, ksr2_rgba_color_uint8((unsigned char)(rectIndex * 32u), 0x80, 0xFF, 0x60));
+	}
+
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+}
+
+static void sceneLongLines(scene_context* pScene)
+{
+	uint32 randomState = 0x89ABCDEu;
+	const int offset = (int)(pScene->frameIndex % 64u);
+
+	clearScreen(pScene, ksr2_color_black());
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 lineIndex = 0u; lineIndex < LONG_LINE_COUNT; ++lineIndex)
+	{
+		const int x1 = (int)(nextRandom(&randomState) % (uint32)pScene->width);
+		const int x2 = (int)(nextRandom(&randomState) % (uint32)pScene->width);
+		const unsigned int thickness = (lineIndex % 4u) == 0u ? 4u : 1u;
+		const ksr2_rgba_color color = ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xFFu);
+
+		//FK: alternate between lines that go from top to bottom and lines that go from left to right
+		if (lineIndex % 2u)
+		{
+			drawLine(pScene, x1 + offset, 0, x2 - offset, pScene->height - 1, thickness, color);
+		}
+		else
+		{
+			const int y1 = x1 % pScene->height;
+			const int y2 = x2 % pScene->height;
+			drawLine(pScene, 0, y1 + offset, pScene->width - 1, y2 - offset, thickness, color);
+		}
+	}
+}
+
+//FK: Short lines of a single thickness in every direction, like the lines of charts. Every 8th line is horizontal and 
+//	  every 8th vertical to cover the fast path of axis aligned lines.
+static void drawChartLines(scene_context* pScene, unsigned int thickness)
+{
+	uint32 randomState = 0x13579BDu;
+	const int offset = (int)(pScene->frameIndex % 64u);
+
+	clearScreen(pScene, ksr2_color_black());
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 lineIndex = 0u; lineIndex < CHART_LINE_COUNT; ++lineIndex)
+	{
+		const int x1 = (int)(nextRandom(&randomState) % (uint32)pScene->width) + offset;
+		const int y1 = (int)(nextRandom(&randomState) % (uint32)pScene->height);
+		int x2 = x1 + (int)(nextRandom(&randomState) % (2u * CHART_LINE_LENGTH + 1u)) - CHART_LINE_LENGTH;
+		int y2 = y1 + (int)(nextRandom(&randomState) % (2u * CHART_LINE_LENGTH + 1u)) - CHART_LINE_LENGTH;
+		const ksr2_rgba_color color = ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xFFu);
+
+		if (lineIndex % 8u == 0u)
+		{
+			y2 = y1;
+		}
+		else if (lineIndex % 8u == 1u)
+		{
+			x2 = x1;
+		}
+
+		drawLine(pScene, x1, y1, x2, y2, thickness, color);
+	}
+}
+
+static void sceneLines1px(scene_context* pScene)
+{
+	drawChartLines(pScene, 1u);
+}
+
+static void sceneLines4px(scene_context* pScene)
+{
+	drawChartLines(pScene, 4u);
+}
+
+static void sceneLines16px(scene_context* pScene)
+{
+	drawChartLines(pScene, 16u);
+}
+
+//FK: Unshared flat colored triangles with subpixel positions, the triangle counterpart of small_rects_batched
+static void sceneSmallTriangles(scene_context* pScene)
+{
+	uint32 randomState = 0x2468ACEu;
+	const float offset = (float)(pScene->frameIndex % 32u) * 0.25f;
+
+	clearScreen(pScene, ksr2_color_black());
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 vertexIndex = 0u; vertexIndex < SMALL_TRIANGLE_COUNT * 3u; vertexIndex += 3u)
+	{
+		const float x = (float)(nextRandom(&randomState) % (uint32)pScene->width) + offset;
+		const float y = (float)(nextRandom(&randomState) % (uint32)pScene->height) + offset;
+		const ksr2_rgba_color color = ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xFFu);
+
+		for (uint32 index = vertexIndex; index < vertexIndex + 3u; ++index)
+		{
+			vertexX[index] 			= x + (float)(nextRandom(&randomState) % (SMALL_TRIANGLE_SIZE * 16u)) / 16.0f;
+			vertexY[index] 			= y + (float)(nextRandom(&randomState) % (SMALL_TRIANGLE_SIZE * 16u)) / 16.0f;
+			vertexColors[index] 	= color;
+			triangleIndices[index] 	= index;
+		}
+	}
+
+	drawTriangles(pScene, SMALL_TRIANGLE_COUNT * 3u, SMALL_TRIANGLE_COUNT * 3u);
+}
+
+//FK: Indexed grid mesh with a color per vertex that covers the whole image, the vertices wobble from frame to frame
+static void sceneTriangleMesh(scene_context* pScene)
+{
+	uint32 randomState = 0x13579BDu;
+	uint32 cellSize = TRIANGLE_MESH_CELL_SIZE;
+
+	//FK: grow the cells on huge images so that the mesh fits into the vertex arrays
+	while ((uint32)(pScene->width / cellSize + 2) * (uint32)(pScene->height / cellSize + 2) > MAX_TRIANGLE_VERTEX_COUNT)
+	{
+		cellSize *= 2u;
+	}
+
+	const uint32 columnCount 	= (uint32)pScene->width / cellSize + 2u;
+	const uint32 rowCount 		= (uint32)pScene->height / cellSize + 2u;
+	const float wobble 			= (float)(pScene->frameIndex % 16u) / 16.0f;
+	uint32 indexCount 			= 0u;
+
+	clearScreen(pScene, ksr2_color_black());
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 row = 0u; row < rowCount; ++row)
+	{
+		for (uint32 column = 0u; column < columnCount; ++column)
+		{
+			const uint32 index = row * columnCount + column;
+			vertexX[index] 		= (float)(column * cellSize) + (float)(nextRandom(&randomState) % cellSize) * wobble * 0.5f;
+			vertexY[index] 		= (float)(row * cellSize) + (float)(nextRandom(&randomState) % cellSize) * wobble * 0.5f;
+			vertexColors[index] = ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xFFu);
+		}
+	}
+
+	for (uint32 row = 0u; row + 1u < rowCount && indexCount + 6u <= MAX_TRIANGLE_VERTEX_COUNT; ++row)
+	{
+		for (uint32 column = 0u; column + 1u < columnCount && indexCount + 6u <= MAX_TRIANGLE_VERTEX_COUNT; ++column)
+		{
+			const unsigned int topLeft = row * columnCount + column;
+			triangleIndices[indexCount++] = topLeft;
+			triangleIndices[indexCount++] = topLeft + 1u;
+			triangleIndices[indexCount++] = topLeft + columnCount;
+			triangleIndices[indexCount++] = topLeft + 1u;
+			triangleIndices[indexCount++] = topLeft + columnCount + 1u;
+			triangleIndices[indexCount++] = topLeft + columnCount;
+		}
+	}
+
+	drawTriangles(pScene, columnCount * rowCount, indexCount);
+}
+
+//FK: Rounded panels covered with small dots, rings and ellipses at subpixel positions and a few circles that cover most 
+//	  of the image. Only the edges of the shapes get blended with their coverage, so the huge circles should cost about 
+//	  as much as a rect of the same size.
+static void sceneRoundShapes(scene_context* pScene)
+{
+	uint32 randomState = 0x5A5A5A5u;
+	const float offset 		= (float)(pScene->frameIndex % 16u) / 16.0f;
+	const float panelWidth 	= (float)pScene->width / ROUND_PANEL_GRID_WIDTH;
+	const float panelHeight = (float)pScene->height / ROUND_PANEL_GRID_HEIGHT;
+	const float largeRadius = (float)(pScene->width < pScene->height ? pScene->width : pScene->height) / 3.0f;
+
+	clearScreen(pScene, ksr2_rgb_color_uint8(30, 30, 36));
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 panelIndex = 0u; panelIndex < ROUND_PANEL_GRID_WIDTH * ROUND_PANEL_GRID_HEIGHT; ++panelIndex)
+	{
+		const float panelX = (float)(panelIndex % ROUND_PANEL_GRID_WIDTH) * panelWidth + offset;
+		const float panelY = (float)(panelIndex / ROUND_PANEL_GRID_WIDTH) * panelHeight;
+		drawRoundedRect(pScene, panelX + 4.0f, panelY + 4.0f, panelX + panelWidth - 4.0f, panelY + panelHeight - 4.0f, 12.0f, ksr2_rgb_color_uint8(50, 50, 60));
+	}
+
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_ALPHA);
+
+	for (uint32 circleIndex = 0u; circleIndex < LARGE_CIRCLE_COUNT; ++circleIndex)
+	{
+		const float x = (float)pScene->width * (float)(circleIndex + 1u) / (LARGE_CIRCLE_COUNT + 1u) + offset;
+		drawEllipse(pScene, x, (float)pScene->height * 0.5f, largeRadius, largeRadius, ksr2_rgba_color_uint8(200, 80, 40, 96));
+	}
+
+	for (uint32 markerIndex = 0u; markerIndex < ROUND_MARKER_COUNT; ++markerIndex)
+	{
+		const float x 					= (float)(nextRandom(&randomState) % (uint32)pScene->width) + offset;
+		const float y 					= (float)(nextRandom(&randomState) % (uint32)pScene->height) + offset;
+		const float radius 				= 2.0f + (float)(nextRandom(&randomState) % 64u) / 8.0f;
+		const ksr2_rgba_color color 	= ksr2_rgba_color_uint32(nextRandom(&randomState) | 0x80u);
+
+		switch(markerIndex % 3u)
+		{
+			case 0u:
+				drawEllipse(pScene, x, y, radius, radius, color);
+			break;
+
+			case 1u:
+				drawRing(pScene, x, y, radius, 1.5f, color);
+			break;
+
+			default:
+				drawEllipse(pScene, x, y, radius, radius * 0.5f, color);
+			break;
+		}
+	}
+}
+
+//FK: Alpha blended sprites at random positions, the sprites per second get printed to stderr
+static void drawSprites(scene_context* pScene, ksr2_texturehandle texture, int size, uint32 spriteCount)
+{
+	uint32 randomState = 0x3C6EF37u;
+	const int offset = (int)(pScene->frameIndex % 64u);
+
+	clearScreen(pScene, ksr2_rgb_color_uint8(40, 60, 90));
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 spriteIndex = 0u; spriteIndex < spriteCount; ++spriteIndex)
+	{
+		const int x = (int)(nextRandom(&randomState) % (uint32)(pScene->width + size)) - size + offset;
+		const int y = (int)(nextRandom(&randomState) % (uint32)(pScene->height + size)) - size;
+		drawSprite(pScene, texture, size, x, y);
+	}
+}
+
+static void sceneSprites32(scene_context* pScene)
+{
+	drawSprites(pScene, pScene->smallSprite, SMALL_SPRITE_SIZE, SMALL_SPRITE_COUNT);
+}
+
+static void sceneSprites256(scene_context* pScene)
+{
+	drawSprites(pScene, pScene->largeSprite, LARGE_SPRITE_SIZE, LARGE_SPRITE_COUNT);
+}
+
+//FK: A grid of icons made of curves, noisy self intersecting polygons filled with the even-odd fill rule and random walks 
+//	  stroked with round joins and caps. Every path gets flattened and recorded again each frame.
+static void scenePaths(scene_context* pScene)
+{
+	uint32 randomState = 0x2468ACEu;
+	const float offset 		= (float)(pScene->frameIndex % 16u) / 16.0f;
+	const float cellWidth 	= (float)pScene->width / PATH_ICON_GRID_WIDTH;
+	const float cellHeight 	= (float)pScene->height / PATH_ICON_GRID_HEIGHT;
+	const float iconSize 	= (cellWidth < cellHeight ? cellWidth : cellHeight) * 0.4f;
+	const float polygonRadius = (float)(pScene->width < pScene->height ? pScene->width : pScene->height) / 4.0f;
+	ksr2_path path;
+
+	clearScreen(pScene, ksr2_rgb_color_uint8(240, 240, 235));
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+
+	for (uint32 iconIndex = 0u; iconIndex < PATH_ICON_GRID_WIDTH * PATH_ICON_GRID_HEIGHT; ++iconIndex)
+	{
+		const float x = ((float)(iconIndex % PATH_ICON_GRID_WIDTH) + 0.5f) * cellWidth + offset;
+		const float y = ((float)(iconIndex / PATH_ICON_GRID_WIDTH) + 0.5f) * cellHeight + offset;
+
+		//FK: heart out of two cubics and a pin out of quads
+		ksr2_init_path(&path, pathVerbs, MAX_PATH_POINT_COUNT, pathPoints, MAX_PATH_POINT_COUNT);
+		if (iconIndex % 2u == 0u)
+		{
+			ksr2_path_move_to(&path, x, y + iconSize);
+			ksr2_path_cubic_to(&path, x - iconSize * 2.0f, y - iconSize * 0.2f, x - iconSize * 0.6f, y - iconSize * 1.6f, x, y - iconSize * 0.5f);
+			ksr2_path_cubic_to(&path, x + iconSize * 0.6f, y - iconSize * 1.6f, x + iconSize * 2.0f, y - iconSize * 0.2f, x, y + iconSize);
+		}
+		else
+		{
+			ksr2_path_move_to(&path, x, y + iconSize);
+			ksr2_path_quad_to(&path, x - iconSize, y, x - iconSize, y - iconSize * 0.4f);
+			ksr2_path_quad_to(&path, x - iconSize, y - iconSize, x, y - iconSize);
+			ksr2_path_quad_to(&path, x + iconSize, y - iconSize, x + iconSize, y - iconSize * 0.4f);
+			ksr2_path_quad_to(&path, x + iconSize, y, x, y + iconSize);
+		}
+		ksr2_path_close(&path);
+
+		fillPath(pScene, &path, K15_RENDERER_2D_FILL_RULE_NONZERO, ksr2_rgba_color_uint32((nextRandom(&randomState) & 0xFFFFFF00u) | 0xFFu));
+	}
+
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_ALPHA);
+
+	for (uint32 polygonIndex = 0u; polygonIndex < PATH_POLYGON_COUNT; ++polygonIndex)
+	{
+		const float centerX = (float)(nextRandom(&randomState) % (uint32)pScene->width) + offset;
+		const float centerY = (float)(nextRandom(&randomState) % (uint32)pScene->height) + offset;
+
+		ksr2_init_path(&path, pathVerbs, MAX_PATH_POINT_COUNT, pathPoints, MAX_PATH_POINT_COUNT);
+		for (uint32 pointIndex = 0u; pointIndex < PATH_POLYGON_POINT_COUNT; ++pointIndex)
+		{
+			const float angle 	= (float)pointIndex * 6.2831853f / PATH_POLYGON_POINT_COUNT;
+			const float radius 	= polygonRadius * (0.3f + (float)(nextRandom(&randomState) % 1024u) / 1024.0f);
+			const float x 		= centerX + cosf(angle) * radius;
+			const float y 		= centerY + sinf(angle) * radius;
+
+			if (pointIndex == 0u)
+			{
+				ksr2_path_move_to(&path, x, y);
+			}
+			else
+			{
+				ksr2_path_line_to(&path, x, y);
+			}
+		}
+
+		fillPath(pScene, &path, K15_RENDERER_2D_FILL_RULE_EVEN_ODD, ksr2_rgba_color_uint32(nextRandom(&randomState) & 0xFFFFFF80u));
+	}
+
+	ksr2_stroke_parameters strokeParameters;
+	strokeParameters.width 		= 3.0f;
+	strokeParameters.miterLimit = 0.0f;
+	strokeParameters.join 		= K15_RENDERER_2D_LINE_JOIN_ROUND;
+	strokeParameters.cap 		= K15_RENDERER_2D_LINE_CAP_ROUND;
+
+	for (uint32 polylineIndex = 0u; polylineIndex < PATH_POLYLINE_COUNT; ++polylineIndex)
+	{
+		float x = (float)(nextRandom(&randomState) % (uint32)pScene->width) + offset;
+		float y = (float)(nextRandom(&randomState) % (uint32)pScene->height) + offset;
+
+		ksr2_init_path(&path, pathVerbs, MAX_PATH_POINT_COUNT, pathPoints, MAX_PATH_POINT_COUNT);
+		ksr2_path_move_to(&path, x, y);
+		for (uint32 pointIndex = 1u; pointIndex < PATH_POLYLINE_POINT_COUNT; ++pointIndex)
+		{
+			x += (float)((int)(nextRandom(&randomState) % 81u) - 40);
+			y += (float)((int)(nextRandom(&randomState) % 81u) - 40);
+			ksr2_path_line_to(&path, x, y);
+		}
+
+		strokePath(pScene, &path, &strokeParameters, ksr2_rgba_color_uint32(nextRandom(&randomState) | 0xC0u));
+	}
+}
+
+static void drawPanel(scene_context* pScene, uint32 panelIndex, int panelX, int panelY, int panelWidth, int panelHeight)
+{
+	const int buttonHeight = panelHeight / (UI_BUTTONS_PER_PANEL / 2) - 4;
+	char label[32];
+
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+	drawRect(pScene, panelX + 2, panelY + 2, panelX + panelWidth - 2, panelY + panelHeight - 2, ksr2_rgb_color_uint8(50, 50, 60));
+	drawLine(pScene, panelX + 2, panelY + 2, panelX + panelWidth - 2, panelY + 2, 1u, ksr2_rgb_color_uint8(90, 90, 110));
+	drawLine(pScene, panelX + 2, panelY + panelHeight - 3, panelX + panelWidth - 2, panelY + panelHeight - 3, 1u, ksr2_rgb_color_uint8(20, 20, 24));
+
+	for (uint32 buttonIndex = 0u; buttonIndex < UI_BUTTONS_PER_PANEL; ++buttonIndex)
+	{
+		const int buttonX = panelX + 6 + (int)(buttonIndex % 2u) * (panelWidth / 2 - 4);
+		const int buttonY = panelY + 6 + (int)(buttonIndex / 2u) * (buttonHeight + 4);
+		const int buttonWidth = panelWidth / 2 - 10;
+		const int isHovered = ((panelIndex * UI_BUTTONS_PER_PANEL + buttonIndex) % 29u) == (pScene->frameIndex % 29u);
+
+		ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_ALPHA);
+		drawRect(pScene, buttonX, buttonY, buttonX + buttonWidth, buttonY + buttonHeight, ksr2_rgba_color_uint8(70, 110, 200, 160));
+
+		if (isHovered)
+		{
+			ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_ADDITIVE);
+			drawRect(pScene, buttonX, buttonY, buttonX + buttonWidth, buttonY + buttonHeight, ksr2_rgba_color_uint8(60, 60, 60, 255));
+		}
+
+		sprintf(label, "Button %u", panelIndex * UI_BUTTONS_PER_PANEL + buttonIndex);
+		ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+		drawText(pScene, buttonX + 4, buttonY + 2, label, ksr2_color_white());
+	}
+}
+
+static void sceneMixedUI(scene_context* pScene)
+{
+	const int panelWidth 	= pScene->width / 6;
+	const int panelHeight 	= pScene->height / 4;
+	const int offset 		= (int)(pScene->frameIndex % 16u);
+
+	clearScreen(pScene, ksr2_rgb_color_uint8(30, 30, 36));
+
+	for (uint32 panelIndex = 0u; panelIndex < UI_PANEL_COUNT; ++panelIndex)
+	{
+		const int panelX = (int)(panelIndex % 6u) * panelWidth;
+		const int panelY = (int)(panelIndex / 6u) * panelHeight + (panelIndex == 0u ? offset : 0);
+		drawPanel(pScene, panelIndex, panelX, panelY, panelWidth, panelHeight);
+	}
+
+	//FK: drop shadow of a tooltip on top of everything
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_MULTIPLY);
+	drawRect(pScene, 104 + offset, 104, 364 + offset, 184, ksr2_rgba_color_uint8(0, 0, 0, 96));
+	ksr2_set_blend_mode(pScene->renderer, K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+	drawRect(pScene, 100 + offset, 100, 360 + offset, 180, ksr2_rgb_color_uint8(240, 240, 200));
+	drawText(pScene, 108 + offset, 108, "Tooltip\nwith two lines", ksr2_color_black());
+}
+
+//FK: range of the panel grid that one thread records into its command list
+typedef struct
+{
+	scene_context 	scene; //FK: renderer is the command list of the thread
+	uint32 			firstPanelIndex;
+	uint32 			endPanelIndex;
+} panel_recorder;
+
+static void recordPanels(panel_recorder* pRecorder)
+{
+	scene_context* pScene 	= &pRecorder->scene;
+	const int panelWidth 	= pScene->width / UI_PANEL_GRID_WIDTH;
+	const int panelHeight 	= pScene->height / UI_PANEL_GRID_HEIGHT;
+
+	for (uint32 panelIndex = pRecorder->firstPanelIndex; panelIndex < pRecorder->endPanelIndex; ++panelIndex)
+	{
+		const int panelX = (int)(panelIndex % UI_PANEL_GRID_WIDTH) * panelWidth;
+		const int panelY = (int)(panelIndex / UI_PANEL_GRID_WIDTH) * panelHeight;
+		drawPanel(pScene, panelIndex, panelX, panelY, panelWidth, panelHeight);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI recordPanelsThread(LPVOID pArgument)
+{
+	recordPanels((panel_recorder*)pArgument);
+	return 0;
+}
+#else
+static void* recordPanelsThread(void* pArgument)
+{
+	recordPanels((panel_recorder*)pArgument);
+	return 0;
+}
+#endif
+
+//FK: Grid of small panels that every recording thread records a part of into its own command list, the command lists 
+//	  get submitted in panel order. Without command lists the panels get recorded into the context directly.
+static void sceneUIPanels(scene_context* pScene)
+{
+	const uint32 panelCount 	= UI_PANEL_GRID_WIDTH * UI_PANEL_GRID_HEIGHT;
+	const uint32 recorderCount 	= pScene->commandListCount > 0u ? pScene->commandListCount : 1u;
+
+	panel_recorder recorders[MAX_RECORD_THREAD_COUNT];
+
+	clearScreen(pScene, ksr2_rgb_color_uint8(30, 30, 36));
+
+	for (uint32 recorderIndex = 0u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		panel_recorder* pRecorder = &recorders[recorderIndex];
+		pRecorder->scene 				= *pScene;
+		pRecorder->firstPanelIndex 		= panelCount * recorderIndex / recorderCount;
+		pRecorder->endPanelIndex 		= panelCount * (recorderIndex + 1u) / recorderCount;
+		memset(&pRecorder->scene.work, 0, sizeof(pRecorder->scene.work));
+
+		if (pScene->commandListCount > 0u)
+		{
+			//FK: the frame that recorded into these command lists got rasterized already, see runScene()
+			pRecorder->scene.renderer = pScene->pCommandLists[recorderIndex];
+			ksr2_reset_command_list(pRecorder->scene.renderer);
+		}
+	}
+
+	const uint64 recordStartTime = getTimeInNs();
+
+	//FK: the calling thread records the first range itself
+#ifdef _WIN32
+	HANDLE threads[MAX_RECORD_THREAD_COUNT];
+	for (uint32 recorderIndex = 1u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		threads[recorderIndex] = CreateThread(0, 0u, recordPanelsThread, &recorders[recorderIndex], 0u, 0);
+	}
+
+	recordPanels(&recorders[0]);
+
+	for (uint32 recorderIndex = 1u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		WaitForSingleObject(threads[recorderIndex], INFINITE);
+		CloseHandle(threads[recorderIndex]);
+	}
+#else
+	pthread_t threads[MAX_RECORD_THREAD_COUNT];
+	for (uint32 recorderIndex = 1u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		pthread_create(&threads[recorderIndex], 0, recordPanelsThread, &recorders[recorderIndex]);
+	}
+
+	recordPanels(&recorders[0]);
+
+	for (uint32 recorderIndex = 1u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		pthread_join(threads[recorderIndex], 0);
+	}
+#endif
+
+	pScene->recordTimeInNs = getTimeInNs() - recordStartTime;
+
+	for (uint32 recorderIndex = 0u; recorderIndex < recorderCount; ++recorderIndex)
+	{
+		if (pScene->commandListCount > 0u)
+		{
+			ksr2_submit_command_list(pScene->renderer, pScene->pCommandLists[recorderIndex]);
+		}
+
+		pScene->work.pixelCount 	+= recorders[recorderIndex].scene.work.pixelCount;
+		pScene->work.commandCount 	+= recorders[recorderIndex].scene.work.commandCount;
+	}
+}
+
+static const scene scenes[] = {
+	{"clear", 				sceneClear},
+	{"small_rects", 		sceneSmallRects},
+	{"small_rects_batched", sceneSmallRectsBatched},
+	{"long_lines", 			sceneLongLines},
+	{"lines_1px", 			sceneLines1px},
+	{"lines_4px", 			sceneLines4px},
+	{"lines_16px", 			sceneLines16px},
+	{"large_rects", 		sceneLargeRects},
+	{"mixed_ui", 			sceneMixedUI},
+	{"ui_panels", 			sceneUIPanels},
+	{"small_triangles", 	sceneSmallTriangles},
+	{"triangle_mesh", 		sceneTriangleMesh},
+	{"round_shapes", 		sceneRoundShapes},
+	{"paths", 				scenePaths},
+	{"sprites_32", 			sceneSprites32},
+	{"sprites_256", 		sceneSprites256}
+};
+
+static int compareUint64(const void* pA, const void* pB)
+{
+	const uint64 a = *(const uint64*)pA;
+	const uint64 b = *(const uint64*)pB;
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static int compareDouble(const void* pA, const void* pB)
+{
+	const double a = *(const double*)pA;
+	const double b = *(const double*)pB;
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+//FK: nearest rank percentile of sorted values
+static uint32 getPercentileIndex(uint32 count, uint32 percentile)
+{
+	const uint32 rank = (count * percentile + 99u) / 100u;
+	return rank == 0u ? 0u : rank - 1u;
+}
+
+static void* allocateChunk(void* pUserData, size_t sizeInBytes)
+{
+	chunk_pool* pPool = (chunk_pool*)pUserData;
+
+	if (pPool->freeChunkCount > 0u)
+	{
+		return pPool->ppFreeChunks[--pPool->freeChunkCount];
+	}
+
+	if (pPool->allocatedChunkCount == pPool->maxChunkCount)
+	{
+		return 0;
+	}
+
+	void* pChunk = malloc(sizeInBytes);
+
+	if (pChunk != 0)
+	{
+		++pPool->allocatedChunkCount;
+	}
+
+	return pChunk;
+}
+
+static void freeChunk(void* pUserData, void* pChunk)
+{
+	chunk_pool* pPool = (chunk_pool*)pUserData;
+	pPool->ppFreeChunks[pPool->freeChunkCount++] = pChunk;
+}
+
+static bool8 writeTrace(ksr2_contexthandle renderer, const char* pTracePrefix, const char* pSceneName)
+{
+	char path[512];
+	snprintf(path, sizeof(path), "%s%s.json", pTracePrefix, pSceneName);
+
+	const size_t jsonSizeInBytes = ksr2_write_trace_json(renderer, 0, 0u);
+	char* pJson = (char*)malloc(jsonSizeInBytes);
+	FILE* pFile = fopen(path, "wb");
+
+	bool8 success = K15_FALSE;
+
+	if (pJson != 0 && pFile != 0)
+	{
+		ksr2_write_trace_json(renderer, pJson, jsonSizeInBytes);
+		success = fwrite(pJson, 1u, jsonSizeInBytes, pFile) == jsonSizeInBytes;
+	}
+
+	if (success == K15_FALSE)
+	{
+		fprintf(stderr, "could not write trace '%s'.\n", path);
+	}
+
+	if (pFile != 0)
+	{
+		fclose(pFile);
+	}
+
+	free(pJson);
+	return success;
+}
+
+//FK: FNV-1a over the pixels of every row, without the padding of padded rows
+static uint64 hashImage(uint64 hash, const unsigned char* pImageData, unsigned int stride, const ksr2_context_parameters* pContextParameters)
+{
+	const size_t rowSizeInBytes = (size_t)pContextParameters->backBufferWidth * ksr2_get_pixel_size(pContextParameters->backBufferFormat);
+
+	for (unsigned int y = 0u; y < pContextParameters->backBufferHeight; ++y)
+	{
+		const unsigned char* pRow = pImageData + (size_t)y * stride;
+
+		for (size_t byteIndex = 0u; byteIndex < rowSizeInBytes; ++byteIndex)
+		{
+			hash = (hash ^ pRow[byteIndex]) * 0x100000001B3ull;
+		}
+	}
+
+	return hash;
+}
+
+//FK: copies the image that is ready for presentation if pPresentBuffer is set and hands it back to the swap chain. Adds the 
+//	  image to the hash of pVerification if that is set.
+static void presentImage(ksr2_contexthandle renderer, unsigned char* pPresentBuffer, const ksr2_context_parameters* pContextParameters, scene_verification* pVerification)
+{
+	unsigned char* pImageData = 0;
+	unsigned int imageIndex = 0u;
+
+	if (ksr2_acquire_presentable_image(renderer, &pImageData, &imageIndex) != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return;
+	}
+
+	const unsigned int width 	= pContextParameters->backBufferWidth;
+	const unsigned int height 	= pContextParameters->backBufferHeight;
+	const unsigned int stride 	= ksr2_get_image_stride(renderer);
+
+	if (pVerification != 0)
+	{
+		pVerification->imageHash = hashImage(pVerification->imageHash, pImageData, stride, pContextParameters);
+	}
+
+	if (pPresentBuffer != 0 && ksr2_get_pixel_size(pContextParameters->backBufferFormat) == 4u)
+	{
+		memcpy(pPresentBuffer, pImageData, (size_t)stride * height);
+	}
+	else if (pPresentBuffer != 0)
+	{
+		for (unsigned int y = 0u; y < height; ++y)
+		{
+			ksr2_convert_pixels(pPresentBuffer + (size_t)y * width * 4u, K15_RENDERER_2D_PIXEL_FORMAT_ARGB, pImageData + (size_t)y * stride, pContextParameters->backBufferFormat, width);
+		}
+	}
+
+	ksr2_swap_buffers(renderer);
+}
+
+//FK: A ball with a checkerboard pattern and an anti-aliased edge, the corners are transparent
+static ksr2_result createSpriteTexture(ksr2_contexthandle renderer, int size, ksr2_texturehandle* pOutTexture)
+{
+	const float radius = (float)size * 0.5f;
+
+	for (int y = 0; y < size; ++y)
+	{
+		for (int x = 0; x < size; ++x)
+		{
+			const float deltaX 		= (float)x + 0.5f - radius;
+			const float deltaY 		= (float)y + 0.5f - radius;
+			const float coverage 	= radius - sqrtf(deltaX * deltaX + deltaY * deltaY);
+			const unsigned char alpha = coverage >= 1.0f ? 255u : (coverage <= 0.0f ? 0u : (unsigned char)(coverage * 255.0f));
+			const unsigned char shade = (((x * 8 / size) + (y * 8 / size)) & 1) ? 230u : 120u;
+
+			spritePixels[y * size + x] = ksr2_rgba_color_uint8(shade, (unsigned char)(x * 255 / size), (unsigned char)(y * 255 / size), alpha);
+		}
+	}
+
+	ksr2_texture_parameters textureParameters;
+	memset(&textureParameters, 0, sizeof(textureParameters));
+	textureParameters.pPixels 	= spritePixels;
+	textureParameters.width 	= (unsigned int)size;
+	textureParameters.height 	= (unsigned int)size;
+	textureParameters.format 	= K15_RENDERER_2D_PIXEL_FORMAT_RGBA;
+
+	return ksr2_create_texture(renderer, &textureParameters, pOutTexture);
+}
+
+//FK: Prints the CSV line of the scene unless pVerification is set.
+static bool8 runScene(const scene* pScene, const ksr2_context_parameters* pContextParameters, uint32 frameCount, uint32 warmupFrameCount, const char* pTracePrefix, uint32 recordThreadCount, bool8 present, scene_verification* pVerification)
+{
+	ksr2_contexthandle renderer;
+	ksr2_result result = ksr2_init_context(pContextParameters, &renderer);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		fprintf(stderr, "could not create context for scene '%s' (error %d).\n", pScene->pName, (int)result);
+		return K15_FALSE;
+	}
+
+	ksr2_font_parameters fontParameters;
+	ksr2_get_builtin_font_parameters(&fontParameters);
+
+	scene_context sceneContext;
+	memset(&sceneContext, 0, sizeof(sceneContext));
+	sceneContext.renderer 	= renderer;
+	sceneContext.width 		= (int)pContextParameters->backBufferWidth;
+	sceneContext.height 	= (int)pContextParameters->backBufferHeight;
+
+	result = ksr2_create_font(renderer, &fontParameters, &sceneContext.font);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		fprintf(stderr, "could not create font for scene '%s' (error %d).\n", pScene->pName, (int)result);
+		ksr2_destroy_context(renderer);
+		return K15_FALSE;
+	}
+
+	result = createSpriteTexture(renderer, SMALL_SPRITE_SIZE, &sceneContext.smallSprite);
+
+	if (result == K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		result = createSpriteTexture(renderer, LARGE_SPRITE_SIZE, &sceneContext.largeSprite);
+	}
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		fprintf(stderr, "could not create sprite textures for scene '%s' (error %d).\n", pScene->pName, (int)result);
+		ksr2_destroy_context(renderer);
+		return K15_FALSE;
+	}
+
+	//FK: with K15_RENDERER_2D_ASYNC_BLIT_FLAG the command lists of the previous frame are still in use while the next one
+	//	  gets recorded, every other frame uses the second set
+	const bool8 isAsync 				= (pContextParameters->flags & K15_RENDERER_2D_ASYNC_BLIT_FLAG) != 0u;
+	const uint32 commandListSetCount 	= isAsync ? 2u : 1u;
+	const uint32 commandListCount 		= recordThreadCount * commandListSetCount;
+
+	ksr2_commandlisthandle commandLists[MAX_RECORD_THREAD_COUNT * 2u];
+	void* pCommandListMemory = 0;
+
+	if (recordThreadCount > 0u)
+	{
+		pCommandListMemory = malloc((size_t)COMMAND_LIST_MEMORY_SIZE_IN_BYTES * commandListCount);
+
+		for (uint32 commandListIndex = 0u; commandListIndex < commandListCount && pCommandListMemory != 0; ++commandListIndex)
+		{
+			ksr2_command_list_parameters commandListParameters;
+			commandListParameters.pMemory 			= (char*)pCommandListMemory + (size_t)COMMAND_LIST_MEMORY_SIZE_IN_BYTES * commandListIndex;
+			commandListParameters.memorySizeInBytes = COMMAND_LIST_MEMORY_SIZE_IN_BYTES;
+			result = ksr2_create_command_list(renderer, &commandListParameters, &commandLists[commandListIndex]);
+		}
+
+		if (pCommandListMemory == 0 || result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			fprintf(stderr, "could not create command lists for scene '%s'.\n", pScene->pName);
+			free(pCommandListMemory);
+			ksr2_destroy_context(renderer);
+			return K15_FALSE;
+		}
+
+		sceneContext.pCommandLists 		= commandLists;
+		sceneContext.commandListCount 	= recordThreadCount;
+	}
+
+	const size_t imageSizeInBytes 	= (size_t)ksr2_get_image_stride(renderer) * pContextParameters->backBufferHeight;
+	const size_t argbSizeInBytes 	= (size_t)pContextParameters->backBufferWidth * pContextParameters->backBufferHeight * 4u;
+	unsigned char* pPresentBuffer 	= present ? (unsigned char*)malloc(imageSizeInBytes > argbSizeInBytes ? imageSizeInBytes : argbSizeInBytes) : 0;
+
+	uint64* pFrameTimes 	= (uint64*)malloc(sizeof(uint64) * frameCount);
+	uint64* pRecordTimes 	= (uint64*)malloc(sizeof(uint64) * frameCount);
+	double* pPixelRates 	= (double*)malloc(sizeof(double) * frameCount);
+	double* pCommandRates 	= (double*)malloc(sizeof(double) * frameCount);
+
+	for (uint32 frameIndex = 0u; frameIndex < warmupFrameCount + frameCount; ++frameIndex)
+	{
+		sceneContext.frameIndex 	= frameIndex;
+		sceneContext.recordTimeInNs = 0u;
+		memset(&sceneContext.work, 0, sizeof(sceneContext.work));
+
+		if (recordThreadCount > 0u)
+		{
+			sceneContext.pCommandLists = commandLists + (frameIndex % commandListSetCount) * recordThreadCount;
+		}
+
+		const uint64 frameStartTime = getTimeInNs();
+		pScene->function(&sceneContext);
+
+		if (isAsync)
+		{
+			//FK: the previous frame got rasterized while this one got recorded
+			if (frameIndex > 0u)
+			{
+				presentImage(renderer, pPresentBuffer, pContextParameters, pVerification);
+			}
+
+			ksr2_blit(renderer);
+		}
+		else
+		{
+			ksr2_blit(renderer);
+			presentImage(renderer, pPresentBuffer, pContextParameters, pVerification);
+		}
+
+		const uint64 frameTime = getTimeInNs() - frameStartTime;
+
+		if (frameIndex >= warmupFrameCount)
+		{
+			const uint32 sampleIndex = frameIndex - warmupFrameCount;
+			const double frameTimeInSeconds = (double)(frameTime > 0u ? frameTime : 1u) / 1000000000.0;
+
+			pFrameTimes[sampleIndex] 	= frameTime;
+			pRecordTimes[sampleIndex] 	= sceneContext.recordTimeInNs;
+			pPixelRates[sampleIndex] 	= (double)sceneContext.work.pixelCount / frameTimeInSeconds / 1000000.0;
+			pCommandRates[sampleIndex] 	= (double)sceneContext.work.commandCount / frameTimeInSeconds;
+		}
+	}
+
+	qsort(pFrameTimes, frameCount, sizeof(uint64), compareUint64);
+	qsort(pRecordTimes, frameCount, sizeof(uint64), compareUint64);
+	qsort(pPixelRates, frameCount, sizeof(double), compareDouble);
+	qsort(pCommandRates, frameCount, sizeof(double), compareDouble);
+
+	//FK: frame times are sorted fastest first, rates slowest first
+	const uint32 medianIndex = getPercentileIndex(frameCount, 50u);
+	const uint32 p99Index = getPercentileIndex(frameCount, 99u);
+	const uint32 p1Index = getPercentileIndex(frameCount, 1u);
+
+	if (pVerification == 0)
+	{
+		printf("%s,%d,%d,%u,%u,%llu,%llu,%.1f,%.1f,%.0f,%.0f\n", pScene->pName, sceneContext.width, sceneContext.height, pContextParameters->workerThreadCount, frameCount,
+			pFrameTimes[medianIndex], pFrameTimes[p99Index], pPixelRates[medianIndex], pPixelRates[p1Index], pCommandRates[medianIndex], pCommandRates[p1Index]);
+	}
+	else
+	{
+		pVerification->cpuLevel = ksr2_get_cpu_level(renderer);
+	}
+
+	if (pRecordTimes[frameCount - 1u] > 0u)
+	{
+		fprintf(stderr, "%s: recording took %llu ns per frame (median) on %u threads\n", pScene->pName, pRecordTimes[medianIndex], recordThreadCount > 0u ? recordThreadCount : 1u);
+	}
+
+	//FK: every frame draws the same number of lines and sprites
+	if (sceneContext.work.lineCount > 0u && pVerification == 0)
+	{
+		fprintf(stderr, "%s: %.0f lines per second (median), %.0f (p99)\n", pScene->pName, 
+			(double)sceneContext.work.lineCount * 1000000000.0 / (double)pFrameTimes[medianIndex], (double)sceneContext.work.lineCount * 1000000000.0 / (double)pFrameTimes[p99Index]);
+	}
+
+	if (sceneContext.work.spriteCount > 0u && pVerification == 0)
+	{
+		fprintf(stderr, "%s: %.0f sprites per second (median), %.0f (p99)\n", pScene->pName, 
+			(double)sceneContext.work.spriteCount * 1000000000.0 / (double)pFrameTimes[medianIndex], (double)sceneContext.work.spriteCount * 1000000000.0 / (double)pFrameTimes[p99Index]);
+	}
+
+	free(pPresentBuffer);
+	free(pFrameTimes);
+	free(pRecordTimes);
+	free(pPixelRates);
+	free(pCommandRates);
+
+	ksr2_frame_stats frameStats = {0};
+
+	if (ksr2_get_frame_stats(renderer, &frameStats) != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		fprintf(stderr, "could not get the frame stats of scene '%s'.\n", pScene->pName);
+	}
+
+	fprintf(stderr, "%s: draw command memory high water mark %zu KB, %u flushes in the last frame, cpu level %d\n", pScene->pName, 
+		ksr2_get_draw_command_memory_high_water_mark(renderer) / 1024u, frameStats.flushCount, (int)ksr2_get_cpu_level(renderer));
+
+	bool8 success = K15_TRUE;
+
+	if (pTracePrefix != 0)
+	{
+		success = writeTrace(renderer, pTracePrefix, pScene->pName);
+	}
+
+	ksr2_destroy_context(renderer);
+	free(pCommandListMemory);
+	return success;
+}
+
+static bool8 parsePixelFormat(const char* pName, ksr2_pixel_format* pOutFormat)
+{
+	const char* pNames[] = {"rgba", "argb", "bgra", "rgb565", "a8", "gray8"};
+	const ksr2_pixel_format formats[] = {K15_RENDERER_2D_PIXEL_FORMAT_RGBA, K15_RENDERER_2D_PIXEL_FORMAT_ARGB, K15_RENDERER_2D_PIXEL_FORMAT_BGRA, 
+		K15_RENDERER_2D_PIXEL_FORMAT_RGB565, K15_RENDERER_2D_PIXEL_FORMAT_A8, K15_RENDERER_2D_PIXEL_FORMAT_GRAY8};
+
+	for (uint32 formatIndex = 0u; formatIndex < sizeof(formats) / sizeof(formats[0]); ++formatIndex)
+	{
+		if (strcmp(pName, pNames[formatIndex]) == 0)
+		{
+			*pOutFormat = formats[formatIndex];
+			return K15_TRUE;
+		}
+	}
+
+	return K15_FALSE;
+}
+
+//FK: indexed by ksr2_cpu_level
+static const char* cpuLevelNames[] = {"best", "scalar", "sse2", "avx2", "avx512"};
+
+static bool8 parseCpuLevel(const char* pName, ksr2_cpu_level* pOutCpuLevel)
+{
+	for (uint32 cpuLevel = K15_RENDERER_2D_CPU_LEVEL_SCALAR; cpuLevel <= K15_RENDERER_2D_CPU_LEVEL_AVX512; ++cpuLevel)
+	{
+		if (strcmp(pName, cpuLevelNames[cpuLevel]) == 0)
+		{
+			*pOutCpuLevel = (ksr2_cpu_level)cpuLevel;
+			return K15_TRUE;
+		}
+	}
+
+	return K15_FALSE;
+}
+
+//FK: Renders the scene at the best cpu level and then at every lower one, the images of every level have to be identical.
+static bool8 verifyScene(const scene* pScene, const ksr2_context_parameters* pContextParameters, uint32 frameCount, uint32 warmupFrameCount, uint32 recordThreadCount)
+{
+	ksr2_context_parameters contextParameters = *pContextParameters;
+	contextParameters.cpuLevel = K15_RENDERER_2D_CPU_LEVEL_BEST;
+
+	scene_verification bestVerification = {0xCBF29CE484222325ull, K15_RENDERER_2D_CPU_LEVEL_BEST};
+
+	if (runScene(pScene, &contextParameters, frameCount, warmupFrameCount, 0, recordThreadCount, K15_FALSE, &bestVerification) == K15_FALSE)
+	{
+		return K15_FALSE;
+	}
+
+	printf("%s,%s,%016llx\n", pScene->pName, cpuLevelNames[bestVerification.cpuLevel], bestVerification.imageHash);
+
+	bool8 success = K15_TRUE;
+
+	for (uint32 cpuLevel = K15_RENDERER_2D_CPU_LEVEL_SCALAR; cpuLevel < (uint32)bestVerification.cpuLevel; ++cpuLevel)
+	{
+		scene_verification verification = {0xCBF29CE484222325ull, K15_RENDERER_2D_CPU_LEVEL_BEST};
+		contextParameters.cpuLevel = (ksr2_cpu_level)cpuLevel;
+
+		if (runScene(pScene, &contextParameters, frameCount, warmupFrameCount, 0, recordThreadCount, K15_FALSE, &verification) == K15_FALSE)
+		{
+			return K15_FALSE;
+		}
+
+		//FK: without runtime dispatch only the level the renderer got compiled for exists
+		if (verification.cpuLevel != (ksr2_cpu_level)cpuLevel)
+		{
+			continue;
+		}
+
+		printf("%s,%s,%016llx\n", pScene->pName, cpuLevelNames[cpuLevel], verification.imageHash);
+
+		if (verification.imageHash != bestVerification.imageHash)
+		{
+			fprintf(stderr, "%s: the images of cpu level %s differ from the ones of cpu level %s.\n", pScene->pName, cpuLevelNames[cpuLevel], cpuLevelNames[bestVerification.cpuLevel]);
+			success = K15_FALSE;
+		}
+	}
+
+	return success;
+}
+
+static void printUsage()
+{
+	fprintf(stderr, "usage: benchmark [--scene name] [--frames count] [--warmup count] [--width w] [--height h] [--threads count] [--memory megabytes] [--incremental] [--padded-rows] [--trace prefix] [--chunk-pool count] [--flush-when-full] [--record-threads count] [--images count] [--async] [--present] [--format rgba|argb|bgra|rgb565|a8|gray8] [--generic-kernels] [--cpu-level scalar|sse2|avx2|avx512] [--verify]\n");
+	fprintf(stderr, "scenes:");
+
+	for (uint32 sceneIndex = 0u; sceneIndex < sizeof(scenes) / sizeof(scenes[0]); ++sceneIndex)
+	{
+		fprintf(stderr, " %s", scenes[sceneIndex].pName);
+	}
+
+	fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv)
+{
+	const char* pSceneName = 0;
+	const char* pTracePrefix = 0;
+	uint32 frameCount = 200u;
+	uint32 warmupFrameCount = 10u;
+	bool8 hasFrameCount = K15_FALSE;
+	bool8 hasWarmupFrameCount = K15_FALSE;
+	bool8 verify = K15_FALSE;
+	uint32 memorySizeInMegabytes = 128u;
+	uint32 recordThreadCount = 0u;
+	bool8 present = K15_FALSE;
+
+	chunk_pool chunkPool;
+	memset(&chunkPool, 0, sizeof(chunkPool));
+
+	ksr2_context_parameters contextParameters;
+	memset(&contextParameters, 0, sizeof(contextParameters));
+	contextParameters.backBufferWidth 	= 1920u;
+	contextParameters.backBufferHeight 	= 1080u;
+	contextParameters.backBufferFormat 	= K15_RENDERER_2D_PIXEL_FORMAT_RGBA;
+	contextParameters.flags 			= K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG;
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const char* pArg = argv[argIndex];
+		const char* pValue = argIndex + 1 < argc ? argv[argIndex + 1] : 0;
+
+		if (strcmp(pArg, "--incremental") == 0)
+		{
+			contextParameters.flags |= K15_RENDERER_2D_INCREMENTAL_RENDERING_FLAG;
+			continue;
+		}
+
+		if (strcmp(pArg, "--padded-rows") == 0)
+		{
+			contextParameters.flags |= K15_RENDERER_2D_PADDED_ROWS_FLAG;
+			continue;
+		}
+
+		if (strcmp(pArg, "--flush-when-full") == 0)
+		{
+			contextParameters.flags |= K15_RENDERER_2D_FLUSH_WHEN_FULL_FLAG;
+			continue;
+		}
+
+		if (strcmp(pArg, "--async") == 0)
+		{
+			contextParameters.flags |= K15_RENDERER_2D_ASYNC_BLIT_FLAG;
+			continue;
+		}
+
+		if (strcmp(pArg, "--present") == 0)
+		{
+			present = K15_TRUE;
+			continue;
+		}
+
+		if (strcmp(pArg, "--generic-kernels") == 0)
+		{
+			contextParameters.flags |= K15_RENDERER_2D_GENERIC_KERNELS_FLAG;
+			continue;
+		}
+
+		if (strcmp(pArg, "--verify") == 0)
+		{
+			verify = K15_TRUE;
+			continue;
+		}
+
+		if (pValue == 0)
+		{
+			printUsage();
+			return 1;
+		}
+
+		if (strcmp(pArg, "--scene") == 0) 			pSceneName = pValue;
+		else if (strcmp(pArg, "--frames") == 0)
+		{
+			frameCount 		= (uint32)strtoul(pValue, 0, 10);
+			hasFrameCount 	= K15_TRUE;
+		}
+		else if (strcmp(pArg, "--warmup") == 0)
+		{
+			warmupFrameCount 	= (uint32)strtoul(pValue, 0, 10);
+			hasWarmupFrameCount = K15_TRUE;
+		}
+		else if (strcmp(pArg, "--width") == 0) 		contextParameters.backBufferWidth = (unsigned int)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--height") == 0) 	contextParameters.backBufferHeight = (unsigned int)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--threads") == 0) 	contextParameters.workerThreadCount = (unsigned int)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--memory") == 0) 	memorySizeInMegabytes = (uint32)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--chunk-pool") == 0) chunkPool.maxChunkCount = (uint32)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--record-threads") == 0) recordThreadCount = (uint32)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--images") == 0) 	contextParameters.backBufferCount = (unsigned int)strtoul(pValue, 0, 10);
+		else if (strcmp(pArg, "--format") == 0)
+		{
+			if (parsePixelFormat(pValue, &contextParameters.backBufferFormat) == K15_FALSE)
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(pArg, "--cpu-level") == 0)
+		{
+			if (parseCpuLevel(pValue, &contextParameters.cpuLevel) == K15_FALSE)
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(pArg, "--trace") == 0)
+		{
+			pTracePrefix = pValue;
+			contextParameters.flags |= K15_RENDERER_2D_TRACING_FLAG;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+
+		++argIndex;
+	}
+
+	if (verify)
+	{
+		frameCount 			= hasFrameCount ? frameCount : 2u;
+		warmupFrameCount 	= hasWarmupFrameCount ? warmupFrameCount : 0u;
+	}
+
+	if (frameCount == 0u || contextParameters.backBufferWidth == 0u || contextParameters.backBufferHeight == 0u || recordThreadCount > MAX_RECORD_THREAD_COUNT)
+	{
+		printUsage();
+		return 1;
+	}
+
+	contextParameters.memorySizeInBytes = ksr2_megabyte((size_t)memorySizeInMegabytes);
+	contextParameters.pMemory 			= malloc(contextParameters.memorySizeInBytes);
+
+	if (contextParameters.pMemory == 0)
+	{
+		fprintf(stderr, "could not allocate %u MB of renderer memory.\n", memorySizeInMegabytes);
+		return 1;
+	}
+
+	if (chunkPool.maxChunkCount > 0u)
+	{
+		chunkPool.ppFreeChunks = (void**)malloc(sizeof(void*) * chunkPool.maxChunkCount);
+
+		contextParameters.allocateChunkFnc 			= allocateChunk;
+		contextParameters.freeChunkFnc 				= freeChunk;
+		contextParameters.pChunkAllocatorUserData 	= &chunkPool;
+	}
+
+	bool8 foundScene = K15_FALSE;
+	int exitCode = 0;
+
+	if (verify)
+	{
+		printf("scene,cpu_level,image_hash\n");
+	}
+	else
+	{
+		printf("scene,width,height,threads,frames,median_ns_per_frame,p99_ns_per_frame,median_mpixels_per_s,p99_mpixels_per_s,median_commands_per_s,p99_commands_per_s\n");
+	}
+
+	for (uint32 sceneIndex = 0u; sceneIndex < sizeof(scenes) / sizeof(scenes[0]); ++sceneIndex)
+	{
+		if (pSceneName != 0 && strcmp(pSceneName, scenes[sceneIndex].pName) != 0)
+		{
+			continue;
+		}
+
+		foundScene = K15_TRUE;
+
+		const bool8 success = verify ? verifyScene(&scenes[sceneIndex], &contextParameters, frameCount, warmupFrameCount, recordThreadCount) : 
+			runScene(&scenes[sceneIndex], &contextParameters, frameCount, warmupFrameCount, pTracePrefix, recordThreadCount, present, 0);
+
+		if (success == K15_FALSE)
+		{
+			exitCode = 1;
+		}
+	}
+
+	if (foundScene == K15_FALSE)
+	{
+		fprintf(stderr, "unknown scene '%s'.\n", pSceneName);
+		printUsage();
+		exitCode = 1;
+	}
+
+	//FK: every chunk got returned to the pool by ksr2_destroy_context
+	for (uint32 chunkIndex = 0u; chunkIndex < chunkPool.freeChunkCount; ++chunkIndex)
+	{
+		free(chunkPool.ppFreeChunks[chunkIndex]);
+	}
+
+	free(chunkPool.ppFreeChunks);
+	free(contextParameters.pMemory);
+	return exitCode;
+}
@@ -6,6 +6,9 @@
 #endif
 
 typedef size_t ksr2_contexthandle;
+typedef size_t ksr2_texturehandle;
+typedef size_t ksr2_fonthandle;
+typedef size_t ksr2_commandlisthandle;
 
 #define ksr2_kilobyte(x) 		(x * 1024)
 #define ksr2_megabyte(x) 		(ksr2_kilobyte(x) * 1024)
@@ -13,6 +16,13 @@ typedef size_t ksr2_contexthandle;
 
 #ifdef K15_RENDERER_2D_NO_ASSERTS
 	#define ksr2_assert(x)
+#elif defined(__GNUC__)
+	#define ksr2_assert(x) {\
+	if (!(x))\
+	{\
+		__builtin_trap();\
+	}\
+	}
 #else
 	#define ksr2_assert(x) {\
 	if (!(x))\
@@ -27,20 +37,55 @@ typedef size_t ksr2_contexthandle;
 
 enum
 {
-    K15_RENDERER_2D_DEFAULT_MEMORY_SIZE_IN_BYTES = ksr2_megabyte(10)
+    K15_RENDERER_2D_DEFAULT_MEMORY_SIZE_IN_BYTES = ksr2_megabyte(10),
+	K15_RENDERER_2D_DEFAULT_TILE_SIZE			 = 64,
+	K15_RENDERER_2D_DEFAULT_TRACE_EVENT_COUNT	 = 16384, //FK: about 30 frames at 1920x1080 with the default tile size
+	K15_RENDERER_2D_IMAGE_ALIGNMENT				 = 64 //FK: swap chain images and padded rows start at multiples of this many bytes
 };
 
+//FK: 32 bit formats are named from the most to the least significant byte of a pixel, RGBA pixels are 0xRRGGBBAA.
+//	  Swap chains with less than 32 bit per pixel blend in 8 bit per channel and round down when the pixels get written.
 typedef enum
 {
     K15_RENDERER_2D_PIXEL_FORMAT_RGBA,
-	K15_RENDERER_2D_PIXEL_FORMAT_ARGB
+	K15_RENDERER_2D_PIXEL_FORMAT_ARGB,
+	K15_RENDERER_2D_PIXEL_FORMAT_BGRA,
+	K15_RENDERER_2D_PIXEL_FORMAT_RGB565, 	//FK: 16 bit, red in the most significant bits, no alpha
+	K15_RENDERER_2D_PIXEL_FORMAT_A8, 		//FK: 8 bit alpha, e.g. for masks
+	K15_RENDERER_2D_PIXEL_FORMAT_GRAY8 		//FK: 8 bit luma ((77 r + 150 g + 29 b) / 256), no alpha
 } ksr2_pixel_format;
 
+//FK: Colors passed to the draw functions are straight (non premultiplied) alpha, 
+//	  they get premultiplied when the draw command gets recorded.
+typedef enum
+{
+	K15_RENDERER_2D_BLEND_MODE_OPAQUE = 0,	//FK: dst = src, alpha gets written as is
+	K15_RENDERER_2D_BLEND_MODE_ALPHA,		//FK: dst = src * srcAlpha + dst * (1 - srcAlpha)
+	K15_RENDERER_2D_BLEND_MODE_ADDITIVE,	//FK: dst = dst + src * srcAlpha
+	K15_RENDERER_2D_BLEND_MODE_MULTIPLY		//FK: dst = dst * (src * srcAlpha + 1 - srcAlpha), destination alpha is kept
+} ksr2_blend_mode;
+
 typedef enum
 {
-	K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG = 0x01
+	K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG 		= 0x01,
+	K15_RENDERER_2D_INCREMENTAL_RENDERING_FLAG 	= 0x02, //FK: only re-rasterize tiles whose draw commands changed, see ksr2_get_damage_list()
+	K15_RENDERER_2D_TRACING_FLAG				= 0x04, //FK: record trace events into a ring buffer in the context memory, see ksr2_write_trace_json()
+	K15_RENDERER_2D_PADDED_ROWS_FLAG			= 0x08, //FK: pad the rows of the swap chain images to cache lines and avoid strides that are a multiple of 4KB, see ksr2_get_image_stride()
+	K15_RENDERER_2D_FLUSH_WHEN_FULL_FLAG		= 0x10, //FK: rasterize the pending draw commands into the current image instead of running out of draw command memory
+	K15_RENDERER_2D_ASYNC_BLIT_FLAG				= 0x20, //FK: ksr2_blit hands the frame to a render thread and returns right away, see ksr2_acquire_presentable_image()
+	K15_RENDERER_2D_GENERIC_KERNELS_FLAG		= 0x40 //FK: use kernels that branch on the pixel format and blend mode of every span instead of the specialized ones, only useful for benchmarking
 } ksr2_context_parameters_flags;
 
+//FK: SIMD instruction sets of the span kernels, ksr2_init_context picks the best one the CPU supports by default.
+typedef enum
+{
+	K15_RENDERER_2D_CPU_LEVEL_BEST = 0,
+	K15_RENDERER_2D_CPU_LEVEL_SCALAR,
+	K15_RENDERER_2D_CPU_LEVEL_SSE2,
+	K15_RENDERER_2D_CPU_LEVEL_AVX2,
+	K15_RENDERER_2D_CPU_LEVEL_AVX512 	//FK: AVX-512F and AVX-512BW
+} ksr2_cpu_level;
+
 typedef enum
 {
     K15_RENDERER_2D_RESULT_SUCCESS = 0,
@@ -60,31 +105,62 @@ typedef enum
 
 typedef void(*ksr2_debug_fnc)(ksr2_contexthandle, ksr2_debug_category, const char*); 
 
+//FK: sizeInBytes is the same for every chunk, chunks need to be aligned like memory returned by malloc.
+typedef void*(*ksr2_allocate_chunk_fnc)(void* pUserData, size_t sizeInBytes);
+typedef void(*ksr2_free_chunk_fnc)(void* pUserData, void* pChunk);
+
 typedef struct
 {
     void*               pMemory;
-	void* 				pPreAllocatedBackBuffers; //FK: need to point to 2 back buffers if K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG is set.
+	void* 				pPreAllocatedBackBuffers; //FK: need to point to as many back buffers as the swap chain has images, see ksr2_query_back_buffer_requirements()
     size_t              memorySizeInBytes;
+	size_t				asyncDrawCommandMemorySizeInBytes; //FK: draw command memory of each of the 2 frames K15_RENDERER_2D_ASYNC_BLIT_FLAG alternates between, taken from pMemory. 0 = memorySizeInBytes / 8
 	
     unsigned int        backBufferWidth;
     unsigned int        backBufferHeight;
-    unsigned int        backBufferCount;
+    unsigned int        backBufferCount; //FK: swap chain images. 0 = 2 if K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG is set, 1 otherwise
     unsigned int		flags;
+	unsigned int		tileSize; //FK: width and height of the tiles ksr2_blit bins draw commands into. 0 = K15_RENDERER_2D_DEFAULT_TILE_SIZE
+	unsigned int		workerThreadCount; //FK: threads that rasterize tiles together with the thread calling ksr2_blit. 0 = no worker threads
+	unsigned int		traceEventCount; //FK: trace events the ring buffer can hold if K15_RENDERER_2D_TRACING_FLAG is set, rounded up to a power of 2. 0 = K15_RENDERER_2D_DEFAULT_TRACE_EVENT_COUNT
 
 	ksr2_pixel_format   backBufferFormat;
+	ksr2_cpu_level		cpuLevel; //FK: forces the kernels of a lower level, e.g. to compare their output. 0 = K15_RENDERER_2D_CPU_LEVEL_BEST
 	
 	ksr2_debug_fnc		debugFnc;
 	ksr2_debug_category debugCategoryFilter;
 
+	//FK: Optional, draw commands get recorded into chunks of the application before the back of the context memory gets used.
+	//	  allocateChunkFnc can return NULL once the pool of the application is exhausted. Chunks get freed by ksr2_blit and ksr2_clear.
+	//	  Unused with K15_RENDERER_2D_ASYNC_BLIT_FLAG, the frames get recorded into asyncDrawCommandMemorySizeInBytes instead.
+	ksr2_allocate_chunk_fnc	allocateChunkFnc;
+	ksr2_free_chunk_fnc		freeChunkFnc;
+	void*					pChunkAllocatorUserData;
+
 } ksr2_context_parameters;
 
+//FK: The command list lives at the start of pMemory, the rest of it holds the recorded draw commands.
+typedef struct
+{
+	void*				pMemory;
+	size_t				memorySizeInBytes;
+} ksr2_command_list_parameters;
+
 typedef struct 
 {
-	void* 				pPreAllocatedBackBuffers; //FK: need to point to 2 back buffers if K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG is set.
+	void* 				pPreAllocatedBackBuffers; //FK: need to point to as many back buffers as the swap chain has images.
     unsigned int        backBufferWidth;
     unsigned int        backBufferHeight;
 } ksr2_resize_swapchain_parameters;
 
+typedef struct
+{
+	unsigned int x1;
+	unsigned int y1;
+	unsigned int x2;
+	unsigned int y2;
+} ksr2_damage_rect;
+
 typedef struct 
 {
 	unsigned char r;
@@ -93,6 +169,111 @@ typedef struct
 	unsigned char a;
 } ksr2_rgba_color;
 
+typedef struct
+{
+	const void*			pPixels; //FK: pixels in the given format
+	unsigned int		width; //FK: width and height can't exceed 65535
+	unsigned int		height;
+	unsigned int		stride; //FK: pixels per row of pPixels. 0 = width
+	unsigned int		useColorKey; //FK: pixels with the rgb value of colorKey become fully transparent
+	ksr2_rgba_color		colorKey;
+	ksr2_pixel_format	format;
+} ksr2_texture_parameters;
+
+//FK: Glyphs are laid out in a grid of glyphWidth x glyphHeight cells, row after row, starting with firstCharacter.
+typedef struct
+{
+	const void*			pPixels; //FK: needs to stay valid as long as the font is used, glyphs get rasterized on first use
+	unsigned int		bitsPerPixel; //FK: 1 = bit mask (most significant bit first), 8 = coverage
+	unsigned int		stride; //FK: bytes per row of pPixels. 0 = tightly packed
+	unsigned int		glyphWidth; //FK: glyph width and height can't exceed 255
+	unsigned int		glyphHeight;
+	unsigned int		glyphsPerRow; //FK: 0 = all glyphs are in one row
+	unsigned int		firstCharacter;
+	unsigned int		glyphCount;
+	unsigned int		advance; //FK: horizontal distance between two glyphs. 0 = glyphWidth
+	unsigned int		lineHeight; //FK: vertical distance between two lines. 0 = glyphHeight
+	unsigned int		glyphCacheSize; //FK: glyphs the glyph cache of the font can hold. 0 = glyphCount
+} ksr2_font_parameters;
+
+typedef enum
+{
+	K15_RENDERER_2D_PATH_VERB_MOVE_TO = 0,	//FK: 1 point, starts a new subpath
+	K15_RENDERER_2D_PATH_VERB_LINE_TO,		//FK: 1 point
+	K15_RENDERER_2D_PATH_VERB_QUAD_TO,		//FK: 2 points, control point and end point
+	K15_RENDERER_2D_PATH_VERB_CUBIC_TO,		//FK: 3 points, both control points and end point
+	K15_RENDERER_2D_PATH_VERB_CLOSE			//FK: no points, connects the subpath back to its first point
+} ksr2_path_verb;
+
+//FK: Paths live in memory of the application, ksr2_init_path() hands it the arrays for the verbs and the points.
+//	  Points are in pixels, drawing verbs continue from the end of the previous one or from (0, 0) at the start of the path.
+typedef struct
+{
+	unsigned char*		pVerbs; //FK: ksr2_path_verb
+	float*				pPoints; //FK: x and y of every point
+	unsigned int		verbCount;
+	unsigned int		pointCount;
+	unsigned int		verbCapacity;
+	unsigned int		pointCapacity; //FK: points, pPoints holds twice as many floats
+} ksr2_path;
+
+typedef enum
+{
+	K15_RENDERER_2D_FILL_RULE_NONZERO = 0,
+	K15_RENDERER_2D_FILL_RULE_EVEN_ODD
+} ksr2_fill_rule;
+
+typedef enum
+{
+	K15_RENDERER_2D_LINE_JOIN_MITER = 0,
+	K15_RENDERER_2D_LINE_JOIN_ROUND,
+	K15_RENDERER_2D_LINE_JOIN_BEVEL
+} ksr2_line_join;
+
+typedef enum
+{
+	K15_RENDERER_2D_LINE_CAP_BUTT = 0,
+	K15_RENDERER_2D_LINE_CAP_ROUND,
+	K15_RENDERER_2D_LINE_CAP_SQUARE
+} ksr2_line_cap;
+
+typedef struct
+{
+	float				width; //FK: in pixels
+	float				miterLimit; //FK: miter joins longer than miterLimit * width become bevel joins. 0 = 4
+	ksr2_line_join		join;
+	ksr2_line_cap		cap;
+} ksr2_stroke_parameters;
+
+typedef struct
+{
+	size_t				hitCount;
+	size_t				missCount; //FK: glyphs that had to be rasterized into the glyph cache
+	size_t				evictionCount;
+} ksr2_glyph_cache_statistics;
+
+//FK: Wide and narrow variants of a draw command are counted together.
+typedef struct
+{
+	unsigned int		lineCommandCount;
+	unsigned int		filledRectCommandCount;
+	unsigned int		imageCommandCount;
+	unsigned int		textCommandCount;
+	unsigned int		triangleCommandCount; //FK: one per triangle of ksr2_draw_triangles()
+	unsigned int		ellipseCommandCount; //FK: circles, ellipses and rings
+	unsigned int		roundedRectCommandCount;
+	unsigned int		pathCommandCount; //FK: one per band of rows of a filled or stroked path
+	size_t				writtenPixelCount; //FK: including clearing and tiles that got copied from the previous image
+	size_t				culledPixelCount; //FK: see ksr2_get_culled_pixel_count()
+	size_t				allocatorFrontPeakInBytes; //FK: swap chain images, textures and fonts, peak since the context got created
+	size_t				allocatorBackPeakInBytes; //FK: draw commands and tile bins, peak during the frame
+	size_t				allocatorCapacityInBytes;
+	size_t				drawCommandMemoryPeakInBytes; //FK: draw command chunks, no matter where they got allocated from
+	unsigned int		flushCount; //FK: see K15_RENDERER_2D_FLUSH_WHEN_FULL_FLAG
+	unsigned long long	recordTimeInNs; //FK: from the first draw call of the frame until ksr2_blit, includes whatever the application did in between
+	unsigned long long	blitTimeInNs; //FK: with K15_RENDERER_2D_ASYNC_BLIT_FLAG from ksr2_blit until the render thread finished the frame
+} ksr2_frame_stats;
+
 ksr2_rgba_color ksr2_rgba_color_float(float r, float g, float b, float a);
 ksr2_rgba_color ksr2_rgba_color_uint8(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
 ksr2_rgba_color ksr2_rgba_color_uint32(unsigned int rgba);
@@ -112,22 +293,173 @@ ksr2_rgba_color ksr2_color_black();
 
 ksr2_result ksr2_init_context(const ksr2_context_parameters* pParameters, ksr2_contexthandle* pOutContextHandle);
 void ksr2_destroy_context(ksr2_contexthandle handle);
+
+//FK: Moves on to the next swap chain image. With K15_RENDERER_2D_ASYNC_BLIT_FLAG it hands the image of 
+//	  ksr2_acquire_presentable_image() back to the swap chain instead.
 void ksr2_swap_buffers(ksr2_contexthandle handle);
+
+//FK: Same as ksr2_acquire_presentable_image(), NULL if there's nothing to present.
 unsigned char* ksr2_get_presenting_image_data(ksr2_contexthandle handle);
+unsigned int ksr2_get_image_stride(ksr2_contexthandle handle); //FK: bytes per row of the swap chain images
+ksr2_cpu_level ksr2_get_cpu_level(ksr2_contexthandle handle); //FK: level of the kernels ksr2_init_context picked
+
+//FK: With K15_RENDERER_2D_ASYNC_BLIT_FLAG the render thread rasterizes frame N while the application records frame N + 1.
+//	  Presenting frame N before handing over frame N + 1 keeps recording, rasterizing and presenting overlapped:
+//	  record frame N + 1 -> ksr2_acquire_presentable_image() (frame N) -> present -> ksr2_swap_buffers() -> ksr2_blit()
+//	  Without the flag both functions return the current image right away.
+
+//FK: Waits until a swap chain image is free and returns its index, the next ksr2_blit renders into it. ksr2_blit acquires
+//	  an image itself otherwise. An image that finished rendering but didn't get presented yet is reused if no other one is free.
+ksr2_result ksr2_acquire_next_image(ksr2_contexthandle handle, unsigned int* pOutImageIndex);
+
+//FK: Returns the latest image that finished rendering and didn't get presented yet, waits for the frame of the render thread
+//	  if there's none. The image doesn't get rendered into until ksr2_swap_buffers() unless the swap chain only has this one,
+//	  acquiring it again before that returns the same image.
+//	  Returns K15_RENDERER_2D_RESULT_INVALID_ARGUMENT if nothing got blitted since the last presented image.
+ksr2_result ksr2_acquire_presentable_image(ksr2_contexthandle handle, unsigned char** ppOutImageData, unsigned int* pOutImageIndex);
+
+//FK: Size and stride in bytes of a single swap chain image for the given ksr2_context_parameters flags. Pre allocated back buffers
+//	  need to follow each other in memory with this layout, the first one should be aligned to K15_RENDERER_2D_IMAGE_ALIGNMENT.
+ksr2_result ksr2_query_back_buffer_requirements(unsigned int width, unsigned int height, ksr2_pixel_format format, unsigned int flags, size_t* pOutSizeInBytes, unsigned int* pOutStrideInBytes);
+
+//FK: Bytes per pixel of the format, 0 for unknown formats.
+unsigned int ksr2_get_pixel_size(ksr2_pixel_format format);
+
+//FK: Converts pixelCount pixels from one format to the other, e.g. a row of a swap chain image before presenting it. 
+//	  The pixels can only overlap if both formats have the same pixel size. Formats without alpha become opaque, 
+//	  A8 pixels become premultiplied white.
+ksr2_result ksr2_convert_pixels(void* pOutPixels, ksr2_pixel_format outFormat, const void* pPixels, ksr2_pixel_format format, unsigned int pixelCount);
 
 void ksr2_blit(ksr2_contexthandle handle);
 ksr2_result ksr2_resize_swap_chain(ksr2_contexthandle handle, const ksr2_resize_swapchain_parameters* pParameters);
 ksr2_result ksr2_draw_line(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, unsigned int thickness, ksr2_rgba_color color);
 ksr2_result ksr2_draw_filled_rect(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, ksr2_rgba_color color);
 
+//FK: Batched versions of ksr2_draw_filled_rect and ksr2_draw_line, every array needs to hold count elements.
+//	  Primitives that got recorded before running out of memory stay recorded.
+ksr2_result ksr2_draw_filled_rects(ksr2_contexthandle handle, const int* pX1, const int* pY1, const int* pX2, const int* pY2, const ksr2_rgba_color* pColors, unsigned int count);
+ksr2_result ksr2_draw_lines(ksr2_contexthandle handle, const int* pX1, const int* pY1, const int* pX2, const int* pY2, unsigned int thickness, const ksr2_rgba_color* pColors, unsigned int count);
+
+//FK: Draws indexCount / 3 triangles, every 3 indices pick the vertices of one triangle. Vertex positions are in pixels with 
+//	  4 bits of subpixel precision, (0, 0) is the top left corner of the image. Pixels get filled if their center lies inside
+//	  the triangle, centers on an edge only belong to the triangle it is a top or left edge of, so triangles sharing an edge 
+//	  neither overlap nor leave gaps. Both windings get drawn, positions get clamped to +-32768. 
+//	  Vertex colors get interpolated (premultiplied) across the triangle. Triangles that got recorded before running out of
+//	  memory or before an index >= vertexCount stay recorded.
+ksr2_result ksr2_draw_triangles(ksr2_contexthandle handle, const float* pX, const float* pY, const ksr2_rgba_color* pColors, unsigned int vertexCount, const unsigned int* pIndices, unsigned int indexCount);
+
+//FK: Anti-aliased shapes, positions and sizes are in pixels with 4 bits of subpixel precision like the triangle vertices.
+//	  The inside gets filled with solid spans, only the pixels along the edge get blended with their coverage.
+//	  Rings are circles with a hole, their thickness is measured inwards from radius. The corner radius of rounded rects
+//	  gets clamped to half of the shorter side. Empty shapes (radius, thickness or size <= 0) don't get recorded.
+ksr2_result ksr2_draw_filled_circle(ksr2_contexthandle handle, float centerX, float centerY, float radius, ksr2_rgba_color color);
+ksr2_result ksr2_draw_filled_ellipse(ksr2_contexthandle handle, float centerX, float centerY, float radiusX, float radiusY, ksr2_rgba_color color);
+ksr2_result ksr2_draw_ring(ksr2_contexthandle handle, float centerX, float centerY, float radius, float thickness, ksr2_rgba_color color);
+ksr2_result ksr2_draw_filled_rounded_rect(ksr2_contexthandle handle, float x1, float y1, float x2, float y2, float cornerRadius, ksr2_rgba_color color);
+
+//FK: Building a path only touches the arrays, the path functions return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY once they're full.
+void ksr2_init_path(ksr2_path* pOutPath, unsigned char* pVerbs, unsigned int verbCapacity, float* pPoints, unsigned int pointCapacity);
+ksr2_result ksr2_path_move_to(ksr2_path* pPath, float x, float y);
+ksr2_result ksr2_path_line_to(ksr2_path* pPath, float x, float y);
+ksr2_result ksr2_path_quad_to(ksr2_path* pPath, float controlX, float controlY, float x, float y);
+ksr2_result ksr2_path_cubic_to(ksr2_path* pPath, float control1X, float control1Y, float control2X, float control2Y, float x, float y);
+ksr2_result ksr2_path_close(ksr2_path* pPath);
+
+//FK: Anti-aliased paths. Curves get flattened into lines and the lines get snapped to 4 bits of subpixel precision when the 
+//	  path gets drawn, the path can be changed or reused right afterwards. Filling closes every subpath. Strokes are the union 
+//	  of their segments, joins and caps, subpaths without length only get drawn with round or square caps.
+//	  Paths get recorded as bands of rows, every band holds the lines passing through it. A band that more lines pass through 
+//	  than fit into a single draw command (about 4000 with the default chunk size) returns K15_RENDERER_2D_RESULT_OUT_OF_MEMORY,
+//	  the bands above it stay recorded.
+ksr2_result ksr2_fill_path(ksr2_contexthandle handle, const ksr2_path* pPath, ksr2_fill_rule fillRule, ksr2_rgba_color color);
+ksr2_result ksr2_stroke_path(ksr2_contexthandle handle, const ksr2_path* pPath, const ksr2_stroke_parameters* pParameters, ksr2_rgba_color color);
+
+ksr2_result ksr2_clear(ksr2_contexthandle handle, ksr2_rgba_color color);
+ksr2_result ksr2_set_blend_mode(ksr2_contexthandle handle, ksr2_blend_mode blendMode); //FK: used by all following draw calls, ksr2_clear is always opaque
+
+//FK: Textures get converted to the swap chain format and stay resident in the context memory until the context gets destroyed.
+//	  Swap chains with less than 32 bit per pixel keep their textures in RGBA so that they can still be alpha blended.
+ksr2_result ksr2_create_texture(ksr2_contexthandle handle, const ksr2_texture_parameters* pParameters, ksr2_texturehandle* pOutTextureHandle);
+
+//FK: Draws the source rect of the texture at dstX, dstY. Every texel covers scale x scale pixels (nearest neighbor).
+//	  Textures that aren't fully opaque get alpha blended in K15_RENDERER_2D_BLEND_MODE_OPAQUE as well.
+ksr2_result ksr2_draw_image(ksr2_contexthandle handle, ksr2_texturehandle texture, int srcX, int srcY, int srcWidth, int srcHeight, int dstX, int dstY, unsigned int scale);
+
+//FK: Fonts stay resident in the context memory until the context gets destroyed. Every font has its own glyph cache.
+ksr2_result ksr2_create_font(ksr2_contexthandle handle, const ksr2_font_parameters* pParameters, ksr2_fonthandle* pOutFontHandle);
+
+//FK: Fixed 6x8 ascii font (characters 32 - 126) that can be passed to ksr2_create_font().
+void ksr2_get_builtin_font_parameters(ksr2_font_parameters* pOutParameters);
+
+//FK: Draws the text with its top left corner at x, y. '\n' starts a new line, characters the font doesn't contain are left blank.
+//	  Glyph edges are always coverage blended, K15_RENDERER_2D_BLEND_MODE_OPAQUE draws the text with full alpha.
+ksr2_result ksr2_draw_text(ksr2_contexthandle handle, ksr2_fonthandle font, int x, int y, const char* pText, ksr2_rgba_color color);
+
+ksr2_result ksr2_get_glyph_cache_statistics(ksr2_contexthandle handle, ksr2_fonthandle font, ksr2_glyph_cache_statistics* pOutStatistics);
+
+//FK: Command lists record draw commands independently of the context and of each other, so every thread can fill its own
+//	  command list without any locking. All draw functions and ksr2_set_blend_mode accept a command list handle in place of the
+//	  context handle, ksr2_clear doesn't. Recording must not overlap with resizing the swap chain or creating textures and fonts.
+ksr2_result ksr2_create_command_list(ksr2_contexthandle handle, const ksr2_command_list_parameters* pParameters, ksr2_commandlisthandle* pOutCommandListHandle);
+
+//FK: Appends the draw commands of the command list to the frame of the context, command lists get rasterized in the order
+//	  they got submitted in. Has to be called on the thread that records into the context. The command list is empty afterwards 
+//	  and can record the next draw commands right away, its memory stays in use until ksr2_reset_command_list().
+//	  Returns K15_RENDERER_2D_RESULT_OUT_OF_MEMORY if not all glyphs fit into the glyph cache, those are left blank.
+ksr2_result ksr2_submit_command_list(ksr2_contexthandle handle, ksr2_commandlisthandle commandListHandle);
+
+//FK: Frees all draw commands of the command list. Must not be called before ksr2_blit rasterized the frame it got submitted to,
+//	  with K15_RENDERER_2D_ASYNC_BLIT_FLAG that's once the image of the frame can be presented or the next ksr2_blit returned.
+ksr2_result ksr2_reset_command_list(ksr2_commandlisthandle commandListHandle);
+
+//FK: Pixels that ksr2_blit didn't have to write because they were covered by later opaque rects.
+//	  Waits for the render thread with K15_RENDERER_2D_ASYNC_BLIT_FLAG, same as ksr2_get_damage_list() and ksr2_write_trace_json().
+size_t ksr2_get_culled_pixel_count(ksr2_contexthandle handle);
+
+//FK: Stats of the last ksr2_blit, with K15_RENDERER_2D_ASYNC_BLIT_FLAG of the last frame the render thread finished. 
+//	  All zero if the renderer was compiled with K15_RENDERER_2D_NO_STATS.
+ksr2_result ksr2_get_frame_stats(ksr2_contexthandle handle, ksr2_frame_stats* pOutStats);
+
+//FK: Most draw command memory that was in use at once since the context got created, use it to size the chunk pool or the context memory.
+size_t ksr2_get_draw_command_memory_high_water_mark(ksr2_contexthandle handle);
+
+//FK: Trace events of the application (e.g. presenting the image) that show up next to the ones of the renderer.
+//	  pName needs to stay valid until the trace got written. Only records something if K15_RENDERER_2D_TRACING_FLAG is set.
+unsigned long long ksr2_begin_trace_event(ksr2_contexthandle handle);
+void ksr2_end_trace_event(ksr2_contexthandle handle, const char* pName, unsigned long long beginTimestamp);
+
+//FK: Writes the events of the trace ring buffer as chrome trace event json (chrome://tracing, Perfetto), shouldn't be called during ksr2_blit.
+//	  Returns the size of the json in bytes, the json is only complete if that doesn't exceed bufferSizeInBytes. pBuffer can be NULL.
+size_t ksr2_write_trace_json(ksr2_contexthandle handle, char* pBuffer, size_t bufferSizeInBytes);
+
+//FK: Regions of the current image that differ from the image of the previous ksr2_blit, valid until the next ksr2_blit.
+//	  Without K15_RENDERER_2D_INCREMENTAL_RENDERING_FLAG this is always the whole image.
+unsigned int ksr2_get_damage_list(ksr2_contexthandle handle, const ksr2_damage_rect** ppOutDamageRects);
+
 #ifdef K15_SOFTWARE_RENDERER_2D_IMPLEMENTATION
 
+//FK: clock_gettime() is POSIX, -std=c99 hides it unless a feature test macro asks for it. Only takes effect if no system 
+//	  header got included before the implementation. (not defined in the GNU modes, it would hide everything but POSIX there)
+#if !defined(_WIN32) && defined(__STRICT_ANSI__) && !defined(_POSIX_C_SOURCE) && !defined(_XOPEN_SOURCE) && !defined(_GNU_SOURCE)
+#	define _POSIX_C_SOURCE 199309L
+#endif
+
 #ifndef K15_RENDERER_2D_STATIC
 #	define ksr2_internal static
 #else
 #	define ksr2_internal extern
 #endif
 
+//FK: Kernels that take the pixel format or blend mode as argument get inlined into the kernels specialized for
+//	  every combination, see K15_RENDERER_2D_DEFINE_PIXEL_KERNELS.
+#if defined(_MSC_VER)
+#	define ksr2_force_inline static __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#	define ksr2_force_inline static inline __attribute__((always_inline))
+#else
+#	define ksr2_force_inline static inline
+#endif
+
 #ifndef K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
 #	define K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK 1
 #endif
@@ -136,6 +468,92 @@ ksr2_result ksr2_draw_filled_rect(ksr2_contexthandle handle, int x1, int y1, int
 #	define ksr2_nullptr			((void*)0)
 #endif
 
+#define ksr2_clamp(v,min,max) ((v) < (min) ? (min) : (v) > (max) ? (max) : (v))
+#define ksr2_min(a,b) ((a) < (b) ? (a) : (b))
+#define ksr2_max(a,b) ((a) > (b) ? (a) : (b))
+
+#ifndef K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES
+#	define K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES ksr2_kilobyte(64)
+#endif
+
+#ifndef K15_RENDERER_2D_MAX_OCCLUSION_CULLING_TILE_SIZE
+#	define K15_RENDERER_2D_MAX_OCCLUSION_CULLING_TILE_SIZE 256 //FK: occlusion culling is disabled for bigger tiles
+#endif
+
+#ifndef K15_RENDERER_2D_IMAGE_SPAN_SIZE
+#	define K15_RENDERER_2D_IMAGE_SPAN_SIZE 256 //FK: scaled images get expanded into spans of this many pixels on the stack
+#endif
+
+#ifndef K15_RENDERER_2D_MAX_TEXT_RUN_GLYPH_COUNT
+#	define K15_RENDERER_2D_MAX_TEXT_RUN_GLYPH_COUNT 64 //FK: longer lines of text get split into multiple draw commands, can't exceed 255
+#endif
+
+#ifndef K15_RENDERER_2D_PATH_TOLERANCE
+#	define K15_RENDERER_2D_PATH_TOLERANCE 0.125f //FK: max distance in pixels between a curve or round join and the lines it gets flattened into
+#endif
+
+#ifndef K15_RENDERER_2D_PATH_BAND_HEIGHT
+#	define K15_RENDERER_2D_PATH_BAND_HEIGHT 64 //FK: rows of a path draw command, bands with too many edges get halved
+#endif
+
+#ifndef K15_RENDERER_2D_PATH_BAND_GROUP_SIZE
+#	define K15_RENDERER_2D_PATH_BAND_GROUP_SIZE 16 //FK: bands of a path that get collected by a single walk over the path
+#endif
+
+#ifndef K15_RENDERER_2D_PATH_STRIP_HEIGHT
+#	define K15_RENDERER_2D_PATH_STRIP_HEIGHT 32 //FK: paths get accumulated in strips of this many rows and K15_RENDERER_2D_IMAGE_SPAN_SIZE pixels on the stack
+#endif
+
+#ifndef K15_RENDERER_2D_BATCH_SIZE
+#	define K15_RENDERER_2D_BATCH_SIZE 64 //FK: batched draw calls clamp and convert this many primitives at once on the stack
+#endif
+
+#ifndef K15_RENDERER_2D_NON_TEMPORAL_FILL_THRESHOLD_IN_BYTES
+#	define K15_RENDERER_2D_NON_TEMPORAL_FILL_THRESHOLD_IN_BYTES ksr2_megabyte(16) //FK: should roughly match the size of the last level cache
+#endif
+
+#ifndef K15_RENDERER_2D_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define K15_RENDERER_2D_SSE2
+#		include "emmintrin.h"
+#	endif
+#	if defined(__AVX2__)
+#		define K15_RENDERER_2D_AVX2
+#		include "immintrin.h"
+#	endif
+#	if defined(__AVX512F__) && defined(__AVX512BW__)
+#		define K15_RENDERER_2D_AVX512
+#	endif
+#endif
+
+//FK: Kernels of all CPU levels get compiled in and ksr2_init_context picks the best one the CPU supports.
+//	  Without it the kernels only use the SIMD level the renderer got compiled for.
+#if defined(K15_RENDERER_2D_SSE2) && !defined(K15_RENDERER_2D_NO_CPU_DISPATCH) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#	define K15_RENDERER_2D_CPU_DISPATCH
+#	include "immintrin.h"
+#	ifdef _MSC_VER
+#		include "intrin.h"
+#	else
+#		include "cpuid.h"
+#	endif
+#endif
+
+//FK: The kernel passes include this file again. Quoted includes look next to this file first, define this if the file 
+//	  got renamed. (__FILE__ won't do, it's the path the compiler opened the file with and not relative to this file)
+#ifndef K15_RENDERER_2D_KERNEL_FILE
+#	define K15_RENDERER_2D_KERNEL_FILE "k15_software_renderer_2d.h"
+#endif
+
+#if !defined(K15_RENDERER_2D_NO_STATS) || !defined(K15_RENDERER_2D_NO_TRACING)
+#	define K15_RENDERER_2D_TIMESTAMPS
+#endif
+
+#include "math.h"
+
+#ifdef _MSC_VER
+#	include "intrin.h"
+#endif
+
 #define ksr2_use_argument(x)	((void)x)
 
 typedef unsigned    int  	ksr2_u32;
@@ -148,6 +566,127 @@ typedef unsigned    char 	ksr2_b8;
 typedef unsigned    int		ksr2_b32;
 typedef unsigned    int    	ksr2_u32;
 typedef unsigned 	char	ksr2_byte;
+typedef unsigned long long	ksr2_u64;
+typedef signed long long	ksr2_s64;
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+#	ifdef _WIN32
+#		include "windows.h"
+
+typedef struct
+{
+	HANDLE 				handle;
+	void				(*pThreadFnc)(void*);
+	void*				pArgument;
+} ksr2_thread;
+
+typedef CRITICAL_SECTION 	ksr2_mutex;
+typedef CONDITION_VARIABLE	ksr2_condition_variable;
+
+ksr2_internal DWORD WINAPI ksr2_thread_entry(LPVOID pArgument)
+{
+	ksr2_thread* pThread = (ksr2_thread*)pArgument;
+	pThread->pThreadFnc(pThread->pArgument);
+	return 0;
+}
+
+ksr2_internal ksr2_b32 ksr2_create_thread(ksr2_thread* pThread, void(*pThreadFnc)(void*), void* pArgument)
+{
+	pThread->pThreadFnc = pThreadFnc;
+	pThread->pArgument	= pArgument;
+	pThread->handle 	= CreateThread(ksr2_nullptr, 0u, ksr2_thread_entry, pThread, 0u, ksr2_nullptr);
+	return pThread->handle != ksr2_nullptr;
+}
+
+ksr2_internal void ksr2_join_thread(ksr2_thread* pThread)
+{
+	WaitForSingleObject(pThread->handle, INFINITE);
+	CloseHandle(pThread->handle);
+}
+
+ksr2_internal void ksr2_init_mutex(ksr2_mutex* pMutex) 		{ InitializeCriticalSection(pMutex); }
+ksr2_internal void ksr2_destroy_mutex(ksr2_mutex* pMutex) 	{ DeleteCriticalSection(pMutex); }
+ksr2_internal void ksr2_lock_mutex(ksr2_mutex* pMutex) 		{ EnterCriticalSection(pMutex); }
+ksr2_internal void ksr2_unlock_mutex(ksr2_mutex* pMutex) 	{ LeaveCriticalSection(pMutex); }
+
+ksr2_internal void ksr2_init_condition_variable(ksr2_condition_variable* pConditionVariable) 						{ InitializeConditionVariable(pConditionVariable); }
+ksr2_internal void ksr2_destroy_condition_variable(ksr2_condition_variable* pConditionVariable) 					{ ksr2_use_argument(pConditionVariable); }
+ksr2_internal void ksr2_wait_condition_variable(ksr2_condition_variable* pConditionVariable, ksr2_mutex* pMutex) 	{ SleepConditionVariableCS(pConditionVariable, pMutex, INFINITE); }
+ksr2_internal void ksr2_broadcast_condition_variable(ksr2_condition_variable* pConditionVariable) 					{ WakeAllConditionVariable(pConditionVariable); }
+
+ksr2_internal ksr2_u64 ksr2_atomic_compare_exchange_u64(volatile ksr2_u64* pValue, ksr2_u64 expected, ksr2_u64 desired)
+{
+	return (ksr2_u64)InterlockedCompareExchange64((volatile LONGLONG*)pValue, (LONGLONG)desired, (LONGLONG)expected);
+}
+
+ksr2_internal ksr2_u64 ksr2_atomic_fetch_add_u64(volatile ksr2_u64* pValue, ksr2_u64 value)
+{
+	return (ksr2_u64)InterlockedExchangeAdd64((volatile LONGLONG*)pValue, (LONGLONG)value);
+}
+
+//FK: a plain 64 bit read can tear on 32 bit targets, compare exchange with equal values only reads
+ksr2_internal ksr2_u64 ksr2_atomic_load_u64(volatile ksr2_u64* pValue)
+{
+	return (ksr2_u64)InterlockedCompareExchange64((volatile LONGLONG*)pValue, 0, 0);
+}
+#	else
+#		include "pthread.h"
+
+typedef struct
+{
+	pthread_t 			handle;
+	void				(*pThreadFnc)(void*);
+	void*				pArgument;
+} ksr2_thread;
+
+typedef pthread_mutex_t 	ksr2_mutex;
+typedef pthread_cond_t		ksr2_condition_variable;
+
+ksr2_internal void* ksr2_thread_entry(void* pArgument)
+{
+	ksr2_thread* pThread = (ksr2_thread*)pArgument;
+	pThread->pThreadFnc(pThread->pArgument);
+	return ksr2_nullptr;
+}
+
+ksr2_internal ksr2_b32 ksr2_create_thread(ksr2_thread* pThread, void(*pThreadFnc)(void*), void* pArgument)
+{
+	pThread->pThreadFnc = pThreadFnc;
+	pThread->pArgument	= pArgument;
+	return pthread_create(&pThread->handle, ksr2_nullptr, ksr2_thread_entry, pThread) == 0;
+}
+
+ksr2_internal void ksr2_join_thread(ksr2_thread* pThread)
+{
+	pthread_join(pThread->handle, ksr2_nullptr);
+}
+
+ksr2_internal void ksr2_init_mutex(ksr2_mutex* pMutex) 		{ pthread_mutex_init(pMutex, ksr2_nullptr); }
+ksr2_internal void ksr2_destroy_mutex(ksr2_mutex* pMutex) 	{ pthread_mutex_destroy(pMutex); }
+ksr2_internal void ksr2_lock_mutex(ksr2_mutex* pMutex) 		{ pthread_mutex_lock(pMutex); }
+ksr2_internal void ksr2_unlock_mutex(ksr2_mutex* pMutex) 	{ pthread_mutex_unlock(pMutex); }
+
+ksr2_internal void ksr2_init_condition_variable(ksr2_condition_variable* pConditionVariable) 						{ pthread_cond_init(pConditionVariable, ksr2_nullptr); }
+ksr2_internal void ksr2_destroy_condition_variable(ksr2_condition_variable* pConditionVariable) 					{ pthread_cond_destroy(pConditionVariable); }
+ksr2_internal void ksr2_wait_condition_variable(ksr2_condition_variable* pConditionVariable, ksr2_mutex* pMutex) 	{ pthread_cond_wait(pConditionVariable, pMutex); }
+ksr2_internal void ksr2_broadcast_condition_variable(ksr2_condition_variable* pConditionVariable) 					{ pthread_cond_broadcast(pConditionVariable); }
+
+ksr2_internal ksr2_u64 ksr2_atomic_compare_exchange_u64(volatile ksr2_u64* pValue, ksr2_u64 expected, ksr2_u64 desired)
+{
+	return __sync_val_compare_and_swap(pValue, expected, desired);
+}
+
+ksr2_internal ksr2_u64 ksr2_atomic_fetch_add_u64(volatile ksr2_u64* pValue, ksr2_u64 value)
+{
+	return __sync_fetch_and_add(pValue, value);
+}
+
+ksr2_internal ksr2_u64 ksr2_atomic_load_u64(volatile ksr2_u64* pValue)
+{
+	return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+}
+#	endif
+#endif //K15_RENDERER_2D_NO_THREADS
 
 typedef ksr2_u32 ksr2_pixel_color;
 
@@ -167,46 +706,141 @@ typedef struct
 	size_t 					memorySizeInBytesStart;
 	size_t 					memorySizeInBytesEnd;
 	size_t 					memoryCapacityInBytes;
+#ifndef K15_RENDERER_2D_NO_STATS
+	size_t 					peakSizeInBytesStart;
+	size_t 					peakSizeInBytesEnd; //FK: gets reset by ksr2_blit
+#endif
 } ksr2_linear_allocator;
 
 typedef struct
 {
 	void*								pImages;
 	void* 								pImageStart; //FK: in case we need to reset the allocator
+	void*								pImageEnd; //FK: end of the swap chain images and the dirty region tracker
 	void*								pCurrentImage;
 	ksr2_u32 							imageCount;
 	ksr2_u32 							imageIndex;
 	ksr2_u32 							width;
 	ksr2_u32 							height;
+	ksr2_u32							stride; //FK: pixels per row, every kernel that touches the swap chain images has to use this instead of width
+	ksr2_b32							padRows;
 	ksr2_pixel_format 					format;
 	ksr2_image_memory_requirements 		memoryRequirements;
 } ksr2_swap_chain;
 
+//FK: The _WIDE variants are only used if the coordinates don't fit into 16 bit
 typedef enum
 {
 	K15_RENDERER_2D_DRAW_COMMAND_LINE,
-	K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT
+	K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE,
+	K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT,
+	K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE,
+	K15_RENDERER_2D_DRAW_COMMAND_IMAGE,
+	K15_RENDERER_2D_DRAW_COMMAND_TEXT,
+	K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE,
+	K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE,
+	K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT,
+	K15_RENDERER_2D_DRAW_COMMAND_PATH,
+
+	K15_RENDERER_2D_DRAW_COMMAND_TYPE_COUNT
 } ksr2_draw_command_type;
 
 typedef struct
 {
-	void* 					pNext;
-	char 					fourcc[4];
-	size_t 					sizeInBytes;
-	ksr2_draw_command_type 	type;
+	ksr2_u8 					type;
+	ksr2_u8 					flags; //FK: blend mode in the lower bits
+	ksr2_u16 					sizeInBytes; //FK: including the header, offset to the next draw command
 } ksr2_draw_command_header;
 
+enum
+{
+	K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK = 0x03,
+	K15_RENDERER_2D_BLEND_MODE_COUNT = 4,
+	K15_RENDERER_2D_FILL_RULE_COUNT = 2
+};
+
+//FK: Every blended pixel is dst = saturate(add + dst * scale / 255), evaluated per channel.
+//	  Opaque draw commands just store 'add'.
+typedef struct
+{
+	ksr2_pixel_color 			add;
+	ksr2_pixel_color 			scale;
+	ksr2_blend_mode				blendMode;
+} ksr2_blend_operand;
+
+struct ksr2_pixel_kernels;
+
+//FK: Swap chain images get addressed in bytes since not every pixel format has 32 bit pixels.
+typedef struct
+{
+	ksr2_byte*							pPixels;
+	const struct ksr2_pixel_kernels*	pKernels;
+	ksr2_u32 							stride; //FK: bytes per row
+	ksr2_u32 							pixelSizeInBytes;
+	ksr2_pixel_format 					format;
+} ksr2_render_target;
+
+//FK: Colors and image pixels are in the format of ksr2_get_color_format(), fill spans get the color of a single pixel.
+typedef void(*ksr2_paint_span_fnc)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand);
+typedef void(*ksr2_paint_image_span_fnc)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode blendMode);
+typedef void(*ksr2_fill_span_fnc)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color);
+typedef void(*ksr2_convert_colors_fnc)(ksr2_pixel_color* pOutPixels, const ksr2_rgba_color* pColors, ksr2_u32 count);
+typedef void(*ksr2_copy_bytes_fnc)(ksr2_byte* pBytes, const ksr2_byte* pSourceBytes, size_t sizeInBytes);
+typedef void(*ksr2_modulate_coverage_span_fnc)(ksr2_pixel_color* pOutPixels, const ksr2_u8* pCoverage, ksr2_u32 pixelCount, ksr2_pixel_color color);
+typedef ksr2_s32(*ksr2_resolve_coverage_span_fnc)(ksr2_u8* pOutCoverage, ksr2_s32* pAreas, ksr2_u32 count);
+typedef void(*ksr2_convert_pixels_from_rgba_fnc)(ksr2_byte* pOutPixels, const ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_pixel_format format);
+typedef void(*ksr2_convert_pixels_to_rgba_fnc)(ksr2_pixel_color* pOutPixels, const ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_format format);
+
+//FK: Kernels of one pixel format and CPU level, picked once by ksr2_init_context so that no span has to branch on the format,
+//	  blend mode or instruction set.
+typedef struct ksr2_pixel_kernels
+{
+	ksr2_paint_span_fnc 				paintSpan[K15_RENDERER_2D_BLEND_MODE_COUNT]; //FK: indexed by ksr2_blend_mode
+	ksr2_paint_image_span_fnc 			paintImageSpan[K15_RENDERER_2D_BLEND_MODE_COUNT]; //FK: opaque copies or converts the image pixels
+	ksr2_fill_span_fnc 					fillSpan;
+	ksr2_fill_span_fnc 					fillSpanNonTemporal; //FK: call ksr2_end_non_temporal_stores() once done
+	ksr2_convert_colors_fnc 			convertColors;
+	ksr2_copy_bytes_fnc 				copyBytes;
+	ksr2_modulate_coverage_span_fnc 	modulateCoverageSpan;
+	ksr2_resolve_coverage_span_fnc 		resolveCoverageSpan[K15_RENDERER_2D_FILL_RULE_COUNT]; //FK: indexed by ksr2_fill_rule
+	ksr2_convert_pixels_from_rgba_fnc 	convertPixelsFromRgba; //FK: these two take the format as argument, they're the same for every format
+	ksr2_convert_pixels_to_rgba_fnc 	convertPixelsToRgba;
+	ksr2_u8								colorShifts[4]; //FK: shift of r, g, b and a in a color, see ksr2_convert_color()
+} ksr2_pixel_kernels;
+
 typedef struct
 {
 	ksr2_draw_command_header 	header;
-	ksr2_u32 					x1;
-	ksr2_u32 					y1;
-	ksr2_u32 					x2; 
-	ksr2_u32 					y2;
-	ksr2_u32 					thickness;
+	ksr2_s16 					x1;
+	ksr2_s16 					y1;
+	ksr2_s16 					x2; 
+	ksr2_s16 					y2;
+	ksr2_u16 					thickness;
+	ksr2_u16 					padding;
 	ksr2_pixel_color 			color;
 } ksr2_line_draw_command;
 
+typedef struct
+{
+	ksr2_draw_command_header 	header;
+	ksr2_s32 					x1;
+	ksr2_s32 					y1;
+	ksr2_s32 					x2; 
+	ksr2_s32 					y2;
+	ksr2_u32 					thickness;
+	ksr2_pixel_color 			color;
+} ksr2_wide_line_draw_command;
+
+typedef struct
+{
+	ksr2_draw_command_header 	header;
+	ksr2_u16 					x1;
+	ksr2_u16 					y1;
+	ksr2_u16 					x2; 
+	ksr2_u16 					y2;
+	ksr2_pixel_color			color;
+} ksr2_filled_rect_draw_command;
+
 typedef struct
 {
 	ksr2_draw_command_header 	header;
@@ -215,662 +849,9882 @@ typedef struct
 	ksr2_u32 					x2; 
 	ksr2_u32 					y2;
 	ksr2_pixel_color			color;
-} ksr2_filled_rect_draw_command;
-
-typedef enum 
-{
-	K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP = 0x001
-} ksr2_context_flags;
+} ksr2_wide_filled_rect_draw_command;
 
 typedef struct
 {
 	char 						fourcc[4];
+	ksr2_u32 					width;
+	ksr2_u32 					height;
+	ksr2_b32 					hasTransparentPixels;
+	ksr2_pixel_color*			pPixels; //FK: premultiplied alpha in the format of the swap chain
+} ksr2_texture;
 
-	ksr2_draw_command_header* 	pFirstDrawCommand;
-    void*   					pMemory;
-    size_t 						memorySizeInBytes;
+typedef struct
+{
+	ksr2_draw_command_header 	header;
+	ksr2_u32 					textureOffset; //FK: offset of the ksr2_texture from the start of the context memory
+	ksr2_s32 					x;
+	ksr2_s32 					y;
+	ksr2_u16 					sourceX;
+	ksr2_u16 					sourceY;
+	ksr2_u16 					sourceWidth;
+	ksr2_u16 					sourceHeight;
+	ksr2_u16 					scale;
+	ksr2_u16 					padding;
+} ksr2_image_draw_command;
 
-	ksr2_linear_allocator 		allocator;
-	ksr2_swap_chain				swapChain;
+enum
+{
+	K15_RENDERER_2D_GLYPH_NOT_CACHED 	= 0xFFFF,
+	K15_RENDERER_2D_GLYPH_EMPTY			= 0xFFFE, //FK: glyph without any coverage, doesn't need a slot in the glyph cache
+	K15_RENDERER_2D_MAX_GLYPH_CACHE_SIZE = 0xFFFD
+};
 
-	ksr2_u32 					flags;
+typedef struct
+{
+	ksr2_u32 					lastUsedFrameIndex; //FK: slots that are used by the current frame can't be evicted
+	ksr2_u16 					glyphIndex;
+	ksr2_u16 					padding;
+} ksr2_glyph_slot;
 
-	ksr2_debug_fnc				debugFnc;
-	ksr2_debug_category 		debugCategoryFilter;
-} ksr2_context;
+//FK: The glyph cache is an atlas of glyphWidth x glyphHeight coverage cells, one per slot.
+typedef struct
+{
+	char 						fourcc[4];
+	const ksr2_u8*				pSourcePixels;
+	ksr2_u32 					sourceStride;
+	ksr2_u32 					sourceBitsPerPixel;
+	ksr2_u32 					glyphsPerRow;
+	ksr2_u32 					glyphWidth;
+	ksr2_u32 					glyphHeight;
+	ksr2_u32 					advance;
+	ksr2_u32 					lineHeight;
+	ksr2_u32 					firstCharacter;
+	ksr2_u32 					glyphCount;
+
+	ksr2_u16*					pGlyphSlotIndices; //FK: slot index per glyph or K15_RENDERER_2D_GLYPH_NOT_CACHED/_EMPTY
+	ksr2_glyph_slot*			pSlots;
+	ksr2_u8*					pAtlas;
+	ksr2_u32 					slotCount;
+	ksr2_u32 					usedSlotCount;
+	ksr2_u32 					nextEvictionSlotIndex;
+
+	ksr2_glyph_cache_statistics statistics;
+} ksr2_font;
 
-ksr2_internal ksr2_b32 				ksr2_true 					= 1u;
-ksr2_internal ksr2_b32 				ksr2_false					= 0u;
-ksr2_internal ksr2_contexthandle 	ksr2_invalid_context_handle = 0u;
-ksr2_internal size_t 				ksr2_default_alignment		= 16u;
+typedef struct
+{
+	ksr2_u16 					glyphIndex;
+	ksr2_u16 					x; //FK: relative to the draw command
+} ksr2_text_glyph;
 
-ksr2_internal void ksr2_debug_fnc_stub(ksr2_contexthandle contextHandle, ksr2_debug_category category, const char* pMessage)
+//FK: One run of glyphs on the same line, the ksr2_text_glyph array directly follows the draw command.
+//	  Glyphs are stored by index rather than by slot so that the command hashes the same no matter where the glyphs are cached.
+typedef struct
 {
-	ksr2_use_argument(contextHandle);
-	ksr2_use_argument(category);
-	ksr2_use_argument(pMessage);
-}
+	ksr2_draw_command_header 	header;
+	ksr2_u32 					fontOffset; //FK: offset of the ksr2_font from the start of the context memory
+	ksr2_s32 					x;
+	ksr2_s32 					y;
+	ksr2_pixel_color			color; //FK: premultiplied alpha, independent of the blend mode
+	ksr2_u16 					width;
+	ksr2_u8 					height;
+	ksr2_u8 					glyphCount;
+} ksr2_text_draw_command;
+
+//FK: Vertices are in subpixels (28.4) and clockwise on the screen, see ksr2_draw_triangles(). Colors are premultiplied
+//	  unless the blend mode is opaque.
+typedef struct
+{
+	ksr2_draw_command_header 	header;
+	ksr2_s32 					x[3];
+	ksr2_s32 					y[3];
+	ksr2_pixel_color 			colors[3];
+} ksr2_triangle_draw_command;
 
-ksr2_internal ksr2_b32 ksr2_check_fourcc(char* pFourCC1, const char* pFourCC2)
+//FK: Center and radii are in subpixels (28.4), circles are ellipses with radiusX == radiusY. Only circles can have a hole.
+typedef struct
 {
-	return pFourCC1[0] == pFourCC2[0] && 
-	pFourCC1[1] == pFourCC2[1] && 
-	pFourCC1[2] == pFourCC2[2] && 
-	pFourCC1[3] == pFourCC2[3];
-}
+	ksr2_draw_command_header 	header;
+	ksr2_s32 					centerX;
+	ksr2_s32 					centerY;
+	ksr2_s32 					radiusX;
+	ksr2_s32 					radiusY;
+	ksr2_s32 					innerRadius; //FK: radius of the hole of rings, 0 otherwise
+	ksr2_pixel_color 			color;
+} ksr2_ellipse_draw_command;
 
-ksr2_internal void ksr2_init_fourcc(char* pFourCCDst, const char* pFourCCSrc)
+//FK: Edges and corner radius are in subpixels (28.4), x1 < x2 and y1 < y2
+typedef struct
 {
-	pFourCCDst[0] = pFourCCSrc[0];
-	pFourCCDst[1] = pFourCCSrc[1];
-	pFourCCDst[2] = pFourCCSrc[2];
-	pFourCCDst[3] = pFourCCSrc[3];
-}
+	ksr2_draw_command_header 	header;
+	ksr2_s32 					x1;
+	ksr2_s32 					y1;
+	ksr2_s32 					x2;
+	ksr2_s32 					y2;
+	ksr2_s32 					cornerRadius; //FK: at most half of the shorter side
+	ksr2_pixel_color 			color;
+} ksr2_rounded_rect_draw_command;
 
-ksr2_internal ksr2_context* ksr2_contexthandle_to_context(ksr2_contexthandle handle)
+//FK: Line of a path in subpixels (28.4), in the direction of the path. Horizontal lines don't get stored.
+typedef struct
 {
-	ksr2_context* pContext = (ksr2_context*)(handle);
+	ksr2_s32 					x1;
+	ksr2_s32 					y1;
+	ksr2_s32 					x2;
+	ksr2_s32 					y2;
+} ksr2_path_edge;
+
+//FK: One band of rows of a filled or stroked path, the ksr2_path_edge array directly follows the draw command.
+//	  It holds every edge of the path that passes through its rows, strokes get filled with the nonzero fill rule.
+typedef struct
+{
+	ksr2_draw_command_header 	header;
+	ksr2_u32 					x1; //FK: pixels that can be covered, clamped to positive coordinates
+	ksr2_u32 					y1;
+	ksr2_u32 					x2;
+	ksr2_u32 					y2;
+	ksr2_pixel_color 			color;
+	ksr2_u16 					edgeCount;
+	ksr2_u8 					fillRule;
+	ksr2_u8 					padding;
+} ksr2_path_draw_command;
+
+//FK: Draw commands get appended in submission order to chunks allocated by the chunk allocator of the application 
+//	  or from the back of the linear allocator. The draw commands of a chunk directly follow the chunk header.
+typedef struct ksr2_draw_command_chunk
+{
+	struct ksr2_draw_command_chunk* pNext;
+	ksr2_u32 						sizeInBytes;
+	ksr2_u32 						capacityInBytes;
+	char 							fourcc[4];
+	ksr2_b32						fromChunkAllocator; //FK: needs to be passed to ksr2_context::freeChunkFnc
+} ksr2_draw_command_chunk;
 
-	if (pContext == ksr2_nullptr)
-	{
-		return ksr2_nullptr;
-	}
+typedef struct
+{
+	ksr2_draw_command_chunk* 	pFirstChunk;
+	ksr2_draw_command_chunk* 	pLastChunk;
+	ksr2_u32 					drawCommandCount;
+	size_t						memorySizeInBytes; //FK: of all chunks including their headers
+} ksr2_draw_command_stream;
 
-#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
-	if (ksr2_check_fourcc(pContext->fourcc, "KR2C") == ksr2_false)
-	{
-		return ksr2_nullptr;
-	}
-#endif
+typedef struct
+{
+	const ksr2_draw_command_chunk* 	pChunk;
+	ksr2_u32 						offsetInBytes;
+} ksr2_draw_command_iterator;
+
+//FK: A path draw command has to fit into a single chunk and its size into ksr2_draw_command_header::sizeInBytes
+enum
+{
+	K15_RENDERER_2D_MAX_PATH_DRAW_COMMAND_SIZE_IN_BYTES = ksr2_min(0xFFFC, K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES - sizeof(ksr2_draw_command_chunk)),
+	K15_RENDERER_2D_MAX_PATH_EDGE_COUNT = (K15_RENDERER_2D_MAX_PATH_DRAW_COMMAND_SIZE_IN_BYTES - sizeof(ksr2_path_draw_command)) / sizeof(ksr2_path_edge)
+};
+
+//FK: line as stored in either of the line draw commands
+typedef struct
+{
+	ksr2_s32 					x1;
+	ksr2_s32 					y1;
+	ksr2_s32 					x2;
+	ksr2_s32 					y2;
+	ksr2_u32 					thickness;
+	ksr2_pixel_color 			color;
+} ksr2_line;
+
+typedef struct
+{
+	ksr2_u32 x1;
+	ksr2_u32 y1;
+	ksr2_u32 x2;
+	ksr2_u32 y2;
+} ksr2_rect;
+
+enum
+{
+	K15_RENDERER_2D_FIXED_POINT_BITS 	= 16,
+	K15_RENDERER_2D_FIXED_POINT_ONE		= 1 << K15_RENDERER_2D_FIXED_POINT_BITS
+};
+
+//FK: Triangles get rasterized in blocks of K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE x K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE pixels. 
+//	  With coordinates clamped to K15_RENDERER_2D_MAX_TRIANGLE_COORDINATE the edge functions within a block that an edge 
+//	  passes through fit into 32 bit.
+enum
+{
+	K15_RENDERER_2D_SUBPIXEL_BITS 				= 4,
+	K15_RENDERER_2D_SUBPIXEL_ONE 				= 1 << K15_RENDERER_2D_SUBPIXEL_BITS,
+	K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE 		= 8,
+	K15_RENDERER_2D_MAX_TRIANGLE_COORDINATE 	= 32768
+};
+
+//FK: relative to the tile, x1 >= x2 means the binned draw command got culled
+typedef struct
+{
+	ksr2_u16 x1;
+	ksr2_u16 y1;
+	ksr2_u16 x2;
+	ksr2_u16 y2;
+} ksr2_bin_clip_rect;
+
+typedef struct
+{
+	const ksr2_draw_command_header** pBinnedDrawCommands; //FK: draw commands of all tiles, tile after tile
+	ksr2_bin_clip_rect*			pBinnedClipRects; //FK: one per binned draw command, ksr2_nullptr if occlusion culling is disabled
+	ksr2_u32*					pTileCulledPixelCounts;
+	ksr2_u32*					pTileWrittenPixelCounts; //FK: ksr2_nullptr if compiled with K15_RENDERER_2D_NO_STATS
+	ksr2_u32*					pTileBinOffsets; //FK: tileCount + 1 offsets into pBinnedDrawCommands
+	const ksr2_u8*				pTileStates; //FK: ksr2_tile_state per tile, ksr2_nullptr = rasterize all tiles
+	const ksr2_byte*			pPreviousImage; //FK: source for K15_RENDERER_2D_TILE_STATE_COPY
+	ksr2_u32					tileSize;
+	ksr2_u32					tileCountX;
+	ksr2_u32					tileCountY;
+} ksr2_tile_bins;
+
+typedef enum
+{
+	K15_RENDERER_2D_TILE_STATE_RASTERIZE = 0,
+	K15_RENDERER_2D_TILE_STATE_COPY, 	//FK: same draw commands as the previous image, copy the pixels from there
+	K15_RENDERER_2D_TILE_STATE_SKIP		//FK: current image already contains the result of the draw commands
+} ksr2_tile_state;
+
+//FK: Tiles get hashed by their draw commands. A hash of 0 means the content of the tile is unknown.
+typedef struct
+{
+	ksr2_u64*					pTileHashes; //FK: tileCount hashes per swap chain image
+	ksr2_u8*					pTileStates;
+	ksr2_damage_rect*			pDamageRects;
+	ksr2_damage_rect			imageDamageRect; //FK: damage list if dirty region tracking is disabled
+	ksr2_u32					tileCount;
+	ksr2_u32					damageRectCount;
+	ksr2_u32					previousImageIndex;
+	ksr2_b32					hasPreviousImage;
+} ksr2_dirty_region_tracker;
+
+struct ksr2_context;
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+typedef struct
+{
+	volatile ksr2_u64	tileRange; //FK: packed tile index range, first tile in the lower, end tile in the upper 32 bits
+	ksr2_u8				padding[56]; //FK: keep the queues of different workers on different cache lines
+} ksr2_tile_queue;
+
+struct ksr2_worker_pool;
+
+typedef struct
+{
+	ksr2_thread					thread;
+	struct ksr2_worker_pool*	pWorkerPool;
+	ksr2_u32					workerIndex;
+} ksr2_worker;
+
+typedef struct ksr2_worker_pool
+{
+	ksr2_mutex					mutex;
+	ksr2_condition_variable		workAvailable;
+	ksr2_condition_variable		workFinished;
+
+	ksr2_worker*				pWorkers;
+	ksr2_tile_queue*			pTileQueues; //FK: workerCount + 1, the last queue belongs to the thread calling ksr2_blit
+	struct ksr2_context*		pContext;
+	const ksr2_tile_bins*		pTileBins;
+
+	ksr2_u32					allocatedWorkerCount; //FK: workers ksr2_init_worker_pool() allocated
+	ksr2_u32					workerCount; //FK: workers whose thread is running
+	ksr2_u32					frameIndex;
+	ksr2_u32					busyWorkerCount;
+	ksr2_b32					shutdown;
+} ksr2_worker_pool;
+#endif //K15_RENDERER_2D_NO_THREADS
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+typedef struct
+{
+	const char*			pName;
+	ksr2_u64			startTimeInNs; //FK: relative to the creation of the context
+	ksr2_u32			durationInNs;
+	ksr2_u32			frameIndex;
+	ksr2_u32			tileIndex; //FK: K15_RENDERER_2D_NO_TRACE_TILE if the event doesn't belong to a tile
+	ksr2_u32			threadIndex; //FK: 0 = thread calling ksr2_blit, 1 + workerIndex = worker threads, 1 + workerCount = render thread
+} ksr2_trace_event;
+
+typedef struct
+{
+	ksr2_trace_event*	pEvents; //FK: ksr2_nullptr if tracing is disabled
+	volatile ksr2_u64	eventCount; //FK: events recorded since the context got created, the ring buffer only keeps the latest eventMask + 1
+	ksr2_u64			eventMask;
+	ksr2_u64			startTimeInNs;
+	ksr2_u32			rasterizeThreadIndex; //FK: thread index of the thread that rasterizes the frame, see ksr2_trace_event::threadIndex
+} ksr2_trace_buffer;
+#endif //K15_RENDERER_2D_NO_TRACING
+
+#define K15_RENDERER_2D_NO_TRACE_TILE 0xFFFFFFFFu
+
+typedef enum 
+{
+	K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP 	= 0x001,
+	K15_RENDERER_2D_DIRTY_REGION_TRACKING		= 0x002,
+	K15_RENDERER_2D_FLUSH_WHEN_FULL				= 0x004,
+	K15_RENDERER_2D_ASYNC_BLIT					= 0x008
+} ksr2_context_flags;
+
+//FK: Draw calls record into a command list. Every context has its own one, the application can create deferred ones
+//	  that get recorded on other threads and are linked into the draw command stream of the context by ksr2_submit_command_list().
+typedef struct ksr2_command_list
+{
+	char 						fourcc[4];
+
+	struct ksr2_context*		pContext;
+	ksr2_draw_command_stream 	drawCommandStream;
+	ksr2_linear_allocator		allocator; //FK: draw command chunks of deferred command lists, unused by the one of the context
+	ksr2_blend_mode				blendMode;
+	ksr2_b32					isDeferred;
+	ksr2_b32					hasTextDrawCommands; //FK: glyphs of deferred text draw commands get cached on submission
+} ksr2_command_list;
+
+#define K15_RENDERER_2D_NO_IMAGE 0xFFFFFFFFu
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+//FK: Frames get recorded into the 2 command lists alternately, so the render thread can rasterize the previous one meanwhile.
+//	  Every swap chain image is in at most one of the 4 states below, the ones that aren't are free. Guarded by the mutex
+//	  except for the command lists, which only get touched by the application thread while no frame is being rendered.
+typedef struct
+{
+	ksr2_thread					thread;
+	ksr2_mutex					mutex;
+	ksr2_condition_variable		frameQueued;
+	ksr2_condition_variable		frameFinished;
+
+	ksr2_command_list			commandLists[2];
+	ksr2_u32					recordIndex; //FK: command list the application records into
+
+	ksr2_u32					acquiredImageIndex; //FK: image the next ksr2_blit renders into
+	ksr2_u32					renderingImageIndex; //FK: image of the frame in flight
+	ksr2_u32					presentableImageIndex; //FK: latest image that finished rendering
+	ksr2_u32					presentingImageIndex; //FK: image between ksr2_acquire_presentable_image() and ksr2_swap_buffers()
+
+	ksr2_b32					clearImage; //FK: ksr2_clear of the frame being recorded
+	ksr2_pixel_color			clearColor;
+	ksr2_u64					blitStartTimeInNs; //FK: of the frame in flight
+	ksr2_u64					recordStartTimeInNs;
+	ksr2_b32					shutdown;
+} ksr2_render_thread;
+#endif //K15_RENDERER_2D_NO_THREADS
+
+typedef struct ksr2_context
+{
+	char 						fourcc[4];
+
+	ksr2_command_list			commandList; //FK: draw commands of the frame that gets rasterized next
+	ksr2_command_list*			pRecordCommandList; //FK: draw calls on the context handle record into this one, &commandList unless K15_RENDERER_2D_ASYNC_BLIT_FLAG is set
+    void*   					pMemory;
+    size_t 						memorySizeInBytes;
+
+	ksr2_linear_allocator 		allocator;
+	ksr2_swap_chain				swapChain;
+	ksr2_pixel_kernels			kernels; //FK: kernels of the swap chain format, see ksr2_select_pixel_kernels()
+	ksr2_cpu_level				cpuLevel;
+
+	ksr2_u32 					flags;
+	ksr2_u32					tileSize;
+
+	ksr2_dirty_region_tracker	dirtyRegionTracker;
+	size_t						culledPixelCount;
+	ksr2_u32					frameIndex; //FK: incremented by every ksr2_blit
+	ksr2_u32					flushCount; //FK: flushes since the last ksr2_blit, see ksr2_flush_draw_commands()
+
+	ksr2_allocate_chunk_fnc		allocateChunkFnc;
+	ksr2_free_chunk_fnc			freeChunkFnc;
+	void*						pChunkAllocatorUserData;
+	size_t						drawCommandMemoryHighWaterMarkInBytes;
+
+	ksr2_b32					clearImage; //FK: set by ksr2_clear, image gets cleared before any draw command is issued
+	ksr2_pixel_color			clearColor;
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	ksr2_frame_stats			frameStats; //FK: stats of the last ksr2_blit
+	ksr2_frame_stats			flushedFrameStats; //FK: stats of the draw commands that got flushed since the last ksr2_blit
+#endif
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+	ksr2_u64					recordStartTimeInNs; //FK: 0 = nothing got recorded since the last ksr2_blit
+#endif
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+	ksr2_trace_buffer			traceBuffer;
+#endif
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	ksr2_worker_pool			workerPool;
+	ksr2_render_thread			renderThread; //FK: only used with K15_RENDERER_2D_ASYNC_BLIT_FLAG
+#endif
+
+	ksr2_debug_fnc				debugFnc;
+	ksr2_debug_category 		debugCategoryFilter;
+} ksr2_context;
+
+ksr2_internal ksr2_b32 				ksr2_true 					= 1u;
+ksr2_internal ksr2_b32 				ksr2_false					= 0u;
+ksr2_internal ksr2_contexthandle 	ksr2_invalid_context_handle = 0u;
+ksr2_internal size_t 				ksr2_default_alignment		= 16u;
+
+ksr2_internal void ksr2_debug_fnc_stub(ksr2_contexthandle contextHandle, ksr2_debug_category category, const char* pMessage)
+{
+	ksr2_use_argument(contextHandle);
+	ksr2_use_argument(category);
+	ksr2_use_argument(pMessage);
+}
+
+ksr2_internal ksr2_b32 ksr2_check_fourcc(char* pFourCC1, const char* pFourCC2)
+{
+	return pFourCC1[0] == pFourCC2[0] && 
+	pFourCC1[1] == pFourCC2[1] && 
+	pFourCC1[2] == pFourCC2[2] && 
+	pFourCC1[3] == pFourCC2[3];
+}
+
+ksr2_internal void ksr2_init_fourcc(char* pFourCCDst, const char* pFourCCSrc)
+{
+	pFourCCDst[0] = pFourCCSrc[0];
+	pFourCCDst[1] = pFourCCSrc[1];
+	pFourCCDst[2] = pFourCCSrc[2];
+	pFourCCDst[3] = pFourCCSrc[3];
+}
+
+ksr2_internal ksr2_context* ksr2_contexthandle_to_context(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = (ksr2_context*)(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return ksr2_nullptr;
+	}
+
+#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
+	if (ksr2_check_fourcc(pContext->fourcc, "KR2C") == ksr2_false)
+	{
+		return ksr2_nullptr;
+	}
+#endif
 
 	return pContext;
 }
 
-ksr2_internal void ksr2_init_linear_allocator(ksr2_linear_allocator* pOutAllocator, void* pBaseAddress, size_t memorySizeInBytes)
+ksr2_internal ksr2_command_list* ksr2_commandlisthandle_to_command_list(ksr2_commandlisthandle handle)
+{
+	ksr2_command_list* pCommandList = (ksr2_command_list*)(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return ksr2_nullptr;
+	}
+
+#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
+	if (ksr2_check_fourcc(pCommandList->fourcc, "KR2L") == ksr2_false)
+	{
+		return ksr2_nullptr;
+	}
+#endif
+
+	return pCommandList;
+}
+
+//FK: Draw functions accept context and command list handles. The fourcc always needs to be checked to tell them apart, 
+//	  both structs start with it.
+ksr2_internal ksr2_command_list* ksr2_handle_to_command_list(size_t handle)
+{
+	char* pFourCC = (char*)(handle);
+
+	if (pFourCC == ksr2_nullptr)
+	{
+		return ksr2_nullptr;
+	}
+
+	if (ksr2_check_fourcc(pFourCC, "KR2C"))
+	{
+		return ((ksr2_context*)pFourCC)->pRecordCommandList;
+	}
+
+	if (ksr2_check_fourcc(pFourCC, "KR2L"))
+	{
+		return (ksr2_command_list*)pFourCC;
+	}
+
+	return ksr2_nullptr;
+}
+
+ksr2_internal ksr2_texture* ksr2_texturehandle_to_texture(const ksr2_context* pContext, ksr2_texturehandle handle)
+{
+	ksr2_texture* pTexture = (ksr2_texture*)(handle);
+
+	if (pTexture == ksr2_nullptr)
+	{
+		return ksr2_nullptr;
+	}
+
+#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
+	if ((ksr2_byte*)pTexture < pContext->allocator.pStartAddress || (ksr2_byte*)pTexture >= pContext->allocator.pEndAddress)
+	{
+		return ksr2_nullptr;
+	}
+
+	if (ksr2_check_fourcc(pTexture->fourcc, "KR2T") == ksr2_false)
+	{
+		return ksr2_nullptr;
+	}
+#else
+	ksr2_use_argument(pContext);
+#endif
+
+	return pTexture;
+}
+
+ksr2_internal ksr2_font* ksr2_fonthandle_to_font(const ksr2_context* pContext, ksr2_fonthandle handle)
+{
+	ksr2_font* pFont = (ksr2_font*)(handle);
+
+	if (pFont == ksr2_nullptr)
+	{
+		return ksr2_nullptr;
+	}
+
+#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
+	if ((ksr2_byte*)pFont < pContext->allocator.pStartAddress || (ksr2_byte*)pFont >= pContext->allocator.pEndAddress)
+	{
+		return ksr2_nullptr;
+	}
+
+	if (ksr2_check_fourcc(pFont->fourcc, "KR2F") == ksr2_false)
+	{
+		return ksr2_nullptr;
+	}
+#else
+	ksr2_use_argument(pContext);
+#endif
+
+	return pFont;
+}
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+#	ifdef _WIN32
+#		include "windows.h"
+
+ksr2_internal ksr2_u64 ksr2_get_time_in_ns()
+{
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (ksr2_u64)(counter.QuadPart / frequency.QuadPart) * 1000000000ull + (ksr2_u64)(counter.QuadPart % frequency.QuadPart) * 1000000000ull / (ksr2_u64)frequency.QuadPart;
+}
+#	else
+#		include "time.h"
+
+ksr2_internal ksr2_u64 ksr2_get_time_in_ns()
+{
+#		if defined(CLOCK_MONOTONIC)
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (ksr2_u64)time.tv_sec * 1000000000ull + (ksr2_u64)time.tv_nsec;
+#		else
+	//FK: system headers got included before the implementation without POSIX, see _POSIX_C_SOURCE above
+	return (ksr2_u64)clock() * (1000000000ull / CLOCKS_PER_SEC);
+#		endif
+}
+#	endif
+#endif //K15_RENDERER_2D_TIMESTAMPS
+
+//FK: Returns 0 if tracing is disabled, ksr2_trace_end() ignores the event in that case.
+ksr2_internal ksr2_u64 ksr2_trace_begin(const ksr2_context* pContext)
+{
+#ifndef K15_RENDERER_2D_NO_TRACING
+	if (pContext->traceBuffer.pEvents != ksr2_nullptr)
+	{
+		return ksr2_get_time_in_ns();
+	}
+#else
+	ksr2_use_argument(pContext);
+#endif
+
+	return 0u;
+}
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+//FK: Timestamp for the frame stats and the trace. Returns 0 with K15_RENDERER_2D_NO_STATS while tracing is disabled, 
+//	  so the clock doesn't get read for nothing on every blit.
+ksr2_internal ksr2_u64 ksr2_get_timestamp_in_ns(const ksr2_context* pContext)
+{
+#	ifndef K15_RENDERER_2D_NO_STATS
+	ksr2_use_argument(pContext);
+	return ksr2_get_time_in_ns();
+#	else
+	return ksr2_trace_begin(pContext);
+#	endif
+}
+#endif //K15_RENDERER_2D_TIMESTAMPS
+
+ksr2_internal void ksr2_add_trace_event(ksr2_context* pContext, const char* pName, ksr2_u64 startTimeInNs, ksr2_u64 endTimeInNs, ksr2_u32 threadIndex, ksr2_u32 tileIndex)
+{
+#ifndef K15_RENDERER_2D_NO_TRACING
+	ksr2_trace_buffer* pTraceBuffer = &pContext->traceBuffer;
+
+	if (pTraceBuffer->pEvents == ksr2_nullptr || startTimeInNs < pTraceBuffer->startTimeInNs)
+	{
+		return;
+	}
+
+	//FK: worker threads add their tile events concurrently
+#	ifndef K15_RENDERER_2D_NO_THREADS
+	const ksr2_u64 eventIndex = ksr2_atomic_fetch_add_u64(&pTraceBuffer->eventCount, 1u);
+#	else
+	const ksr2_u64 eventIndex = pTraceBuffer->eventCount++;
+#	endif
+
+	const ksr2_u64 durationInNs = endTimeInNs - startTimeInNs;
+
+	ksr2_trace_event* pEvent = &pTraceBuffer->pEvents[eventIndex & pTraceBuffer->eventMask];
+	pEvent->pName 			= pName;
+	pEvent->startTimeInNs 	= startTimeInNs - pTraceBuffer->startTimeInNs;
+	pEvent->durationInNs 	= durationInNs < 0xFFFFFFFFu ? (ksr2_u32)durationInNs : 0xFFFFFFFFu;
+	pEvent->frameIndex 		= pContext->frameIndex;
+	pEvent->tileIndex 		= tileIndex;
+	pEvent->threadIndex 	= threadIndex;
+#else
+	ksr2_use_argument(pContext);
+	ksr2_use_argument(pName);
+	ksr2_use_argument(startTimeInNs);
+	ksr2_use_argument(endTimeInNs);
+	ksr2_use_argument(threadIndex);
+	ksr2_use_argument(tileIndex);
+#endif
+}
+
+ksr2_internal void ksr2_trace_end(ksr2_context* pContext, const char* pName, ksr2_u64 beginTimeInNs, ksr2_u32 threadIndex, ksr2_u32 tileIndex)
+{
+	if (beginTimeInNs == 0u)
+	{
+		return;
+	}
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+	ksr2_add_trace_event(pContext, pName, beginTimeInNs, ksr2_get_time_in_ns(), threadIndex, tileIndex);
+#else
+	ksr2_use_argument(pContext);
+	ksr2_use_argument(pName);
+	ksr2_use_argument(threadIndex);
+	ksr2_use_argument(tileIndex);
+#endif
+}
+
+ksr2_internal ksr2_u32 ksr2_get_rasterize_thread_index(const ksr2_context* pContext)
+{
+#ifndef K15_RENDERER_2D_NO_TRACING
+	return pContext->traceBuffer.rasterizeThreadIndex;
+#else
+	ksr2_use_argument(pContext);
+	return 0u;
+#endif
+}
+
+ksr2_internal void ksr2_init_linear_allocator(ksr2_linear_allocator* pOutAllocator, void* pBaseAddress, size_t memorySizeInBytes)
+{
+	ksr2_linear_allocator allocator 	= {0};
+	allocator.pStartAddress 			= (ksr2_byte*)pBaseAddress;
+	allocator.pEndAddress				= (ksr2_byte*)pBaseAddress + memorySizeInBytes;
+	allocator.memorySizeInBytesStart 	= 0u;
+	allocator.memorySizeInBytesEnd	 	= 0u;
+	allocator.memoryCapacityInBytes 	= memorySizeInBytes;	
+	*pOutAllocator = allocator;
+}
+
+ksr2_internal void ksr2_set_linear_allocator_front(ksr2_linear_allocator* pAllocator, void* pStartAddress)
+{
+	ksr2_assert(pAllocator != ksr2_nullptr);
+	ksr2_assert(pStartAddress != ksr2_nullptr);
+
+	pAllocator->memorySizeInBytesStart = ((size_t)pStartAddress - (size_t)pAllocator->pStartAddress);
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	pAllocator->peakSizeInBytesStart = ksr2_max(pAllocator->peakSizeInBytesStart, pAllocator->memorySizeInBytesStart);
+#endif
+}
+
+ksr2_internal size_t ksr2_get_linear_allocator_capacity(const ksr2_linear_allocator* pAllocator)
+{
+	return pAllocator->memoryCapacityInBytes - (pAllocator->memorySizeInBytesStart + pAllocator->memorySizeInBytesEnd);
+}
+
+//FK: alignment has to be a power of 2, 0 = no alignment
+ksr2_internal ksr2_result ksr2_allocate_from_linear_allocator_front(void** pOutPointer, ksr2_linear_allocator* pAllocator, size_t memorySizeInBytes, size_t alignment)
+{
+	ksr2_assert((alignment & (alignment - 1u)) == 0u);
+
+	const size_t alignmentMask = alignment > 0u ? alignment - 1u : 0u;
+	const size_t address = (size_t)(pAllocator->pStartAddress + pAllocator->memorySizeInBytesStart);
+	const size_t paddingInBytes = (alignment - (address & alignmentMask)) & alignmentMask;
+	const size_t allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+
+	if (allocatorCapacityInBytes < memorySizeInBytes || allocatorCapacityInBytes - memorySizeInBytes < paddingInBytes)
+	{
+		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+	}
+
+	*pOutPointer = (void*)(address + paddingInBytes);
+	pAllocator->memorySizeInBytesStart += paddingInBytes + memorySizeInBytes;
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	pAllocator->peakSizeInBytesStart = ksr2_max(pAllocator->peakSizeInBytesStart, pAllocator->memorySizeInBytesStart);
+#endif
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: alignment has to be a power of 2, 0 = no alignment
+ksr2_internal ksr2_result ksr2_allocate_from_linear_allocator_back(void** pOutPointer, ksr2_linear_allocator* pAllocator, size_t memorySizeInBytes, size_t alignment)
+{
+	ksr2_assert((alignment & (alignment - 1u)) == 0u);
+
+	const size_t alignmentMask = alignment > 0u ? alignment - 1u : 0u;
+	const size_t endAddress = (size_t)(pAllocator->pEndAddress - pAllocator->memorySizeInBytesEnd);
+	const size_t allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+
+	if (allocatorCapacityInBytes < memorySizeInBytes)
+	{
+		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+	}
+
+	//FK: the back grows downwards, so the padding ends up behind the allocation
+	const size_t paddingInBytes = (endAddress - memorySizeInBytes) & alignmentMask;
+
+	if (allocatorCapacityInBytes - memorySizeInBytes < paddingInBytes)
+	{
+		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+	}
+
+	*pOutPointer = (void*)(endAddress - memorySizeInBytes - paddingInBytes);
+	pAllocator->memorySizeInBytesEnd += memorySizeInBytes + paddingInBytes;
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	pAllocator->peakSizeInBytesEnd = ksr2_max(pAllocator->peakSizeInBytesEnd, pAllocator->memorySizeInBytesEnd);
+#endif
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+ksr2_internal void ksr2_reset_allocator_back(ksr2_linear_allocator* pAllocator)
+{
+	pAllocator->memorySizeInBytesEnd = 0u;
+}
+
+ksr2_force_inline size_t ksr2_get_pixel_size_in_bytes(ksr2_pixel_format format)
+{
+	switch(format)
+	{
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGBA:
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			return 4u;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			return 2u;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			return 1u;
+
+		default:
+			return 0u;
+	}
+}
+
+//FK: Formats with less than 32 bit per pixel keep draw command colors, the clear color and textures in RGBA,
+//	  their kernels convert when they read and write the pixels of the image.
+ksr2_force_inline ksr2_pixel_format ksr2_get_color_format(ksr2_pixel_format format)
+{
+	return ksr2_get_pixel_size_in_bytes(format) == 4u ? format : K15_RENDERER_2D_PIXEL_FORMAT_RGBA;
+}
+
+//FK: Rows that are a multiple of 4KB apart map to the same cache sets and falsely alias in the load/store buffers,
+//	  which hurts everything that walks down columns of the image (tiles, vertical lines, text).
+ksr2_internal ksr2_u32 ksr2_get_padded_stride(ksr2_u32 width, ksr2_u32 pixelSizeInBytes)
+{
+	const ksr2_u32 pixelsPerAlignment = K15_RENDERER_2D_IMAGE_ALIGNMENT / pixelSizeInBytes;
+	ksr2_u32 stride = (width + pixelsPerAlignment - 1u) & ~(pixelsPerAlignment - 1u);
+
+	if (((size_t)stride * pixelSizeInBytes) % ksr2_kilobyte(4) == 0u)
+	{
+		stride += pixelsPerAlignment;
+	}
+
+	return stride;
+}
+
+ksr2_internal ksr2_result ksr2_query_image_memory_requirements(ksr2_image_memory_requirements* pOutRequirements, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format, ksr2_b32 padRows)
+{
+	ksr2_image_memory_requirements requirements = {0};
+	const ksr2_u32 pixelSizeInBytes = (ksr2_u32)ksr2_get_pixel_size_in_bytes(format);
+	
+	switch(format)
+	{
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGBA:
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			requirements.bitsPerChannel[0] = 8u;
+			requirements.bitsPerChannel[1] = 8u;
+			requirements.bitsPerChannel[2] = 8u;
+			requirements.bitsPerChannel[3] = 8u;
+			requirements.channelCount = 4u;
+			break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			requirements.bitsPerChannel[0] = 5u;
+			requirements.bitsPerChannel[1] = 6u;
+			requirements.bitsPerChannel[2] = 5u;
+			requirements.channelCount = 3u;
+			break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			requirements.bitsPerChannel[0] = 8u;
+			requirements.channelCount = 1u;
+			break;
+
+		default:
+			return K15_RENDERER_2D_UNKNOWN_PIXEL_FORMAT;
+	}
+
+	requirements.stride = padRows ? ksr2_get_padded_stride(width, pixelSizeInBytes) : width;
+	requirements.alignment = K15_RENDERER_2D_IMAGE_ALIGNMENT;
+	requirements.memorySizeInBytes = (size_t)height * requirements.stride * pixelSizeInBytes;
+
+	*pOutRequirements = requirements;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_internal ksr2_result ksr2_allocate_swap_chain_images(void** pImages, ksr2_u32 imageCount, ksr2_linear_allocator* pAllocator, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format, ksr2_b32 padRows)
+{
+	ksr2_image_memory_requirements memoryRequirements = {0};
+	ksr2_result result = ksr2_query_image_memory_requirements(&memoryRequirements, width, height, format, padRows);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	result = ksr2_allocate_from_linear_allocator_front(pImages, pAllocator, memoryRequirements.memorySizeInBytes * imageCount, memoryRequirements.alignment);
+	return result;
+}
+
+ksr2_internal void* ksr2_get_allocator_front_address(ksr2_linear_allocator* pAllocator)
+{
+	ksr2_assert(pAllocator != ksr2_nullptr);
+	return pAllocator->pStartAddress + pAllocator->memorySizeInBytesStart;
+}
+
+ksr2_internal ksr2_byte* ksr2_get_swap_chain_image(const ksr2_swap_chain* pSwapChain, ksr2_u32 imageIndex)
+{
+	return (ksr2_byte*)pSwapChain->pImages + pSwapChain->memoryRequirements.memorySizeInBytes * imageIndex;
+}
+
+//FK: pImageStart is the allocator front before the swap chain images got allocated
+ksr2_internal ksr2_result ksr2_init_swap_chain(ksr2_swap_chain* pOutSwapChain, void* pImageStart, void* pImages, ksr2_u32 imageCount, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format, ksr2_b32 padRows)
+{
+	ksr2_swap_chain swapChain = {0};
+	ksr2_result result = ksr2_query_image_memory_requirements(&swapChain.memoryRequirements, width, height, format, padRows);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	swapChain.imageCount 			= imageCount;
+	swapChain.pImages 				= pImages;
+	swapChain.width 				= width;
+	swapChain.height 				= height;
+	swapChain.stride 				= swapChain.memoryRequirements.stride;
+	swapChain.padRows 				= padRows;
+	swapChain.format 				= format;
+	swapChain.pImageStart 			= pImageStart;
+	swapChain.pImageEnd 			= pImageStart;
+	swapChain.pCurrentImage			= pImages;
+	swapChain.imageIndex			= 0;
+	*pOutSwapChain = swapChain;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_internal void ksr2_init_draw_command_chunk(ksr2_draw_command_chunk* pChunk, size_t chunkSizeInBytes, ksr2_b32 fromChunkAllocator)
+{
+	ksr2_init_fourcc(pChunk->fourcc, "KR2D");
+	pChunk->pNext 				= ksr2_nullptr;
+	pChunk->sizeInBytes 		= 0u;
+	pChunk->capacityInBytes 	= (ksr2_u32)(chunkSizeInBytes - sizeof(ksr2_draw_command_chunk));
+	pChunk->fromChunkAllocator 	= fromChunkAllocator;
+}
+
+//FK: Deferred command lists only allocate from their own memory, the context and its chunk allocator are left alone.
+ksr2_internal ksr2_result ksr2_allocate_draw_command_chunk(ksr2_draw_command_chunk** pOutChunk, ksr2_command_list* pCommandList, size_t minCapacityInBytes)
+{
+	ksr2_context* pContext = pCommandList->pContext;
+	ksr2_draw_command_chunk* pChunk = ksr2_nullptr;
+	ksr2_linear_allocator* pAllocator = &pCommandList->allocator;
+	size_t allocatorCapacityInBytes = 0u;
+
+	if (pCommandList->isDeferred)
+	{
+		allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+	}
+	else
+	{
+		//FK: The back of the linear allocator is only used once the chunk allocator of the application can't keep up
+		if (pContext->allocateChunkFnc != ksr2_nullptr && K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES >= sizeof(ksr2_draw_command_chunk) + minCapacityInBytes)
+		{
+			pChunk = (ksr2_draw_command_chunk*)pContext->allocateChunkFnc(pContext->pChunkAllocatorUserData, K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES);
+
+			if (pChunk != ksr2_nullptr)
+			{
+				ksr2_init_draw_command_chunk(pChunk, K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES, ksr2_true);
+				*pOutChunk = pChunk;
+
+				return K15_RENDERER_2D_RESULT_SUCCESS;
+			}
+		}
+
+		pAllocator = &pContext->allocator;
+		allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+
+		if (pContext->flags & K15_RENDERER_2D_FLUSH_WHEN_FULL)
+		{
+			//FK: Leave at least as much memory as the draw commands take up to bin them once they get flushed,
+			//	  otherwise the flush would have to issue every draw command for the whole image.
+			const size_t drawCommandMemorySizeInBytes = pCommandList->drawCommandStream.memorySizeInBytes;
+			allocatorCapacityInBytes = allocatorCapacityInBytes > drawCommandMemorySizeInBytes ? (allocatorCapacityInBytes - drawCommandMemorySizeInBytes) / 2u : 0u;
+		}
+	}
+
+	//FK: Use up whatever is left if there's not enough memory for a whole chunk, minus what aligning it might cost
+	size_t chunkSizeInBytes = K15_RENDERER_2D_DRAW_COMMAND_CHUNK_SIZE_IN_BYTES;
+	if (chunkSizeInBytes > allocatorCapacityInBytes)
+	{
+		chunkSizeInBytes = (allocatorCapacityInBytes - ksr2_min(allocatorCapacityInBytes, ksr2_default_alignment - 1u)) & ~(ksr2_default_alignment - 1u);
+	}
+
+	if (chunkSizeInBytes < sizeof(ksr2_draw_command_chunk) + minCapacityInBytes)
+	{
+		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+	}
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_back((void**)&pChunk, pAllocator, chunkSizeInBytes, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_init_draw_command_chunk(pChunk, chunkSizeInBytes, ksr2_false);
+	*pOutChunk = pChunk;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_internal void ksr2_reset_draw_command_stream(ksr2_draw_command_stream* pStream)
+{
+	pStream->pFirstChunk 		= ksr2_nullptr;
+	pStream->pLastChunk 		= ksr2_nullptr;
+	pStream->drawCommandCount 	= 0u;
+	pStream->memorySizeInBytes 	= 0u;
+}
+
+//FK: Hands the chunks of the application back before resetting the stream, the back of the linear allocator needs to be reset separately.
+//	  Chunks of submitted command lists belong to them.
+ksr2_internal void ksr2_release_draw_command_stream(ksr2_context* pContext)
+{
+	ksr2_draw_command_chunk* pChunk = pContext->commandList.drawCommandStream.pFirstChunk;
+
+	while (pChunk != ksr2_nullptr)
+	{
+		ksr2_draw_command_chunk* pNextChunk = pChunk->pNext;
+
+		if (pChunk->fromChunkAllocator && pContext->freeChunkFnc != ksr2_nullptr)
+		{
+			pContext->freeChunkFnc(pContext->pChunkAllocatorUserData, pChunk);
+		}
+
+		pChunk = pNextChunk;
+	}
+
+	ksr2_reset_draw_command_stream(&pContext->commandList.drawCommandStream);
+}
+
+//FK: Links the chunks of pAppendedStream to the end of pStream, pAppendedStream needs to be reset afterwards.
+ksr2_internal void ksr2_append_draw_command_stream(ksr2_draw_command_stream* pStream, const ksr2_draw_command_stream* pAppendedStream)
+{
+	if (pAppendedStream->pFirstChunk == ksr2_nullptr)
+	{
+		return;
+	}
+
+	if (pStream->pLastChunk == ksr2_nullptr)
+	{
+		pStream->pFirstChunk = pAppendedStream->pFirstChunk;
+	}
+	else
+	{
+		pStream->pLastChunk->pNext = pAppendedStream->pFirstChunk;
+	}
+
+	pStream->pLastChunk 		= pAppendedStream->pLastChunk;
+	pStream->drawCommandCount 	+= pAppendedStream->drawCommandCount;
+	pStream->memorySizeInBytes 	+= pAppendedStream->memorySizeInBytes;
+}
+
+//FK: Defined next to ksr2_blit as it shares the rasterization with it.
+ksr2_internal void ksr2_flush_draw_commands(ksr2_context* pContext);
+
+//FK: Makes sure that at least minSizeInBytes of draw commands fit into the last chunk of the draw command stream. Returns
+//	  where the next draw command goes and how many bytes are left in the chunk, see ksr2_commit_draw_command_memory().
+ksr2_internal ksr2_result ksr2_reserve_draw_command_memory(ksr2_byte** pOutMemory, ksr2_u32* pOutCapacityInBytes, ksr2_command_list* pCommandList, size_t minSizeInBytes)
+{
+	ksr2_context* pContext = pCommandList->pContext;
+	ksr2_draw_command_stream* pStream = &pCommandList->drawCommandStream;
+	ksr2_draw_command_chunk* pChunk = pStream->pLastChunk;
+
+	if (pChunk == ksr2_nullptr || pChunk->capacityInBytes - pChunk->sizeInBytes < minSizeInBytes)
+	{
+		//FK: deferred command lists get recorded on other threads, they must not touch the context. The command lists of
+		//	  K15_RENDERER_2D_ASYNC_BLIT_FLAG are deferred as well but belong to the thread that records into the context.
+		const ksr2_b32 recordsIntoContext = pCommandList == pContext->pRecordCommandList;
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+		//FK: the first draw command of a frame always needs a new chunk
+		if (pChunk == ksr2_nullptr && recordsIntoContext && pContext->recordStartTimeInNs == 0u)
+		{
+			pContext->recordStartTimeInNs = ksr2_get_timestamp_in_ns(pContext);
+		}
+#endif
+
+		ksr2_result result = ksr2_allocate_draw_command_chunk(&pChunk, pCommandList, minSizeInBytes);
+
+		if (result == K15_RENDERER_2D_RESULT_OUT_OF_MEMORY && recordsIntoContext && (pContext->flags & K15_RENDERER_2D_FLUSH_WHEN_FULL) && pStream->pFirstChunk != ksr2_nullptr)
+		{
+			//FK: All draw commands recorded so far are complete, make room for the new ones by rasterizing them right away
+			ksr2_flush_draw_commands(pContext);
+			result = ksr2_allocate_draw_command_chunk(&pChunk, pCommandList, minSizeInBytes);
+		}
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		if (pStream->pLastChunk == ksr2_nullptr)
+		{
+			pStream->pFirstChunk = pChunk;
+		}
+		else
+		{
+			pStream->pLastChunk->pNext = pChunk;
+		}
+
+		pStream->pLastChunk 		= pChunk;
+		pStream->memorySizeInBytes 	+= sizeof(ksr2_draw_command_chunk) + pChunk->capacityInBytes;
+
+		if (recordsIntoContext)
+		{
+			pContext->drawCommandMemoryHighWaterMarkInBytes = ksr2_max(pContext->drawCommandMemoryHighWaterMarkInBytes, pStream->memorySizeInBytes);
+		}
+	}
+
+	*pOutMemory 			= (ksr2_byte*)(pChunk + 1) + pChunk->sizeInBytes;
+	*pOutCapacityInBytes 	= pChunk->capacityInBytes - pChunk->sizeInBytes;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: Appends the draw commands that got written to the reserved memory to the draw command stream.
+ksr2_internal void ksr2_commit_draw_command_memory(ksr2_command_list* pCommandList, ksr2_u32 sizeInBytes, ksr2_u32 drawCommandCount)
+{
+	ksr2_draw_command_stream* pStream = &pCommandList->drawCommandStream;
+	pStream->pLastChunk->sizeInBytes 	+= sizeInBytes;
+	pStream->drawCommandCount 			+= drawCommandCount;
+}
+
+ksr2_internal void ksr2_init_draw_command_header(ksr2_draw_command_header* pHeader, size_t sizeInBytes, ksr2_draw_command_type type, ksr2_blend_mode blendMode)
+{
+	pHeader->type 			= (ksr2_u8)type;
+	pHeader->flags 			= (ksr2_u8)blendMode;
+	pHeader->sizeInBytes 	= (ksr2_u16)sizeInBytes;
+}
+
+//FK: sizeInBytes includes the header. Draw commands are appended to the draw command stream right away.
+ksr2_internal ksr2_result ksr2_allocate_draw_command(void** pOutDrawCommand, ksr2_command_list* pCommandList, size_t sizeInBytes, ksr2_draw_command_type type, ksr2_blend_mode blendMode)
+{
+	ksr2_assert(sizeInBytes % 4u == 0u);
+
+	ksr2_byte* pMemory = ksr2_nullptr;
+	ksr2_u32 capacityInBytes = 0u;
+	ksr2_result result = ksr2_reserve_draw_command_memory(&pMemory, &capacityInBytes, pCommandList, sizeInBytes);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_draw_command_header* pHeader = (ksr2_draw_command_header*)pMemory;
+	ksr2_init_draw_command_header(pHeader, sizeInBytes, type, blendMode);
+	ksr2_commit_draw_command_memory(pCommandList, (ksr2_u32)sizeInBytes, 1u);
+
+	*pOutDrawCommand = pHeader;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_internal void ksr2_init_draw_command_iterator(ksr2_draw_command_iterator* pOutIterator, const ksr2_draw_command_stream* pStream)
+{
+	pOutIterator->pChunk 		= pStream->pFirstChunk;
+	pOutIterator->offsetInBytes = 0u;
+}
+
+//FK: Returns the draw commands in submission order, ksr2_nullptr once the end of the stream has been reached
+ksr2_internal const ksr2_draw_command_header* ksr2_next_draw_command(ksr2_draw_command_iterator* pIterator)
+{
+	while (pIterator->pChunk != ksr2_nullptr)
+	{
+#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
+		if (ksr2_check_fourcc((char*)pIterator->pChunk->fourcc, "KR2D") == ksr2_false)
+		{
+			return ksr2_nullptr;
+		}
+#endif
+
+		if (pIterator->offsetInBytes < pIterator->pChunk->sizeInBytes)
+		{
+			const ksr2_draw_command_header* pHeader = (const ksr2_draw_command_header*)((const ksr2_byte*)(pIterator->pChunk + 1) + pIterator->offsetInBytes);
+			pIterator->offsetInBytes += pHeader->sizeInBytes;
+
+			return pHeader;
+		}
+
+		pIterator->pChunk 		 = pIterator->pChunk->pNext;
+		pIterator->offsetInBytes = 0u;
+	}
+
+	return ksr2_nullptr;
+}
+
+ksr2_internal void ksr2_decode_line_draw_command(ksr2_line* pOutLine, const ksr2_draw_command_header* pHeader)
+{
+	if (pHeader->type == K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE)
+	{
+		const ksr2_wide_line_draw_command* pDrawCommand = (const ksr2_wide_line_draw_command*)pHeader;
+		pOutLine->x1 		= pDrawCommand->x1;
+		pOutLine->y1 		= pDrawCommand->y1;
+		pOutLine->x2 		= pDrawCommand->x2;
+		pOutLine->y2 		= pDrawCommand->y2;
+		pOutLine->thickness = pDrawCommand->thickness;
+		pOutLine->color 	= pDrawCommand->color;
+	}
+	else
+	{
+		const ksr2_line_draw_command* pDrawCommand = (const ksr2_line_draw_command*)pHeader;
+		pOutLine->x1 		= pDrawCommand->x1;
+		pOutLine->y1 		= pDrawCommand->y1;
+		pOutLine->x2 		= pDrawCommand->x2;
+		pOutLine->y2 		= pDrawCommand->y2;
+		pOutLine->thickness = pDrawCommand->thickness;
+		pOutLine->color 	= pDrawCommand->color;
+	}
+}
+
+ksr2_internal void ksr2_decode_filled_rect_draw_command(ksr2_rect* pOutRect, ksr2_pixel_color* pOutColor, const ksr2_draw_command_header* pHeader)
+{
+	if (pHeader->type == K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE)
+	{
+		const ksr2_wide_filled_rect_draw_command* pDrawCommand = (const ksr2_wide_filled_rect_draw_command*)pHeader;
+		pOutRect->x1 	= pDrawCommand->x1;
+		pOutRect->y1 	= pDrawCommand->y1;
+		pOutRect->x2 	= pDrawCommand->x2;
+		pOutRect->y2 	= pDrawCommand->y2;
+		*pOutColor 		= pDrawCommand->color;
+	}
+	else
+	{
+		const ksr2_filled_rect_draw_command* pDrawCommand = (const ksr2_filled_rect_draw_command*)pHeader;
+		pOutRect->x1 	= pDrawCommand->x1;
+		pOutRect->y1 	= pDrawCommand->y1;
+		pOutRect->x2 	= pDrawCommand->x2;
+		pOutRect->y2 	= pDrawCommand->y2;
+		*pOutColor 		= pDrawCommand->color;
+	}
+}
+
+ksr2_internal void ksr2_end_non_temporal_stores()
+{
+#ifdef K15_RENDERER_2D_SSE2
+	_mm_sfence();
+#endif
+}
+
+//FK: exact x / 255 for x in [0, 255 * 255]
+ksr2_internal ksr2_u32 ksr2_div255(ksr2_u32 value)
+{
+	value += 128u;
+	return (value + (value >> 8u)) >> 8u;
+}
+
+//FK: Coverage of a pixel from the signed area the edges of a path left in it, K15_RENDERER_2D_FIXED_POINT_ONE is a whole pixel.
+//	  Even-odd coverage folds the area back and forth between 0 and 1, so windings of 2 are uncovered again.
+ksr2_internal ksr2_u32 ksr2_get_path_coverage(ksr2_s32 area, ksr2_fill_rule fillRule)
+{
+	ksr2_u32 coverage = area < 0 ? 0u - (ksr2_u32)area : (ksr2_u32)area;
+
+	if (fillRule == K15_RENDERER_2D_FILL_RULE_EVEN_ODD)
+	{
+		coverage &= 2u * K15_RENDERER_2D_FIXED_POINT_ONE - 1u;
+		coverage = coverage > K15_RENDERER_2D_FIXED_POINT_ONE ? 2u * K15_RENDERER_2D_FIXED_POINT_ONE - coverage : coverage;
+	}
+	else
+	{
+		coverage = ksr2_min(coverage, (ksr2_u32)K15_RENDERER_2D_FIXED_POINT_ONE);
+	}
+
+	return (coverage * 255u + K15_RENDERER_2D_FIXED_POINT_ONE / 2u) >> K15_RENDERER_2D_FIXED_POINT_BITS;
+}
+
+ksr2_internal ksr2_pixel_color ksr2_blend_pixel(ksr2_pixel_color pixel, const ksr2_blend_operand* pOperand)
+{
+	ksr2_pixel_color result = 0u;
+
+	for (ksr2_u32 shift = 0u; shift < 32u; shift += 8u)
+	{
+		const ksr2_u32 channel 	= (pixel >> shift) & 0xFFu;
+		const ksr2_u32 scale 	= (pOperand->scale >> shift) & 0xFFu;
+		const ksr2_u32 add 		= (pOperand->add >> shift) & 0xFFu;
+		const ksr2_u32 value 	= ksr2_div255(channel * scale) + add;
+
+		result |= (value > 0xFFu ? 0xFFu : value) << shift;
+	}
+
+	return result;
+}
+
+#ifdef K15_RENDERER_2D_SSE2
+ksr2_internal __m128i ksr2_div255_sse2(__m128i value)
+{
+	value = _mm_add_epi16(value, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+#endif
+ksr2_force_inline ksr2_u32 ksr2_get_alpha_shift(ksr2_pixel_format format)
+{
+	return format == K15_RENDERER_2D_PIXEL_FORMAT_ARGB ? 24u : 0u;
+}
+
+//FK: color is the color stored in the draw command, see ksr2_resolve_blend_color()
+ksr2_internal void ksr2_init_blend_operand(ksr2_blend_operand* pOutOperand, ksr2_pixel_color color, ksr2_blend_mode blendMode, ksr2_pixel_format format)
+{
+	pOutOperand->blendMode = blendMode;
+
+	switch(blendMode)
+	{
+		case K15_RENDERER_2D_BLEND_MODE_ALPHA:
+		{
+			const ksr2_u32 inverseAlpha = 0xFFu - ((color >> ksr2_get_alpha_shift(format)) & 0xFFu);
+			pOutOperand->add 	= color;
+			pOutOperand->scale 	= inverseAlpha * 0x01010101u;
+			break;
+		}
+
+		case K15_RENDERER_2D_BLEND_MODE_ADDITIVE:
+			pOutOperand->add 	= color;
+			pOutOperand->scale 	= 0xFFFFFFFFu;
+		break;
+
+		case K15_RENDERER_2D_BLEND_MODE_MULTIPLY:
+			pOutOperand->add 	= 0u;
+			pOutOperand->scale 	= color;
+		break;
+
+		default:
+			pOutOperand->add 	= color;
+			pOutOperand->scale 	= 0u;
+		break;
+	}
+}
+
+//FK: Image pixels carry their own (premultiplied) alpha, so the operand is different for every pixel.
+//	  A premultiplied channel is never bigger than its alpha, so color + inverse alpha can't overflow.
+ksr2_force_inline void ksr2_init_image_blend_operand(ksr2_blend_operand* pOutOperand, ksr2_pixel_color sourcePixel, ksr2_blend_mode blendMode, ksr2_u32 alphaShift)
+{
+	const ksr2_u32 inverseAlpha = (0xFFu - ((sourcePixel >> alphaShift) & 0xFFu)) * 0x01010101u;
+	pOutOperand->blendMode = blendMode;
+
+	switch(blendMode)
+	{
+		case K15_RENDERER_2D_BLEND_MODE_ADDITIVE:
+			pOutOperand->add 	= sourcePixel;
+			pOutOperand->scale 	= 0xFFFFFFFFu;
+		break;
+
+		case K15_RENDERER_2D_BLEND_MODE_MULTIPLY:
+			pOutOperand->add 	= 0u;
+			pOutOperand->scale 	= sourcePixel + inverseAlpha;
+		break;
+
+		default:
+			pOutOperand->add 	= sourcePixel;
+			pOutOperand->scale 	= inverseAlpha;
+		break;
+	}
+}
+
+//FK: Nearest neighbor upscaling of a texture row. firstTexelRepeatCount is the number of pixels the first texel still covers.
+ksr2_internal void ksr2_expand_image_span(ksr2_pixel_color* pOutPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_u32 scale, ksr2_u32 firstTexelRepeatCount)
+{
+	ksr2_pixel_color* pPixelsEnd = pOutPixels + pixelCount;
+	ksr2_u32 repeatCount = firstTexelRepeatCount;
+
+	while(pOutPixels < pPixelsEnd)
+	{
+		const ksr2_u32 texelPixelCount = ksr2_min(repeatCount, (ksr2_u32)(pPixelsEnd - pOutPixels));
+		const ksr2_pixel_color texel = *pSourcePixels++;
+
+		for (ksr2_u32 pixelIndex = 0u; pixelIndex < texelPixelCount; ++pixelIndex)
+		{
+			pOutPixels[pixelIndex] = texel;
+		}
+
+		pOutPixels += texelPixelCount;
+		repeatCount = scale;
+	}
+}
+
+ksr2_internal void ksr2_init_render_target(ksr2_render_target* pOutTarget, const ksr2_context* pContext, void* pImage)
+{
+	pOutTarget->pPixels 			= (ksr2_byte*)pImage;
+	pOutTarget->pKernels 			= &pContext->kernels;
+	pOutTarget->pixelSizeInBytes 	= (ksr2_u32)ksr2_get_pixel_size_in_bytes(pContext->swapChain.format);
+	pOutTarget->stride 				= pContext->swapChain.stride * pOutTarget->pixelSizeInBytes;
+	pOutTarget->format 				= pContext->swapChain.format;
+}
+
+ksr2_internal ksr2_byte* ksr2_get_render_target_address(const ksr2_render_target* pTarget, ksr2_u32 x, ksr2_u32 y)
+{
+	return pTarget->pPixels + (size_t)x * pTarget->pixelSizeInBytes + (size_t)y * pTarget->stride;
+}
+
+ksr2_internal ksr2_u32 ksr2_get_luma(ksr2_pixel_color color)
+{
+	return (77u * (color >> 24u) + 150u * ((color >> 16u) & 0xFFu) + 29u * ((color >> 8u) & 0xFFu) + 128u) >> 8u;
+}
+
+ksr2_internal ksr2_u32 ksr2_expand_5_bit(ksr2_u32 value)
+{
+	return (value << 3u) | (value >> 2u);
+}
+
+ksr2_internal ksr2_u32 ksr2_expand_6_bit(ksr2_u32 value)
+{
+	return (value << 2u) | (value >> 4u);
+}
+
+//FK: Converts an RGBA color to the value of a pixel in the given format, channels with less than 8 bit get rounded down.
+ksr2_force_inline ksr2_u32 ksr2_pack_pixel(ksr2_pixel_color color, ksr2_pixel_format format)
+{
+	switch(format)
+	{
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+			return (color >> 8u) | (color << 24u);
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			return (color & 0x00FF00FFu) | ((color >> 16u) & 0xFF00u) | ((color << 16u) & 0xFF000000u);
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			return ((color >> 16u) & 0xF800u) | ((color >> 13u) & 0x07E0u) | ((color >> 11u) & 0x001Fu);
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+			return color & 0xFFu;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			return ksr2_get_luma(color);
+
+		default:
+			return color;
+	}
+}
+
+//FK: Converts the value of a pixel in the given format to an RGBA color, see ksr2_convert_pixels().
+ksr2_force_inline ksr2_pixel_color ksr2_unpack_pixel(ksr2_u32 value, ksr2_pixel_format format)
+{
+	switch(format)
+	{
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+			return (value << 8u) | (value >> 24u);
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			return (value & 0x00FF00FFu) | ((value >> 16u) & 0xFF00u) | ((value << 16u) & 0xFF000000u);
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			return ksr2_expand_5_bit((value >> 11u) & 0x1Fu) << 24u | ksr2_expand_6_bit((value >> 5u) & 0x3Fu) << 16u | ksr2_expand_5_bit(value & 0x1Fu) << 8u | 0xFFu;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+			return (value & 0xFFu) * 0x01010101u;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			return (value & 0xFFu) * 0x01010100u | 0xFFu;
+
+		default:
+			return value;
+	}
+}
+
+//FK: See ksr2_get_color_format(), swap chains with less than 32 bit per pixel use RGBA colors.
+ksr2_pixel_color ksr2_convert_to_pixel_format(ksr2_rgba_color color, ksr2_pixel_format format)
+{
+	if (format == K15_RENDERER_2D_PIXEL_FORMAT_ARGB)
+	{
+			return (ksr2_pixel_color)( (ksr2_u32)color.a << 24u |
+								(ksr2_u32)color.r << 16u |
+								(ksr2_u32)color.g <<  8u |
+								(ksr2_u32)color.b <<  0u );
+	}
+
+	if (format == K15_RENDERER_2D_PIXEL_FORMAT_BGRA)
+	{
+			return (ksr2_pixel_color)( (ksr2_u32)color.b << 24u |
+								(ksr2_u32)color.g << 16u |
+								(ksr2_u32)color.r <<  8u |
+								(ksr2_u32)color.a <<  0u );
+	}
+
+	return (ksr2_pixel_color)( (ksr2_u32)color.r << 24u |
+							(ksr2_u32)color.g << 16u |
+							(ksr2_u32)color.b <<  8u |
+							(ksr2_u32)color.a <<  0u );
+}
+
+//FK: The kernels live at the end of the file and get compiled once per CPU level by including this file again,
+//	  ksr2_select_pixel_kernels() binds the ones of the level ksr2_init_context picked.
+#define ksr2_paste_kernel_name(name, suffix) name##_##suffix
+#define ksr2_kernel_name_with_suffix(name, suffix) ksr2_paste_kernel_name(name, suffix)
+#define ksr2_kernel_name(name) ksr2_kernel_name_with_suffix(name, K15_RENDERER_2D_KERNEL_SUFFIX)
+
+#define K15_RENDERER_2D_KERNEL_PASS
+#ifdef K15_RENDERER_2D_CPU_DISPATCH
+#	pragma push_macro("K15_RENDERER_2D_SSE2")
+#	pragma push_macro("K15_RENDERER_2D_AVX2")
+#	pragma push_macro("K15_RENDERER_2D_AVX512")
+#	undef K15_RENDERER_2D_SSE2
+#	undef K15_RENDERER_2D_AVX2
+#	undef K15_RENDERER_2D_AVX512
+
+#	define K15_RENDERER_2D_KERNEL_SUFFIX scalar
+#	include K15_RENDERER_2D_KERNEL_FILE
+#	undef K15_RENDERER_2D_KERNEL_SUFFIX
+
+#	define K15_RENDERER_2D_SSE2
+#	define K15_RENDERER_2D_KERNEL_SUFFIX sse2
+#	include K15_RENDERER_2D_KERNEL_FILE
+#	undef K15_RENDERER_2D_KERNEL_SUFFIX
+
+//FK: MSVC doesn't need a target to use the intrinsics of a higher level
+#	define K15_RENDERER_2D_AVX2
+#	define K15_RENDERER_2D_KERNEL_SUFFIX avx2
+#	if defined(__clang__)
+#		pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#	elif defined(__GNUC__)
+#		pragma GCC push_options
+#		pragma GCC target("avx2")
+#	endif
+#	include K15_RENDERER_2D_KERNEL_FILE
+#	if defined(__clang__)
+#		pragma clang attribute pop
+#	elif defined(__GNUC__)
+#		pragma GCC pop_options
+#	endif
+#	undef K15_RENDERER_2D_KERNEL_SUFFIX
+
+#	define K15_RENDERER_2D_AVX512
+#	define K15_RENDERER_2D_KERNEL_SUFFIX avx512
+#	if defined(__clang__)
+#		pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512bw"))), apply_to = function)
+#	elif defined(__GNUC__)
+#		pragma GCC push_options
+#		pragma GCC target("avx2,avx512f,avx512bw")
+#	endif
+#	include K15_RENDERER_2D_KERNEL_FILE
+#	if defined(__clang__)
+#		pragma clang attribute pop
+#	elif defined(__GNUC__)
+#		pragma GCC pop_options
+#	endif
+#	undef K15_RENDERER_2D_KERNEL_SUFFIX
+
+#	pragma pop_macro("K15_RENDERER_2D_SSE2")
+#	pragma pop_macro("K15_RENDERER_2D_AVX2")
+#	pragma pop_macro("K15_RENDERER_2D_AVX512")
+#else
+#	define K15_RENDERER_2D_KERNEL_SUFFIX native //FK: just the SIMD level the renderer got compiled for
+#	include K15_RENDERER_2D_KERNEL_FILE
+#	undef K15_RENDERER_2D_KERNEL_SUFFIX
+#endif
+#undef K15_RENDERER_2D_KERNEL_PASS
+
+//FK: color is in the format of ksr2_get_color_format()
+ksr2_internal void ksr2_fill_rect(const ksr2_render_target* pTarget, const ksr2_rect* pRect, ksr2_pixel_color color, ksr2_b32 nonTemporal)
+{
+	if (pRect->x1 >= pRect->x2 || pRect->y1 >= pRect->y2)
+	{
+		return;
+	}
+
+	const ksr2_fill_span_fnc fillSpan = nonTemporal ? pTarget->pKernels->fillSpanNonTemporal : pTarget->pKernels->fillSpan;
+	const ksr2_u32 pixelCount = pRect->x2 - pRect->x1;
+	ksr2_byte* pRow = ksr2_get_render_target_address(pTarget, pRect->x1, pRect->y1);
+
+	for (ksr2_u32 y = pRect->y1; y < pRect->y2; ++y)
+	{
+		fillSpan(pTarget, pRow, pixelCount, color);
+		pRow += pTarget->stride;
+	}
+
+	if (nonTemporal)
+	{
+		ksr2_end_non_temporal_stores();
+	}
+}
+
+ksr2_internal void ksr2_paint_rect(const ksr2_render_target* pTarget, const ksr2_rect* pRect, const ksr2_blend_operand* pOperand, ksr2_b32 nonTemporal)
+{
+	if (pOperand->blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+	{
+		ksr2_fill_rect(pTarget, pRect, pOperand->add, nonTemporal);
+		return;
+	}
+
+	if (pRect->x1 >= pRect->x2 || pRect->y1 >= pRect->y2)
+	{
+		return;
+	}
+
+	const ksr2_paint_span_fnc paintSpan = pTarget->pKernels->paintSpan[pOperand->blendMode];
+	const ksr2_u32 pixelCount = pRect->x2 - pRect->x1;
+	ksr2_byte* pRow = ksr2_get_render_target_address(pTarget, pRect->x1, pRect->y1);
+
+	for (ksr2_u32 y = pRect->y1; y < pRect->y2; ++y)
+	{
+		paintSpan(pTarget, pRow, pixelCount, pOperand);
+		pRow += pTarget->stride;
+	}
+}
+
+//FK: Copies don't care about the format, just about the size of the pixels.
+ksr2_internal void ksr2_copy_rect(const ksr2_render_target* pTarget, const ksr2_byte* pSourcePixels, const ksr2_rect* pRect)
+{
+	const size_t rowOffset 			= (size_t)(ksr2_get_render_target_address(pTarget, pRect->x1, pRect->y1) - pTarget->pPixels);
+	const size_t rowSizeInBytes 	= (size_t)(pRect->x2 - pRect->x1) * pTarget->pixelSizeInBytes;
+	const ksr2_copy_bytes_fnc copyBytes = pTarget->pKernels->copyBytes;
+	ksr2_byte* pRow = pTarget->pPixels + rowOffset;
+	const ksr2_byte* pSourceRow = pSourcePixels + rowOffset;
+
+	for (ksr2_u32 y = pRect->y1; y < pRect->y2; ++y)
+	{
+		copyBytes(pRow, pSourceRow, rowSizeInBytes);
+		pRow 		+= pTarget->stride;
+		pSourceRow 	+= pTarget->stride;
+	}
+}
+
+ksr2_internal void ksr2_clip_rect(ksr2_rect* pOutRect, const ksr2_rect* pRect, const ksr2_rect* pClipRect)
+{
+	pOutRect->x1 = pRect->x1 > pClipRect->x1 ? pRect->x1 : pClipRect->x1;
+	pOutRect->y1 = pRect->y1 > pClipRect->y1 ? pRect->y1 : pClipRect->y1;
+	pOutRect->x2 = pRect->x2 < pClipRect->x2 ? pRect->x2 : pClipRect->x2;
+	pOutRect->y2 = pRect->y2 < pClipRect->y2 ? pRect->y2 : pClipRect->y2;
+}
+
+ksr2_internal size_t ksr2_get_rect_pixel_count(const ksr2_rect* pRect)
+{
+	if (pRect->x1 >= pRect->x2 || pRect->y1 >= pRect->y2)
+	{
+		return 0u;
+	}
+
+	return (size_t)(pRect->x2 - pRect->x1) * (pRect->y2 - pRect->y1);
+}
+
+//FK: Non temporal stores only pay off if the whole fill doesn't fit into the cache anyway and no later draw command reads the pixels back.
+ksr2_internal ksr2_b32 ksr2_use_non_temporal_stores(const ksr2_render_target* pTarget, const ksr2_rect* pRect, ksr2_b32 isLastDrawCommand)
+{
+	const size_t fillSizeInBytes = (size_t)(pRect->x2 - pRect->x1) * (size_t)(pRect->y2 - pRect->y1) * pTarget->pixelSizeInBytes;
+	return isLastDrawCommand && fillSizeInBytes >= K15_RENDERER_2D_NON_TEMPORAL_FILL_THRESHOLD_IN_BYTES;
+}
+
+ksr2_internal ksr2_s32 ksr2_fixed_ceil_to_int(ksr2_s64 value)
+{
+	return (ksr2_s32)((value + K15_RENDERER_2D_FIXED_POINT_ONE - 1) >> K15_RENDERER_2D_FIXED_POINT_BITS);
+}
+
+ksr2_internal ksr2_s64 ksr2_double_to_fixed(double value)
+{
+	return (ksr2_s64)(value * (double)K15_RENDERER_2D_FIXED_POINT_ONE);
+}
+
+ksr2_internal size_t ksr2_paint_signed_rect(const ksr2_render_target* pTarget, const ksr2_rect* pClipRect, ksr2_s32 x1, ksr2_s32 y1, ksr2_s32 x2, ksr2_s32 y2, const ksr2_blend_operand* pOperand)
+{
+	ksr2_rect rect = {0};
+	rect.x1 = x1 > (ksr2_s32)pClipRect->x1 ? (ksr2_u32)x1 : pClipRect->x1;
+	rect.y1 = y1 > (ksr2_s32)pClipRect->y1 ? (ksr2_u32)y1 : pClipRect->y1;
+	rect.x2 = x2 < (ksr2_s32)pClipRect->x2 ? (ksr2_u32)(x2 > 0 ? x2 : 0) : pClipRect->x2;
+	rect.y2 = y2 < (ksr2_s32)pClipRect->y2 ? (ksr2_u32)(y2 > 0 ? y2 : 0) : pClipRect->y2;
+
+	ksr2_paint_rect(pTarget, &rect, pOperand, ksr2_false);
+
+	return ksr2_get_rect_pixel_count(&rect);
+}
+
+typedef struct
+{
+	ksr2_s64 x;
+	ksr2_s64 y;
+} ksr2_fixed_point;
+
+typedef struct
+{
+	const ksr2_fixed_point* 	pVertices;
+	ksr2_s64					slope;
+	ksr2_u32					vertexIndex;
+	ksr2_s32					step;
+} ksr2_polygon_edge_walker;
+
+ksr2_internal void ksr2_update_polygon_edge_walker_slope(ksr2_polygon_edge_walker* pWalker)
+{
+	const ksr2_fixed_point* pStart 	= &pWalker->pVertices[pWalker->vertexIndex];
+	const ksr2_fixed_point* pEnd 	= &pWalker->pVertices[(pWalker->vertexIndex + 4u + pWalker->step) % 4u];
+	const ksr2_s64 edgeHeight 		= pEnd->y - pStart->y;
+
+	//FK: multiplied instead of shifted, edges that go left have a negative width
+	pWalker->slope = edgeHeight > 0 ? ((pEnd->x - pStart->x) * ((ksr2_s64)1 << K15_RENDERER_2D_FIXED_POINT_BITS)) / edgeHeight : 0;
+}
+
+ksr2_internal void ksr2_init_polygon_edge_walker(ksr2_polygon_edge_walker* pWalker, const ksr2_fixed_point* pVertices, ksr2_u32 topVertexIndex, ksr2_s32 step)
+{
+	pWalker->pVertices 		= pVertices;
+	pWalker->vertexIndex 	= topVertexIndex;
+	pWalker->step			= step;
+
+	ksr2_update_polygon_edge_walker_slope(pWalker);
+}
+
+ksr2_internal void ksr2_advance_polygon_edge_walker(ksr2_polygon_edge_walker* pWalker, ksr2_s64 sampleY, ksr2_u32 bottomVertexIndex)
+{
+	ksr2_b32 edgeChanged = ksr2_false;
+	ksr2_u32 nextVertexIndex = (pWalker->vertexIndex + 4u + pWalker->step) % 4u;
+
+	while(pWalker->vertexIndex != bottomVertexIndex && sampleY >= pWalker->pVertices[nextVertexIndex].y)
+	{
+		pWalker->vertexIndex 	= nextVertexIndex;
+		nextVertexIndex 		= (pWalker->vertexIndex + 4u + pWalker->step) % 4u;
+		edgeChanged				= ksr2_true;
+	}
+
+	if (edgeChanged)
+	{
+		ksr2_update_polygon_edge_walker_slope(pWalker);
+	}
+}
+
+ksr2_internal ksr2_s64 ksr2_get_polygon_edge_walker_x(const ksr2_polygon_edge_walker* pWalker, ksr2_s64 sampleY)
+{
+	const ksr2_fixed_point* pStart = &pWalker->pVertices[pWalker->vertexIndex];
+	return pStart->x + (((sampleY - pStart->y) * pWalker->slope) >> K15_RENDERER_2D_FIXED_POINT_BITS);
+}
+
+//FK: Pixel centers are sampled, a pixel gets filled if its center lies inside the polygon (top/left edges inclusive).
+//	  Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_rasterize_convex_quad(const ksr2_render_target* pTarget, const ksr2_rect* pClipRect, const ksr2_fixed_point* pVertices, const ksr2_blend_operand* pOperand)
+{
+	const ksr2_s64 halfPixel = K15_RENDERER_2D_FIXED_POINT_ONE / 2;
+
+	ksr2_u32 topVertexIndex 	= 0u;
+	ksr2_u32 bottomVertexIndex 	= 0u;
+
+	for (ksr2_u32 vertexIndex = 1u; vertexIndex < 4u; ++vertexIndex)
+	{
+		topVertexIndex 		= pVertices[vertexIndex].y < pVertices[topVertexIndex].y ? vertexIndex : topVertexIndex;
+		bottomVertexIndex 	= pVertices[vertexIndex].y > pVertices[bottomVertexIndex].y ? vertexIndex : bottomVertexIndex;
+	}
+
+	ksr2_s32 firstRow 	= ksr2_fixed_ceil_to_int(pVertices[topVertexIndex].y - halfPixel);
+	ksr2_s32 endRow 	= ksr2_fixed_ceil_to_int(pVertices[bottomVertexIndex].y - halfPixel);
+
+	firstRow 	= firstRow > (ksr2_s32)pClipRect->y1 ? firstRow : (ksr2_s32)pClipRect->y1;
+	endRow 		= endRow < (ksr2_s32)pClipRect->y2 ? endRow : (ksr2_s32)pClipRect->y2;
+
+	if (firstRow >= endRow)
+	{
+		return 0u;
+	}
+
+	//FK: walk down both sides of the polygon, starting at the top vertex
+	ksr2_polygon_edge_walker firstWalker;
+	ksr2_polygon_edge_walker secondWalker;
+	ksr2_init_polygon_edge_walker(&firstWalker, pVertices, topVertexIndex, 1);
+	ksr2_init_polygon_edge_walker(&secondWalker, pVertices, topVertexIndex, -1);
+
+	const ksr2_paint_span_fnc paintSpan = pTarget->pKernels->paintSpan[pOperand->blendMode];
+	ksr2_byte* pRow = ksr2_get_render_target_address(pTarget, 0u, (ksr2_u32)firstRow);
+	size_t writtenPixelCount = 0u;
+
+	for (ksr2_s32 y = firstRow; y < endRow; ++y)
+	{
+		const ksr2_s64 sampleY = ((ksr2_s64)y << K15_RENDERER_2D_FIXED_POINT_BITS) + halfPixel;
+
+		ksr2_advance_polygon_edge_walker(&firstWalker, sampleY, bottomVertexIndex);
+		ksr2_advance_polygon_edge_walker(&secondWalker, sampleY, bottomVertexIndex);
+
+		const ksr2_s64 firstX 	= ksr2_get_polygon_edge_walker_x(&firstWalker, sampleY);
+		const ksr2_s64 secondX 	= ksr2_get_polygon_edge_walker_x(&secondWalker, sampleY);
+
+		ksr2_s32 firstColumn 	= ksr2_fixed_ceil_to_int((firstX < secondX ? firstX : secondX) - halfPixel);
+		ksr2_s32 endColumn 		= ksr2_fixed_ceil_to_int((firstX < secondX ? secondX : firstX) - halfPixel);
+
+		firstColumn = firstColumn > (ksr2_s32)pClipRect->x1 ? firstColumn : (ksr2_s32)pClipRect->x1;
+		endColumn 	= endColumn < (ksr2_s32)pClipRect->x2 ? endColumn : (ksr2_s32)pClipRect->x2;
+
+		if (firstColumn < endColumn)
+		{
+			paintSpan(pTarget, pRow + (size_t)firstColumn * pTarget->pixelSizeInBytes, (ksr2_u32)(endColumn - firstColumn), pOperand);
+			writtenPixelCount += (size_t)(endColumn - firstColumn);
+		}
+
+		pRow += pTarget->stride;
+	}
+
+	return writtenPixelCount;
+}
+
+//FK: Integer coordinates address pixel centers. A line is rasterized as a rectangle of 'thickness' width 
+//	  around the segment, extended by half a pixel at both ends so that both end points get drawn.
+ksr2_internal size_t ksr2_rasterize_line(const ksr2_render_target* pTarget, const ksr2_rect* pClipRect, ksr2_s32 x1, ksr2_s32 y1, ksr2_s32 x2, ksr2_s32 y2, ksr2_u32 thickness, const ksr2_blend_operand* pOperand)
+{
+	const ksr2_s32 halfThickness = (ksr2_s32)(thickness / 2u);
+
+	if (y1 == y2)
+	{
+		const ksr2_s32 minX = x1 < x2 ? x1 : x2;
+		const ksr2_s32 maxX = x1 < x2 ? x2 : x1;
+		return ksr2_paint_signed_rect(pTarget, pClipRect, minX, y1 - halfThickness, maxX + 1, y1 - halfThickness + (ksr2_s32)thickness, pOperand);
+	}
+
+	if (x1 == x2)
+	{
+		const ksr2_s32 minY = y1 < y2 ? y1 : y2;
+		const ksr2_s32 maxY = y1 < y2 ? y2 : y1;
+		return ksr2_paint_signed_rect(pTarget, pClipRect, x1 - halfThickness, minY, x1 - halfThickness + (ksr2_s32)thickness, maxY + 1, pOperand);
+	}
+
+	const double deltaX 	= (double)(x2 - x1);
+	const double deltaY 	= (double)(y2 - y1);
+	const double length 	= sqrt(deltaX * deltaX + deltaY * deltaY);
+	const double normalX 	= -deltaY / length * (double)thickness * 0.5;
+	const double normalY 	= deltaX / length * (double)thickness * 0.5;
+	const double extendX 	= deltaX / length * 0.5;
+	const double extendY 	= deltaY / length * 0.5;
+
+	const double startX = (double)x1 + 0.5 - extendX;
+	const double startY = (double)y1 + 0.5 - extendY;
+	const double endX 	= (double)x2 + 0.5 + extendX;
+	const double endY 	= (double)y2 + 0.5 + extendY;
+
+	ksr2_fixed_point vertices[4];
+	vertices[0].x = ksr2_double_to_fixed(startX + normalX);
+	vertices[0].y = ksr2_double_to_fixed(startY + normalY);
+	vertices[1].x = ksr2_double_to_fixed(endX + normalX);
+	vertices[1].y = ksr2_double_to_fixed(endY + normalY);
+	vertices[2].x = ksr2_double_to_fixed(endX - normalX);
+	vertices[2].y = ksr2_double_to_fixed(endY - normalY);
+	vertices[3].x = ksr2_double_to_fixed(startX - normalX);
+	vertices[3].y = ksr2_double_to_fixed(startY - normalY);
+
+	return ksr2_rasterize_convex_quad(pTarget, pClipRect, vertices, pOperand);
+}
+
+//FK: Liang-Barsky clipping against the given rect, returns false if the line is completely outside.
+ksr2_internal ksr2_b32 ksr2_clip_line(ksr2_s32* pX1, ksr2_s32* pY1, ksr2_s32* pX2, ksr2_s32* pY2, ksr2_s32 minX, ksr2_s32 minY, ksr2_s32 maxX, ksr2_s32 maxY)
+{
+	const double deltaX = (double)*pX2 - (double)*pX1;
+	const double deltaY = (double)*pY2 - (double)*pY1;
+	const double p[4] = { -deltaX, deltaX, -deltaY, deltaY };
+	const double q[4] = { (double)*pX1 - (double)minX, (double)maxX - (double)*pX1, (double)*pY1 - (double)minY, (double)maxY - (double)*pY1 };
+
+	double t1 = 0.0;
+	double t2 = 1.0;
+
+	for (ksr2_u32 edgeIndex = 0u; edgeIndex < 4u; ++edgeIndex)
+	{
+		if (p[edgeIndex] == 0.0)
+		{
+			if (q[edgeIndex] < 0.0)
+			{
+				return ksr2_false;
+			}
+
+			continue;
+		}
+
+		const double t = q[edgeIndex] / p[edgeIndex];
+
+		if (p[edgeIndex] < 0.0)
+		{
+			t1 = t > t1 ? t : t1;
+		}
+		else
+		{
+			t2 = t < t2 ? t : t2;
+		}
+	}
+
+	if (t1 > t2)
+	{
+		return ksr2_false;
+	}
+
+	if (t1 > 0.0 || t2 < 1.0)
+	{
+		const double x1 = (double)*pX1;
+		const double y1 = (double)*pY1;
+		*pX1 = (ksr2_s32)(x1 + t1 * deltaX);
+		*pY1 = (ksr2_s32)(y1 + t1 * deltaY);
+		*pX2 = (ksr2_s32)(x1 + t2 * deltaX);
+		*pY2 = (ksr2_s32)(y1 + t2 * deltaY);
+	}
+
+	return ksr2_true;
+}
+
+ksr2_internal size_t ksr2_issue_line_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	ksr2_line line = {0};
+	ksr2_decode_line_draw_command(&line, pHeader);
+	ksr2_use_argument(isLastDrawCommand);
+
+	ksr2_blend_operand operand;
+	ksr2_init_blend_operand(&operand, line.color, (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK), pContext->swapChain.format);
+
+	return ksr2_rasterize_line(&target, pClipRect, line.x1, line.y1, line.x2, line.y2, line.thickness, &operand);
+}
+
+ksr2_internal size_t ksr2_issue_filled_rect_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	ksr2_rect rect = {0};
+	ksr2_pixel_color color = 0u;
+	ksr2_decode_filled_rect_draw_command(&rect, &color, pHeader);
+
+	ksr2_blend_operand operand;
+	ksr2_init_blend_operand(&operand, color, (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK), pContext->swapChain.format);
+
+	const ksr2_b32 nonTemporal = ksr2_use_non_temporal_stores(&target, &rect, isLastDrawCommand);
+
+	ksr2_clip_rect(&rect, &rect, pClipRect);
+	ksr2_paint_rect(&target, &rect, &operand, nonTemporal);
+
+	return ksr2_get_rect_pixel_count(&rect);
+}
+
+ksr2_internal const ksr2_texture* ksr2_get_image_draw_command_texture(const ksr2_context* pContext, const ksr2_image_draw_command* pDrawCommand)
+{
+	return (const ksr2_texture*)(pContext->allocator.pStartAddress + pDrawCommand->textureOffset);
+}
+
+//FK: destination rect of the image, clamped to positive coordinates
+ksr2_internal void ksr2_get_image_draw_command_rect(ksr2_rect* pOutRect, const ksr2_image_draw_command* pDrawCommand)
+{
+	const ksr2_s64 x2 = (ksr2_s64)pDrawCommand->x + (ksr2_s64)pDrawCommand->sourceWidth * pDrawCommand->scale;
+	const ksr2_s64 y2 = (ksr2_s64)pDrawCommand->y + (ksr2_s64)pDrawCommand->sourceHeight * pDrawCommand->scale;
+
+	pOutRect->x1 = pDrawCommand->x > 0 ? (ksr2_u32)pDrawCommand->x : 0u;
+	pOutRect->y1 = pDrawCommand->y > 0 ? (ksr2_u32)pDrawCommand->y : 0u;
+	pOutRect->x2 = (ksr2_u32)ksr2_clamp(x2, 0, 0xFFFFFFFFll);
+	pOutRect->y2 = (ksr2_u32)ksr2_clamp(y2, 0, 0xFFFFFFFFll);
+}
+
+ksr2_internal size_t ksr2_issue_image_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	const ksr2_image_draw_command* pDrawCommand = (const ksr2_image_draw_command*)pHeader;
+	const ksr2_texture* pTexture = ksr2_get_image_draw_command_texture(pContext, pDrawCommand);
+	ksr2_use_argument(isLastDrawCommand);
+
+	ksr2_rect rect = {0};
+	ksr2_get_image_draw_command_rect(&rect, pDrawCommand);
+	ksr2_clip_rect(&rect, &rect, pClipRect);
+
+	if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+	{
+		return 0u;
+	}
+
+	const ksr2_blend_mode blendMode 				= (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK);
+	const ksr2_paint_image_span_fnc paintImageSpan 	= target.pKernels->paintImageSpan[blendMode];
+	const ksr2_u32 scale 							= pDrawCommand->scale;
+
+	//FK: offset of the clipped rect into the unclipped destination rect
+	const ksr2_u32 offsetX = (ksr2_u32)((ksr2_s64)rect.x1 - pDrawCommand->x);
+	const ksr2_u32 offsetY = (ksr2_u32)((ksr2_s64)rect.y1 - pDrawCommand->y);
+
+	const ksr2_pixel_color* pSourceRow = pTexture->pPixels + pDrawCommand->sourceX + (size_t)(pDrawCommand->sourceY + offsetY / scale) * pTexture->width;
+	ksr2_byte* pRow = ksr2_get_render_target_address(&target, rect.x1, rect.y1);
+
+	if (scale == 1u)
+	{
+		for (ksr2_u32 y = rect.y1; y < rect.y2; ++y)
+		{
+			paintImageSpan(&target, pRow, pSourceRow + offsetX, rect.x2 - rect.x1, blendMode);
+			pRow 		+= target.stride;
+			pSourceRow 	+= pTexture->width;
+		}
+
+		return ksr2_get_rect_pixel_count(&rect);
+	}
+
+	//FK: Expand the scaled texture rows span by span. Rows that sample the same texture row can reuse the expanded span.
+	ksr2_pixel_color expandedSpan[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+
+	for (ksr2_u32 spanX = rect.x1; spanX < rect.x2; spanX += K15_RENDERER_2D_IMAGE_SPAN_SIZE)
+	{
+		const ksr2_u32 spanOffsetX 		= offsetX + (spanX - rect.x1);
+		const ksr2_u32 spanPixelCount 	= ksr2_min(rect.x2 - spanX, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+		const ksr2_u32 repeatCount 		= scale - spanOffsetX % scale;
+
+		const ksr2_pixel_color* pSpanSourceRow = pSourceRow + spanOffsetX / scale;
+		ksr2_byte* pSpanRow = pRow + (size_t)(spanX - rect.x1) * target.pixelSizeInBytes;
+		ksr2_u32 rowRepeatCount = scale - offsetY % scale;
+
+		ksr2_expand_image_span(expandedSpan, pSpanSourceRow, spanPixelCount, scale, repeatCount);
+
+		for (ksr2_u32 y = rect.y1; y < rect.y2; ++y)
+		{
+			if (rowRepeatCount == 0u)
+			{
+				pSpanSourceRow += pTexture->width;
+				rowRepeatCount = scale;
+				ksr2_expand_image_span(expandedSpan, pSpanSourceRow, spanPixelCount, scale, repeatCount);
+			}
+
+			paintImageSpan(&target, pSpanRow, expandedSpan, spanPixelCount, blendMode);
+			pSpanRow += target.stride;
+			--rowRepeatCount;
+		}
+	}
+
+	return ksr2_get_rect_pixel_count(&rect);
+}
+
+ksr2_internal const ksr2_font* ksr2_get_text_draw_command_font(const ksr2_context* pContext, const ksr2_text_draw_command* pDrawCommand)
+{
+	return (const ksr2_font*)(pContext->allocator.pStartAddress + pDrawCommand->fontOffset);
+}
+
+ksr2_internal const ksr2_text_glyph* ksr2_get_text_draw_command_glyphs(const ksr2_text_draw_command* pDrawCommand)
+{
+	return (const ksr2_text_glyph*)(pDrawCommand + 1);
+}
+
+//FK: destination rect of the glyph run, clamped to positive coordinates
+ksr2_internal void ksr2_get_text_draw_command_rect(ksr2_rect* pOutRect, const ksr2_text_draw_command* pDrawCommand)
+{
+	const ksr2_s64 x2 = (ksr2_s64)pDrawCommand->x + pDrawCommand->width;
+	const ksr2_s64 y2 = (ksr2_s64)pDrawCommand->y + pDrawCommand->height;
+
+	pOutRect->x1 = pDrawCommand->x > 0 ? (ksr2_u32)pDrawCommand->x : 0u;
+	pOutRect->y1 = pDrawCommand->y > 0 ? (ksr2_u32)pDrawCommand->y : 0u;
+	pOutRect->x2 = (ksr2_u32)ksr2_clamp(x2, 0, 0xFFFFFFFFll);
+	pOutRect->y2 = (ksr2_u32)ksr2_clamp(y2, 0, 0xFFFFFFFFll);
+}
+
+//FK: Every glyph row gets modulated with the text color on the stack and then blended like a row of a premultiplied image.
+ksr2_internal size_t ksr2_issue_text_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	const ksr2_text_draw_command* pDrawCommand = (const ksr2_text_draw_command*)pHeader;
+	const ksr2_text_glyph* pGlyphs = ksr2_get_text_draw_command_glyphs(pDrawCommand);
+	const ksr2_font* pFont = ksr2_get_text_draw_command_font(pContext, pDrawCommand);
+	ksr2_use_argument(isLastDrawCommand);
+
+	const ksr2_blend_mode blendMode 				= (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK);
+	const ksr2_paint_image_span_fnc paintImageSpan 	= target.pKernels->paintImageSpan[blendMode];
+	const ksr2_u32 glyphSizeInBytes 				= pFont->glyphWidth * pFont->glyphHeight;
+
+	ksr2_pixel_color modulatedSpan[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	size_t writtenPixelCount = 0u;
+
+	for (ksr2_u32 glyphIndex = 0u; glyphIndex < pDrawCommand->glyphCount; ++glyphIndex)
+	{
+		const ksr2_s64 glyphX = (ksr2_s64)pDrawCommand->x + pGlyphs[glyphIndex].x;
+		const ksr2_s64 glyphY = (ksr2_s64)pDrawCommand->y;
+
+		ksr2_rect rect = {0};
+		rect.x1 = (ksr2_u32)ksr2_clamp(glyphX, 0, 0xFFFFFFFFll);
+		rect.y1 = (ksr2_u32)ksr2_clamp(glyphY, 0, 0xFFFFFFFFll);
+		rect.x2 = (ksr2_u32)ksr2_clamp(glyphX + pFont->glyphWidth, 0, 0xFFFFFFFFll);
+		rect.y2 = (ksr2_u32)ksr2_clamp(glyphY + pFont->glyphHeight, 0, 0xFFFFFFFFll);
+		ksr2_clip_rect(&rect, &rect, pClipRect);
+
+		if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+		{
+			continue;
+		}
+
+		//FK: glyphs of recorded draw commands can't be evicted before they got rasterized, see ksr2_cache_glyph(). Deferred 
+		//	  text draw commands contain empty glyphs as well as the ones that didn't fit into the glyph cache.
+		const ksr2_u32 slotIndex = pFont->pGlyphSlotIndices[pGlyphs[glyphIndex].glyphIndex];
+
+		if (slotIndex >= pFont->slotCount)
+		{
+			continue;
+		}
+		const ksr2_u8* pCoverageRow = pFont->pAtlas + (size_t)slotIndex * glyphSizeInBytes + (size_t)(rect.y1 - glyphY) * pFont->glyphWidth + (rect.x1 - glyphX);
+		ksr2_byte* pRow = ksr2_get_render_target_address(&target, rect.x1, rect.y1);
+		writtenPixelCount += ksr2_get_rect_pixel_count(&rect);
+
+		for (ksr2_u32 y = rect.y1; y < rect.y2; ++y)
+		{
+			for (ksr2_u32 spanX = 0u; spanX < rect.x2 - rect.x1; spanX += K15_RENDERER_2D_IMAGE_SPAN_SIZE)
+			{
+				const ksr2_u32 spanPixelCount = ksr2_min(rect.x2 - rect.x1 - spanX, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+				target.pKernels->modulateCoverageSpan(modulatedSpan, pCoverageRow + spanX, spanPixelCount, pDrawCommand->color);
+				paintImageSpan(&target, pRow + (size_t)spanX * target.pixelSizeInBytes, modulatedSpan, spanPixelCount, blendMode);
+			}
+
+			pRow 			+= target.stride;
+			pCoverageRow 	+= pFont->glyphWidth;
+		}
+	}
+
+	return writtenPixelCount;
+}
+
+ksr2_internal ksr2_u32 ksr2_find_lowest_set_bit(ksr2_u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long bitIndex = 0u;
+	_BitScanForward64(&bitIndex, value);
+	return (ksr2_u32)bitIndex;
+#elif defined(__GNUC__) || defined(__clang__)
+	return (ksr2_u32)__builtin_ctzll(value);
+#else
+	ksr2_u32 bitIndex = 0u;
+	while((value & 1u) == 0u)
+	{
+		value >>= 1u;
+		++bitIndex;
+	}
+	return bitIndex;
+#endif
+}
+
+ksr2_internal ksr2_u32 ksr2_find_highest_set_bit(ksr2_u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long bitIndex = 0u;
+	_BitScanReverse64(&bitIndex, value);
+	return (ksr2_u32)bitIndex;
+#elif defined(__GNUC__) || defined(__clang__)
+	return 63u - (ksr2_u32)__builtin_clzll(value);
+#else
+	ksr2_u32 bitIndex = 63u;
+	while((value >> bitIndex) == 0u)
+	{
+		--bitIndex;
+	}
+	return bitIndex;
+#endif
+}
+
+//FK: Pixels whose centers can lie inside the triangle, clamped to positive coordinates
+ksr2_internal void ksr2_get_triangle_draw_command_rect(ksr2_rect* pOutRect, const ksr2_triangle_draw_command* pDrawCommand)
+{
+	const ksr2_s32 halfPixel = K15_RENDERER_2D_SUBPIXEL_ONE / 2;
+
+	const ksr2_s32 minX = ksr2_min(pDrawCommand->x[0], ksr2_min(pDrawCommand->x[1], pDrawCommand->x[2]));
+	const ksr2_s32 minY = ksr2_min(pDrawCommand->y[0], ksr2_min(pDrawCommand->y[1], pDrawCommand->y[2]));
+	const ksr2_s32 maxX = ksr2_max(pDrawCommand->x[0], ksr2_max(pDrawCommand->x[1], pDrawCommand->x[2]));
+	const ksr2_s32 maxY = ksr2_max(pDrawCommand->y[0], ksr2_max(pDrawCommand->y[1], pDrawCommand->y[2]));
+
+	//FK: first and one past the last pixel whose center lies within the bounds of the vertices
+	const ksr2_s32 x1 = (minX + halfPixel - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 y1 = (minY + halfPixel - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 x2 = ((maxX - halfPixel) >> K15_RENDERER_2D_SUBPIXEL_BITS) + 1;
+	const ksr2_s32 y2 = ((maxY - halfPixel) >> K15_RENDERER_2D_SUBPIXEL_BITS) + 1;
+
+	pOutRect->x1 = x1 > 0 ? (ksr2_u32)x1 : 0u;
+	pOutRect->y1 = y1 > 0 ? (ksr2_u32)y1 : 0u;
+	pOutRect->x2 = x2 > 0 ? (ksr2_u32)x2 : 0u;
+	pOutRect->y2 = y2 > 0 ? (ksr2_u32)y2 : 0u;
+}
+
+//FK: Twice the signed area of the triangle in subpixels, positive if the vertices are clockwise on the screen
+ksr2_internal ksr2_s64 ksr2_get_triangle_area(const ksr2_s32* pX, const ksr2_s32* pY)
+{
+	return ((ksr2_s64)pX[1] - pX[0]) * ((ksr2_s64)pY[2] - pY[0]) - ((ksr2_s64)pY[1] - pY[0]) * ((ksr2_s64)pX[2] - pX[0]);
+}
+
+//FK: Edge function of the edge from vertex 1 to vertex 2 at the center of pixel x, y: stepX * x + stepY * y + offset.
+//	  Positive on the inside of clockwise triangles. Pixel centers that lie exactly on the edge are only inside if it's
+//	  a top or left edge, the offset of every other edge is one less.
+typedef struct
+{
+	ksr2_s64 					stepX;
+	ksr2_s64 					stepY;
+	ksr2_s64 					offset;
+} ksr2_edge_function;
+
+ksr2_internal void ksr2_init_edge_function(ksr2_edge_function* pOutEdge, ksr2_s32 x1, ksr2_s32 y1, ksr2_s32 x2, ksr2_s32 y2)
+{
+	const ksr2_s64 halfPixel 	= K15_RENDERER_2D_SUBPIXEL_ONE / 2;
+	const ksr2_s64 deltaX 		= (ksr2_s64)x2 - x1;
+	const ksr2_s64 deltaY 		= (ksr2_s64)y2 - y1;
+
+	//FK: the inside is below top edges and right of left edges (y points down)
+	const ksr2_b32 isTopLeftEdge = deltaY < 0 || (deltaY == 0 && deltaX > 0);
+
+	pOutEdge->stepX 	= -deltaY * K15_RENDERER_2D_SUBPIXEL_ONE;
+	pOutEdge->stepY 	= deltaX * K15_RENDERER_2D_SUBPIXEL_ONE;
+	pOutEdge->offset 	= deltaX * (halfPixel - y1) - deltaY * (halfPixel - x1) - (isTopLeftEdge ? 0 : 1);
+}
+
+//FK: Channels of the interpolated colors in 16.16 fixed point, lane i is byte i of a color. Values are rounded, 
+//	  0.5 is already added to them.
+typedef struct
+{
+	ksr2_s64 					values[4]; //FK: at the center of pixel originX, originY
+	ksr2_s64 					stepsX[4];
+	ksr2_s64 					stepsY[4];
+	ksr2_s32 					spanSteps[4]; //FK: stepsX clamped to a whole channel, spans of more than one pixel can't change faster
+	ksr2_s32 					originX;
+	ksr2_s32 					originY;
+	ksr2_u32 					alphaLane;
+	ksr2_b32 					isPremultiplied; //FK: channels need to be clamped to alpha
+} ksr2_triangle_gradients;
+
+ksr2_internal void ksr2_init_triangle_gradients(ksr2_triangle_gradients* pOutGradients, const ksr2_triangle_draw_command* pDrawCommand, const ksr2_edge_function* pEdges, ksr2_u32 alphaShift, ksr2_b32 isPremultiplied)
+{
+	const ksr2_s32 halfPixel 	= K15_RENDERER_2D_SUBPIXEL_ONE / 2;
+	const ksr2_s32 originX 		= pDrawCommand->x[0] >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 originY 		= pDrawCommand->y[0] >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const double inverseArea 	= 1.0 / (double)ksr2_get_triangle_area(pDrawCommand->x, pDrawCommand->y);
+	const double maxStep 		= (double)((ksr2_s64)1 << 40); //FK: keeps the values of the bounding rect in 64 bit
+
+	//FK: barycentric weights of vertex 1 and 2 at the origin pixel, they're the edge functions of the opposite edges.
+	//	  Interpolating the differences to vertex 0 keeps channels that are the same at every vertex exact.
+	const ksr2_s64 originOffsetX 	= (ksr2_s64)originX * K15_RENDERER_2D_SUBPIXEL_ONE + halfPixel - pDrawCommand->x[0];
+	const ksr2_s64 originOffsetY 	= (ksr2_s64)originY * K15_RENDERER_2D_SUBPIXEL_ONE + halfPixel - pDrawCommand->y[0];
+	const ksr2_s64 weight1 			= (pEdges[2].stepX * originOffsetX + pEdges[2].stepY * originOffsetY) / K15_RENDERER_2D_SUBPIXEL_ONE;
+	const ksr2_s64 weight2 			= (pEdges[0].stepX * originOffsetX + pEdges[0].stepY * originOffsetY) / K15_RENDERER_2D_SUBPIXEL_ONE;
+
+	for (ksr2_u32 lane = 0u; lane < 4u; ++lane)
+	{
+		const ksr2_u32 shift 	= lane * 8u;
+		const ksr2_s32 color0 	= (ksr2_s32)((pDrawCommand->colors[0] >> shift) & 0xFFu);
+		const double delta1 	= (double)((ksr2_s32)((pDrawCommand->colors[1] >> shift) & 0xFFu) - color0);
+		const double delta2 	= (double)((ksr2_s32)((pDrawCommand->colors[2] >> shift) & 0xFFu) - color0);
+
+		const double stepX = (delta1 * (double)pEdges[2].stepX + delta2 * (double)pEdges[0].stepX) * inverseArea * 65536.0;
+		const double stepY = (delta1 * (double)pEdges[2].stepY + delta2 * (double)pEdges[0].stepY) * inverseArea * 65536.0;
+		const double value = (delta1 * (double)weight1 + delta2 * (double)weight2) * inverseArea * 65536.0;
+
+		pOutGradients->stepsX[lane] 	= (ksr2_s64)floor(ksr2_clamp(stepX, -maxStep, maxStep) + 0.5);
+		pOutGradients->stepsY[lane] 	= (ksr2_s64)floor(ksr2_clamp(stepY, -maxStep, maxStep) + 0.5);
+		pOutGradients->values[lane] 	= ((ksr2_s64)color0 << 16) + (ksr2_s64)floor(ksr2_clamp(value, -maxStep, maxStep) + 0.5) + 0x8000;
+		pOutGradients->spanSteps[lane] 	= (ksr2_s32)ksr2_clamp(pOutGradients->stepsX[lane], -0x1000000ll, 0x1000000ll);
+	}
+
+	pOutGradients->originX 			= originX;
+	pOutGradients->originY 			= originY;
+	pOutGradients->alphaLane 		= alphaShift / 8u;
+	pOutGradients->isPremultiplied 	= isPremultiplied;
+}
+
+//FK: Colors of pixelCount pixels starting at pixel x, y. Channels get clamped to 0 - 255 and premultiplied channels to alpha.
+ksr2_internal void ksr2_interpolate_triangle_span(ksr2_pixel_color* pOutPixels, const ksr2_triangle_gradients* pGradients, ksr2_s32 x, ksr2_s32 y, ksr2_u32 pixelCount)
+{
+	const ksr2_s64 maxValue = (ksr2_s64)1 << 30;
+	ksr2_s32 values[4];
+
+	//FK: evaluated per span from the origin so that the colors don't depend on where a tile starts the span
+	for (ksr2_u32 lane = 0u; lane < 4u; ++lane)
+	{
+		const ksr2_s64 value = pGradients->values[lane] + pGradients->stepsX[lane] * (x - pGradients->originX) + pGradients->stepsY[lane] * (y - pGradients->originY);
+		values[lane] = (ksr2_s32)ksr2_clamp(value, -maxValue, maxValue);
+	}
+
+	ksr2_u32 pixelIndex = 0u;
+
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		__m128i valueVector 		= _mm_loadu_si128((const __m128i*)values);
+		const __m128i stepVector 	= _mm_loadu_si128((const __m128i*)pGradients->spanSteps);
+		const ksr2_b32 alphaIsLast 	= pGradients->alphaLane == 3u;
+
+		for (; pixelIndex < pixelCount; ++pixelIndex)
+		{
+			__m128i channels = _mm_srai_epi32(valueVector, 16);
+			channels = _mm_packs_epi32(channels, channels);
+
+			if (pGradients->isPremultiplied)
+			{
+				const __m128i alpha = alphaIsLast ? _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)) : _mm_shufflelo_epi16(channels, _MM_SHUFFLE(0, 0, 0, 0));
+				channels = _mm_min_epi16(channels, alpha);
+			}
+
+			pOutPixels[pixelIndex] = (ksr2_pixel_color)_mm_cvtsi128_si32(_mm_packus_epi16(channels, channels));
+			valueVector = _mm_add_epi32(valueVector, stepVector);
+		}
+	}
+#endif
+
+	for (; pixelIndex < pixelCount; ++pixelIndex)
+	{
+		ksr2_u32 channels[4];
+		for (ksr2_u32 lane = 0u; lane < 4u; ++lane)
+		{
+			channels[lane] 	= (ksr2_u32)ksr2_clamp(values[lane] >> 16, 0, 0xFF);
+			values[lane] 	+= pGradients->spanSteps[lane];
+		}
+
+		const ksr2_u32 alpha = pGradients->isPremultiplied ? channels[pGradients->alphaLane] : 0xFFu;
+		ksr2_pixel_color pixel = 0u;
+
+		for (ksr2_u32 lane = 0u; lane < 4u; ++lane)
+		{
+			pixel |= ksr2_min(channels[lane], alpha) << (lane * 8u);
+		}
+
+		pOutPixels[pixelIndex] = pixel;
+	}
+}
+
+//FK: Bit x of the mask of a block row is set if the center of pixel x lies inside every edge that passes through the block.
+//	  Values are the edge functions at the first pixel of the block, they're within 32 bit for these edges.
+ksr2_internal void ksr2_get_triangle_block_masks(ksr2_u8* pOutRowMasks, const ksr2_s32* pValues, const ksr2_s32* pStepsX, const ksr2_s32* pStepsY, ksr2_u32 edgeCount, ksr2_u32 columnCount, ksr2_u32 rowCount)
+{
+	const ksr2_u32 columnMask = (1u << columnCount) - 1u;
+
+#ifdef K15_RENDERER_2D_SSE2
+	__m128i leftValues[3];
+	__m128i rightValues[3];
+	__m128i stepsY[3];
+
+	for (ksr2_u32 edgeIndex = 0u; edgeIndex < edgeCount; ++edgeIndex)
+	{
+		const ksr2_s32 value 	= pValues[edgeIndex];
+		const ksr2_s32 stepX 	= pStepsX[edgeIndex];
+		leftValues[edgeIndex] 	= _mm_setr_epi32(value, value + stepX, value + 2 * stepX, value + 3 * stepX);
+		rightValues[edgeIndex] 	= _mm_add_epi32(leftValues[edgeIndex], _mm_set1_epi32(4 * stepX));
+		stepsY[edgeIndex] 		= _mm_set1_epi32(pStepsY[edgeIndex]);
+	}
+
+	const __m128i outsideValue = _mm_set1_epi32(-1);
+
+	for (ksr2_u32 row = 0u; row < rowCount; ++row)
+	{
+		__m128i leftInside 	= _mm_set1_epi32(-1);
+		__m128i rightInside = _mm_set1_epi32(-1);
+
+		for (ksr2_u32 edgeIndex = 0u; edgeIndex < edgeCount; ++edgeIndex)
+		{
+			leftInside 				= _mm_and_si128(leftInside, _mm_cmpgt_epi32(leftValues[edgeIndex], outsideValue));
+			rightInside 			= _mm_and_si128(rightInside, _mm_cmpgt_epi32(rightValues[edgeIndex], outsideValue));
+			leftValues[edgeIndex] 	= _mm_add_epi32(leftValues[edgeIndex], stepsY[edgeIndex]);
+			rightValues[edgeIndex] 	= _mm_add_epi32(rightValues[edgeIndex], stepsY[edgeIndex]);
+		}
+
+		const ksr2_u32 mask = (ksr2_u32)_mm_movemask_ps(_mm_castsi128_ps(leftInside)) | ((ksr2_u32)_mm_movemask_ps(_mm_castsi128_ps(rightInside)) << 4u);
+		pOutRowMasks[row] = (ksr2_u8)(mask & columnMask);
+	}
+#else
+	for (ksr2_u32 row = 0u; row < rowCount; ++row)
+	{
+		ksr2_u32 mask = columnMask;
+
+		for (ksr2_u32 edgeIndex = 0u; edgeIndex < edgeCount; ++edgeIndex)
+		{
+			ksr2_s32 value = pValues[edgeIndex] + pStepsY[edgeIndex] * (ksr2_s32)row;
+			ksr2_u32 edgeMask = 0u;
+
+			for (ksr2_u32 column = 0u; column < columnCount; ++column)
+			{
+				edgeMask |= (value >= 0 ? 1u : 0u) << column;
+				value += pStepsX[edgeIndex];
+			}
+
+			mask &= edgeMask;
+		}
+
+		pOutRowMasks[row] = (ksr2_u8)mask;
+	}
+#endif
+}
+
+//FK: The bounding rect gets walked in blocks of K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE pixels. Blocks outside of an edge get
+//	  skipped, blocks inside of all edges are covered completely and only the others test their pixels against the edges
+//	  that pass through them. The covered pixels of a row are contiguous, the blocks of a row of blocks add up to a single span
+//	  per pixel row. Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_issue_triangle_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	const ksr2_triangle_draw_command* pDrawCommand = (const ksr2_triangle_draw_command*)pHeader;
+	ksr2_use_argument(isLastDrawCommand);
+
+	ksr2_rect rect = {0};
+	ksr2_get_triangle_draw_command_rect(&rect, pDrawCommand);
+	ksr2_clip_rect(&rect, &rect, pClipRect);
+
+	if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+	{
+		return 0u;
+	}
+
+	ksr2_edge_function edges[3];
+	for (ksr2_u32 edgeIndex = 0u; edgeIndex < 3u; ++edgeIndex)
+	{
+		const ksr2_u32 nextIndex = edgeIndex == 2u ? 0u : edgeIndex + 1u;
+		ksr2_init_edge_function(&edges[edgeIndex], pDrawCommand->x[edgeIndex], pDrawCommand->y[edgeIndex], pDrawCommand->x[nextIndex], pDrawCommand->y[nextIndex]);
+	}
+
+	const ksr2_blend_mode blendMode = (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK);
+	const ksr2_u32 alphaShift 		= ksr2_get_alpha_shift(pContext->swapChain.format);
+	const ksr2_b32 isFlat 			= pDrawCommand->colors[0] == pDrawCommand->colors[1] && pDrawCommand->colors[0] == pDrawCommand->colors[2];
+
+	//FK: flat triangles get filled like rects, the others get interpolated into a span and blended like image pixels
+	ksr2_blend_operand operand;
+	ksr2_triangle_gradients gradients = {0};
+
+	if (isFlat)
+	{
+		if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+		{
+			ksr2_init_blend_operand(&operand, pDrawCommand->colors[0], blendMode, pContext->swapChain.format);
+		}
+		else
+		{
+			ksr2_init_image_blend_operand(&operand, pDrawCommand->colors[0], blendMode, alphaShift);
+		}
+	}
+	else
+	{
+		ksr2_init_triangle_gradients(&gradients, pDrawCommand, edges, alphaShift, blendMode != K15_RENDERER_2D_BLEND_MODE_OPAQUE);
+	}
+
+	const ksr2_paint_span_fnc paintSpan 			= target.pKernels->paintSpan[blendMode];
+	const ksr2_paint_image_span_fnc paintImageSpan 	= target.pKernels->paintImageSpan[blendMode];
+	const ksr2_s32 blockSize 						= K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE;
+
+	ksr2_pixel_color interpolatedSpan[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	ksr2_u32 spanStarts[K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE];
+	ksr2_u32 spanEnds[K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE];
+	ksr2_u8 rowMasks[K15_RENDERER_2D_TRIANGLE_BLOCK_SIZE];
+	size_t writtenPixelCount = 0u;
+
+	for (ksr2_u32 blockY = rect.y1; blockY < rect.y2; blockY += blockSize)
+	{
+		const ksr2_u32 rowCount = ksr2_min(rect.y2 - blockY, (ksr2_u32)blockSize);
+		ksr2_b32 rowIsCovered = ksr2_false;
+
+		for (ksr2_u32 row = 0u; row < rowCount; ++row)
+		{
+			spanStarts[row] = rect.x2;
+			spanEnds[row] 	= rect.x1;
+		}
+
+		ksr2_s64 blockValues[3];
+		for (ksr2_u32 edgeIndex = 0u; edgeIndex < 3u; ++edgeIndex)
+		{
+			blockValues[edgeIndex] = edges[edgeIndex].stepX * rect.x1 + edges[edgeIndex].stepY * blockY + edges[edgeIndex].offset;
+		}
+
+		for (ksr2_u32 blockX = rect.x1; blockX < rect.x2; blockX += blockSize)
+		{
+			const ksr2_u32 columnCount = ksr2_min(rect.x2 - blockX, (ksr2_u32)blockSize);
+
+			ksr2_s32 partialValues[3];
+			ksr2_s32 partialStepsX[3];
+			ksr2_s32 partialStepsY[3];
+			ksr2_u32 partialEdgeCount = 0u;
+			ksr2_b32 isOutside = ksr2_false;
+
+			//FK: trivial reject/accept, edge functions are linear so the extremes are at the corner pixels of the block
+			for (ksr2_u32 edgeIndex = 0u; edgeIndex < 3u; ++edgeIndex)
+			{
+				const ksr2_edge_function* pEdge = &edges[edgeIndex];
+				const ksr2_s64 deltaX = pEdge->stepX * (ksr2_s64)(columnCount - 1u);
+				const ksr2_s64 deltaY = pEdge->stepY * (ksr2_s64)(rowCount - 1u);
+				const ksr2_s64 minValue = blockValues[edgeIndex] + (deltaX < 0 ? deltaX : 0) + (deltaY < 0 ? deltaY : 0);
+				const ksr2_s64 maxValue = blockValues[edgeIndex] + (deltaX > 0 ? deltaX : 0) + (deltaY > 0 ? deltaY : 0);
+
+				if (maxValue < 0)
+				{
+					isOutside = ksr2_true;
+					break;
+				}
+
+				if (minValue < 0)
+				{
+					partialValues[partialEdgeCount] = (ksr2_s32)blockValues[edgeIndex];
+					partialStepsX[partialEdgeCount] = (ksr2_s32)pEdge->stepX;
+					partialStepsY[partialEdgeCount] = (ksr2_s32)pEdge->stepY;
+					++partialEdgeCount;
+				}
+			}
+
+			for (ksr2_u32 edgeIndex = 0u; edgeIndex < 3u; ++edgeIndex)
+			{
+				blockValues[edgeIndex] += edges[edgeIndex].stepX * blockSize;
+			}
+
+			if (isOutside)
+			{
+				//FK: the triangle is convex, once a block to the right of covered pixels is outside all following ones are as well
+				if (rowIsCovered)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			if (partialEdgeCount == 0u)
+			{
+				for (ksr2_u32 row = 0u; row < rowCount; ++row)
+				{
+					spanStarts[row] = ksr2_min(spanStarts[row], blockX);
+					spanEnds[row] 	= blockX + columnCount;
+				}
+
+				rowIsCovered = ksr2_true;
+				continue;
+			}
+
+			ksr2_get_triangle_block_masks(rowMasks, partialValues, partialStepsX, partialStepsY, partialEdgeCount, columnCount, rowCount);
+
+			for (ksr2_u32 row = 0u; row < rowCount; ++row)
+			{
+				if (rowMasks[row] == 0u)
+				{
+					continue;
+				}
+
+				spanStarts[row] = ksr2_min(spanStarts[row], blockX + ksr2_find_lowest_set_bit(rowMasks[row]));
+				spanEnds[row] 	= blockX + ksr2_find_highest_set_bit(rowMasks[row]) + 1u;
+				rowIsCovered 	= ksr2_true;
+			}
+		}
+
+		ksr2_byte* pRow = ksr2_get_render_target_address(&target, 0u, blockY);
+
+		for (ksr2_u32 row = 0u; row < rowCount; ++row)
+		{
+			if (spanStarts[row] < spanEnds[row])
+			{
+				const ksr2_u32 pixelCount = spanEnds[row] - spanStarts[row];
+				ksr2_byte* pSpan = pRow + (size_t)spanStarts[row] * target.pixelSizeInBytes;
+
+				if (isFlat)
+				{
+					paintSpan(&target, pSpan, pixelCount, &operand);
+				}
+				else
+				{
+					for (ksr2_u32 spanX = 0u; spanX < pixelCount; spanX += K15_RENDERER_2D_IMAGE_SPAN_SIZE)
+					{
+						const ksr2_u32 spanPixelCount = ksr2_min(pixelCount - spanX, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+						ksr2_interpolate_triangle_span(interpolatedSpan, &gradients, (ksr2_s32)(spanStarts[row] + spanX), (ksr2_s32)(blockY + row), spanPixelCount);
+						paintImageSpan(&target, pSpan + (size_t)spanX * target.pixelSizeInBytes, interpolatedSpan, spanPixelCount, blendMode);
+					}
+				}
+
+				writtenPixelCount += pixelCount;
+			}
+
+			pRow += target.stride;
+		}
+	}
+
+	return writtenPixelCount;
+}
+
+//FK: Pixels that overlap the bounding box of the ellipse, clamped to positive coordinates
+ksr2_internal void ksr2_get_ellipse_draw_command_rect(ksr2_rect* pOutRect, const ksr2_ellipse_draw_command* pDrawCommand)
+{
+	const ksr2_s32 x1 = (pDrawCommand->centerX - pDrawCommand->radiusX) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 y1 = (pDrawCommand->centerY - pDrawCommand->radiusY) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 x2 = (pDrawCommand->centerX + pDrawCommand->radiusX + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 y2 = (pDrawCommand->centerY + pDrawCommand->radiusY + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+
+	pOutRect->x1 = x1 > 0 ? (ksr2_u32)x1 : 0u;
+	pOutRect->y1 = y1 > 0 ? (ksr2_u32)y1 : 0u;
+	pOutRect->x2 = x2 > 0 ? (ksr2_u32)x2 : 0u;
+	pOutRect->y2 = y2 > 0 ? (ksr2_u32)y2 : 0u;
+}
+
+//FK: Pixels that overlap the rounded rect, clamped to positive coordinates
+ksr2_internal void ksr2_get_rounded_rect_draw_command_rect(ksr2_rect* pOutRect, const ksr2_rounded_rect_draw_command* pDrawCommand)
+{
+	const ksr2_s32 x1 = pDrawCommand->x1 >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 y1 = pDrawCommand->y1 >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 x2 = (pDrawCommand->x2 + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 y2 = (pDrawCommand->y2 + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+
+	pOutRect->x1 = x1 > 0 ? (ksr2_u32)x1 : 0u;
+	pOutRect->y1 = y1 > 0 ? (ksr2_u32)y1 : 0u;
+	pOutRect->x2 = x2 > 0 ? (ksr2_u32)x2 : 0u;
+	pOutRect->y2 = y2 > 0 ? (ksr2_u32)y2 : 0u;
+}
+
+ksr2_internal void ksr2_get_path_draw_command_rect(ksr2_rect* pOutRect, const ksr2_path_draw_command* pDrawCommand)
+{
+	pOutRect->x1 = pDrawCommand->x1;
+	pOutRect->y1 = pDrawCommand->y1;
+	pOutRect->x2 = pDrawCommand->x2;
+	pOutRect->y2 = pDrawCommand->y2;
+}
+
+typedef enum
+{
+	K15_RENDERER_2D_SHAPE_CIRCLE,
+	K15_RENDERER_2D_SHAPE_ELLIPSE,
+	K15_RENDERER_2D_SHAPE_ROUNDED_RECT
+} ksr2_shape_type;
+
+//FK: Shapes get anti-aliased with the signed distance of the pixel center to their edge (negative inside). Pixels at a distance 
+//	  of -0.5 or less are covered completely, pixels at +0.5 or more aren't covered at all. All values are in pixels.
+typedef struct
+{
+	float 						centerX;
+	float 						centerY;
+	float 						radiusX; //FK: rounded rects: half of the size minus the corner radius
+	float 						radiusY;
+	float 						inverseRadiusX2; //FK: ellipses: 1 / radiusX^2
+	float 						inverseRadiusY2;
+	float 						innerRadius; //FK: circles: radius of the hole, rounded rects: corner radius
+	ksr2_shape_type 			type;
+} ksr2_shape;
+
+ksr2_internal void ksr2_init_shape(ksr2_shape* pOutShape, ksr2_pixel_color* pOutColor, const ksr2_draw_command_header* pHeader)
+{
+	const float pixelsPerSubpixel = 1.0f / (float)K15_RENDERER_2D_SUBPIXEL_ONE;
+
+	if (pHeader->type == K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE)
+	{
+		const ksr2_ellipse_draw_command* pDrawCommand = (const ksr2_ellipse_draw_command*)pHeader;
+
+		pOutShape->centerX 			= (float)pDrawCommand->centerX * pixelsPerSubpixel;
+		pOutShape->centerY 			= (float)pDrawCommand->centerY * pixelsPerSubpixel;
+		pOutShape->radiusX 			= (float)pDrawCommand->radiusX * pixelsPerSubpixel;
+		pOutShape->radiusY 			= (float)pDrawCommand->radiusY * pixelsPerSubpixel;
+		pOutShape->inverseRadiusX2 	= 1.0f / (pOutShape->radiusX * pOutShape->radiusX);
+		pOutShape->inverseRadiusY2 	= 1.0f / (pOutShape->radiusY * pOutShape->radiusY);
+		pOutShape->innerRadius 		= (float)pDrawCommand->innerRadius * pixelsPerSubpixel;
+		pOutShape->type 			= pDrawCommand->radiusX == pDrawCommand->radiusY ? K15_RENDERER_2D_SHAPE_CIRCLE : K15_RENDERER_2D_SHAPE_ELLIPSE;
+		*pOutColor 					= pDrawCommand->color;
+	}
+	else
+	{
+		const ksr2_rounded_rect_draw_command* pDrawCommand = (const ksr2_rounded_rect_draw_command*)pHeader;
+		const ksr2_s32 cornerRadius = pDrawCommand->cornerRadius;
+
+		pOutShape->centerX 			= (float)((ksr2_s64)pDrawCommand->x1 + pDrawCommand->x2) * 0.5f * pixelsPerSubpixel;
+		pOutShape->centerY 			= (float)((ksr2_s64)pDrawCommand->y1 + pDrawCommand->y2) * 0.5f * pixelsPerSubpixel;
+		pOutShape->radiusX 			= (float)((ksr2_s64)pDrawCommand->x2 - pDrawCommand->x1 - 2 * cornerRadius) * 0.5f * pixelsPerSubpixel;
+		pOutShape->radiusY 			= (float)((ksr2_s64)pDrawCommand->y2 - pDrawCommand->y1 - 2 * cornerRadius) * 0.5f * pixelsPerSubpixel;
+		pOutShape->inverseRadiusX2 	= 0.0f;
+		pOutShape->inverseRadiusY2 	= 0.0f;
+		pOutShape->innerRadius 		= (float)cornerRadius * pixelsPerSubpixel;
+		pOutShape->type 			= K15_RENDERER_2D_SHAPE_ROUNDED_RECT;
+		*pOutColor 					= pDrawCommand->color;
+	}
+}
+
+//FK: Half width of the pixel centers of a row that can be covered, relative to centerX. Returns false if the row is empty.
+ksr2_internal ksr2_b32 ksr2_get_shape_row_half_width(float* pOutHalfWidth, const ksr2_shape* pShape, float deltaY)
+{
+	deltaY = fabsf(deltaY);
+
+	switch(pShape->type)
+	{
+		case K15_RENDERER_2D_SHAPE_CIRCLE:
+		{
+			const float radius = pShape->radiusX + 0.5f;
+
+			if (deltaY >= radius)
+			{
+				return ksr2_false;
+			}
+
+			*pOutHalfWidth = sqrtf(radius * radius - deltaY * deltaY);
+			return ksr2_true;
+		}
+
+		case K15_RENDERER_2D_SHAPE_ELLIPSE:
+		{
+			//FK: The approximated distance can be below 0.5 further out than the exact one. Measured for radii from 0.25 to 1000,
+			//	  it stays within the chord a pixel closer to the center grown by a pixel and the distance to the bounding box
+			//	  limits it to half a pixel around the bounding box.
+			if (deltaY >= pShape->radiusY + 0.5f)
+			{
+				return ksr2_false;
+			}
+
+			const float chordY = ksr2_max(deltaY - 1.0f, 0.0f);
+			const float chordHalfWidth = pShape->radiusX * sqrtf(ksr2_max(1.0f - chordY * chordY * pShape->inverseRadiusY2, 0.0f)) + 1.0f;
+			*pOutHalfWidth = ksr2_min(chordHalfWidth, pShape->radiusX + 0.5f);
+			return ksr2_true;
+		}
+
+		default:
+		{
+			const float cornerRadius 	= pShape->innerRadius + 0.5f;
+			const float cornerY 		= deltaY - pShape->radiusY;
+
+			if (cornerY <= 0.0f)
+			{
+				*pOutHalfWidth = pShape->radiusX + cornerRadius;
+				return ksr2_true;
+			}
+
+			if (cornerY >= cornerRadius)
+			{
+				return ksr2_false;
+			}
+
+			*pOutHalfWidth = pShape->radiusX + sqrtf(cornerRadius * cornerRadius - cornerY * cornerY);
+			return ksr2_true;
+		}
+	}
+}
+
+//FK: Coverage of pixel x of the row at deltaY from the center, 0xFF means the pixel is covered completely.
+//	  Distances are exact for circles and rounded rects. Ellipses use the first order approximation value / |gradient| of 
+//	  their implicit function, which is too small beyond the ends of thin ellipses, the distance to the bounding box is a 
+//	  lower bound there.
+ksr2_internal ksr2_u8 ksr2_get_shape_coverage(const ksr2_shape* pShape, ksr2_s32 x, float deltaY)
+{
+	const float deltaX = (float)x + 0.5f - pShape->centerX;
+	float coverage = 0.0f;
+
+	switch(pShape->type)
+	{
+		case K15_RENDERER_2D_SHAPE_CIRCLE:
+		{
+			const float distance = sqrtf(deltaX * deltaX + deltaY * deltaY);
+			coverage = ksr2_clamp(pShape->radiusX + 0.5f - distance, 0.0f, 1.0f);
+
+			//FK: rings are covered by the circle minus what the hole covers, which also works for rings thinner than a pixel
+			if (pShape->innerRadius > 0.0f)
+			{
+				coverage += ksr2_clamp(distance - pShape->innerRadius + 0.5f, 0.0f, 1.0f) - 1.0f;
+			}
+			break;
+		}
+
+		case K15_RENDERER_2D_SHAPE_ELLIPSE:
+		{
+			const float gradientX 	= deltaX * pShape->inverseRadiusX2;
+			const float gradientY 	= deltaY * pShape->inverseRadiusY2;
+			const float value 		= deltaX * gradientX + deltaY * gradientY - 1.0f;
+			const float gradient 	= 2.0f * sqrtf(gradientX * gradientX + gradientY * gradientY);
+
+			const float boxDistance = ksr2_max(fabsf(deltaX) - pShape->radiusX, fabsf(deltaY) - pShape->radiusY);
+			const float distance 	= ksr2_max(value / ksr2_max(gradient, 1e-6f), boxDistance);
+
+			coverage = ksr2_clamp(0.5f - distance, 0.0f, 1.0f);
+			break;
+		}
+
+		default:
+		{
+			const float cornerX 	= fabsf(deltaX) - pShape->radiusX;
+			const float cornerY 	= fabsf(deltaY) - pShape->radiusY;
+			const float outsideX 	= ksr2_max(cornerX, 0.0f);
+			const float outsideY 	= ksr2_max(cornerY, 0.0f);
+			const float distance 	= sqrtf(outsideX * outsideX + outsideY * outsideY) + ksr2_min(ksr2_max(cornerX, cornerY), 0.0f) - pShape->innerRadius;
+
+			coverage = ksr2_clamp(0.5f - distance, 0.0f, 1.0f);
+			break;
+		}
+	}
+
+	return (ksr2_u8)(ksr2_max(coverage, 0.0f) * 255.0f + 0.5f);
+}
+
+typedef struct
+{
+	ksr2_render_target 			target;
+	ksr2_blend_operand 			operand; //FK: for the covered pixels
+	ksr2_pixel_color 			edgeColor; //FK: premultiplied
+	ksr2_blend_mode 			edgeBlendMode;
+} ksr2_shape_painter;
+
+//FK: the edges get blended like text, opaque shapes blend them with the color at full alpha
+ksr2_internal void ksr2_init_shape_painter(ksr2_shape_painter* pOutPainter, ksr2_context* pContext, ksr2_pixel_color color, ksr2_blend_mode blendMode)
+{
+	ksr2_init_render_target(&pOutPainter->target, pContext, pContext->swapChain.pCurrentImage);
+	ksr2_init_blend_operand(&pOutPainter->operand, color, blendMode, pContext->swapChain.format);
+	pOutPainter->edgeColor 		= blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE ? color | (0xFFu << ksr2_get_alpha_shift(pContext->swapChain.format)) : color;
+	pOutPainter->edgeBlendMode 	= blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE ? K15_RENDERER_2D_BLEND_MODE_ALPHA : blendMode;
+}
+
+//FK: Blends the pixels of the row from x on with their coverage until a pixel has a coverage of stopCoverage or x2 got 
+//	  reached. Returns the first pixel that didn't get blended.
+ksr2_internal ksr2_s32 ksr2_paint_shape_edge(const ksr2_shape_painter* pPainter, ksr2_byte* pRow, const ksr2_shape* pShape, float deltaY, ksr2_s32 x, ksr2_s32 x2, ksr2_u8 stopCoverage)
+{
+	const ksr2_render_target* pTarget = &pPainter->target;
+
+	ksr2_u8 coverage[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	ksr2_pixel_color modulatedSpan[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	ksr2_b32 isDone = ksr2_false;
+
+	while (isDone == ksr2_false && x < x2)
+	{
+		const ksr2_u32 maxPixelCount = ksr2_min((ksr2_u32)(x2 - x), (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+		ksr2_u32 pixelCount = 0u;
+
+		for (; pixelCount < maxPixelCount; ++pixelCount)
+		{
+			coverage[pixelCount] = ksr2_get_shape_coverage(pShape, x + (ksr2_s32)pixelCount, deltaY);
+
+			if (coverage[pixelCount] == stopCoverage)
+			{
+				isDone = ksr2_true;
+				break;
+			}
+		}
+
+		if (pixelCount > 0u)
+		{
+			pTarget->pKernels->modulateCoverageSpan(modulatedSpan, coverage, pixelCount, pPainter->edgeColor);
+			pTarget->pKernels->paintImageSpan[pPainter->edgeBlendMode](pTarget, pRow + (size_t)x * pTarget->pixelSizeInBytes, modulatedSpan, pixelCount, pPainter->edgeBlendMode);
+		}
+
+		x += (ksr2_s32)pixelCount;
+	}
+
+	return x;
+}
+
+//FK: The coverage of the pixels x1 to x2 has to rise to a run of covered pixels and fall off again, which it does for a whole
+//	  row of every shape but rings. Only the pixels of the rising and falling edge get evaluated, the end of the covered run
+//	  gets found with a binary search and filled as a single span. Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_paint_shape_row(const ksr2_shape_painter* pPainter, ksr2_byte* pRow, const ksr2_shape* pShape, float deltaY, ksr2_s32 x1, ksr2_s32 x2)
+{
+	while (x1 < x2 && ksr2_get_shape_coverage(pShape, x1, deltaY) == 0u)
+	{
+		++x1;
+	}
+
+	const ksr2_s32 coveredStart = ksr2_paint_shape_edge(pPainter, pRow, pShape, deltaY, x1, x2, 0xFFu);
+
+	if (coveredStart == x2)
+	{
+		return (size_t)(coveredStart - x1);
+	}
+
+	ksr2_s32 lastCoveredX = coveredStart;
+	ksr2_s32 searchEnd = x2 - 1;
+
+	while (lastCoveredX < searchEnd)
+	{
+		const ksr2_s32 x = lastCoveredX + (searchEnd - lastCoveredX + 1) / 2;
+
+		if (ksr2_get_shape_coverage(pShape, x, deltaY) == 0xFFu)
+		{
+			lastCoveredX = x;
+		}
+		else
+		{
+			searchEnd = x - 1;
+		}
+	}
+
+	const ksr2_s32 coveredEnd = lastCoveredX + 1;
+	pPainter->target.pKernels->paintSpan[pPainter->operand.blendMode](&pPainter->target, pRow + (size_t)coveredStart * pPainter->target.pixelSizeInBytes, (ksr2_u32)(coveredEnd - coveredStart), &pPainter->operand);
+
+	const ksr2_s32 edgeEnd = ksr2_paint_shape_edge(pPainter, pRow, pShape, deltaY, coveredEnd, x2, 0u);
+
+	return (size_t)(edgeEnd - x1);
+}
+
+//FK: Circles, ellipses, rings and rounded rects. Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_issue_shape_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	ksr2_use_argument(isLastDrawCommand);
+
+	ksr2_rect rect = {0};
+	if (pHeader->type == K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE)
+	{
+		ksr2_get_ellipse_draw_command_rect(&rect, (const ksr2_ellipse_draw_command*)pHeader);
+	}
+	else
+	{
+		ksr2_get_rounded_rect_draw_command_rect(&rect, (const ksr2_rounded_rect_draw_command*)pHeader);
+	}
+
+	ksr2_clip_rect(&rect, &rect, pClipRect);
+
+	if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+	{
+		return 0u;
+	}
+
+	ksr2_shape shape;
+	ksr2_pixel_color color = 0u;
+	ksr2_init_shape(&shape, &color, pHeader);
+
+	ksr2_shape_painter painter;
+	ksr2_init_shape_painter(&painter, pContext, color, (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK));
+
+	ksr2_byte* pRow = ksr2_get_render_target_address(&painter.target, 0u, rect.y1);
+	size_t writtenPixelCount = 0u;
+
+	for (ksr2_u32 y = rect.y1; y < rect.y2; ++y, pRow += painter.target.stride)
+	{
+		const float deltaY = (float)y + 0.5f - shape.centerY;
+		float halfWidth = 0.0f;
+
+		if (ksr2_get_shape_row_half_width(&halfWidth, &shape, deltaY) == ksr2_false)
+		{
+			continue;
+		}
+
+		const ksr2_s32 x1 = ksr2_max((ksr2_s32)floorf(shape.centerX - halfWidth - 0.5f), (ksr2_s32)rect.x1);
+		const ksr2_s32 x2 = ksr2_min((ksr2_s32)floorf(shape.centerX + halfWidth - 0.5f) + 1, (ksr2_s32)rect.x2);
+
+		if (x1 >= x2)
+		{
+			continue;
+		}
+
+		//FK: rows through the hole of a ring rise and fall on both sides of the center
+		if (shape.type == K15_RENDERER_2D_SHAPE_CIRCLE && shape.innerRadius > 0.0f && fabsf(deltaY) < shape.innerRadius + 0.5f)
+		{
+			const ksr2_s32 centerX = ksr2_clamp((ksr2_s32)floorf(shape.centerX + 0.5f), x1, x2);
+			writtenPixelCount += ksr2_paint_shape_row(&painter, pRow, &shape, deltaY, x1, centerX);
+			writtenPixelCount += ksr2_paint_shape_row(&painter, pRow, &shape, deltaY, centerX, x2);
+		}
+		else
+		{
+			writtenPixelCount += ksr2_paint_shape_row(&painter, pRow, &shape, deltaY, x1, x2);
+		}
+	}
+
+	return writtenPixelCount;
+}
+
+//FK: Signed areas of a strip of rows of a path within K15_RENDERER_2D_IMAGE_SPAN_SIZE pixels. The sum of the cells of a 
+//	  row up to a pixel is the winding number at that pixel times its coverage, K15_RENDERER_2D_FIXED_POINT_ONE per winding.
+//	  Only the cells from firstCell to lastCell of a row can be non-zero, resolving a row clears them again.
+typedef struct
+{
+	ksr2_s32 	cells[K15_RENDERER_2D_PATH_STRIP_HEIGHT][K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	ksr2_s32 	firstCell[K15_RENDERER_2D_PATH_STRIP_HEIGHT];
+	ksr2_s32 	lastCell[K15_RENDERER_2D_PATH_STRIP_HEIGHT];
+	ksr2_s32 	width;
+} ksr2_path_accumulator;
+
+enum
+{
+	K15_RENDERER_2D_PATH_AREA_PER_SUBPIXEL_ROW = K15_RENDERER_2D_FIXED_POINT_ONE / K15_RENDERER_2D_SUBPIXEL_ONE
+};
+
+//FK: Part of a pixel right of a line that crosses its row, averaged over the height of the line within the row. The distances
+//	  are from the left and right end of the line to the right border of the pixel, width is the distance between both ends.
+ksr2_internal float ksr2_get_path_line_coverage(float leftDistance, float rightDistance, float width)
+{
+	if (rightDistance >= 1.0f)
+	{
+		return 1.0f;
+	}
+
+	if (leftDistance <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (leftDistance <= 1.0f)
+	{
+		//FK: the line either lies within the pixel or starts left of it
+		return rightDistance >= 0.0f ? 0.5f * (leftDistance + rightDistance) : leftDistance * leftDistance / (2.0f * width);
+	}
+
+	if (rightDistance >= 0.0f)
+	{
+		const float uncoveredDistance = 1.0f - rightDistance;
+		return 1.0f - uncoveredDistance * uncoveredDistance / (2.0f * width);
+	}
+
+	return (leftDistance - 0.5f) / width;
+}
+
+ksr2_internal ksr2_s32 ksr2_floor_to_s32(double value)
+{
+	const ksr2_s32 integer = (ksr2_s32)value;
+	return (double)integer > value ? integer - 1 : integer;
+}
+
+//FK: Adds the part of a line within a row to the cells of the row. The x coordinates are in subpixels of the image so that
+//	  the coverage doesn't depend on where the accumulator starts, x is its first pixel. area is the signed height of the line
+//	  within the row, K15_RENDERER_2D_FIXED_POINT_ONE for the whole row. The cells a line touches add up to exactly area once
+//	  the line ends within the accumulator, no matter how the coverage got rounded.
+ksr2_internal void ksr2_accumulate_path_row(ksr2_path_accumulator* pAccumulator, ksr2_u32 row, ksr2_s32 x, double topX, double bottomX, ksr2_s32 area)
+{
+	const double x1 	= ksr2_min(topX, bottomX);
+	const double x2 	= ksr2_max(topX, bottomX);
+	ksr2_s32* pCells 	= pAccumulator->cells[row];
+
+	//FK: pixels from coveredCell on are right of the whole line
+	const ksr2_s32 firstLineCell 	= ksr2_floor_to_s32(x1 / K15_RENDERER_2D_SUBPIXEL_ONE) - x;
+	const ksr2_s32 coveredCell 		= ksr2_floor_to_s32(x2 / K15_RENDERER_2D_SUBPIXEL_ONE) + 1 - x;
+
+	if (firstLineCell >= pAccumulator->width)
+	{
+		return;
+	}
+
+	const ksr2_s32 firstCell 	= ksr2_max(firstLineCell, 0);
+	const ksr2_s32 lastCell 	= ksr2_min(coveredCell, pAccumulator->width - 1);
+
+	if (coveredCell <= 0)
+	{
+		pCells[0] += area;
+	}
+	else
+	{
+		const float width 			= (float)((x2 - x1) / K15_RENDERER_2D_SUBPIXEL_ONE);
+		const ksr2_s32 totalArea 	= area < 0 ? -area : area;
+		ksr2_s32 previousArea 		= 0;
+
+		for (ksr2_s32 cell = firstCell; cell <= lastCell; ++cell)
+		{
+			ksr2_s32 coveredArea = totalArea;
+
+			if (cell != coveredCell)
+			{
+				const double pixelX2 	= (double)((x + cell + 1) << K15_RENDERER_2D_SUBPIXEL_BITS);
+				const float coverage 	= ksr2_get_path_line_coverage((float)((pixelX2 - x1) / K15_RENDERER_2D_SUBPIXEL_ONE), (float)((pixelX2 - x2) / K15_RENDERER_2D_SUBPIXEL_ONE), width);
+				coveredArea = (ksr2_s32)(ksr2_clamp(coverage, 0.0f, 1.0f) * (float)totalArea + 0.5f);
+			}
+
+			pCells[cell] += area < 0 ? previousArea - coveredArea : coveredArea - previousArea;
+			previousArea = coveredArea;
+		}
+	}
+
+	pAccumulator->firstCell[row] 	= ksr2_min(pAccumulator->firstCell[row], firstCell);
+	pAccumulator->lastCell[row] 	= ksr2_max(pAccumulator->lastCell[row], coveredCell <= 0 ? 0 : lastCell);
+}
+
+//FK: Accumulates the edges of a path that pass through the rows y1 to y2 and reach the pixels from x on.
+ksr2_internal void ksr2_accumulate_path_edges(ksr2_path_accumulator* pAccumulator, const ksr2_path_edge* pEdges, ksr2_u32 edgeCount, ksr2_s32 x, ksr2_s32 y1, ksr2_s32 y2)
+{
+	const ksr2_s32 stripY1 	= y1 << K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 stripY2 	= y2 << K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 windowX1 = x << K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 windowX2 = (x + pAccumulator->width) << K15_RENDERER_2D_SUBPIXEL_BITS;
+
+	for (ksr2_u32 edgeIndex = 0u; edgeIndex < edgeCount; ++edgeIndex)
+	{
+		const ksr2_path_edge* pEdge = pEdges + edgeIndex;
+		const ksr2_b32 isDownwards 	= pEdge->y2 > pEdge->y1;
+		const ksr2_s32 topX 		= isDownwards ? pEdge->x1 : pEdge->x2;
+		const ksr2_s32 topY 		= isDownwards ? pEdge->y1 : pEdge->y2;
+		const ksr2_s32 bottomX 		= isDownwards ? pEdge->x2 : pEdge->x1;
+		const ksr2_s32 bottomY 		= isDownwards ? pEdge->y2 : pEdge->y1;
+
+		if (bottomY <= stripY1 || topY >= stripY2 || ksr2_min(topX, bottomX) >= windowX2)
+		{
+			continue;
+		}
+
+		const ksr2_s32 areaPerSubpixelRow 	= isDownwards ? K15_RENDERER_2D_PATH_AREA_PER_SUBPIXEL_ROW : -K15_RENDERER_2D_PATH_AREA_PER_SUBPIXEL_ROW;
+		const double slope 					= (double)(bottomX - topX) / (double)(bottomY - topY);
+		const ksr2_s32 endY 				= ksr2_min(bottomY, stripY2);
+
+		ksr2_s32 subpixelY = ksr2_max(topY, stripY1);
+
+		//FK: edges left of the accumulator only change the winding of its rows, that's common with narrow tiles
+		if (ksr2_max(topX, bottomX) < windowX1)
+		{
+			while (subpixelY < endY)
+			{
+				const ksr2_s32 nextSubpixelY 	= ksr2_min((subpixelY & ~(K15_RENDERER_2D_SUBPIXEL_ONE - 1)) + K15_RENDERER_2D_SUBPIXEL_ONE, endY);
+				const ksr2_u32 row 				= (ksr2_u32)((subpixelY >> K15_RENDERER_2D_SUBPIXEL_BITS) - y1);
+
+				pAccumulator->cells[row][0] 	+= (nextSubpixelY - subpixelY) * areaPerSubpixelRow;
+				pAccumulator->firstCell[row] 	= 0;
+				pAccumulator->lastCell[row] 	= ksr2_max(pAccumulator->lastCell[row], 0);
+
+				subpixelY = nextSubpixelY;
+			}
+
+			continue;
+		}
+
+		double rowTopX = (double)topX + (double)(subpixelY - topY) * slope;
+
+		while (subpixelY < endY)
+		{
+			const ksr2_s32 nextSubpixelY 	= ksr2_min((subpixelY & ~(K15_RENDERER_2D_SUBPIXEL_ONE - 1)) + K15_RENDERER_2D_SUBPIXEL_ONE, endY);
+			const double rowBottomX 		= (double)topX + (double)(nextSubpixelY - topY) * slope;
+			const ksr2_u32 row 				= (ksr2_u32)((subpixelY >> K15_RENDERER_2D_SUBPIXEL_BITS) - y1);
+
+			ksr2_accumulate_path_row(pAccumulator, row, x, rowTopX, rowBottomX, (nextSubpixelY - subpixelY) * areaPerSubpixelRow);
+
+			subpixelY 	= nextSubpixelY;
+			rowTopX 	= rowBottomX;
+		}
+	}
+}
+
+//FK: Paints a row of pixels with their coverage, covered runs get painted as a single span. Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_paint_path_row(const ksr2_shape_painter* pPainter, ksr2_byte* pRow, const ksr2_u8* pCoverage, ksr2_u32 pixelCount)
+{
+	const ksr2_render_target* pTarget = &pPainter->target;
+	ksr2_pixel_color modulatedSpan[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	size_t writtenPixelCount = 0u;
+	ksr2_u32 x = 0u;
+
+	while (x < pixelCount)
+	{
+		const ksr2_u8 coverage = pCoverage[x];
+		ksr2_u32 runEnd = x + 1u;
+
+		if (coverage == 0u)
+		{
+			while (runEnd < pixelCount && pCoverage[runEnd] == 0u)
+			{
+				++runEnd;
+			}
+
+			x = runEnd;
+			continue;
+		}
+
+		if (coverage == 0xFFu)
+		{
+			while (runEnd < pixelCount && pCoverage[runEnd] == 0xFFu)
+			{
+				++runEnd;
+			}
+
+			pTarget->pKernels->paintSpan[pPainter->operand.blendMode](pTarget, pRow + (size_t)x * pTarget->pixelSizeInBytes, runEnd - x, &pPainter->operand);
+		}
+		else
+		{
+			while (runEnd < pixelCount && pCoverage[runEnd] != 0u && pCoverage[runEnd] != 0xFFu)
+			{
+				++runEnd;
+			}
+
+			pTarget->pKernels->modulateCoverageSpan(modulatedSpan, pCoverage + x, runEnd - x, pPainter->edgeColor);
+			pTarget->pKernels->paintImageSpan[pPainter->edgeBlendMode](pTarget, pRow + (size_t)x * pTarget->pixelSizeInBytes, modulatedSpan, runEnd - x, pPainter->edgeBlendMode);
+		}
+
+		writtenPixelCount += runEnd - x;
+		x = runEnd;
+	}
+
+	return writtenPixelCount;
+}
+
+//FK: Bands of filled and stroked paths. The edges get accumulated in strips of K15_RENDERER_2D_PATH_STRIP_HEIGHT rows and 
+//	  K15_RENDERER_2D_IMAGE_SPAN_SIZE pixels, only the cells between the first and last edge of a row get resolved, the pixels 
+//	  right of the last edge share its coverage. Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_issue_path_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pHeader, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	const ksr2_path_draw_command* pDrawCommand = (const ksr2_path_draw_command*)pHeader;
+	const ksr2_path_edge* pEdges = (const ksr2_path_edge*)(pDrawCommand + 1);
+	ksr2_use_argument(isLastDrawCommand);
+
+	ksr2_rect rect = {0};
+	ksr2_get_path_draw_command_rect(&rect, pDrawCommand);
+	ksr2_clip_rect(&rect, &rect, pClipRect);
+
+	if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+	{
+		return 0u;
+	}
+
+	ksr2_shape_painter painter;
+	ksr2_init_shape_painter(&painter, pContext, pDrawCommand->color, (ksr2_blend_mode)(pHeader->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK));
+
+	const ksr2_fill_rule fillRule = (ksr2_fill_rule)pDrawCommand->fillRule;
+	const ksr2_resolve_coverage_span_fnc resolveCoverageSpan = painter.target.pKernels->resolveCoverageSpan[fillRule];
+
+	ksr2_path_accumulator accumulator;
+	ksr2_u8 coverage[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+	size_t writtenPixelCount = 0u;
+
+	const ksr2_u32 stripHeight 	= ksr2_min(rect.y2 - rect.y1, (ksr2_u32)K15_RENDERER_2D_PATH_STRIP_HEIGHT);
+	const ksr2_u32 maxWidth 	= ksr2_min(rect.x2 - rect.x1, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+
+	for (ksr2_u32 row = 0u; row < stripHeight; ++row)
+	{
+		for (ksr2_u32 cell = 0u; cell < maxWidth; ++cell)
+		{
+			accumulator.cells[row][cell] = 0;
+		}
+	}
+
+	for (ksr2_u32 y = rect.y1; y < rect.y2; y += K15_RENDERER_2D_PATH_STRIP_HEIGHT)
+	{
+		const ksr2_u32 y2 = ksr2_min(y + K15_RENDERER_2D_PATH_STRIP_HEIGHT, rect.y2);
+
+		for (ksr2_u32 x = rect.x1; x < rect.x2; x += K15_RENDERER_2D_IMAGE_SPAN_SIZE)
+		{
+			const ksr2_u32 width = ksr2_min(rect.x2 - x, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+			accumulator.width = (ksr2_s32)width;
+
+			for (ksr2_u32 row = 0u; row < y2 - y; ++row)
+			{
+				accumulator.firstCell[row] 	= (ksr2_s32)width;
+				accumulator.lastCell[row] 	= -1;
+			}
+
+			ksr2_accumulate_path_edges(&accumulator, pEdges, pDrawCommand->edgeCount, (ksr2_s32)x, (ksr2_s32)y, (ksr2_s32)y2);
+
+			ksr2_byte* pRow = ksr2_get_render_target_address(&painter.target, x, y);
+
+			for (ksr2_u32 row = 0u; row < y2 - y; ++row, pRow += painter.target.stride)
+			{
+				const ksr2_s32 firstCell 	= accumulator.firstCell[row];
+				const ksr2_s32 lastCell 	= accumulator.lastCell[row];
+
+				if (firstCell > lastCell)
+				{
+					continue;
+				}
+
+				const ksr2_s32 area = resolveCoverageSpan(coverage + firstCell, accumulator.cells[row] + firstCell, (ksr2_u32)(lastCell - firstCell + 1));
+				const ksr2_u8 remainingCoverage = (ksr2_u8)ksr2_get_path_coverage(area, fillRule);
+				ksr2_u32 pixelCount = (ksr2_u32)lastCell + 1u;
+
+				if (remainingCoverage > 0u)
+				{
+					for (; pixelCount < width; ++pixelCount)
+					{
+						coverage[pixelCount] = remainingCoverage;
+					}
+				}
+
+				writtenPixelCount += ksr2_paint_path_row(&painter, pRow + (size_t)firstCell * painter.target.pixelSizeInBytes, coverage + firstCell, pixelCount - (ksr2_u32)firstCell);
+			}
+		}
+	}
+
+	return writtenPixelCount;
+}
+
+//FK: Returns the number of pixels that got written.
+ksr2_internal size_t ksr2_issue_draw_command(ksr2_context* pContext, const ksr2_draw_command_header* pDrawCommand, const ksr2_rect* pClipRect, ksr2_b32 isLastDrawCommand)
+{
+	switch(pDrawCommand->type)
+	{
+		case K15_RENDERER_2D_DRAW_COMMAND_LINE:
+		case K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE:
+			return ksr2_issue_line_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT:
+		case K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE:
+			return ksr2_issue_filled_rect_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_IMAGE:
+			return ksr2_issue_image_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_TEXT:
+			return ksr2_issue_text_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE:
+			return ksr2_issue_triangle_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE:
+		case K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT:
+			return ksr2_issue_shape_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		case K15_RENDERER_2D_DRAW_COMMAND_PATH:
+			return ksr2_issue_path_draw_command(pContext, pDrawCommand, pClipRect, isLastDrawCommand);
+
+		default:
+			ksr2_assert(ksr2_false);
+		break;
+	}
+
+	return 0u;
+}
+
+ksr2_internal void ksr2_get_draw_command_bounds(ksr2_rect* pOutBounds, const ksr2_draw_command_header* pDrawCommand)
+{
+	ksr2_rect bounds = {0};
+
+	switch(pDrawCommand->type)
+	{
+		case K15_RENDERER_2D_DRAW_COMMAND_LINE:
+		case K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE:
+		{
+			ksr2_line line = {0};
+			ksr2_decode_line_draw_command(&line, pDrawCommand);
+
+			const ksr2_s32 halfThickness = (ksr2_s32)(line.thickness / 2u) + 1;
+			const ksr2_s32 minX = (line.x1 < line.x2 ? line.x1 : line.x2) - halfThickness;
+			const ksr2_s32 minY = (line.y1 < line.y2 ? line.y1 : line.y2) - halfThickness;
+			const ksr2_s32 maxX = (line.x1 > line.x2 ? line.x1 : line.x2) + halfThickness + 1;
+			const ksr2_s32 maxY = (line.y1 > line.y2 ? line.y1 : line.y2) + halfThickness + 1;
+
+			bounds.x1 = minX > 0 ? (ksr2_u32)minX : 0u;
+			bounds.y1 = minY > 0 ? (ksr2_u32)minY : 0u;
+			bounds.x2 = maxX > 0 ? (ksr2_u32)maxX : 0u;
+			bounds.y2 = maxY > 0 ? (ksr2_u32)maxY : 0u;
+			break;
+		}
+
+		case K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT:
+		case K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE:
+		{
+			ksr2_pixel_color color = 0u;
+			ksr2_decode_filled_rect_draw_command(&bounds, &color, pDrawCommand);
+			break;
+		}
+
+		case K15_RENDERER_2D_DRAW_COMMAND_IMAGE:
+			ksr2_get_image_draw_command_rect(&bounds, (const ksr2_image_draw_command*)pDrawCommand);
+		break;
+
+		case K15_RENDERER_2D_DRAW_COMMAND_TEXT:
+			ksr2_get_text_draw_command_rect(&bounds, (const ksr2_text_draw_command*)pDrawCommand);
+		break;
+
+		case K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE:
+			ksr2_get_triangle_draw_command_rect(&bounds, (const ksr2_triangle_draw_command*)pDrawCommand);
+		break;
+
+		case K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE:
+			ksr2_get_ellipse_draw_command_rect(&bounds, (const ksr2_ellipse_draw_command*)pDrawCommand);
+		break;
+
+		case K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT:
+			ksr2_get_rounded_rect_draw_command_rect(&bounds, (const ksr2_rounded_rect_draw_command*)pDrawCommand);
+		break;
+
+		case K15_RENDERER_2D_DRAW_COMMAND_PATH:
+			ksr2_get_path_draw_command_rect(&bounds, (const ksr2_path_draw_command*)pDrawCommand);
+		break;
+
+		default:
+			ksr2_assert(ksr2_false);
+		break;
+	}
+
+	*pOutBounds = bounds;
+}
+
+ksr2_internal ksr2_b32 ksr2_get_draw_command_tile_range(ksr2_rect* pOutTileRange, const ksr2_draw_command_header* pDrawCommand, const ksr2_tile_bins* pTileBins, ksr2_u32 width, ksr2_u32 height)
+{
+	ksr2_rect bounds = {0};
+	ksr2_get_draw_command_bounds(&bounds, pDrawCommand);
+
+	bounds.x2 = bounds.x2 < width ? bounds.x2 : width;
+	bounds.y2 = bounds.y2 < height ? bounds.y2 : height;
+
+	if (bounds.x1 >= bounds.x2 || bounds.y1 >= bounds.y2)
+	{
+		return ksr2_false;
+	}
+
+	//FK: tile range is inclusive
+	pOutTileRange->x1 = bounds.x1 / pTileBins->tileSize;
+	pOutTileRange->y1 = bounds.y1 / pTileBins->tileSize;
+	pOutTileRange->x2 = (bounds.x2 - 1u) / pTileBins->tileSize;
+	pOutTileRange->y2 = (bounds.y2 - 1u) / pTileBins->tileSize;
+
+	return ksr2_true;
+}
+
+ksr2_internal ksr2_u32 ksr2_get_tile_count(ksr2_u32 tileSize, ksr2_u32 width, ksr2_u32 height)
+{
+	return ((width + tileSize - 1u) / tileSize) * ((height + tileSize - 1u) / tileSize);
+}
+
+ksr2_internal void ksr2_set_image_damage_rect(ksr2_dirty_region_tracker* pTracker, const ksr2_swap_chain* pSwapChain)
+{
+	pTracker->imageDamageRect.x1 	= 0u;
+	pTracker->imageDamageRect.y1 	= 0u;
+	pTracker->imageDamageRect.x2 	= pSwapChain->width;
+	pTracker->imageDamageRect.y2 	= pSwapChain->height;
+	pTracker->pDamageRects 			= &pTracker->imageDamageRect;
+	pTracker->damageRectCount 		= 1u;
+}
+
+ksr2_internal size_t ksr2_get_dirty_region_tracker_size_in_bytes(const ksr2_swap_chain* pSwapChain, ksr2_u32 tileSize, ksr2_u32 contextFlags)
+{
+	if ((contextFlags & K15_RENDERER_2D_DIRTY_REGION_TRACKING) == 0u)
+	{
+		return 0u;
+	}
+
+	//FK: plus alignment padding of the 3 allocations
+	const size_t tileCount = ksr2_get_tile_count(tileSize, pSwapChain->width, pSwapChain->height);
+	return tileCount * (sizeof(ksr2_u64) * pSwapChain->imageCount + sizeof(ksr2_damage_rect) + sizeof(ksr2_u8)) + 3u * ksr2_default_alignment;
+}
+
+//FK: Gets allocated from the allocator front right after the swap chain images
+ksr2_internal ksr2_result ksr2_init_dirty_region_tracker(ksr2_dirty_region_tracker* pTracker, ksr2_linear_allocator* pAllocator, const ksr2_swap_chain* pSwapChain, ksr2_u32 tileSize, ksr2_u32 contextFlags)
+{
+	ksr2_dirty_region_tracker tracker = {0};
+	ksr2_set_image_damage_rect(&tracker, pSwapChain);
+
+	if ((contextFlags & K15_RENDERER_2D_DIRTY_REGION_TRACKING) == 0u)
+	{
+		*pTracker = tracker;
+		pTracker->pDamageRects = &pTracker->imageDamageRect;
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	tracker.tileCount = ksr2_get_tile_count(tileSize, pSwapChain->width, pSwapChain->height);
+	const ksr2_u32 tileHashCount = tracker.tileCount * pSwapChain->imageCount;
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front((void**)&tracker.pTileHashes, pAllocator, sizeof(ksr2_u64) * tileHashCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	result = ksr2_allocate_from_linear_allocator_front((void**)&tracker.pDamageRects, pAllocator, sizeof(ksr2_damage_rect) * tracker.tileCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	result = ksr2_allocate_from_linear_allocator_front((void**)&tracker.pTileStates, pAllocator, sizeof(ksr2_u8) * tracker.tileCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	for (ksr2_u32 tileHashIndex = 0u; tileHashIndex < tileHashCount; ++tileHashIndex)
+	{
+		tracker.pTileHashes[tileHashIndex] = 0u;
+	}
+
+	//FK: nothing got rasterized yet, so the first ksr2_blit damages the whole image
+	tracker.pDamageRects[0]	= tracker.imageDamageRect;
+	tracker.damageRectCount = 1u;
+
+	*pTracker = tracker;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: FNV-1a over 32 bit words instead of bytes, draw commands are always a multiple of 4 bytes
+ksr2_internal ksr2_u64 ksr2_hash_u32(ksr2_u64 hash, ksr2_u32 value)
+{
+	return (hash ^ value) * 0x100000001B3ull;
+}
+
+ksr2_internal ksr2_u64 ksr2_hash_tile(const ksr2_context* pContext, const ksr2_tile_bins* pTileBins, ksr2_u32 tileIndex)
+{
+	ksr2_u64 hash = 0xCBF29CE484222325ull;
+	hash = ksr2_hash_u32(hash, pContext->clearImage);
+	hash = ksr2_hash_u32(hash, pContext->clearImage ? pContext->clearColor : 0u);
+
+	const ksr2_u32 binStart = pTileBins->pTileBinOffsets[tileIndex];
+	const ksr2_u32 binEnd 	= pTileBins->pTileBinOffsets[tileIndex + 1u];
+
+	for (ksr2_u32 binIndex = binStart; binIndex < binEnd; ++binIndex)
+	{
+		const ksr2_u32* pWords 		= (const ksr2_u32*)pTileBins->pBinnedDrawCommands[binIndex];
+		const ksr2_u32 wordCount 	= pTileBins->pBinnedDrawCommands[binIndex]->sizeInBytes / 4u;
+
+		for (ksr2_u32 wordIndex = 0u; wordIndex < wordCount; ++wordIndex)
+		{
+			hash = ksr2_hash_u32(hash, pWords[wordIndex]);
+		}
+	}
+
+	return hash | 1u;
+}
+
+//FK: Decides per tile whether it has to be rasterized, can be copied from the previous image or can be skipped.
+//	  Tiles that differ from the previous image end up in the damage list, horizontally adjacent tiles get merged.
+ksr2_internal void ksr2_update_dirty_regions(ksr2_context* pContext, ksr2_tile_bins* pTileBins)
+{
+	ksr2_dirty_region_tracker* pTracker = &pContext->dirtyRegionTracker;
+	const ksr2_swap_chain* pSwapChain 	= &pContext->swapChain;
+
+	ksr2_u64* pCurrentTileHashes 		= pTracker->pTileHashes + (size_t)pSwapChain->imageIndex * pTracker->tileCount;
+	const ksr2_u64* pPreviousTileHashes = pTracker->hasPreviousImage ? pTracker->pTileHashes + (size_t)pTracker->previousImageIndex * pTracker->tileCount : ksr2_nullptr;
+
+	pTracker->damageRectCount = 0u;
+
+	for (ksr2_u32 tileY = 0u; tileY < pTileBins->tileCountY; ++tileY)
+	{
+		ksr2_damage_rect* pDamageRect = ksr2_nullptr;
+
+		for (ksr2_u32 tileX = 0u; tileX < pTileBins->tileCountX; ++tileX)
+		{
+			const ksr2_u32 tileIndex 	= tileX + tileY * pTileBins->tileCountX;
+			const ksr2_u64 tileHash 	= ksr2_hash_tile(pContext, pTileBins, tileIndex);
+			const ksr2_u64 previousHash = pPreviousTileHashes != ksr2_nullptr ? pPreviousTileHashes[tileIndex] : 0u;
+
+			if (tileHash == pCurrentTileHashes[tileIndex])
+			{
+				pTracker->pTileStates[tileIndex] = K15_RENDERER_2D_TILE_STATE_SKIP;
+			}
+			else if (tileHash == previousHash)
+			{
+				pTracker->pTileStates[tileIndex] = K15_RENDERER_2D_TILE_STATE_COPY;
+			}
+			else
+			{
+				pTracker->pTileStates[tileIndex] = K15_RENDERER_2D_TILE_STATE_RASTERIZE;
+			}
+
+			pCurrentTileHashes[tileIndex] = tileHash;
+
+			if (tileHash == previousHash)
+			{
+				pDamageRect = ksr2_nullptr;
+				continue;
+			}
+
+			const ksr2_u32 x2 = ksr2_min((tileX + 1u) * pTileBins->tileSize, pSwapChain->width);
+
+			if (pDamageRect != ksr2_nullptr)
+			{
+				pDamageRect->x2 = x2;
+				continue;
+			}
+
+			pDamageRect = &pTracker->pDamageRects[pTracker->damageRectCount++];
+			pDamageRect->x1 = tileX * pTileBins->tileSize;
+			pDamageRect->y1 = tileY * pTileBins->tileSize;
+			pDamageRect->x2 = x2;
+			pDamageRect->y2 = ksr2_min((tileY + 1u) * pTileBins->tileSize, pSwapChain->height);
+		}
+	}
+
+	pTileBins->pTileStates 		= pTracker->pTileStates;
+	pTileBins->pPreviousImage 	= pTracker->hasPreviousImage ? ksr2_get_swap_chain_image(pSwapChain, pTracker->previousImageIndex) : ksr2_nullptr;
+}
+
+//FK: The image got rasterized without dirty region tracking, its tiles can't be trusted anymore.
+ksr2_internal void ksr2_invalidate_dirty_regions(ksr2_context* pContext)
+{
+	ksr2_dirty_region_tracker* pTracker = &pContext->dirtyRegionTracker;
+	ksr2_u64* pCurrentTileHashes = pTracker->pTileHashes + (size_t)pContext->swapChain.imageIndex * pTracker->tileCount;
+
+	for (ksr2_u32 tileIndex = 0u; tileIndex < pTracker->tileCount; ++tileIndex)
+	{
+		pCurrentTileHashes[tileIndex] = 0u;
+	}
+
+	pTracker->pDamageRects[0] 	= pTracker->imageDamageRect;
+	pTracker->damageRectCount 	= 1u;
+}
+
+ksr2_internal ksr2_result ksr2_bin_draw_commands(ksr2_tile_bins* pOutTileBins, ksr2_context* pContext)
+{
+	const ksr2_u32 width 		= pContext->swapChain.width;
+	const ksr2_u32 height 		= pContext->swapChain.height;
+	const ksr2_u32 tileSize		= pContext->tileSize;
+
+	ksr2_tile_bins tileBins = {0};
+	tileBins.tileSize 	= tileSize;
+	tileBins.tileCountX = (width + tileSize - 1u) / tileSize;
+	tileBins.tileCountY = (height + tileSize - 1u) / tileSize;
+
+	const ksr2_u32 tileCount = tileBins.tileCountX * tileBins.tileCountY;
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_back((void**)&tileBins.pTileBinOffsets, &pContext->allocator, sizeof(ksr2_u32) * (tileCount + 1u), ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	for (ksr2_u32 tileIndex = 0u; tileIndex <= tileCount; ++tileIndex)
+	{
+		tileBins.pTileBinOffsets[tileIndex] = 0u;
+	}
+
+	//FK: first pass - count draw commands per tile
+	ksr2_rect tileRange = {0};
+	ksr2_draw_command_iterator drawCommandIterator = {0};
+	ksr2_init_draw_command_iterator(&drawCommandIterator, &pContext->commandList.drawCommandStream);
+
+	const ksr2_draw_command_header* pDrawCommand = ksr2_nullptr;
+	while((pDrawCommand = ksr2_next_draw_command(&drawCommandIterator)) != ksr2_nullptr)
+	{
+		if (ksr2_get_draw_command_tile_range(&tileRange, pDrawCommand, &tileBins, width, height))
+		{
+			for (ksr2_u32 tileY = tileRange.y1; tileY <= tileRange.y2; ++tileY)
+			{
+				for (ksr2_u32 tileX = tileRange.x1; tileX <= tileRange.x2; ++tileX)
+				{
+					++tileBins.pTileBinOffsets[tileX + tileY * tileBins.tileCountX + 1u];
+				}
+			}
+		}
+	}
+
+	for (ksr2_u32 tileIndex = 1u; tileIndex <= tileCount; ++tileIndex)
+	{
+		tileBins.pTileBinOffsets[tileIndex] += tileBins.pTileBinOffsets[tileIndex - 1u];
+	}
+
+	const ksr2_u32 binnedDrawCommandCount = tileBins.pTileBinOffsets[tileCount];
+	result = ksr2_allocate_from_linear_allocator_back((void**)&tileBins.pBinnedDrawCommands, &pContext->allocator, sizeof(const ksr2_draw_command_header*) * binnedDrawCommandCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	//FK: occlusion culling is optional, don't fail if there's not enough memory left for it
+	if (tileSize <= K15_RENDERER_2D_MAX_OCCLUSION_CULLING_TILE_SIZE)
+	{
+		if (ksr2_allocate_from_linear_allocator_back((void**)&tileBins.pBinnedClipRects, &pContext->allocator, sizeof(ksr2_bin_clip_rect) * binnedDrawCommandCount, ksr2_default_alignment) != K15_RENDERER_2D_RESULT_SUCCESS ||
+			ksr2_allocate_from_linear_allocator_back((void**)&tileBins.pTileCulledPixelCounts, &pContext->allocator, sizeof(ksr2_u32) * tileCount, ksr2_default_alignment) != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			tileBins.pBinnedClipRects 		= ksr2_nullptr;
+			tileBins.pTileCulledPixelCounts = ksr2_nullptr;
+		}
+	}
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	if (ksr2_allocate_from_linear_allocator_back((void**)&tileBins.pTileWrittenPixelCounts, &pContext->allocator, sizeof(ksr2_u32) * tileCount, ksr2_default_alignment) != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		tileBins.pTileWrittenPixelCounts = ksr2_nullptr;
+	}
+#endif
+
+	//FK: second pass - fill the bins. The offsets get advanced while filling, so afterwards each one 
+	//	  points to the start of the next bin and they have to be shifted back by one tile.
+	ksr2_init_draw_command_iterator(&drawCommandIterator, &pContext->commandList.drawCommandStream);
+	while((pDrawCommand = ksr2_next_draw_command(&drawCommandIterator)) != ksr2_nullptr)
+	{
+		if (ksr2_get_draw_command_tile_range(&tileRange, pDrawCommand, &tileBins, width, height))
+		{
+			for (ksr2_u32 tileY = tileRange.y1; tileY <= tileRange.y2; ++tileY)
+			{
+				for (ksr2_u32 tileX = tileRange.x1; tileX <= tileRange.x2; ++tileX)
+				{
+					ksr2_u32* pTileBinOffset = &tileBins.pTileBinOffsets[tileX + tileY * tileBins.tileCountX];
+					tileBins.pBinnedDrawCommands[*pTileBinOffset] = pDrawCommand;
+					++(*pTileBinOffset);
+				}
+			}
+		}
+	}
+
+	for (ksr2_u32 tileIndex = tileCount; tileIndex > 0u; --tileIndex)
+	{
+		tileBins.pTileBinOffsets[tileIndex] = tileBins.pTileBinOffsets[tileIndex - 1u];
+	}
+	tileBins.pTileBinOffsets[0] = 0u;
+
+	*pOutTileBins = tileBins;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+enum
+{
+	K15_RENDERER_2D_OCCLUSION_WORDS_PER_ROW = (K15_RENDERER_2D_MAX_OCCLUSION_CULLING_TILE_SIZE + 63) / 64
+};
+
+//FK: One bit per pixel of the tile, set if a later opaque draw command writes the pixel
+typedef struct
+{
+	ksr2_u64 rows[K15_RENDERER_2D_MAX_OCCLUSION_CULLING_TILE_SIZE][K15_RENDERER_2D_OCCLUSION_WORDS_PER_ROW];
+} ksr2_tile_coverage;
+
+//FK: bits of the pixel range [x1, x2) that fall into the given word of a coverage row
+ksr2_internal ksr2_u64 ksr2_get_coverage_mask(ksr2_u32 wordIndex, ksr2_u32 x1, ksr2_u32 x2)
+{
+	const ksr2_u32 wordStart 	= wordIndex * 64u;
+	const ksr2_u32 firstBit 	= x1 > wordStart ? x1 - wordStart : 0u;
+	const ksr2_u32 endBit 		= x2 - wordStart < 64u ? x2 - wordStart : 64u;
+	const ksr2_u64 endMask 		= endBit == 64u ? ~0ull : (1ull << endBit) - 1u;
+
+	return endMask & ~((1ull << firstBit) - 1u);
+}
+
+//FK: Trims the rect to the bounds of its pixels that aren't covered yet, returns false if all of them are covered.
+ksr2_internal ksr2_b32 ksr2_trim_covered_rect(ksr2_bin_clip_rect* pRect, const ksr2_tile_coverage* pCoverage)
+{
+	ksr2_u64 visibleColumns[K15_RENDERER_2D_OCCLUSION_WORDS_PER_ROW] = {0};
+	ksr2_u32 firstVisibleRow 	= pRect->y2;
+	ksr2_u32 endVisibleRow 		= pRect->y1;
+
+	const ksr2_u32 firstWordIndex 	= pRect->x1 / 64u;
+	const ksr2_u32 endWordIndex		= (pRect->x2 + 63u) / 64u;
+
+	for (ksr2_u32 y = pRect->y1; y < pRect->y2; ++y)
+	{
+		ksr2_u64 visibleRowPixels = 0u;
+
+		for (ksr2_u32 wordIndex = firstWordIndex; wordIndex < endWordIndex; ++wordIndex)
+		{
+			const ksr2_u64 visibleWordPixels = ksr2_get_coverage_mask(wordIndex, pRect->x1, pRect->x2) & ~pCoverage->rows[y][wordIndex];
+			visibleColumns[wordIndex] |= visibleWordPixels;
+			visibleRowPixels |= visibleWordPixels;
+		}
+
+		if (visibleRowPixels != 0u)
+		{
+			firstVisibleRow = firstVisibleRow < y ? firstVisibleRow : y;
+			endVisibleRow 	= y + 1u;
+		}
+	}
+
+	if (firstVisibleRow >= endVisibleRow)
+	{
+		return ksr2_false;
+	}
+
+	ksr2_u32 firstWordWithVisibleColumns = firstWordIndex;
+	while(visibleColumns[firstWordWithVisibleColumns] == 0u)
+	{
+		++firstWordWithVisibleColumns;
+	}
+
+	ksr2_u32 lastWordWithVisibleColumns = endWordIndex - 1u;
+	while(visibleColumns[lastWordWithVisibleColumns] == 0u)
+	{
+		--lastWordWithVisibleColumns;
+	}
+
+	pRect->x1 = (ksr2_u16)(firstWordWithVisibleColumns * 64u + ksr2_find_lowest_set_bit(visibleColumns[firstWordWithVisibleColumns]));
+	pRect->x2 = (ksr2_u16)(lastWordWithVisibleColumns * 64u + ksr2_find_highest_set_bit(visibleColumns[lastWordWithVisibleColumns]) + 1u);
+	pRect->y1 = (ksr2_u16)firstVisibleRow;
+	pRect->y2 = (ksr2_u16)endVisibleRow;
+
+	return ksr2_true;
+}
+
+ksr2_internal void ksr2_cover_rect(ksr2_tile_coverage* pCoverage, const ksr2_bin_clip_rect* pRect)
+{
+	const ksr2_u32 firstWordIndex 	= pRect->x1 / 64u;
+	const ksr2_u32 endWordIndex		= (pRect->x2 + 63u) / 64u;
+
+	for (ksr2_u32 y = pRect->y1; y < pRect->y2; ++y)
+	{
+		for (ksr2_u32 wordIndex = firstWordIndex; wordIndex < endWordIndex; ++wordIndex)
+		{
+			pCoverage->rows[y][wordIndex] |= ksr2_get_coverage_mask(wordIndex, pRect->x1, pRect->x2);
+		}
+	}
+}
+
+//FK: Walks the bin of the tile back to front and culls or trims filled rects and images that are (partially) covered by later
+//	  opaque filled rects or images. Writes the clip rect for every binned draw command, returns the number of pixels that
+//	  don't need to be written. *pOutTileCovered is set if the whole tile is covered.
+ksr2_internal ksr2_u32 ksr2_cull_occluded_draw_commands(const ksr2_tile_bins* pTileBins, ksr2_u32 tileIndex, const ksr2_rect* pTileRect, ksr2_b32* pOutTileCovered)
+{
+	const ksr2_u32 binStart 	= pTileBins->pTileBinOffsets[tileIndex];
+	const ksr2_u32 binEnd		= pTileBins->pTileBinOffsets[tileIndex + 1u];
+	const ksr2_u32 tileWidth 	= pTileRect->x2 - pTileRect->x1;
+	const ksr2_u32 tileHeight 	= pTileRect->y2 - pTileRect->y1;
+
+	ksr2_tile_coverage coverage;
+	for (ksr2_u32 y = 0u; y < tileHeight; ++y)
+	{
+		for (ksr2_u32 wordIndex = 0u; wordIndex < K15_RENDERER_2D_OCCLUSION_WORDS_PER_ROW; ++wordIndex)
+		{
+			coverage.rows[y][wordIndex] = 0u;
+		}
+	}
+
+	ksr2_bin_clip_rect tileClipRect = {0};
+	tileClipRect.x2 = (ksr2_u16)tileWidth;
+	tileClipRect.y2 = (ksr2_u16)tileHeight;
+
+	ksr2_u32 culledPixelCount = 0u;
+
+	for (ksr2_u32 binIndex = binEnd; binIndex > binStart; --binIndex)
+	{
+		const ksr2_draw_command_header* pDrawCommand = pTileBins->pBinnedDrawCommands[binIndex - 1u];
+		ksr2_bin_clip_rect* pClipRect = &pTileBins->pBinnedClipRects[binIndex - 1u];
+		*pClipRect = tileClipRect;
+
+		if (pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_LINE || pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE || pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE)
+		{
+			continue;
+		}
+
+		//FK: opaque images don't have transparent pixels, see ksr2_draw_image()
+		ksr2_rect rect = {0};
+		ksr2_get_draw_command_bounds(&rect, pDrawCommand);
+		ksr2_clip_rect(&rect, &rect, pTileRect);
+
+		pClipRect->x1 = (ksr2_u16)(rect.x1 - pTileRect->x1);
+		pClipRect->y1 = (ksr2_u16)(rect.y1 - pTileRect->y1);
+		pClipRect->x2 = (ksr2_u16)(rect.x2 - pTileRect->x1);
+		pClipRect->y2 = (ksr2_u16)(rect.y2 - pTileRect->y1);
+
+		const ksr2_bin_clip_rect rectClipRect = *pClipRect;
+		const ksr2_u32 pixelCount = (ksr2_u32)(rectClipRect.x2 - rectClipRect.x1) * (ksr2_u32)(rectClipRect.y2 - rectClipRect.y1);
+
+		if (ksr2_trim_covered_rect(pClipRect, &coverage) == ksr2_false)
+		{
+			pClipRect->x1 = 0u;
+			pClipRect->x2 = 0u;
+			culledPixelCount += pixelCount;
+			continue;
+		}
+
+		culledPixelCount += pixelCount - (ksr2_u32)(pClipRect->x2 - pClipRect->x1) * (ksr2_u32)(pClipRect->y2 - pClipRect->y1);
+
+		//FK: shapes can get culled, but their anti-aliased edges don't cover their bounds even if they're opaque
+		const ksr2_b32 isShape = pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE || pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT || pDrawCommand->type == K15_RENDERER_2D_DRAW_COMMAND_PATH;
+
+		if ((pDrawCommand->flags & K15_RENDERER_2D_DRAW_COMMAND_BLEND_MODE_MASK) == K15_RENDERER_2D_BLEND_MODE_OPAQUE && isShape == ksr2_false)
+		{
+			ksr2_cover_rect(&coverage, &rectClipRect);
+		}
+	}
+
+	*pOutTileCovered = ksr2_trim_covered_rect(&tileClipRect, &coverage) == ksr2_false;
+
+	return culledPixelCount;
+}
+
+ksr2_internal void ksr2_set_tile_written_pixel_count(const ksr2_tile_bins* pTileBins, ksr2_u32 tileIndex, size_t writtenPixelCount)
+{
+	if (pTileBins->pTileWrittenPixelCounts != ksr2_nullptr)
+	{
+		pTileBins->pTileWrittenPixelCounts[tileIndex] = (ksr2_u32)writtenPixelCount;
+	}
+}
+
+ksr2_internal void ksr2_rasterize_tile(ksr2_context* pContext, const ksr2_tile_bins* pTileBins, ksr2_u32 tileX, ksr2_u32 tileY)
+{
+	const ksr2_u32 tileIndex 	= tileX + tileY * pTileBins->tileCountX;
+	const ksr2_u32 binStart 	= pTileBins->pTileBinOffsets[tileIndex];
+	const ksr2_u32 binEnd		= pTileBins->pTileBinOffsets[tileIndex + 1u];
+
+	ksr2_rect tileRect = {0};
+	tileRect.x1 = tileX * pTileBins->tileSize;
+	tileRect.y1 = tileY * pTileBins->tileSize;
+	tileRect.x2 = tileRect.x1 + pTileBins->tileSize;
+	tileRect.y2 = tileRect.y1 + pTileBins->tileSize;
+
+	tileRect.x2 = tileRect.x2 < pContext->swapChain.width ? tileRect.x2 : pContext->swapChain.width;
+	tileRect.y2 = tileRect.y2 < pContext->swapChain.height ? tileRect.y2 : pContext->swapChain.height;
+
+	const ksr2_u8 tileState = pTileBins->pTileStates != ksr2_nullptr ? pTileBins->pTileStates[tileIndex] : K15_RENDERER_2D_TILE_STATE_RASTERIZE;
+
+	ksr2_render_target target;
+	ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+	if (pTileBins->pTileCulledPixelCounts != ksr2_nullptr)
+	{
+		pTileBins->pTileCulledPixelCounts[tileIndex] = 0u;
+	}
+
+	ksr2_set_tile_written_pixel_count(pTileBins, tileIndex, 0u);
+
+	if (tileState == K15_RENDERER_2D_TILE_STATE_SKIP)
+	{
+		return;
+	}
+
+	if (tileState == K15_RENDERER_2D_TILE_STATE_COPY)
+	{
+		ksr2_copy_rect(&target, pTileBins->pPreviousImage, &tileRect);
+
+		ksr2_set_tile_written_pixel_count(pTileBins, tileIndex, ksr2_get_rect_pixel_count(&tileRect));
+		return;
+	}
+
+	ksr2_b32 tileCovered = ksr2_false;
+	size_t writtenPixelCount = 0u;
+
+	if (pTileBins->pBinnedClipRects != ksr2_nullptr)
+	{
+		pTileBins->pTileCulledPixelCounts[tileIndex] = ksr2_cull_occluded_draw_commands(pTileBins, tileIndex, &tileRect, &tileCovered);
+	}
+
+	if (pContext->clearImage)
+	{
+		if (tileCovered)
+		{
+			pTileBins->pTileCulledPixelCounts[tileIndex] += (tileRect.x2 - tileRect.x1) * (tileRect.y2 - tileRect.y1);
+		}
+		else
+		{
+			ksr2_rect imageRect = {0};
+			imageRect.x2 = pContext->swapChain.width;
+			imageRect.y2 = pContext->swapChain.height;
+
+			const ksr2_b32 nonTemporal = ksr2_use_non_temporal_stores(&target, &imageRect, binStart == binEnd);
+			ksr2_fill_rect(&target, &tileRect, pContext->clearColor, nonTemporal);
+			writtenPixelCount += ksr2_get_rect_pixel_count(&tileRect);
+		}
+	}
+
+	for (ksr2_u32 binIndex = binStart; binIndex < binEnd; ++binIndex)
+	{
+		ksr2_rect clipRect = tileRect;
+
+		if (pTileBins->pBinnedClipRects != ksr2_nullptr)
+		{
+			const ksr2_bin_clip_rect* pBinClipRect = &pTileBins->pBinnedClipRects[binIndex];
+
+			if (pBinClipRect->x1 >= pBinClipRect->x2)
+			{
+				continue;
+			}
+
+			clipRect.x1 = tileRect.x1 + pBinClipRect->x1;
+			clipRect.y1 = tileRect.y1 + pBinClipRect->y1;
+			clipRect.x2 = tileRect.x1 + pBinClipRect->x2;
+			clipRect.y2 = tileRect.y1 + pBinClipRect->y2;
+		}
+
+		writtenPixelCount += ksr2_issue_draw_command(pContext, pTileBins->pBinnedDrawCommands[binIndex], &clipRect, binIndex + 1u == binEnd);
+	}
+
+	ksr2_set_tile_written_pixel_count(pTileBins, tileIndex, writtenPixelCount);
+}
+
+ksr2_internal void ksr2_rasterize_and_trace_tile(ksr2_context* pContext, const ksr2_tile_bins* pTileBins, ksr2_u32 tileIndex, ksr2_u32 threadIndex)
+{
+	const ksr2_u32 tileX = tileIndex % pTileBins->tileCountX;
+	const ksr2_u32 tileY = tileIndex / pTileBins->tileCountX;
+
+	//FK: don't flood the trace with tiles that didn't change
+	if (pTileBins->pTileStates != ksr2_nullptr && pTileBins->pTileStates[tileIndex] == K15_RENDERER_2D_TILE_STATE_SKIP)
+	{
+		ksr2_rasterize_tile(pContext, pTileBins, tileX, tileY);
+		return;
+	}
+
+	const ksr2_u64 beginTimeInNs = ksr2_trace_begin(pContext);
+	ksr2_rasterize_tile(pContext, pTileBins, tileX, tileY);
+	ksr2_trace_end(pContext, "rasterize tile", beginTimeInNs, threadIndex, tileIndex);
+}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+ksr2_internal ksr2_u64 ksr2_pack_tile_range(ksr2_u32 firstTileIndex, ksr2_u32 endTileIndex)
+{
+	return (ksr2_u64)firstTileIndex | ((ksr2_u64)endTileIndex << 32u);
+}
+
+ksr2_internal void ksr2_unpack_tile_range(ksr2_u64 tileRange, ksr2_u32* pOutFirstTileIndex, ksr2_u32* pOutEndTileIndex)
+{
+	*pOutFirstTileIndex = (ksr2_u32)(tileRange & 0xFFFFFFFFu);
+	*pOutEndTileIndex 	= (ksr2_u32)(tileRange >> 32u);
+}
+
+//FK: The owning worker takes tiles from the front of its queue...
+ksr2_internal ksr2_b32 ksr2_pop_tile(ksr2_tile_queue* pTileQueue, ksr2_u32* pOutTileIndex)
+{
+	ksr2_u32 firstTileIndex = 0u;
+	ksr2_u32 endTileIndex	= 0u;
+
+	for (;;)
+	{
+		const ksr2_u64 tileRange = ksr2_atomic_load_u64(&pTileQueue->tileRange);
+		ksr2_unpack_tile_range(tileRange, &firstTileIndex, &endTileIndex);
+
+		if (firstTileIndex >= endTileIndex)
+		{
+			return ksr2_false;
+		}
+
+		if (ksr2_atomic_compare_exchange_u64(&pTileQueue->tileRange, tileRange, ksr2_pack_tile_range(firstTileIndex + 1u, endTileIndex)) == tileRange)
+		{
+			*pOutTileIndex = firstTileIndex;
+			return ksr2_true;
+		}
+	}
+}
+
+//FK: ...while other workers steal from the back so they don't fight over the same tiles.
+ksr2_internal ksr2_b32 ksr2_steal_tile(ksr2_tile_queue* pTileQueue, ksr2_u32* pOutTileIndex)
+{
+	ksr2_u32 firstTileIndex = 0u;
+	ksr2_u32 endTileIndex	= 0u;
+
+	for (;;)
+	{
+		const ksr2_u64 tileRange = ksr2_atomic_load_u64(&pTileQueue->tileRange);
+		ksr2_unpack_tile_range(tileRange, &firstTileIndex, &endTileIndex);
+
+		if (firstTileIndex >= endTileIndex)
+		{
+			return ksr2_false;
+		}
+
+		if (ksr2_atomic_compare_exchange_u64(&pTileQueue->tileRange, tileRange, ksr2_pack_tile_range(firstTileIndex, endTileIndex - 1u)) == tileRange)
+		{
+			*pOutTileIndex = endTileIndex - 1u;
+			return ksr2_true;
+		}
+	}
+}
+
+ksr2_internal void ksr2_rasterize_queued_tiles(ksr2_worker_pool* pWorkerPool, ksr2_u32 workerIndex)
+{
+	const ksr2_tile_bins* pTileBins = pWorkerPool->pTileBins;
+	const ksr2_u32 queueCount = pWorkerPool->workerCount + 1u;
+	const ksr2_u32 threadIndex = workerIndex < pWorkerPool->workerCount ? workerIndex + 1u : ksr2_get_rasterize_thread_index(pWorkerPool->pContext);
+	ksr2_u32 tileIndex = 0u;
+
+	while(ksr2_pop_tile(&pWorkerPool->pTileQueues[workerIndex], &tileIndex))
+	{
+		ksr2_rasterize_and_trace_tile(pWorkerPool->pContext, pTileBins, tileIndex, threadIndex);
+	}
+
+	//FK: Own queue is empty, help out the others. No new tiles get queued during a frame, so one sweep over all queues is enough.
+	for (ksr2_u32 queueOffset = 1u; queueOffset < queueCount; ++queueOffset)
+	{
+		ksr2_tile_queue* pVictimTileQueue = &pWorkerPool->pTileQueues[(workerIndex + queueOffset) % queueCount];
+
+		while(ksr2_steal_tile(pVictimTileQueue, &tileIndex))
+		{
+			ksr2_rasterize_and_trace_tile(pWorkerPool->pContext, pTileBins, tileIndex, threadIndex);
+		}
+	}
+}
+
+ksr2_internal void ksr2_worker_thread_fnc(void* pArgument)
+{
+	ksr2_worker* pWorker = (ksr2_worker*)pArgument;
+	ksr2_worker_pool* pWorkerPool = pWorker->pWorkerPool;
+	ksr2_u32 frameIndex = 0u;
+
+	while(ksr2_true)
+	{
+		ksr2_lock_mutex(&pWorkerPool->mutex);
+
+		while(pWorkerPool->shutdown == ksr2_false && pWorkerPool->frameIndex == frameIndex)
+		{
+			ksr2_wait_condition_variable(&pWorkerPool->workAvailable, &pWorkerPool->mutex);
+		}
+
+		if (pWorkerPool->shutdown)
+		{
+			ksr2_unlock_mutex(&pWorkerPool->mutex);
+			break;
+		}
+
+		frameIndex = pWorkerPool->frameIndex;
+		ksr2_unlock_mutex(&pWorkerPool->mutex);
+
+		ksr2_rasterize_queued_tiles(pWorkerPool, pWorker->workerIndex);
+
+		ksr2_lock_mutex(&pWorkerPool->mutex);
+		if (--pWorkerPool->busyWorkerCount == 0u)
+		{
+			ksr2_broadcast_condition_variable(&pWorkerPool->workFinished);
+		}
+		ksr2_unlock_mutex(&pWorkerPool->mutex);
+	}
+}
+
+ksr2_internal void ksr2_destroy_worker_pool(ksr2_worker_pool* pWorkerPool)
+{
+	ksr2_lock_mutex(&pWorkerPool->mutex);
+	pWorkerPool->shutdown = ksr2_true;
+	ksr2_broadcast_condition_variable(&pWorkerPool->workAvailable);
+	ksr2_unlock_mutex(&pWorkerPool->mutex);
+
+	for (ksr2_u32 workerIndex = 0u; workerIndex < pWorkerPool->workerCount; ++workerIndex)
+	{
+		ksr2_join_thread(&pWorkerPool->pWorkers[workerIndex].thread);
+	}
+
+	ksr2_destroy_condition_variable(&pWorkerPool->workFinished);
+	ksr2_destroy_condition_variable(&pWorkerPool->workAvailable);
+	ksr2_destroy_mutex(&pWorkerPool->mutex);
+
+	pWorkerPool->workerCount = 0u;
+}
+
+//FK: Allocates the workers of the pool, the threads get started by ksr2_start_worker_pool() once the rest of the context 
+//	  is set up. Threads that got started before an allocation failed would keep waiting on memory the caller takes back.
+ksr2_internal ksr2_result ksr2_init_worker_pool(ksr2_worker_pool* pWorkerPool, struct ksr2_context* pContext, ksr2_linear_allocator* pAllocator, ksr2_u32 workerCount)
+{
+	ksr2_worker_pool workerPool = {0};
+	workerPool.pContext = pContext;
+
+	*pWorkerPool = workerPool;
+
+	if (workerCount == 0u)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front((void**)&pWorkerPool->pWorkers, pAllocator, sizeof(ksr2_worker) * workerCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	result = ksr2_allocate_from_linear_allocator_front((void**)&pWorkerPool->pTileQueues, pAllocator, sizeof(ksr2_tile_queue) * (workerCount + 1u), ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	pWorkerPool->allocatedWorkerCount = workerCount;
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: Returns the number of threads that could be created, the pool keeps working with fewer workers.
+ksr2_internal ksr2_u32 ksr2_start_worker_pool(ksr2_worker_pool* pWorkerPool)
+{
+	const ksr2_u32 workerCount = pWorkerPool->allocatedWorkerCount;
+
+	if (workerCount == 0u)
+	{
+		return 0u;
+	}
+
+	ksr2_init_mutex(&pWorkerPool->mutex);
+	ksr2_init_condition_variable(&pWorkerPool->workAvailable);
+	ksr2_init_condition_variable(&pWorkerPool->workFinished);
+
+	for (ksr2_u32 workerIndex = 0u; workerIndex < workerCount; ++workerIndex)
+	{
+		ksr2_worker* pWorker = &pWorkerPool->pWorkers[workerIndex];
+		pWorker->pWorkerPool = pWorkerPool;
+		pWorker->workerIndex = workerIndex;
+
+		if (ksr2_create_thread(&pWorker->thread, ksr2_worker_thread_fnc, pWorker) == ksr2_false)
+		{
+			//FK: keep the threads that could be created
+			break;
+		}
+
+		++pWorkerPool->workerCount;
+	}
+
+	return pWorkerPool->workerCount;
+}
+
+ksr2_internal void ksr2_rasterize_tiles_parallel(ksr2_worker_pool* pWorkerPool, const ksr2_tile_bins* pTileBins)
+{
+	const ksr2_u32 tileCount 		= pTileBins->tileCountX * pTileBins->tileCountY;
+	const ksr2_u32 queueCount 		= pWorkerPool->workerCount + 1u;
+	const ksr2_u32 tilesPerQueue 	= (tileCount + queueCount - 1u) / queueCount;
+
+	ksr2_lock_mutex(&pWorkerPool->mutex);
+
+	//FK: every worker starts off with its own band of consecutive tiles
+	for (ksr2_u32 queueIndex = 0u; queueIndex < queueCount; ++queueIndex)
+	{
+		ksr2_u32 firstTileIndex = queueIndex * tilesPerQueue;
+		ksr2_u32 endTileIndex	= firstTileIndex + tilesPerQueue;
+
+		firstTileIndex 	= firstTileIndex < tileCount ? firstTileIndex : tileCount;
+		endTileIndex 	= endTileIndex < tileCount ? endTileIndex : tileCount;
+
+		pWorkerPool->pTileQueues[queueIndex].tileRange = ksr2_pack_tile_range(firstTileIndex, endTileIndex);
+	}
+
+	pWorkerPool->pTileBins 			= pTileBins;
+	pWorkerPool->busyWorkerCount 	= pWorkerPool->workerCount;
+	++pWorkerPool->frameIndex;
+
+	ksr2_broadcast_condition_variable(&pWorkerPool->workAvailable);
+	ksr2_unlock_mutex(&pWorkerPool->mutex);
+
+	ksr2_rasterize_queued_tiles(pWorkerPool, pWorkerPool->workerCount);
+
+	ksr2_lock_mutex(&pWorkerPool->mutex);
+	while(pWorkerPool->busyWorkerCount > 0u)
+	{
+		ksr2_wait_condition_variable(&pWorkerPool->workFinished, &pWorkerPool->mutex);
+	}
+	ksr2_unlock_mutex(&pWorkerPool->mutex);
+}
+
+//FK: Defined next to ksr2_blit as it shares the rasterization with it.
+ksr2_internal void ksr2_render_thread_fnc(void* pArgument);
+
+//FK: The command lists get allocated before the swap chain images, same as the worker pool. The thread gets started by
+//	  ksr2_start_render_thread() once the rest of the context is set up.
+ksr2_internal ksr2_result ksr2_init_render_thread(ksr2_render_thread* pRenderThread, struct ksr2_context* pContext, ksr2_linear_allocator* pAllocator, size_t drawCommandMemorySizeInBytes)
+{
+	ksr2_render_thread renderThread = {0};
+	renderThread.acquiredImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+	renderThread.renderingImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+	renderThread.presentableImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+	renderThread.presentingImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+
+	*pRenderThread = renderThread;
+
+	for (ksr2_u32 commandListIndex = 0u; commandListIndex < 2u; ++commandListIndex)
+	{
+		void* pMemory = ksr2_nullptr;
+		ksr2_result result = ksr2_allocate_from_linear_allocator_front(&pMemory, pAllocator, drawCommandMemorySizeInBytes, ksr2_default_alignment);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		//FK: deferred, so the draw calls never touch the state the render thread is working with
+		ksr2_command_list* pCommandList = &pRenderThread->commandLists[commandListIndex];
+		ksr2_init_fourcc(pCommandList->fourcc, "KR2L");
+		pCommandList->pContext 				= pContext;
+		pCommandList->blendMode 			= K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+		pCommandList->isDeferred 			= ksr2_true;
+		pCommandList->hasTextDrawCommands 	= ksr2_false;
+		ksr2_init_linear_allocator(&pCommandList->allocator, pMemory, drawCommandMemorySizeInBytes);
+		ksr2_reset_draw_command_stream(&pCommandList->drawCommandStream);
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_internal ksr2_b32 ksr2_start_render_thread(ksr2_render_thread* pRenderThread, struct ksr2_context* pContext)
+{
+	ksr2_init_mutex(&pRenderThread->mutex);
+	ksr2_init_condition_variable(&pRenderThread->frameQueued);
+	ksr2_init_condition_variable(&pRenderThread->frameFinished);
+
+	if (ksr2_create_thread(&pRenderThread->thread, ksr2_render_thread_fnc, pContext) == ksr2_false)
+	{
+		ksr2_destroy_condition_variable(&pRenderThread->frameFinished);
+		ksr2_destroy_condition_variable(&pRenderThread->frameQueued);
+		ksr2_destroy_mutex(&pRenderThread->mutex);
+		return ksr2_false;
+	}
+
+	return ksr2_true;
+}
+
+ksr2_internal void ksr2_destroy_render_thread(ksr2_render_thread* pRenderThread)
+{
+	ksr2_lock_mutex(&pRenderThread->mutex);
+	pRenderThread->shutdown = ksr2_true;
+	ksr2_broadcast_condition_variable(&pRenderThread->frameQueued);
+	ksr2_unlock_mutex(&pRenderThread->mutex);
+
+	ksr2_join_thread(&pRenderThread->thread);
+
+	ksr2_destroy_condition_variable(&pRenderThread->frameFinished);
+	ksr2_destroy_condition_variable(&pRenderThread->frameQueued);
+	ksr2_destroy_mutex(&pRenderThread->mutex);
+}
+
+//FK: Needs the mutex of the render thread to be locked. Free images get acquired in swap chain order, the presentable image
+//	  gets reused if none is free. Only waits for the render thread if its image is the only one the application doesn't hold.
+ksr2_internal ksr2_u32 ksr2_acquire_next_image_locked(struct ksr2_context* pContext)
+{
+	ksr2_render_thread* pRenderThread 	= &pContext->renderThread;
+	const ksr2_u32 imageCount 			= pContext->swapChain.imageCount;
+
+	while(pRenderThread->acquiredImageIndex == K15_RENDERER_2D_NO_IMAGE)
+	{
+		for (ksr2_u32 imageOffset = 1u; imageOffset <= imageCount; ++imageOffset)
+		{
+			const ksr2_u32 imageIndex = (pContext->swapChain.imageIndex + imageOffset) % imageCount;
+
+			if (imageIndex != pRenderThread->renderingImageIndex && imageIndex != pRenderThread->presentableImageIndex && 
+				imageIndex != pRenderThread->presentingImageIndex)
+			{
+				pRenderThread->acquiredImageIndex = imageIndex;
+				break;
+			}
+		}
+
+		if (pRenderThread->acquiredImageIndex != K15_RENDERER_2D_NO_IMAGE)
+		{
+			break;
+		}
+
+		if (pRenderThread->presentableImageIndex != K15_RENDERER_2D_NO_IMAGE)
+		{
+			//FK: the frame didn't get presented in time and gets dropped
+			pRenderThread->acquiredImageIndex 		= pRenderThread->presentableImageIndex;
+			pRenderThread->presentableImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+		}
+		else if (pRenderThread->renderingImageIndex == K15_RENDERER_2D_NO_IMAGE)
+		{
+			//FK: the application holds the only image, render into it just like without K15_RENDERER_2D_ASYNC_BLIT_FLAG
+			pRenderThread->acquiredImageIndex 		= pRenderThread->presentingImageIndex;
+			pRenderThread->presentingImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+		}
+		else
+		{
+			ksr2_wait_condition_variable(&pRenderThread->frameFinished, &pRenderThread->mutex);
+		}
+	}
+
+	return pRenderThread->acquiredImageIndex;
+}
+#endif //K15_RENDERER_2D_NO_THREADS
+
+//FK: Returns once the render thread of K15_RENDERER_2D_ASYNC_BLIT_FLAG finished the frame in flight, the calling thread
+//	  has the context to itself until the next ksr2_blit.
+ksr2_internal void ksr2_wait_for_render_thread(struct ksr2_context* pContext)
+{
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if ((pContext->flags & K15_RENDERER_2D_ASYNC_BLIT) == 0u)
+	{
+		return;
+	}
+
+	ksr2_render_thread* pRenderThread = &pContext->renderThread;
+
+	ksr2_lock_mutex(&pRenderThread->mutex);
+	while(pRenderThread->renderingImageIndex != K15_RENDERER_2D_NO_IMAGE)
+	{
+		ksr2_wait_condition_variable(&pRenderThread->frameFinished, &pRenderThread->mutex);
+	}
+	ksr2_unlock_mutex(&pRenderThread->mutex);
+#else
+	ksr2_use_argument(pContext);
+#endif
+}
+
+ksr2_rgba_color ksr2_rgba_color_float(float r, float g, float b, float a)
+{
+	ksr2_rgba_color color;
+	color.r = (ksr2_u8)(ksr2_clamp(r, 0.0f, 1.0f) * 255.0f);
+	color.g = (ksr2_u8)(ksr2_clamp(g, 0.0f, 1.0f) * 255.0f);
+	color.b = (ksr2_u8)(ksr2_clamp(b, 0.0f, 1.0f) * 255.0f);
+	color.a = (ksr2_u8)(ksr2_clamp(a, 0.0f, 1.0f) * 255.0f);
+
+	return color;
+}
+
+ksr2_rgba_color ksr2_rgba_color_uint8(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+	ksr2_rgba_color color;
+	color.r = r;
+	color.g = g;
+	color.b = b;
+	color.a = a;
+
+	return color;
+}
+
+ksr2_rgba_color ksr2_rgba_color_uint32(unsigned int rgba)
+{
+	ksr2_rgba_color color;
+	color.r = ((rgba >> 24) & 0xFF);
+	color.g = ((rgba >> 16) & 0xFF);
+	color.b = ((rgba >>  8) & 0xFF);
+	color.a = ((rgba >>  0) & 0xFF);
+
+	return color; 
+}
+
+ksr2_rgba_color ksr2_rgb_color_float(float r, float g, float b)
+{
+	ksr2_rgba_color color;
+	color.r = (ksr2_u8)(ksr2_clamp(r, 0.0f, 1.0f) * 255.0f);
+	color.g = (ksr2_u8)(ksr2_clamp(g, 0.0f, 1.0f) * 255.0f);
+	color.b = (ksr2_u8)(ksr2_clamp(b, 0.0f, 1.0f) * 255.0f);
+	color.a = 255u;
+
+	return color;
+}
+
+ksr2_rgba_color ksr2_rgb_color_uint8(unsigned char r, unsigned char g, unsigned char b)
+{
+	ksr2_rgba_color color;
+	color.r = r;
+	color.g = g;
+	color.b = b;
+	color.a = 255u;
+	
+	return color;
+}
+
+ksr2_rgba_color ksr2_rgb_color_uint32(unsigned int rgb)
+{
+	ksr2_rgba_color color;
+	color.r = ((rgb >> 16) & 0xFF);
+	color.g = ((rgb >>  8) & 0xFF);
+	color.b = ((rgb >>  0) & 0xFF);
+	color.a = 255u;
+	
+	return color;
+}
+
+ksr2_rgba_color ksr2_color_red()
+{
+	return ksr2_rgb_color_uint8(0xFF, 0x00, 0x00);
+}
+
+ksr2_rgba_color ksr2_color_green()
+{
+	return ksr2_rgb_color_uint8(0x00, 0xFF, 0x00);
+}
+
+ksr2_rgba_color ksr2_color_blue()
+{
+	return ksr2_rgb_color_uint8(0x00, 0x00, 0xFF);
+}
+
+ksr2_rgba_color ksr2_color_yellow()
+{
+	return ksr2_rgb_color_uint8(0xFF, 0xFF, 0x00);
+}
+
+ksr2_rgba_color ksr2_color_magenta()
+{
+	return ksr2_rgb_color_uint8(0xFF, 0x00, 0xFF);
+}
+
+ksr2_rgba_color ksr2_color_cyan()
+{
+	return ksr2_rgb_color_uint8(0x00, 0xFF, 0xFF);
+}
+
+ksr2_rgba_color ksr2_color_white()
+{
+	return ksr2_rgb_color_uint8(0xFF, 0xFF, 0xFF);
+}
+
+ksr2_rgba_color ksr2_color_black()
+{
+	return ksr2_rgb_color_uint8(0x00, 0x00, 0x00);
+}
+
+#ifdef K15_RENDERER_2D_CPU_DISPATCH
+//FK: pOutRegisters gets eax, ebx, ecx and edx
+ksr2_internal void ksr2_cpuid(ksr2_u32 leaf, ksr2_u32 subLeaf, ksr2_u32* pOutRegisters)
+{
+#ifdef _MSC_VER
+	int registers[4];
+	__cpuidex(registers, (int)leaf, (int)subLeaf);
+
+	for (ksr2_u32 registerIndex = 0u; registerIndex < 4u; ++registerIndex)
+	{
+		pOutRegisters[registerIndex] = (ksr2_u32)registers[registerIndex];
+	}
+#else
+	__cpuid_count(leaf, subLeaf, pOutRegisters[0], pOutRegisters[1], pOutRegisters[2], pOutRegisters[3]);
+#endif
+}
+
+//FK: Register state the OS saves on context switches, only call if cpuid reports OSXSAVE.
+ksr2_internal ksr2_u32 ksr2_get_xcr0()
+{
+#ifdef _MSC_VER
+	return (ksr2_u32)_xgetbv(0);
+#else
+	ksr2_u32 low = 0u;
+	ksr2_u32 high = 0u;
+	__asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return low;
+#endif
+}
+
+ksr2_internal ksr2_cpu_level ksr2_detect_cpu_level()
+{
+	ksr2_u32 registers[4] = {0};
+
+	ksr2_cpuid(0u, 0u, registers);
+	const ksr2_u32 maxLeaf = registers[0];
+
+	ksr2_cpuid(1u, 0u, registers);
+	const ksr2_b32 hasOsxsave 	= (registers[2] >> 27u) & 1u;
+	const ksr2_b32 hasAvx 		= (registers[2] >> 28u) & 1u;
+
+	if (maxLeaf < 7u || !hasOsxsave || !hasAvx)
+	{
+		return K15_RENDERER_2D_CPU_LEVEL_SSE2;
+	}
+
+	//FK: the OS has to save the xmm and ymm registers for AVX2 and additionally the opmask and zmm registers for AVX-512
+	const ksr2_u32 xcr0 = ksr2_get_xcr0();
+
+	if ((xcr0 & 0x06u) != 0x06u)
+	{
+		return K15_RENDERER_2D_CPU_LEVEL_SSE2;
+	}
+
+	ksr2_cpuid(7u, 0u, registers);
+	const ksr2_b32 hasAvx2 		= (registers[1] >> 5u) & 1u;
+	const ksr2_b32 hasAvx512F 	= (registers[1] >> 16u) & 1u;
+	const ksr2_b32 hasAvx512BW 	= (registers[1] >> 30u) & 1u;
+
+	if (!hasAvx2)
+	{
+		return K15_RENDERER_2D_CPU_LEVEL_SSE2;
+	}
+
+	if (hasAvx512F && hasAvx512BW && (xcr0 & 0xE6u) == 0xE6u)
+	{
+		return K15_RENDERER_2D_CPU_LEVEL_AVX512;
+	}
+
+	return K15_RENDERER_2D_CPU_LEVEL_AVX2;
+}
+#endif
+
+//FK: Best level the CPU supports out of the ones the renderer got compiled with.
+ksr2_internal ksr2_cpu_level ksr2_get_supported_cpu_level()
+{
+#if defined(K15_RENDERER_2D_CPU_DISPATCH)
+	//FK: cpuid can be slow in virtual machines. Threads racing here all store the same value.
+	static volatile ksr2_u32 detectedCpuLevel = K15_RENDERER_2D_CPU_LEVEL_BEST;
+
+	if (detectedCpuLevel == K15_RENDERER_2D_CPU_LEVEL_BEST)
+	{
+		detectedCpuLevel = ksr2_detect_cpu_level();
+	}
+
+	return (ksr2_cpu_level)detectedCpuLevel;
+#elif defined(K15_RENDERER_2D_AVX512)
+	return K15_RENDERER_2D_CPU_LEVEL_AVX512;
+#elif defined(K15_RENDERER_2D_AVX2)
+	return K15_RENDERER_2D_CPU_LEVEL_AVX2;
+#elif defined(K15_RENDERER_2D_SSE2)
+	return K15_RENDERER_2D_CPU_LEVEL_SSE2;
+#else
+	return K15_RENDERER_2D_CPU_LEVEL_SCALAR;
+#endif
+}
+
+//FK: cpuLevel has to be supported, see ksr2_get_supported_cpu_level().
+ksr2_internal void ksr2_select_pixel_kernels(ksr2_pixel_kernels* pOutKernels, ksr2_pixel_format format, ksr2_u32 flags, ksr2_cpu_level cpuLevel)
+{
+#ifdef K15_RENDERER_2D_CPU_DISPATCH
+	switch(cpuLevel)
+	{
+		case K15_RENDERER_2D_CPU_LEVEL_AVX512:
+			ksr2_init_pixel_kernels_avx512(pOutKernels, format, flags);
+		break;
+
+		case K15_RENDERER_2D_CPU_LEVEL_AVX2:
+			ksr2_init_pixel_kernels_avx2(pOutKernels, format, flags);
+		break;
+
+		case K15_RENDERER_2D_CPU_LEVEL_SSE2:
+			ksr2_init_pixel_kernels_sse2(pOutKernels, format, flags);
+		break;
+
+		default:
+			ksr2_init_pixel_kernels_scalar(pOutKernels, format, flags);
+		break;
+	}
+#else
+	ksr2_use_argument(cpuLevel);
+	ksr2_init_pixel_kernels_native(pOutKernels, format, flags);
+#endif
+}
+
+//FK: Branch free ksr2_convert_to_pixel_format() for the format of the kernels.
+ksr2_internal ksr2_pixel_color ksr2_convert_color(const ksr2_pixel_kernels* pKernels, ksr2_rgba_color color)
+{
+	return (ksr2_pixel_color)( (ksr2_u32)color.r << pKernels->colorShifts[0] |
+							(ksr2_u32)color.g << pKernels->colorShifts[1] |
+							(ksr2_u32)color.b << pKernels->colorShifts[2] |
+							(ksr2_u32)color.a << pKernels->colorShifts[3] );
+}
+
+//FK: Premultiplies RGBA pixels in place, pixels with the rgb value of the color key (0xRRGGBB00) become fully transparent.
+//	  Returns whether any of the pixels isn't fully opaque.
+ksr2_internal ksr2_b32 ksr2_premultiply_span(ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_b32 useColorKey, ksr2_pixel_color colorKey)
+{
+	ksr2_u32 index = 0u;
+	ksr2_b32 hasTransparentPixels = ksr2_false;
+
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const __m128i zeroVector 		= _mm_setzero_si128();
+		const __m128i alphaMask 		= _mm_set1_epi32(0xFF);
+		const __m128i colorMask 		= _mm_set1_epi32((int)0xFFFFFF00u);
+		const __m128i colorKeyVector 	= _mm_set1_epi32(useColorKey ? (int)colorKey : -1);
+		int opaqueMask = 0xFFFF;
+
+		for (; index + 4u <= pixelCount; index += 4u)
+		{
+			__m128i pixelVector = _mm_loadu_si128((const __m128i*)(pPixels + index));
+			pixelVector = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(pixelVector, colorMask), colorKeyVector), pixelVector);
+
+			//FK: alpha in every channel but the alpha channel itself, that one gets multiplied with 255
+			__m128i alphaVector = _mm_and_si128(pixelVector, alphaMask);
+			opaqueMask &= _mm_movemask_epi8(_mm_cmpeq_epi32(alphaVector, alphaMask));
+			alphaVector = _mm_or_si128(alphaVector, _mm_slli_epi32(alphaVector, 8));
+			alphaVector = _mm_or_si128(_mm_or_si128(alphaVector, _mm_slli_epi32(alphaVector, 16)), alphaMask);
+
+			const __m128i lowVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixelVector, zeroVector), _mm_unpacklo_epi8(alphaVector, zeroVector)));
+			const __m128i highVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixelVector, zeroVector), _mm_unpackhi_epi8(alphaVector, zeroVector)));
+			_mm_storeu_si128((__m128i*)(pPixels + index), _mm_packus_epi16(lowVector, highVector));
+		}
+
+		hasTransparentPixels = opaqueMask != 0xFFFF;
+	}
+#endif
+
+	for (; index < pixelCount; ++index)
+	{
+		ksr2_pixel_color pixel = pPixels[index];
+
+		if (useColorKey && (pixel & 0xFFFFFF00u) == colorKey)
+		{
+			pixel = 0u;
+		}
+
+		const ksr2_u32 alpha = pixel & 0xFFu;
+		hasTransparentPixels |= alpha != 0xFFu;
+
+		pPixels[index] = ksr2_div255((pixel >> 24u) * alpha) << 24u | ksr2_div255(((pixel >> 16u) & 0xFFu) * alpha) << 16u | ksr2_div255(((pixel >> 8u) & 0xFFu) * alpha) << 8u | alpha;
+	}
+
+	return hasTransparentPixels;
+}
+
+unsigned int ksr2_get_pixel_size(ksr2_pixel_format format)
+{
+	return (unsigned int)ksr2_get_pixel_size_in_bytes(format);
+}
+
+ksr2_result ksr2_convert_pixels(void* pOutPixels, ksr2_pixel_format outFormat, const void* pPixels, ksr2_pixel_format format, unsigned int pixelCount)
+{
+	if (pOutPixels == ksr2_nullptr || pPixels == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const size_t outPixelSizeInBytes 	= ksr2_get_pixel_size_in_bytes(outFormat);
+	const size_t pixelSizeInBytes 		= ksr2_get_pixel_size_in_bytes(format);
+
+	if (outPixelSizeInBytes == 0u || pixelSizeInBytes == 0u)
+	{
+		return K15_RENDERER_2D_UNKNOWN_PIXEL_FORMAT;
+	}
+
+	ksr2_byte* pOutBytes 	= (ksr2_byte*)pOutPixels;
+	const ksr2_byte* pBytes = (const ksr2_byte*)pPixels;
+
+	//FK: the conversions don't depend on the format of the kernels
+	ksr2_pixel_kernels kernels;
+	ksr2_select_pixel_kernels(&kernels, K15_RENDERER_2D_PIXEL_FORMAT_RGBA, 0u, ksr2_get_supported_cpu_level());
+
+	if (outFormat == format)
+	{
+		if (pOutBytes != pBytes)
+		{
+			kernels.copyBytes(pOutBytes, pBytes, (size_t)pixelCount * pixelSizeInBytes);
+		}
+
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	//FK: everything goes through RGBA, a span at a time
+	ksr2_pixel_color rgbaPixels[K15_RENDERER_2D_IMAGE_SPAN_SIZE];
+
+	for (ksr2_u32 index = 0u; index < pixelCount; index += K15_RENDERER_2D_IMAGE_SPAN_SIZE)
+	{
+		const ksr2_u32 spanPixelCount = ksr2_min(pixelCount - index, (ksr2_u32)K15_RENDERER_2D_IMAGE_SPAN_SIZE);
+
+		if (format == K15_RENDERER_2D_PIXEL_FORMAT_RGBA)
+		{
+			kernels.convertPixelsFromRgba(pOutBytes + index * outPixelSizeInBytes, (const ksr2_pixel_color*)(pBytes + index * pixelSizeInBytes), spanPixelCount, outFormat);
+		}
+		else if (outFormat == K15_RENDERER_2D_PIXEL_FORMAT_RGBA)
+		{
+			kernels.convertPixelsToRgba((ksr2_pixel_color*)(pOutBytes + index * outPixelSizeInBytes), pBytes + index * pixelSizeInBytes, spanPixelCount, format);
+		}
+		else
+		{
+			kernels.convertPixelsToRgba(rgbaPixels, pBytes + index * pixelSizeInBytes, spanPixelCount, format);
+			kernels.convertPixelsFromRgba(pOutBytes + index * outPixelSizeInBytes, rgbaPixels, spanPixelCount, outFormat);
+		}
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: Clamps count coordinates to [0, max]
+ksr2_internal void ksr2_clamp_coordinates(ksr2_s32* pOutCoordinates, const int* pCoordinates, ksr2_u32 count, ksr2_s32 max)
+{
+	ksr2_u32 index = 0u;
+
+#if defined(K15_RENDERER_2D_AVX2)
+	{
+		const __m256i zeroVector 	= _mm256_setzero_si256();
+		const __m256i maxVector 	= _mm256_set1_epi32(max);
+
+		for (; index + 8u <= count; index += 8u)
+		{
+			const __m256i coordinateVector = _mm256_loadu_si256((const __m256i*)(pCoordinates + index));
+			_mm256_storeu_si256((__m256i*)(pOutCoordinates + index), _mm256_min_epi32(_mm256_max_epi32(coordinateVector, zeroVector), maxVector));
+		}
+	}
+#endif
+
+#if defined(K15_RENDERER_2D_SSE2)
+	{
+		//FK: SSE2 doesn't have 32 bit min/max, use compare masks instead
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i maxVector 	= _mm_set1_epi32(max);
+
+		for (; index + 4u <= count; index += 4u)
+		{
+			__m128i coordinateVector = _mm_loadu_si128((const __m128i*)(pCoordinates + index));
+			coordinateVector = _mm_andnot_si128(_mm_cmplt_epi32(coordinateVector, zeroVector), coordinateVector);
+
+			const __m128i greaterMask = _mm_cmpgt_epi32(coordinateVector, maxVector);
+			coordinateVector = _mm_or_si128(_mm_and_si128(greaterMask, maxVector), _mm_andnot_si128(greaterMask, coordinateVector));
+			_mm_storeu_si128((__m128i*)(pOutCoordinates + index), coordinateVector);
+		}
+	}
+#endif
+
+	for (; index < count; ++index)
+	{
+		pOutCoordinates[index] = ksr2_clamp(pCoordinates[index], 0, max);
+	}
+}
+
+//FK: Converts the color to what gets stored in the draw command for the current blend mode of the command list.
+//	  Returns false if the draw command wouldn't change any pixel.
+ksr2_internal ksr2_b32 ksr2_resolve_blend_color(ksr2_pixel_color* pOutColor, ksr2_blend_mode* pOutBlendMode, const ksr2_command_list* pCommandList, ksr2_rgba_color color)
+{
+	const ksr2_pixel_kernels* pKernels = &pCommandList->pContext->kernels;
+	ksr2_blend_mode blendMode = pCommandList->blendMode;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA && color.a == 0xFFu)
+	{
+		blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	}
+
+	*pOutBlendMode = blendMode;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+	{
+		*pOutColor = ksr2_convert_color(pKernels, color);
+		return ksr2_true;
+	}
+
+	if (color.a == 0u)
+	{
+		return ksr2_false;
+	}
+
+	ksr2_rgba_color premultipliedColor = color;
+	premultipliedColor.r = (unsigned char)ksr2_div255((ksr2_u32)color.r * color.a);
+	premultipliedColor.g = (unsigned char)ksr2_div255((ksr2_u32)color.g * color.a);
+	premultipliedColor.b = (unsigned char)ksr2_div255((ksr2_u32)color.b * color.a);
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_MULTIPLY)
+	{
+		//FK: store the per channel factor the destination gets multiplied with
+		premultipliedColor.r = (unsigned char)(premultipliedColor.r + 0xFFu - color.a);
+		premultipliedColor.g = (unsigned char)(premultipliedColor.g + 0xFFu - color.a);
+		premultipliedColor.b = (unsigned char)(premultipliedColor.b + 0xFFu - color.a);
+		premultipliedColor.a = 0xFFu;
+
+		if (premultipliedColor.r == 0xFFu && premultipliedColor.g == 0xFFu && premultipliedColor.b == 0xFFu)
+		{
+			return ksr2_false;
+		}
+	}
+
+	*pOutColor = ksr2_convert_color(pKernels, premultipliedColor);
+	return ksr2_true;
+}
+
+enum
+{
+	K15_RENDERER_2D_INVISIBLE_BLEND_MODE = 0xFF
+};
+
+//FK: Batched ksr2_resolve_blend_color(), colors that wouldn't change any pixel get K15_RENDERER_2D_INVISIBLE_BLEND_MODE.
+//	  Opaque colors only need the format conversion.
+ksr2_internal void ksr2_resolve_blend_colors(ksr2_pixel_color* pOutColors, ksr2_u8* pOutBlendModes, const ksr2_command_list* pCommandList, const ksr2_rgba_color* pColors, ksr2_u32 count)
+{
+	if (pCommandList->blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+	{
+		pCommandList->pContext->kernels.convertColors(pOutColors, pColors, count);
+
+		for (ksr2_u32 index = 0u; index < count; ++index)
+		{
+			pOutBlendModes[index] = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+		}
+
+		return;
+	}
+
+	for (ksr2_u32 index = 0u; index < count; ++index)
+	{
+		ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+		const ksr2_b32 isVisible = ksr2_resolve_blend_color(&pOutColors[index], &blendMode, pCommandList, pColors[index]);
+		pOutBlendModes[index] = isVisible ? (ksr2_u8)blendMode : (ksr2_u8)K15_RENDERER_2D_INVISIBLE_BLEND_MODE;
+	}
+}
+
+//FK: Triangle colors get interpolated and blended like image pixels, so they're premultiplied for every blend mode but opaque.
+//	  Returns false if the triangle wouldn't change any pixel.
+ksr2_internal ksr2_b32 ksr2_resolve_triangle_colors(ksr2_pixel_color* pOutColors, ksr2_blend_mode* pOutBlendMode, const ksr2_command_list* pCommandList, const ksr2_rgba_color* pColors)
+{
+	const ksr2_pixel_kernels* pKernels = &pCommandList->pContext->kernels;
+	const ksr2_u32 minAlpha = ksr2_min(pColors[0].a, ksr2_min(pColors[1].a, pColors[2].a));
+	const ksr2_u32 maxAlpha = ksr2_max(pColors[0].a, ksr2_max(pColors[1].a, pColors[2].a));
+	ksr2_blend_mode blendMode = pCommandList->blendMode;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA && minAlpha == 0xFFu)
+	{
+		blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	}
+
+	if (blendMode != K15_RENDERER_2D_BLEND_MODE_OPAQUE && maxAlpha == 0u)
+	{
+		return ksr2_false;
+	}
+
+	*pOutBlendMode = blendMode;
+
+	for (ksr2_u32 vertexIndex = 0u; vertexIndex < 3u; ++vertexIndex)
+	{
+		ksr2_rgba_color color = pColors[vertexIndex];
+
+		if (blendMode != K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+		{
+			color.r = (unsigned char)ksr2_div255((ksr2_u32)color.r * color.a);
+			color.g = (unsigned char)ksr2_div255((ksr2_u32)color.g * color.a);
+			color.b = (unsigned char)ksr2_div255((ksr2_u32)color.b * color.a);
+		}
+
+		pOutColors[vertexIndex] = ksr2_convert_color(pKernels, color);
+	}
+
+	return ksr2_true;
+}
+
+//FK: Only clip against the image grown by the line thickness, clipping the end points to the image
+//	  itself would change the slope of the line. Returns false if the line doesn't need to be drawn.
+ksr2_internal ksr2_b32 ksr2_clip_line_to_guard_band(ksr2_s32* pX1, ksr2_s32* pY1, ksr2_s32* pX2, ksr2_s32* pY2, ksr2_u32 thickness, const ksr2_swap_chain* pSwapChain)
+{
+	if (*pX1 == *pX2 && *pY1 == *pY2)
+	{
+		return ksr2_false;
+	}
+
+	const ksr2_s32 guardBand = (ksr2_s32)(thickness > 0x10000u ? 0x10000u : thickness) + 2;
+	const ksr2_s32 maxX = (ksr2_s32)pSwapChain->width + guardBand;
+	const ksr2_s32 maxY = (ksr2_s32)pSwapChain->height + guardBand;
+
+	//FK: most lines are completely inside, they don't need the floating point clipping
+	if (ksr2_min(*pX1, *pX2) >= -guardBand && ksr2_max(*pX1, *pX2) <= maxX && ksr2_min(*pY1, *pY2) >= -guardBand && ksr2_max(*pY1, *pY2) <= maxY)
+	{
+		return ksr2_true;
+	}
+
+	return ksr2_clip_line(pX1, pY1, pX2, pY2, -guardBand, -guardBand, maxX, maxY);
+}
+
+ksr2_internal ksr2_b32 ksr2_line_fits_into_16_bit(ksr2_s32 x1, ksr2_s32 y1, ksr2_s32 x2, ksr2_s32 y2, ksr2_u32 thickness)
+{
+	return thickness <= 0xFFFFu &&
+		ksr2_min(x1, x2) >= -0x8000 && ksr2_max(x1, x2) <= 0x7FFF &&
+		ksr2_min(y1, y2) >= -0x8000 && ksr2_max(y1, y2) <= 0x7FFF;
+}
+
+//FK: Text always gets coverage blended, so its color gets stored premultiplied for every blend mode.
+//	  Returns false if the text wouldn't change any pixel.
+ksr2_internal ksr2_b32 ksr2_resolve_text_color(ksr2_pixel_color* pOutColor, ksr2_blend_mode* pOutBlendMode, const ksr2_command_list* pCommandList, ksr2_rgba_color color)
+{
+	ksr2_blend_mode blendMode = pCommandList->blendMode;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+	{
+		blendMode = K15_RENDERER_2D_BLEND_MODE_ALPHA;
+		color.a = 0xFFu;
+	}
+
+	if (color.a == 0u)
+	{
+		return ksr2_false;
+	}
+
+	color.r = (unsigned char)ksr2_div255((ksr2_u32)color.r * color.a);
+	color.g = (unsigned char)ksr2_div255((ksr2_u32)color.g * color.a);
+	color.b = (unsigned char)ksr2_div255((ksr2_u32)color.b * color.a);
+
+	*pOutBlendMode 	= blendMode;
+	*pOutColor 		= ksr2_convert_color(&pCommandList->pContext->kernels, color);
+	return ksr2_true;
+}
+
+//FK: 5x7 glyphs in 8x8 cells, one byte per row (most significant bit first), one glyph per cell row
+ksr2_internal const ksr2_u8 ksr2_builtin_font_pixels[] = 
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //FK: ' '
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x20, 0x00, //FK: '!'
+	0x50, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //FK: '"'
+	0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50, 0x00, //FK: '#'
+	0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20, 0x00, //FK: '$'
+	0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18, 0x00, //FK: '%'
+	0x60, 0x90, 0xA0, 0x40, 0xA8, 0x90, 0x68, 0x00, //FK: '&'
+	0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //FK: '''
+	0x10, 0x20, 0x40, 0x40, 0x40, 0x20, 0x10, 0x00, //FK: '('
+	0x40, 0x20, 0x10, 0x10, 0x10, 0x20, 0x40, 0x00, //FK: ')'
+	0x00, 0x20, 0xA8, 0x70, 0xA8, 0x20, 0x00, 0x00, //FK: '*'
+	0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00, 0x00, //FK: '+'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x40, //FK: ','
+	0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, //FK: '-'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, //FK: '.'
+	0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00, //FK: '/'
+	0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70, 0x00, //FK: '0'
+	0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, //FK: '1'
+	0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8, 0x00, //FK: '2'
+	0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70, 0x00, //FK: '3'
+	0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10, 0x00, //FK: '4'
+	0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70, 0x00, //FK: '5'
+	0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70, 0x00, //FK: '6'
+	0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x00, //FK: '7'
+	0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70, 0x00, //FK: '8'
+	0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60, 0x00, //FK: '9'
+	0x00, 0x00, 0x20, 0x00, 0x00, 0x20, 0x00, 0x00, //FK: ':'
+	0x00, 0x00, 0x20, 0x00, 0x00, 0x20, 0x20, 0x40, //FK: ';'
+	0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x10, 0x00, //FK: '<'
+	0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00, 0x00, //FK: '='
+	0x40, 0x20, 0x10, 0x08, 0x10, 0x20, 0x40, 0x00, //FK: '>'
+	0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20, 0x00, //FK: '?'
+	0x70, 0x88, 0x08, 0x68, 0xA8, 0xA8, 0x70, 0x00, //FK: '@'
+	0x70, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88, 0x00, //FK: 'A'
+	0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0, 0x00, //FK: 'B'
+	0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70, 0x00, //FK: 'C'
+	0xE0, 0x90, 0x88, 0x88, 0x88, 0x90, 0xE0, 0x00, //FK: 'D'
+	0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8, 0x00, //FK: 'E'
+	0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80, 0x00, //FK: 'F'
+	0x70, 0x88, 0x80, 0xB8, 0x88, 0x88, 0x78, 0x00, //FK: 'G'
+	0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88, 0x00, //FK: 'H'
+	0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, //FK: 'I'
+	0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60, 0x00, //FK: 'J'
+	0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88, 0x00, //FK: 'K'
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8, 0x00, //FK: 'L'
+	0x88, 0xD8, 0xA8, 0xA8, 0x88, 0x88, 0x88, 0x00, //FK: 'M'
+	0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88, 0x00, //FK: 'N'
+	0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70, 0x00, //FK: 'O'
+	0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80, 0x00, //FK: 'P'
+	0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68, 0x00, //FK: 'Q'
+	0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88, 0x00, //FK: 'R'
+	0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xF0, 0x00, //FK: 'S'
+	0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, //FK: 'T'
+	0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70, 0x00, //FK: 'U'
+	0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00, //FK: 'V'
+	0x88, 0x88, 0x88, 0xA8, 0xA8, 0xA8, 0x50, 0x00, //FK: 'W'
+	0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88, 0x00, //FK: 'X'
+	0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20, 0x00, //FK: 'Y'
+	0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8, 0x00, //FK: 'Z'
+	0x70, 0x40, 0x40, 0x40, 0x40, 0x40, 0x70, 0x00, //FK: '['
+	0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00, 0x00, //FK: backslash
+	0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x70, 0x00, //FK: ']'
+	0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, //FK: '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, //FK: '_'
+	0x40, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //FK: '`'
+	0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78, 0x00, //FK: 'a'
+	0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0xF0, 0x00, //FK: 'b'
+	0x00, 0x00, 0x70, 0x80, 0x80, 0x88, 0x70, 0x00, //FK: 'c'
+	0x08, 0x08, 0x68, 0x98, 0x88, 0x88, 0x78, 0x00, //FK: 'd'
+	0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70, 0x00, //FK: 'e'
+	0x30, 0x48, 0x40, 0xE0, 0x40, 0x40, 0x40, 0x00, //FK: 'f'
+	0x00, 0x00, 0x78, 0x88, 0x88, 0x78, 0x08, 0x70, //FK: 'g'
+	0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00, //FK: 'h'
+	0x20, 0x00, 0x60, 0x20, 0x20, 0x20, 0x70, 0x00, //FK: 'i'
+	0x10, 0x00, 0x30, 0x10, 0x10, 0x10, 0x90, 0x60, //FK: 'j'
+	0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x00, //FK: 'k'
+	0x60, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, //FK: 'l'
+	0x00, 0x00, 0xD0, 0xA8, 0xA8, 0x88, 0x88, 0x00, //FK: 'm'
+	0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00, //FK: 'n'
+	0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70, 0x00, //FK: 'o'
+	0x00, 0x00, 0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, //FK: 'p'
+	0x00, 0x00, 0x78, 0x88, 0x88, 0x78, 0x08, 0x08, //FK: 'q'
+	0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80, 0x00, //FK: 'r'
+	0x00, 0x00, 0x70, 0x80, 0x70, 0x08, 0xF0, 0x00, //FK: 's'
+	0x40, 0x40, 0xE0, 0x40, 0x40, 0x48, 0x30, 0x00, //FK: 't'
+	0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68, 0x00, //FK: 'u'
+	0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00, //FK: 'v'
+	0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50, 0x00, //FK: 'w'
+	0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00, //FK: 'x'
+	0x00, 0x00, 0x88, 0x88, 0x88, 0x78, 0x08, 0x70, //FK: 'y'
+	0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8, 0x00, //FK: 'z'
+	0x10, 0x20, 0x20, 0x40, 0x20, 0x20, 0x10, 0x00, //FK: '{'
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, //FK: '|'
+	0x40, 0x20, 0x20, 0x10, 0x20, 0x20, 0x40, 0x00, //FK: '}'
+	0x00, 0x00, 0x40, 0xA8, 0x10, 0x00, 0x00, 0x00, //FK: '~'
+};
+
+//FK: Writes the coverage of the glyph to pOutCoverage (glyphWidth x glyphHeight) unless it's ksr2_nullptr.
+//	  Returns false if the glyph doesn't have any coverage.
+ksr2_internal ksr2_b32 ksr2_rasterize_glyph(ksr2_u8* pOutCoverage, const ksr2_font* pFont, ksr2_u32 glyphIndex)
+{
+	const ksr2_u32 cellX = (glyphIndex % pFont->glyphsPerRow) * pFont->glyphWidth;
+	const ksr2_u32 cellY = (glyphIndex / pFont->glyphsPerRow) * pFont->glyphHeight;
+	const ksr2_u8* pSourceRow = pFont->pSourcePixels + (size_t)cellY * pFont->sourceStride;
+	ksr2_b32 hasCoverage = ksr2_false;
+
+	for (ksr2_u32 y = 0u; y < pFont->glyphHeight; ++y)
+	{
+		for (ksr2_u32 x = cellX; x < cellX + pFont->glyphWidth; ++x)
+		{
+			ksr2_u8 coverage = 0u;
+
+			if (pFont->sourceBitsPerPixel == 1u)
+			{
+				coverage = ((pSourceRow[x / 8u] >> (7u - x % 8u)) & 1u) ? 0xFFu : 0u;
+			}
+			else
+			{
+				coverage = pSourceRow[x];
+			}
+
+			hasCoverage |= coverage != 0u;
+
+			if (pOutCoverage != ksr2_nullptr)
+			{
+				*pOutCoverage++ = coverage;
+			}
+		}
+
+		pSourceRow += pFont->sourceStride;
+	}
+
+	return hasCoverage;
+}
+
+//FK: Looks the glyph up in the glyph cache of the font and rasterizes it into a free slot on a miss. If there's no free slot
+//	  left, slots get evicted round robin, skipping the ones used by the current frame. Recorded text draw commands rely 
+//	  on their glyphs staying in their slots until ksr2_blit.
+ksr2_internal ksr2_result ksr2_cache_glyph(ksr2_font* pFont, ksr2_u32 glyphIndex, ksr2_u32 frameIndex)
+{
+	ksr2_u16* pGlyphSlotIndex = &pFont->pGlyphSlotIndices[glyphIndex];
+
+	if (*pGlyphSlotIndex != K15_RENDERER_2D_GLYPH_NOT_CACHED)
+	{
+		if (*pGlyphSlotIndex != K15_RENDERER_2D_GLYPH_EMPTY)
+		{
+			pFont->pSlots[*pGlyphSlotIndex].lastUsedFrameIndex = frameIndex;
+		}
+
+		++pFont->statistics.hitCount;
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	if (ksr2_rasterize_glyph(ksr2_nullptr, pFont, glyphIndex) == ksr2_false)
+	{
+		*pGlyphSlotIndex = K15_RENDERER_2D_GLYPH_EMPTY;
+		++pFont->statistics.missCount;
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_u32 slotIndex = pFont->usedSlotCount;
+
+	if (pFont->usedSlotCount < pFont->slotCount)
+	{
+		++pFont->usedSlotCount;
+	}
+	else
+	{
+		ksr2_u32 slotOffset = 0u;
+
+		for (; slotOffset < pFont->slotCount; ++slotOffset)
+		{
+			slotIndex = (pFont->nextEvictionSlotIndex + slotOffset) % pFont->slotCount;
+
+			if (pFont->pSlots[slotIndex].lastUsedFrameIndex != frameIndex)
+			{
+				break;
+			}
+		}
+
+		if (slotOffset == pFont->slotCount)
+		{
+			return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+		}
+
+		pFont->pGlyphSlotIndices[pFont->pSlots[slotIndex].glyphIndex] = K15_RENDERER_2D_GLYPH_NOT_CACHED;
+		pFont->nextEvictionSlotIndex = (slotIndex + 1u) % pFont->slotCount;
+		++pFont->statistics.evictionCount;
+	}
+
+	ksr2_rasterize_glyph(pFont->pAtlas + (size_t)slotIndex * pFont->glyphWidth * pFont->glyphHeight, pFont, glyphIndex);
+
+	pFont->pSlots[slotIndex].glyphIndex 		= (ksr2_u16)glyphIndex;
+	pFont->pSlots[slotIndex].lastUsedFrameIndex = frameIndex;
+	*pGlyphSlotIndex 							= (ksr2_u16)slotIndex;
+	++pFont->statistics.missCount;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: Caches the glyphs of the text draw commands for the current frame, glyphs that don't fit into the glyph cache stay uncached.
+ksr2_internal ksr2_result ksr2_cache_draw_command_stream_glyphs(ksr2_context* pContext, const ksr2_draw_command_stream* pStream)
+{
+	ksr2_result result = K15_RENDERER_2D_RESULT_SUCCESS;
+
+	ksr2_draw_command_iterator drawCommandIterator;
+	ksr2_init_draw_command_iterator(&drawCommandIterator, pStream);
+
+	const ksr2_draw_command_header* pHeader = ksr2_nullptr;
+	while ((pHeader = ksr2_next_draw_command(&drawCommandIterator)) != ksr2_nullptr)
+	{
+		if (pHeader->type != K15_RENDERER_2D_DRAW_COMMAND_TEXT)
+		{
+			continue;
+		}
+
+		const ksr2_text_draw_command* pDrawCommand = (const ksr2_text_draw_command*)pHeader;
+		const ksr2_text_glyph* pGlyphs = (const ksr2_text_glyph*)(pDrawCommand + 1);
+		ksr2_font* pFont = (ksr2_font*)ksr2_get_text_draw_command_font(pContext, pDrawCommand);
+
+		for (ksr2_u32 glyphIndex = 0u; glyphIndex < pDrawCommand->glyphCount; ++glyphIndex)
+		{
+			if (ksr2_cache_glyph(pFont, pGlyphs[glyphIndex].glyphIndex, pContext->frameIndex) != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				result = K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+			}
+		}
+	}
+
+	return result;
+}
+
+ksr2_internal ksr2_result ksr2_record_text_run(ksr2_command_list* pCommandList, const ksr2_font* pFont, ksr2_s32 x, ksr2_s32 y, const ksr2_text_glyph* pGlyphs, ksr2_u32 glyphCount, ksr2_pixel_color color, ksr2_blend_mode blendMode)
+{
+	if (glyphCount == 0u)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_text_draw_command* pDrawCommand = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_text_draw_command) + sizeof(ksr2_text_glyph) * glyphCount, K15_RENDERER_2D_DRAW_COMMAND_TEXT, blendMode);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	pCommandList->hasTextDrawCommands = ksr2_true;
+
+	pDrawCommand->fontOffset 	= (ksr2_u32)((const ksr2_byte*)pFont - pCommandList->pContext->allocator.pStartAddress);
+	pDrawCommand->x 			= x;
+	pDrawCommand->y 			= y;
+	pDrawCommand->color 		= color;
+	pDrawCommand->width 		= (ksr2_u16)(pGlyphs[glyphCount - 1u].x + pFont->glyphWidth);
+	pDrawCommand->height 		= (ksr2_u8)pFont->glyphHeight;
+	pDrawCommand->glyphCount 	= (ksr2_u8)glyphCount;
+
+	ksr2_text_glyph* pDrawCommandGlyphs = (ksr2_text_glyph*)(pDrawCommand + 1);
+
+	for (ksr2_u32 glyphIndex = 0u; glyphIndex < glyphCount; ++glyphIndex)
+	{
+		pDrawCommandGlyphs[glyphIndex] = pGlyphs[glyphIndex];
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+ksr2_internal ksr2_result ksr2_init_trace_buffer(ksr2_trace_buffer* pOutTraceBuffer, ksr2_linear_allocator* pAllocator, const ksr2_context_parameters* pParameters)
+{
+	ksr2_trace_buffer traceBuffer = {0};
+	*pOutTraceBuffer = traceBuffer;
+
+	if ((pParameters->flags & K15_RENDERER_2D_TRACING_FLAG) == 0u)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_u64 requestedEventCount = pParameters->traceEventCount > 0u ? pParameters->traceEventCount : K15_RENDERER_2D_DEFAULT_TRACE_EVENT_COUNT;
+	ksr2_u64 eventCount = 1u;
+
+	while(eventCount < requestedEventCount)
+	{
+		eventCount <<= 1u;
+	}
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front((void**)&pOutTraceBuffer->pEvents, pAllocator, sizeof(ksr2_trace_event) * eventCount, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	pOutTraceBuffer->eventMask 		= eventCount - 1u;
+	pOutTraceBuffer->startTimeInNs 	= ksr2_get_time_in_ns();
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+#endif //K15_RENDERER_2D_NO_TRACING
+
+ksr2_result ksr2_init_context(const ksr2_context_parameters* pParameters, ksr2_contexthandle* pOutContextHandle)
+{
+	ksr2_debug_fnc debugFnc = pParameters != ksr2_nullptr ? pParameters->debugFnc : ksr2_nullptr;
+	
+	if (debugFnc == ksr2_nullptr)
+	{
+		debugFnc = ksr2_debug_fnc_stub;
+	}
+	
+	if (pParameters == ksr2_nullptr)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "pParameter in 'ksr2_init_context' is NULL.\n");
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_context* pContext = ksr2_nullptr;
+	ksr2_linear_allocator allocator;
+	ksr2_init_linear_allocator(&allocator, pParameters->pMemory, pParameters->memorySizeInBytes);
+	ksr2_u32 contextFlags = 0u;
+
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front(&pContext, &allocator, sizeof(ksr2_context), ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		//debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "Not enough memory. need at least %u bytes for context.\n", sizeof(ksr2_context));
+		return result;
+	}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	//FK: worker pool memory has to be allocated before the swap chain images, resizing the swap chain resets the allocator front to the first image.
+	result = ksr2_init_worker_pool(&pContext->workerPool, pContext, &allocator, pParameters->workerThreadCount);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+#else
+	if (pParameters->workerThreadCount > 0u)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "workerThreadCount is ignored, renderer was compiled with K15_RENDERER_2D_NO_THREADS.\n");
+	}
+#endif
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+	//FK: same as the worker pool, the trace buffer has to survive resizing the swap chain
+	result = ksr2_init_trace_buffer(&pContext->traceBuffer, &allocator, pParameters);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+#else
+	if (pParameters->flags & K15_RENDERER_2D_TRACING_FLAG)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "K15_RENDERER_2D_TRACING_FLAG is ignored, renderer was compiled with K15_RENDERER_2D_NO_TRACING.\n");
+	}
+#endif
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pParameters->flags & K15_RENDERER_2D_ASYNC_BLIT_FLAG)
+	{
+		//FK: same as the worker pool, the command lists of the render thread have to survive resizing the swap chain
+		const size_t drawCommandMemorySizeInBytes = pParameters->asyncDrawCommandMemorySizeInBytes > 0u ? pParameters->asyncDrawCommandMemorySizeInBytes : pParameters->memorySizeInBytes / 8u;
+		result = ksr2_init_render_thread(&pContext->renderThread, pContext, &allocator, drawCommandMemorySizeInBytes);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		contextFlags |= K15_RENDERER_2D_ASYNC_BLIT;
+	}
+#else
+	if (pParameters->flags & K15_RENDERER_2D_ASYNC_BLIT_FLAG)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "K15_RENDERER_2D_ASYNC_BLIT_FLAG is ignored, renderer was compiled with K15_RENDERER_2D_NO_THREADS.\n");
+	}
+#endif
+
+	ksr2_u32 swapChainImageCount = pParameters->backBufferCount;
+
+	if (swapChainImageCount == 0u)
+	{
+		swapChainImageCount = (pParameters->flags & K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG) > 0u ? 2u : 1u;
+	}
+
+	const ksr2_b32 padRows = (pParameters->flags & K15_RENDERER_2D_PADDED_ROWS_FLAG) > 0u;
+	void* pImages = pParameters->pPreAllocatedBackBuffers;
+	void* pImageStart = ksr2_get_allocator_front_address(&allocator);
+
+	if (pImages == ksr2_nullptr)
+	{
+		contextFlags |= K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP;
+
+		result = ksr2_allocate_swap_chain_images(&pImages, swapChainImageCount, &allocator, 
+			pParameters->backBufferWidth, pParameters->backBufferHeight, pParameters->backBufferFormat, padRows);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+	}
+
+	result = ksr2_init_swap_chain(&pContext->swapChain, pImageStart, pImages, swapChainImageCount, pParameters->backBufferWidth, pParameters->backBufferHeight, pParameters->backBufferFormat, padRows);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_cpu_level cpuLevel = ksr2_get_supported_cpu_level();
+
+	if (pParameters->cpuLevel > cpuLevel)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "cpuLevel isn't supported by the CPU or the renderer, using the best level that is.\n");
+	}
+	else if (pParameters->cpuLevel != K15_RENDERER_2D_CPU_LEVEL_BEST)
+	{
+#ifdef K15_RENDERER_2D_CPU_DISPATCH
+		cpuLevel = pParameters->cpuLevel;
+#else
+		if (pParameters->cpuLevel != cpuLevel)
+		{
+			debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "cpuLevel is ignored, renderer was compiled with K15_RENDERER_2D_NO_CPU_DISPATCH or without SIMD.\n");
+		}
+#endif
+	}
+
+	pContext->cpuLevel = cpuLevel;
+	ksr2_select_pixel_kernels(&pContext->kernels, pParameters->backBufferFormat, pParameters->flags, cpuLevel);
+
+	const ksr2_u32 tileSize = pParameters->tileSize > 0u ? pParameters->tileSize : K15_RENDERER_2D_DEFAULT_TILE_SIZE;
+
+	if (pParameters->flags & K15_RENDERER_2D_INCREMENTAL_RENDERING_FLAG)
+	{
+		contextFlags |= K15_RENDERER_2D_DIRTY_REGION_TRACKING;
+	}
+
+	if (pParameters->flags & K15_RENDERER_2D_FLUSH_WHEN_FULL_FLAG)
+	{
+		contextFlags |= K15_RENDERER_2D_FLUSH_WHEN_FULL;
+	}
+
+	result = ksr2_init_dirty_region_tracker(&pContext->dirtyRegionTracker, &allocator, &pContext->swapChain, tileSize, contextFlags);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	pContext->swapChain.pImageEnd = ksr2_get_allocator_front_address(&allocator);
+
+	ksr2_init_fourcc(pContext->fourcc, "KR2C");
+	ksr2_init_fourcc(pContext->commandList.fourcc, "KR2L");
+	pContext->commandList.pContext 				= pContext;
+	pContext->commandList.blendMode 			= K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	pContext->commandList.isDeferred 			= ksr2_false;
+	pContext->commandList.hasTextDrawCommands 	= ksr2_false;
+	ksr2_init_linear_allocator(&pContext->commandList.allocator, ksr2_nullptr, 0u);
+
+	pContext->allocator 		= allocator;
+	ksr2_reset_draw_command_stream(&pContext->commandList.drawCommandStream);
+	pContext->flags 			= contextFlags;
+	pContext->tileSize			= tileSize;
+	pContext->clearImage		= ksr2_false;
+	pContext->culledPixelCount	= 0u;
+	pContext->frameIndex		= 0u;
+	pContext->flushCount		= 0u;
+	pContext->debugFnc			= debugFnc;
+
+	pContext->allocateChunkFnc 							= pParameters->allocateChunkFnc;
+	pContext->freeChunkFnc 								= pParameters->freeChunkFnc;
+	pContext->pChunkAllocatorUserData 					= pParameters->pChunkAllocatorUserData;
+	pContext->drawCommandMemoryHighWaterMarkInBytes 	= 0u;
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	const ksr2_frame_stats emptyFrameStats = {0};
+	pContext->frameStats 			= emptyFrameStats;
+	pContext->flushedFrameStats 	= emptyFrameStats;
+#endif
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+	pContext->recordStartTimeInNs 	= 0u;
+#endif
+	pContext->debugCategoryFilter = pParameters->debugCategoryFilter;
+	pContext->pRecordCommandList = &pContext->commandList;
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	//FK: nothing can fail anymore, threads started earlier would outlive a failed ksr2_init_context
+	if (ksr2_start_worker_pool(&pContext->workerPool) < pParameters->workerThreadCount)
+	{
+		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "Could not create all worker threads in 'ksr2_init_context'.\n");
+	}
+
+	if (contextFlags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		if (ksr2_start_render_thread(&pContext->renderThread, pContext))
+		{
+			pContext->pRecordCommandList = &pContext->renderThread.commandLists[0];
+		}
+		else
+		{
+			debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "Could not create the render thread in 'ksr2_init_context', ksr2_blit rasterizes on the calling thread.\n");
+			pContext->flags &= ~K15_RENDERER_2D_ASYNC_BLIT;
+		}
+	}
+#endif
+
+	ksr2_contexthandle handle = (ksr2_contexthandle)(pContext);
+	*pOutContextHandle = handle;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+void ksr2_destroy_context(ksr2_contexthandle handle)
+{
+	ksr2_assert(handle != ksr2_invalid_context_handle);
+
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return;
+	}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	//FK: before the worker pool, the render thread might still be rasterizing a frame with it
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		ksr2_destroy_render_thread(&pContext->renderThread);
+	}
+#endif
+
+	ksr2_release_draw_command_stream(pContext);
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	ksr2_destroy_worker_pool(&pContext->workerPool);
+#endif
+}
+
+void ksr2_swap_buffers(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	const ksr2_u64 traceBeginTimeInNs = ksr2_trace_begin(pContext);
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		//FK: the image the next ksr2_blit renders into gets picked by ksr2_acquire_next_image()
+		ksr2_render_thread* pRenderThread = &pContext->renderThread;
+		ksr2_lock_mutex(&pRenderThread->mutex);
+		pRenderThread->presentingImageIndex = K15_RENDERER_2D_NO_IMAGE;
+		ksr2_unlock_mutex(&pRenderThread->mutex);
+
+		ksr2_trace_end(pContext, "swap", traceBeginTimeInNs, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+		return;
+	}
+#endif
+
+	if (pContext->swapChain.imageIndex + 1u == pContext->swapChain.imageCount)
+	{
+		pContext->swapChain.imageIndex = 0u;
+	} 
+	else
+	{
+		++pContext->swapChain.imageIndex;
+	}
+	
+	pContext->swapChain.pCurrentImage = ksr2_get_swap_chain_image(&pContext->swapChain, pContext->swapChain.imageIndex);
+
+	ksr2_trace_end(pContext, "swap", traceBeginTimeInNs, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+}
+
+unsigned char* ksr2_get_presenting_image_data(ksr2_contexthandle handle)
+{
+	unsigned char* pImageData = ksr2_nullptr;
+	unsigned int imageIndex = 0u;
+
+	if (ksr2_acquire_presentable_image(handle, &pImageData, &imageIndex) != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return ksr2_nullptr;
+	}
+
+	return pImageData;
+}
+
+ksr2_result ksr2_acquire_next_image(ksr2_contexthandle handle, unsigned int* pOutImageIndex)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pOutImageIndex == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		ksr2_render_thread* pRenderThread = &pContext->renderThread;
+		ksr2_lock_mutex(&pRenderThread->mutex);
+		*pOutImageIndex = ksr2_acquire_next_image_locked(pContext);
+		ksr2_unlock_mutex(&pRenderThread->mutex);
+
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+#endif
+
+	*pOutImageIndex = pContext->swapChain.imageIndex;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_acquire_presentable_image(ksr2_contexthandle handle, unsigned char** ppOutImageData, unsigned int* pOutImageIndex)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || ppOutImageData == ksr2_nullptr || pOutImageIndex == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_u32 imageIndex = pContext->swapChain.imageIndex;
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		ksr2_render_thread* pRenderThread = &pContext->renderThread;
+		ksr2_lock_mutex(&pRenderThread->mutex);
+
+		if (pRenderThread->presentingImageIndex == K15_RENDERER_2D_NO_IMAGE)
+		{
+			while(pRenderThread->presentableImageIndex == K15_RENDERER_2D_NO_IMAGE && pRenderThread->renderingImageIndex != K15_RENDERER_2D_NO_IMAGE)
+			{
+				ksr2_wait_condition_variable(&pRenderThread->frameFinished, &pRenderThread->mutex);
+			}
+
+			pRenderThread->presentingImageIndex 	= pRenderThread->presentableImageIndex;
+			pRenderThread->presentableImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+		}
+
+		imageIndex = pRenderThread->presentingImageIndex;
+		ksr2_unlock_mutex(&pRenderThread->mutex);
+
+		if (imageIndex == K15_RENDERER_2D_NO_IMAGE)
+		{
+			return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		}
+	}
+#endif
+
+	*ppOutImageData = (unsigned char*)ksr2_get_swap_chain_image(&pContext->swapChain, imageIndex);
+	*pOutImageIndex = imageIndex;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+unsigned int ksr2_get_image_stride(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	return pContext->swapChain.stride * (ksr2_u32)ksr2_get_pixel_size_in_bytes(pContext->swapChain.format);
+}
+
+ksr2_cpu_level ksr2_get_cpu_level(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	return pContext->cpuLevel;
+}
+
+ksr2_result ksr2_query_back_buffer_requirements(unsigned int width, unsigned int height, ksr2_pixel_format format, unsigned int flags, size_t* pOutSizeInBytes, unsigned int* pOutStrideInBytes)
+{
+	if (pOutSizeInBytes == ksr2_nullptr || pOutStrideInBytes == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_image_memory_requirements memoryRequirements = {0};
+	ksr2_result result = ksr2_query_image_memory_requirements(&memoryRequirements, width, height, format, (flags & K15_RENDERER_2D_PADDED_ROWS_FLAG) > 0u);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	*pOutSizeInBytes 	= memoryRequirements.memorySizeInBytes;
+	*pOutStrideInBytes 	= memoryRequirements.stride * (ksr2_u32)ksr2_get_pixel_size_in_bytes(format);
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+#ifndef K15_RENDERER_2D_NO_STATS
+//FK: Has to be called before the draw command stream gets reset. Draw commands get counted here
+//	  instead of while recording to keep the draw calls as cheap as possible.
+ksr2_internal void ksr2_add_draw_command_stream_stats(ksr2_frame_stats* pStats, const ksr2_draw_command_stream* pStream, size_t writtenPixelCount)
+{
+	ksr2_u32 drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_TYPE_COUNT] = {0};
+	ksr2_draw_command_iterator drawCommandIterator = {0};
+	ksr2_init_draw_command_iterator(&drawCommandIterator, pStream);
+
+	const ksr2_draw_command_header* pDrawCommand = ksr2_nullptr;
+	while((pDrawCommand = ksr2_next_draw_command(&drawCommandIterator)) != ksr2_nullptr)
+	{
+		++drawCommandCounts[pDrawCommand->type];
+	}
+
+	pStats->lineCommandCount 				+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_LINE] + drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE];
+	pStats->filledRectCommandCount 			+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT] + drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE];
+	pStats->imageCommandCount 				+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_IMAGE];
+	pStats->textCommandCount 				+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_TEXT];
+	pStats->triangleCommandCount 			+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE];
+	pStats->ellipseCommandCount 			+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE];
+	pStats->roundedRectCommandCount 		+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT];
+	pStats->pathCommandCount 				+= drawCommandCounts[K15_RENDERER_2D_DRAW_COMMAND_PATH];
+	pStats->writtenPixelCount 				+= writtenPixelCount;
+	pStats->drawCommandMemoryPeakInBytes 	= ksr2_max(pStats->drawCommandMemoryPeakInBytes, pStream->memorySizeInBytes);
+}
+
+ksr2_internal void ksr2_update_frame_stats(ksr2_context* pContext, ksr2_frame_stats* pStats, size_t writtenPixelCount, ksr2_u64 blitStartTimeInNs, ksr2_u64 recordStartTimeInNs)
+{
+	ksr2_linear_allocator* pAllocator = &pContext->allocator;
+
+	//FK: starts with whatever got flushed during the frame
+	*pStats = pContext->flushedFrameStats;
+	pStats->blitTimeInNs = ksr2_get_time_in_ns() - blitStartTimeInNs;
+
+	ksr2_add_draw_command_stream_stats(pStats, &pContext->commandList.drawCommandStream, writtenPixelCount);
+
+	pStats->culledPixelCount 			= pContext->culledPixelCount;
+	pStats->allocatorFrontPeakInBytes 	= pAllocator->peakSizeInBytesStart;
+	pStats->allocatorBackPeakInBytes 	= pAllocator->peakSizeInBytesEnd;
+	pStats->allocatorCapacityInBytes 	= pAllocator->memoryCapacityInBytes;
+	pStats->flushCount 					= pContext->flushCount;
+	pStats->recordTimeInNs 				= recordStartTimeInNs > 0u ? blitStartTimeInNs - recordStartTimeInNs : 0u;
+
+	const ksr2_frame_stats emptyFrameStats = {0};
+	pContext->flushedFrameStats = emptyFrameStats;
+
+	//FK: the allocator back gets reset by ksr2_blit right after this
+	pAllocator->peakSizeInBytesEnd 		= 0u;
+}
+#endif //K15_RENDERER_2D_NO_STATS
+
+//FK: Rasterizes the recorded draw commands into the current image and returns the written pixel count, culled pixels get
+//	  added to ksr2_context::culledPixelCount. Tiles only get reused from the previous image if nothing got flushed this frame.
+ksr2_internal size_t ksr2_rasterize_draw_command_stream(ksr2_context* pContext)
+{
+	size_t writtenPixelCount = 0u;
+	ksr2_tile_bins tileBins = {0};
+	ksr2_u64 traceBeginTimeInNs = ksr2_trace_begin(pContext);
+	ksr2_result result = ksr2_bin_draw_commands(&tileBins, pContext);
+	ksr2_trace_end(pContext, "bin", traceBeginTimeInNs, ksr2_get_rasterize_thread_index(pContext), K15_RENDERER_2D_NO_TRACE_TILE);
+
+	const ksr2_b32 trackDirtyRegions = (pContext->flags & K15_RENDERER_2D_DIRTY_REGION_TRACKING) > 0u;
+
+	if (result == K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		if (trackDirtyRegions && pContext->flushCount == 0u)
+		{
+			traceBeginTimeInNs = ksr2_trace_begin(pContext);
+			ksr2_update_dirty_regions(pContext, &tileBins);
+			ksr2_trace_end(pContext, "update dirty regions", traceBeginTimeInNs, ksr2_get_rasterize_thread_index(pContext), K15_RENDERER_2D_NO_TRACE_TILE);
+		}
+		else if (trackDirtyRegions)
+		{
+			//FK: the draw commands of the frame got split across flushes, the tiles can't be compared to the previous image
+			ksr2_invalidate_dirty_regions(pContext);
+		}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+		if (pContext->workerPool.workerCount > 0u)
+		{
+			ksr2_rasterize_tiles_parallel(&pContext->workerPool, &tileBins);
+		}
+		else
+#endif
+		{
+			const ksr2_u32 tileCount = tileBins.tileCountX * tileBins.tileCountY;
+			for (ksr2_u32 tileIndex = 0u; tileIndex < tileCount; ++tileIndex)
+			{
+				ksr2_rasterize_and_trace_tile(pContext, &tileBins, tileIndex, ksr2_get_rasterize_thread_index(pContext));
+			}
+		}
+
+		if (tileBins.pTileCulledPixelCounts != ksr2_nullptr)
+		{
+			const ksr2_u32 tileCount = tileBins.tileCountX * tileBins.tileCountY;
+			for (ksr2_u32 tileIndex = 0u; tileIndex < tileCount; ++tileIndex)
+			{
+				pContext->culledPixelCount += tileBins.pTileCulledPixelCounts[tileIndex];
+			}
+		}
+
+		if (tileBins.pTileWrittenPixelCounts != ksr2_nullptr)
+		{
+			const ksr2_u32 tileCount = tileBins.tileCountX * tileBins.tileCountY;
+			for (ksr2_u32 tileIndex = 0u; tileIndex < tileCount; ++tileIndex)
+			{
+				writtenPixelCount += tileBins.pTileWrittenPixelCounts[tileIndex];
+			}
+		}
+	}
+	else
+	{
+		//FK: Not enough memory left to bin the draw commands, issue them for the whole image instead.
+		if (trackDirtyRegions)
+		{
+			ksr2_invalidate_dirty_regions(pContext);
+		}
+
+		ksr2_rect imageRect = {0};
+		imageRect.x2 = pContext->swapChain.width;
+		imageRect.y2 = pContext->swapChain.height;
+
+		const ksr2_u32 drawCommandCount = pContext->commandList.drawCommandStream.drawCommandCount;
+
+		if (pContext->clearImage)
+		{
+			ksr2_render_target target;
+			ksr2_init_render_target(&target, pContext, pContext->swapChain.pCurrentImage);
+
+			const ksr2_b32 nonTemporal = ksr2_use_non_temporal_stores(&target, &imageRect, drawCommandCount == 0u);
+			ksr2_fill_rect(&target, &imageRect, pContext->clearColor, nonTemporal);
+			writtenPixelCount += ksr2_get_rect_pixel_count(&imageRect);
+		}
+
+		ksr2_draw_command_iterator drawCommandIterator = {0};
+		ksr2_init_draw_command_iterator(&drawCommandIterator, &pContext->commandList.drawCommandStream);
+
+		traceBeginTimeInNs = ksr2_trace_begin(pContext);
+
+		const ksr2_draw_command_header* pDrawCommand = ksr2_nullptr;
+		ksr2_u32 drawCommandIndex = 0u;
+		while((pDrawCommand = ksr2_next_draw_command(&drawCommandIterator)) != ksr2_nullptr)
+		{
+			++drawCommandIndex;
+			writtenPixelCount += ksr2_issue_draw_command(pContext, pDrawCommand, &imageRect, drawCommandIndex == drawCommandCount);
+		}
+
+		ksr2_trace_end(pContext, "rasterize image", traceBeginTimeInNs, ksr2_get_rasterize_thread_index(pContext), K15_RENDERER_2D_NO_TRACE_TILE);
+	}
+
+	return writtenPixelCount;
+}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+//FK: Hands what got recorded into the context since the last ksr2_blit or flush over to the draw command stream that gets
+//	  rasterized next, along with the image it gets rasterized into. The render thread has to be idle.
+ksr2_internal void ksr2_take_recorded_frame(ksr2_context* pContext)
+{
+	ksr2_render_thread* pRenderThread 		= &pContext->renderThread;
+	ksr2_command_list* pRecordCommandList 	= pContext->pRecordCommandList;
+
+	ksr2_lock_mutex(&pRenderThread->mutex);
+	const ksr2_u32 imageIndex = ksr2_acquire_next_image_locked(pContext);
+	ksr2_unlock_mutex(&pRenderThread->mutex);
+
+	pContext->swapChain.imageIndex 		= imageIndex;
+	pContext->swapChain.pCurrentImage 	= ksr2_get_swap_chain_image(&pContext->swapChain, imageIndex);
+
+	if (pRenderThread->clearImage)
+	{
+		pContext->clearImage 		= ksr2_true;
+		pContext->clearColor 		= pRenderThread->clearColor;
+		pRenderThread->clearImage 	= ksr2_false;
+	}
+
+	ksr2_append_draw_command_stream(&pContext->commandList.drawCommandStream, &pRecordCommandList->drawCommandStream);
+
+	//FK: the glyph cache doesn't get touched while the render thread is busy, glyphs that don't fit are left blank
+	if (pRecordCommandList->hasTextDrawCommands)
+	{
+		ksr2_cache_draw_command_stream_glyphs(pContext, &pContext->commandList.drawCommandStream);
+	}
+
+	ksr2_reset_draw_command_stream(&pRecordCommandList->drawCommandStream);
+	pRecordCommandList->hasTextDrawCommands = ksr2_false;
+}
+#endif //K15_RENDERER_2D_NO_THREADS
+
+//FK: Makes room for new draw commands, the image stays as is until ksr2_blit rasterizes the remaining draw commands.
+ksr2_internal void ksr2_flush_draw_commands(ksr2_context* pContext)
+{
+	const ksr2_u64 traceBeginTimeInNs = ksr2_trace_begin(pContext);
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		//FK: gets rasterized on the calling thread into the image the frame gets rendered into
+		ksr2_wait_for_render_thread(pContext);
+		ksr2_take_recorded_frame(pContext);
+	}
+#endif
+
+	if (pContext->flushCount == 0u)
+	{
+		pContext->culledPixelCount = 0u;
+	}
+
+	//FK: incremented first, the tile hashes of this flush would only cover part of the draw commands of the frame
+	++pContext->flushCount;
+
+	const size_t writtenPixelCount = ksr2_rasterize_draw_command_stream(pContext);
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	ksr2_add_draw_command_stream_stats(&pContext->flushedFrameStats, &pContext->commandList.drawCommandStream, writtenPixelCount);
+#else
+	ksr2_use_argument(writtenPixelCount);
+#endif
+
+	ksr2_release_draw_command_stream(pContext);
+	ksr2_reset_allocator_back(&pContext->allocator);
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		ksr2_reset_allocator_back(&pContext->pRecordCommandList->allocator);
+	}
+#endif
+
+	//FK: the clear color is part of the image now
+	pContext->clearImage = ksr2_false;
+
+	ksr2_trace_end(pContext, "flush", traceBeginTimeInNs, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+}
+
+//FK: Rasterizes the frame into the current image and leaves the context ready for the next one. Runs on the render thread
+//	  with K15_RENDERER_2D_ASYNC_BLIT_FLAG, which is why the stats don't get written to the context directly.
+ksr2_internal void ksr2_render_frame(ksr2_context* pContext, ksr2_frame_stats* pOutStats, ksr2_u64 blitStartTimeInNs, ksr2_u64 recordStartTimeInNs)
+{
+	if (pContext->flushCount == 0u)
+	{
+		pContext->culledPixelCount = 0u;
+	}
+
+	const size_t writtenPixelCount = ksr2_rasterize_draw_command_stream(pContext);
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	ksr2_update_frame_stats(pContext, pOutStats, writtenPixelCount, blitStartTimeInNs, recordStartTimeInNs);
+#else
+	ksr2_use_argument(writtenPixelCount);
+	ksr2_use_argument(pOutStats);
+	ksr2_use_argument(recordStartTimeInNs);
+#endif
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+	if (pContext->traceBuffer.pEvents != ksr2_nullptr)
+	{
+		ksr2_add_trace_event(pContext, "blit", blitStartTimeInNs, ksr2_get_time_in_ns(), ksr2_get_rasterize_thread_index(pContext), K15_RENDERER_2D_NO_TRACE_TILE);
+	}
+#else
+	ksr2_use_argument(blitStartTimeInNs);
+#endif
+
+	ksr2_release_draw_command_stream(pContext);
+	pContext->clearImage		= ksr2_false;
+	pContext->flushCount		= 0u;
+	ksr2_reset_allocator_back(&pContext->allocator);
+
+	pContext->dirtyRegionTracker.previousImageIndex = pContext->swapChain.imageIndex;
+	pContext->dirtyRegionTracker.hasPreviousImage 	= ksr2_true;
+}
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+ksr2_internal void ksr2_render_thread_fnc(void* pArgument)
+{
+	ksr2_context* pContext = (ksr2_context*)pArgument;
+	ksr2_render_thread* pRenderThread = &pContext->renderThread;
+
+	ksr2_lock_mutex(&pRenderThread->mutex);
+
+	while(ksr2_true)
+	{
+		while(pRenderThread->shutdown == ksr2_false && pRenderThread->renderingImageIndex == K15_RENDERER_2D_NO_IMAGE)
+		{
+			ksr2_wait_condition_variable(&pRenderThread->frameQueued, &pRenderThread->mutex);
+		}
+
+		//FK: the frame in flight gets finished before shutting down
+		if (pRenderThread->renderingImageIndex == K15_RENDERER_2D_NO_IMAGE)
+		{
+			break;
+		}
+
+		const ksr2_u64 blitStartTimeInNs 	= pRenderThread->blitStartTimeInNs;
+		const ksr2_u64 recordStartTimeInNs 	= pRenderThread->recordStartTimeInNs;
+		ksr2_unlock_mutex(&pRenderThread->mutex);
+
+		//FK: flushes rasterize on the thread calling ksr2_blit while the render thread is idle
+#ifndef K15_RENDERER_2D_NO_TRACING
+		pContext->traceBuffer.rasterizeThreadIndex = pContext->workerPool.workerCount + 1u;
+#endif
+
+		ksr2_frame_stats frameStats = {0};
+		ksr2_render_frame(pContext, &frameStats, blitStartTimeInNs, recordStartTimeInNs);
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+		pContext->traceBuffer.rasterizeThreadIndex = 0u;
+#endif
+
+		ksr2_lock_mutex(&pRenderThread->mutex);
+
+#ifndef K15_RENDERER_2D_NO_STATS
+		pContext->frameStats = frameStats;
+#endif
+
+		//FK: replaces the previous presentable image if that didn't get presented, it's free again
+		pRenderThread->presentableImageIndex 	= pRenderThread->renderingImageIndex;
+		pRenderThread->renderingImageIndex 		= K15_RENDERER_2D_NO_IMAGE;
+		ksr2_broadcast_condition_variable(&pRenderThread->frameFinished);
+	}
+
+	ksr2_unlock_mutex(&pRenderThread->mutex);
+}
+
+//FK: The render thread gets the frame as soon as it finished the previous one, the application can record the next frame
+//	  into the other command list meanwhile.
+ksr2_internal void ksr2_queue_frame(ksr2_context* pContext, ksr2_u64 blitStartTimeInNs, ksr2_u64 recordStartTimeInNs)
+{
+	ksr2_render_thread* pRenderThread = &pContext->renderThread;
+
+	ksr2_wait_for_render_thread(pContext);
+
+	//FK: glyphs of the previous frame can be evicted from now on
+	++pContext->frameIndex;
+	ksr2_take_recorded_frame(pContext);
+
+	//FK: the command list of the previous frame got rasterized already
+	ksr2_command_list* pNextCommandList = &pRenderThread->commandLists[pRenderThread->recordIndex ^ 1u];
+	pNextCommandList->blendMode = pContext->pRecordCommandList->blendMode;
+	ksr2_reset_allocator_back(&pNextCommandList->allocator);
+
+	pRenderThread->recordIndex 		^= 1u;
+	pContext->pRecordCommandList 	= pNextCommandList;
+
+	ksr2_lock_mutex(&pRenderThread->mutex);
+	pRenderThread->renderingImageIndex 	= pRenderThread->acquiredImageIndex;
+	pRenderThread->acquiredImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+	pRenderThread->blitStartTimeInNs 	= blitStartTimeInNs;
+	pRenderThread->recordStartTimeInNs 	= recordStartTimeInNs;
+	ksr2_broadcast_condition_variable(&pRenderThread->frameQueued);
+	ksr2_unlock_mutex(&pRenderThread->mutex);
+}
+#endif //K15_RENDERER_2D_NO_THREADS
+
+void ksr2_blit(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+	const ksr2_u64 blitStartTimeInNs 	= ksr2_get_timestamp_in_ns(pContext);
+	const ksr2_u64 recordStartTimeInNs 	= pContext->recordStartTimeInNs;
+
+	if (recordStartTimeInNs > 0u)
+	{
+		ksr2_add_trace_event(pContext, "record", recordStartTimeInNs, blitStartTimeInNs, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+	}
+
+	pContext->recordStartTimeInNs = 0u;
+#else
+	const ksr2_u64 blitStartTimeInNs 	= 0u;
+	const ksr2_u64 recordStartTimeInNs 	= 0u;
+#endif
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		ksr2_queue_frame(pContext, blitStartTimeInNs, recordStartTimeInNs);
+		return;
+	}
+#endif
+
+	ksr2_frame_stats frameStats = {0};
+	ksr2_render_frame(pContext, &frameStats, blitStartTimeInNs, recordStartTimeInNs);
+
+#ifndef K15_RENDERER_2D_NO_STATS
+	pContext->frameStats = frameStats;
+#endif
+
+	++pContext->frameIndex;
+}
+
+ksr2_result ksr2_resize_swap_chain(ksr2_contexthandle handle, const ksr2_resize_swapchain_parameters* pParameters)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	if(pContext == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	if ((pContext->flags & K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP) == 0 && pParameters->pPreAllocatedBackBuffers == ksr2_nullptr)
+	{
+		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "context was created with pre allocated back buffer, however no pre allocated back buffer was passed for ksr2_resize_swap_chain.");
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_wait_for_render_thread(pContext);
+
+	ksr2_swap_chain* pSwapChain 		= &pContext->swapChain;
+	ksr2_linear_allocator* pAllocator 	= &pContext->allocator;
+
+	ksr2_swap_chain resizedSwapChain = *pSwapChain;
+	resizedSwapChain.width 	= pParameters->backBufferWidth;
+	resizedSwapChain.height = pParameters->backBufferHeight;
+
+	size_t requiredSizeInBytes = ksr2_get_dirty_region_tracker_size_in_bytes(&resizedSwapChain, pContext->tileSize, pContext->flags);
+
+	if (pContext->flags & K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP)
+	{
+		ksr2_image_memory_requirements memoryRequirements = {0};
+		ksr2_result result = ksr2_query_image_memory_requirements(&memoryRequirements, resizedSwapChain.width, resizedSwapChain.height, resizedSwapChain.format, resizedSwapChain.padRows);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		requiredSizeInBytes += memoryRequirements.memorySizeInBytes * resizedSwapChain.imageCount + memoryRequirements.alignment;
+	}
+
+	//FK: Swap chain images and the dirty region tracker live at the allocator front and get allocated again. Textures that got
+	//	  created after them can't be moved, in that case the old memory only gets reused if the new swap chain fits into it.
+	ksr2_byte* pFront 		= (ksr2_byte*)ksr2_get_allocator_front_address(pAllocator);
+	ksr2_byte* pRegionStart = (ksr2_byte*)pSwapChain->pImageStart;
+	ksr2_byte* pRegionEnd 	= (ksr2_byte*)pSwapChain->pImageEnd;
+	ksr2_b32 regionIsAtFront = pFront == pRegionEnd;
+
+	if (regionIsAtFront == ksr2_false && requiredSizeInBytes > (size_t)(pRegionEnd - pRegionStart))
+	{
+		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_WARNING, "swap chain got resized after textures have been created and doesn't fit into its previous memory, the previous memory can't be reused.");
+		pRegionStart 	= pFront;
+		regionIsAtFront = ksr2_true;
+	}
+
+	//FK: The old swap chain and tracker stay untouched until the new images and tracker got allocated. Nothing gets written
+	//	  into the reused memory before that, so on failure restoring the allocator front leaves them intact.
+	ksr2_set_linear_allocator_front(pAllocator, pRegionStart);
+	resizedSwapChain.pImageStart = pRegionStart;
+
+	if (pContext->flags & K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP)
+	{
+		ksr2_result result = ksr2_allocate_swap_chain_images(&resizedSwapChain.pImages, resizedSwapChain.imageCount, pAllocator, resizedSwapChain.width, resizedSwapChain.height, resizedSwapChain.format, resizedSwapChain.padRows);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			ksr2_set_linear_allocator_front(pAllocator, pFront);
+			return result;
+		}
+	}
+	else
+	{
+		resizedSwapChain.pImages = pParameters->pPreAllocatedBackBuffers;
+	}
+
+	ksr2_query_image_memory_requirements(&resizedSwapChain.memoryRequirements, resizedSwapChain.width, resizedSwapChain.height, resizedSwapChain.format, resizedSwapChain.padRows);
+	resizedSwapChain.stride 		= resizedSwapChain.memoryRequirements.stride;
+	resizedSwapChain.pCurrentImage 	= ksr2_get_swap_chain_image(&resizedSwapChain, resizedSwapChain.imageIndex);
+
+	//FK: only writes the tracker if all of its allocations succeeded
+	ksr2_result result = ksr2_init_dirty_region_tracker(&pContext->dirtyRegionTracker, pAllocator, &resizedSwapChain, pContext->tileSize, pContext->flags);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		ksr2_set_linear_allocator_front(pAllocator, pFront);
+		return result;
+	}
+
+	if (regionIsAtFront)
+	{
+		resizedSwapChain.pImageEnd = ksr2_get_allocator_front_address(pAllocator);
+	}
+	else
+	{
+		ksr2_set_linear_allocator_front(pAllocator, pFront);
+	}
+
+	*pSwapChain = resizedSwapChain;
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		//FK: the images got rendered with the previous size, none of them can be presented anymore
+		ksr2_render_thread* pRenderThread = &pContext->renderThread;
+		ksr2_lock_mutex(&pRenderThread->mutex);
+		pRenderThread->acquiredImageIndex 		= K15_RENDERER_2D_NO_IMAGE;
+		pRenderThread->presentableImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+		pRenderThread->presentingImageIndex 	= K15_RENDERER_2D_NO_IMAGE;
+		ksr2_unlock_mutex(&pRenderThread->mutex);
+	}
+#endif
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_line(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, unsigned int thickness, ksr2_rgba_color color)
+{
+	if (thickness == 0u)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	if (ksr2_clip_line_to_guard_band(&x1, &y1, &x2, &y2, thickness, &pCommandList->pContext->swapChain) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_pixel_color pixelColor = 0u;
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	if (ksr2_resolve_blend_color(&pixelColor, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_b32 fitsInto16Bit = ksr2_line_fits_into_16_bit(x1, y1, x2, y2, thickness);
+
+	if (fitsInto16Bit)
+	{
+		ksr2_line_draw_command* pDrawCommand = ksr2_nullptr;
+		ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_line_draw_command), K15_RENDERER_2D_DRAW_COMMAND_LINE, blendMode);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		pDrawCommand->x1 		= (ksr2_s16)x1;
+		pDrawCommand->y1 		= (ksr2_s16)y1;
+		pDrawCommand->x2 		= (ksr2_s16)x2;
+		pDrawCommand->y2 		= (ksr2_s16)y2;
+		pDrawCommand->thickness = (ksr2_u16)thickness;
+		pDrawCommand->padding 	= 0u;
+		pDrawCommand->color 	= pixelColor;
+	}
+	else
+	{
+		ksr2_wide_line_draw_command* pDrawCommand = ksr2_nullptr;
+		ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_wide_line_draw_command), K15_RENDERER_2D_DRAW_COMMAND_LINE_WIDE, blendMode);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		pDrawCommand->x1 		= x1;
+		pDrawCommand->y1 		= y1;
+		pDrawCommand->x2 		= x2;
+		pDrawCommand->y2 		= y2;
+		pDrawCommand->thickness = thickness;
+		pDrawCommand->color 	= pixelColor;
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_filled_rect(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, ksr2_rgba_color color)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	x1 = ksr2_clamp(x1, 0, (ksr2_s32)pSwapChain->width);
+	x2 = ksr2_clamp(x2, 0, (ksr2_s32)pSwapChain->width);
+	y1 = ksr2_clamp(y1, 0, (ksr2_s32)pSwapChain->height);
+	y2 = ksr2_clamp(y2, 0, (ksr2_s32)pSwapChain->height);
+
+	if (x1 >= x2 || y1 >= y2)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_pixel_color pixelColor = 0u;
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	if (ksr2_resolve_blend_color(&pixelColor, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	//FK: coordinates are clamped to the image, so they only need the wide draw command for huge images
+	if (pSwapChain->width <= 0xFFFFu && pSwapChain->height <= 0xFFFFu)
+	{
+		ksr2_filled_rect_draw_command* pDrawCommand = ksr2_nullptr;
+		ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_filled_rect_draw_command), K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT, blendMode);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		pDrawCommand->color = pixelColor;
+		pDrawCommand->x1 	= (ksr2_u16)x1;
+		pDrawCommand->x2 	= (ksr2_u16)x2;
+		pDrawCommand->y1 	= (ksr2_u16)y1;
+		pDrawCommand->y2 	= (ksr2_u16)y2;
+	}
+	else
+	{
+		ksr2_wide_filled_rect_draw_command* pDrawCommand = ksr2_nullptr;
+		ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_wide_filled_rect_draw_command), K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT_WIDE, blendMode);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		pDrawCommand->color = pixelColor;
+		pDrawCommand->x1 	= (ksr2_u32)x1;
+		pDrawCommand->x2 	= (ksr2_u32)x2;
+		pDrawCommand->y1 	= (ksr2_u32)y1;
+		pDrawCommand->y2 	= (ksr2_u32)y2;
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_filled_rects(ksr2_contexthandle handle, const int* pX1, const int* pY1, const int* pX2, const int* pY2, const ksr2_rgba_color* pColors, unsigned int count)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || (count > 0u && (pX1 == ksr2_nullptr || pY1 == ksr2_nullptr || pX2 == ksr2_nullptr || pY2 == ksr2_nullptr || pColors == ksr2_nullptr)))
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	//FK: huge images need the wide draw command, not worth batching
+	if (pSwapChain->width > 0xFFFFu || pSwapChain->height > 0xFFFFu)
+	{
+		for (ksr2_u32 rectIndex = 0u; rectIndex < count; ++rectIndex)
+		{
+			ksr2_result result = ksr2_draw_filled_rect(handle, pX1[rectIndex], pY1[rectIndex], pX2[rectIndex], pY2[rectIndex], pColors[rectIndex]);
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				return result;
+			}
+		}
+
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_s32 x1[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_s32 y1[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_s32 x2[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_s32 y2[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_pixel_color pixelColors[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_u8 blendModes[K15_RENDERER_2D_BATCH_SIZE];
+
+	const ksr2_s32 width 	= (ksr2_s32)pSwapChain->width;
+	const ksr2_s32 height 	= (ksr2_s32)pSwapChain->height;
+
+	for (ksr2_u32 batchStart = 0u; batchStart < count; batchStart += K15_RENDERER_2D_BATCH_SIZE)
+	{
+		const ksr2_u32 batchCount = ksr2_min(count - batchStart, (ksr2_u32)K15_RENDERER_2D_BATCH_SIZE);
+
+		ksr2_clamp_coordinates(x1, pX1 + batchStart, batchCount, width);
+		ksr2_clamp_coordinates(y1, pY1 + batchStart, batchCount, height);
+		ksr2_clamp_coordinates(x2, pX2 + batchStart, batchCount, width);
+		ksr2_clamp_coordinates(y2, pY2 + batchStart, batchCount, height);
+		ksr2_resolve_blend_colors(pixelColors, blendModes, pCommandList, pColors + batchStart, batchCount);
+
+		//FK: write the draw commands straight into the chunk and only touch the draw command stream once per chunk
+		ksr2_u32 rectIndex = 0u;
+		while (rectIndex < batchCount)
+		{
+			ksr2_byte* pMemory = ksr2_nullptr;
+			ksr2_u32 capacityInBytes = 0u;
+			ksr2_result result = ksr2_reserve_draw_command_memory(&pMemory, &capacityInBytes, pCommandList, sizeof(ksr2_filled_rect_draw_command));
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				return result;
+			}
+
+			ksr2_filled_rect_draw_command* pDrawCommand = (ksr2_filled_rect_draw_command*)pMemory;
+			const ksr2_u32 maxDrawCommandCount = capacityInBytes / sizeof(ksr2_filled_rect_draw_command);
+			ksr2_u32 drawCommandCount = 0u;
+
+			for (; rectIndex < batchCount && drawCommandCount < maxDrawCommandCount; ++rectIndex)
+			{
+				if (x1[rectIndex] >= x2[rectIndex] || y1[rectIndex] >= y2[rectIndex] || blendModes[rectIndex] == K15_RENDERER_2D_INVISIBLE_BLEND_MODE)
+				{
+					continue;
+				}
+
+				ksr2_init_draw_command_header(&pDrawCommand->header, sizeof(ksr2_filled_rect_draw_command), K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT, (ksr2_blend_mode)blendModes[rectIndex]);
+				pDrawCommand->color = pixelColors[rectIndex];
+				pDrawCommand->x1 	= (ksr2_u16)x1[rectIndex];
+				pDrawCommand->x2 	= (ksr2_u16)x2[rectIndex];
+				pDrawCommand->y1 	= (ksr2_u16)y1[rectIndex];
+				pDrawCommand->y2 	= (ksr2_u16)y2[rectIndex];
+
+				++pDrawCommand;
+				++drawCommandCount;
+			}
+
+			ksr2_commit_draw_command_memory(pCommandList, drawCommandCount * sizeof(ksr2_filled_rect_draw_command), drawCommandCount);
+		}
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_lines(ksr2_contexthandle handle, const int* pX1, const int* pY1, const int* pX2, const int* pY2, unsigned int thickness, const ksr2_rgba_color* pColors, unsigned int count)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || (count > 0u && (pX1 == ksr2_nullptr || pY1 == ksr2_nullptr || pX2 == ksr2_nullptr || pY2 == ksr2_nullptr || pColors == ksr2_nullptr)))
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	if (thickness == 0u)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_pixel_color pixelColors[K15_RENDERER_2D_BATCH_SIZE];
+	ksr2_u8 blendModes[K15_RENDERER_2D_BATCH_SIZE];
+
+	for (ksr2_u32 batchStart = 0u; batchStart < count; batchStart += K15_RENDERER_2D_BATCH_SIZE)
+	{
+		const ksr2_u32 batchCount = ksr2_min(count - batchStart, (ksr2_u32)K15_RENDERER_2D_BATCH_SIZE);
+		ksr2_resolve_blend_colors(pixelColors, blendModes, pCommandList, pColors + batchStart, batchCount);
+
+		ksr2_u32 lineIndex = 0u;
+		while (lineIndex < batchCount)
+		{
+			ksr2_byte* pMemory = ksr2_nullptr;
+			ksr2_u32 capacityInBytes = 0u;
+			ksr2_result result = ksr2_reserve_draw_command_memory(&pMemory, &capacityInBytes, pCommandList, sizeof(ksr2_line_draw_command));
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				return result;
+			}
+
+			ksr2_line_draw_command* pDrawCommand = (ksr2_line_draw_command*)pMemory;
+			const ksr2_u32 maxDrawCommandCount = capacityInBytes / sizeof(ksr2_line_draw_command);
+			ksr2_u32 drawCommandCount = 0u;
+			ksr2_b32 isWideLine = ksr2_false;
+
+			for (; lineIndex < batchCount && drawCommandCount < maxDrawCommandCount; ++lineIndex)
+			{
+				const ksr2_u32 sourceIndex = batchStart + lineIndex;
+				ksr2_s32 x1 = pX1[sourceIndex];
+				ksr2_s32 y1 = pY1[sourceIndex];
+				ksr2_s32 x2 = pX2[sourceIndex];
+				ksr2_s32 y2 = pY2[sourceIndex];
+
+				if (blendModes[lineIndex] == K15_RENDERER_2D_INVISIBLE_BLEND_MODE || ksr2_clip_line_to_guard_band(&x1, &y1, &x2, &y2, thickness, &pCommandList->pContext->swapChain) == ksr2_false)
+				{
+					continue;
+				}
+
+				if (ksr2_line_fits_into_16_bit(x1, y1, x2, y2, thickness) == ksr2_false)
+				{
+					isWideLine = ksr2_true;
+					break;
+				}
+
+				ksr2_init_draw_command_header(&pDrawCommand->header, sizeof(ksr2_line_draw_command), K15_RENDERER_2D_DRAW_COMMAND_LINE, (ksr2_blend_mode)blendModes[lineIndex]);
+				pDrawCommand->x1 		= (ksr2_s16)x1;
+				pDrawCommand->y1 		= (ksr2_s16)y1;
+				pDrawCommand->x2 		= (ksr2_s16)x2;
+				pDrawCommand->y2 		= (ksr2_s16)y2;
+				pDrawCommand->thickness = (ksr2_u16)thickness;
+				pDrawCommand->padding 	= 0u;
+				pDrawCommand->color 	= pixelColors[lineIndex];
+
+				++pDrawCommand;
+				++drawCommandCount;
+			}
+
+			ksr2_commit_draw_command_memory(pCommandList, drawCommandCount * sizeof(ksr2_line_draw_command), drawCommandCount);
+
+			//FK: wide lines are rare, record them one by one after the narrow lines that came before
+			if (isWideLine)
+			{
+				const ksr2_u32 sourceIndex = batchStart + lineIndex;
+				result = ksr2_draw_line(handle, pX1[sourceIndex], pY1[sourceIndex], pX2[sourceIndex], pY2[sourceIndex], thickness, pColors[sourceIndex]);
+
+				if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+				{
+					return result;
+				}
+
+				++lineIndex;
+			}
+		}
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: 28.4 fixed point, NaN ends up at -K15_RENDERER_2D_MAX_TRIANGLE_COORDINATE
+ksr2_internal ksr2_s32 ksr2_float_to_subpixels(float value)
+{
+	const double maxValue = (double)K15_RENDERER_2D_MAX_TRIANGLE_COORDINATE;
+	const double clampedValue = (double)value > -maxValue ? ((double)value < maxValue ? (double)value : maxValue) : -maxValue;
+	return (ksr2_s32)floor(clampedValue * (double)K15_RENDERER_2D_SUBPIXEL_ONE + 0.5);
+}
+
+ksr2_result ksr2_draw_triangles(ksr2_contexthandle handle, const float* pX, const float* pY, const ksr2_rgba_color* pColors, unsigned int vertexCount, const unsigned int* pIndices, unsigned int indexCount)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || indexCount % 3u != 0u || (indexCount > 0u && (pX == ksr2_nullptr || pY == ksr2_nullptr || pColors == ksr2_nullptr || pIndices == ksr2_nullptr)))
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	//FK: write the draw commands straight into the chunk and only touch the draw command stream once per chunk
+	ksr2_u32 indexOffset = 0u;
+	while (indexOffset < indexCount)
+	{
+		ksr2_byte* pMemory = ksr2_nullptr;
+		ksr2_u32 capacityInBytes = 0u;
+		ksr2_result result = ksr2_reserve_draw_command_memory(&pMemory, &capacityInBytes, pCommandList, sizeof(ksr2_triangle_draw_command));
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+
+		ksr2_triangle_draw_command* pDrawCommand = (ksr2_triangle_draw_command*)pMemory;
+		const ksr2_u32 maxDrawCommandCount = capacityInBytes / sizeof(ksr2_triangle_draw_command);
+		ksr2_u32 drawCommandCount = 0u;
+
+		for (; indexOffset < indexCount && drawCommandCount < maxDrawCommandCount; indexOffset += 3u)
+		{
+			ksr2_u32 indices[3] = { pIndices[indexOffset], pIndices[indexOffset + 1u], pIndices[indexOffset + 2u] };
+
+			if (indices[0] >= vertexCount || indices[1] >= vertexCount || indices[2] >= vertexCount)
+			{
+				result = K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+				break;
+			}
+
+			for (ksr2_u32 vertexIndex = 0u; vertexIndex < 3u; ++vertexIndex)
+			{
+				pDrawCommand->x[vertexIndex] = ksr2_float_to_subpixels(pX[indices[vertexIndex]]);
+				pDrawCommand->y[vertexIndex] = ksr2_float_to_subpixels(pY[indices[vertexIndex]]);
+			}
+
+			const ksr2_s64 area = ksr2_get_triangle_area(pDrawCommand->x, pDrawCommand->y);
+
+			if (area == 0)
+			{
+				continue;
+			}
+
+			//FK: the rasterizer expects clockwise triangles
+			if (area < 0)
+			{
+				const ksr2_s32 x = pDrawCommand->x[1];
+				const ksr2_s32 y = pDrawCommand->y[1];
+				const ksr2_u32 index = indices[1];
+				pDrawCommand->x[1] 	= pDrawCommand->x[2];
+				pDrawCommand->y[1] 	= pDrawCommand->y[2];
+				indices[1] 			= indices[2];
+				pDrawCommand->x[2] 	= x;
+				pDrawCommand->y[2] 	= y;
+				indices[2] 			= index;
+			}
+
+			ksr2_rect rect = {0};
+			ksr2_get_triangle_draw_command_rect(&rect, pDrawCommand);
+
+			if (rect.x1 >= ksr2_min(rect.x2, pSwapChain->width) || rect.y1 >= ksr2_min(rect.y2, pSwapChain->height))
+			{
+				continue;
+			}
+
+			const ksr2_rgba_color colors[3] = { pColors[indices[0]], pColors[indices[1]], pColors[indices[2]] };
+			ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+
+			if (ksr2_resolve_triangle_colors(pDrawCommand->colors, &blendMode, pCommandList, colors) == ksr2_false)
+			{
+				continue;
+			}
+
+			ksr2_init_draw_command_header(&pDrawCommand->header, sizeof(ksr2_triangle_draw_command), K15_RENDERER_2D_DRAW_COMMAND_TRIANGLE, blendMode);
+
+			++pDrawCommand;
+			++drawCommandCount;
+		}
+
+		ksr2_commit_draw_command_memory(pCommandList, drawCommandCount * sizeof(ksr2_triangle_draw_command), drawCommandCount);
+
+		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		{
+			return result;
+		}
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: innerRadius is in subpixels, see ksr2_ellipse_draw_command
+ksr2_internal ksr2_result ksr2_draw_ellipse_shape(ksr2_contexthandle handle, float centerX, float centerY, float radiusX, float radiusY, ksr2_s32 innerRadius, ksr2_rgba_color color)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	ksr2_ellipse_draw_command drawCommand = {0};
+	drawCommand.centerX 	= ksr2_float_to_subpixels(centerX);
+	drawCommand.centerY 	= ksr2_float_to_subpixels(centerY);
+	drawCommand.radiusX 	= ksr2_float_to_subpixels(radiusX);
+	drawCommand.radiusY 	= ksr2_float_to_subpixels(radiusY);
+	drawCommand.innerRadius = innerRadius;
+
+	if (drawCommand.radiusX <= 0 || drawCommand.radiusY <= 0)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_rect rect = {0};
+	ksr2_get_ellipse_draw_command_rect(&rect, &drawCommand);
+
+	if (rect.x1 >= ksr2_min(rect.x2, pSwapChain->width) || rect.y1 >= ksr2_min(rect.y2, pSwapChain->height))
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	if (ksr2_resolve_blend_color(&drawCommand.color, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_ellipse_draw_command* pDrawCommand = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_ellipse_draw_command), K15_RENDERER_2D_DRAW_COMMAND_ELLIPSE, blendMode);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	drawCommand.header = pDrawCommand->header;
+	*pDrawCommand = drawCommand;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_filled_circle(ksr2_contexthandle handle, float centerX, float centerY, float radius, ksr2_rgba_color color)
+{
+	return ksr2_draw_ellipse_shape(handle, centerX, centerY, radius, radius, 0, color);
+}
+
+ksr2_result ksr2_draw_filled_ellipse(ksr2_contexthandle handle, float centerX, float centerY, float radiusX, float radiusY, ksr2_rgba_color color)
+{
+	return ksr2_draw_ellipse_shape(handle, centerX, centerY, radiusX, radiusY, 0, color);
+}
+
+ksr2_result ksr2_draw_ring(ksr2_contexthandle handle, float centerX, float centerY, float radius, float thickness, ksr2_rgba_color color)
+{
+	const ksr2_s32 subpixelThickness = ksr2_float_to_subpixels(thickness);
+
+	if (subpixelThickness <= 0)
+	{
+		return ksr2_handle_to_command_list(handle) != ksr2_nullptr ? K15_RENDERER_2D_RESULT_SUCCESS : K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	//FK: rings that are at least as thick as their radius are filled circles
+	const ksr2_s32 innerRadius = ksr2_float_to_subpixels(radius) - subpixelThickness;
+	return ksr2_draw_ellipse_shape(handle, centerX, centerY, radius, radius, innerRadius > 0 ? innerRadius : 0, color);
+}
+
+ksr2_result ksr2_draw_filled_rounded_rect(ksr2_contexthandle handle, float x1, float y1, float x2, float y2, float cornerRadius, ksr2_rgba_color color)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	ksr2_rounded_rect_draw_command drawCommand = {0};
+	drawCommand.x1 = ksr2_float_to_subpixels(x1);
+	drawCommand.y1 = ksr2_float_to_subpixels(y1);
+	drawCommand.x2 = ksr2_float_to_subpixels(x2);
+	drawCommand.y2 = ksr2_float_to_subpixels(y2);
+
+	if (drawCommand.x1 >= drawCommand.x2 || drawCommand.y1 >= drawCommand.y2)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_s32 maxCornerRadius = ksr2_min(drawCommand.x2 - drawCommand.x1, drawCommand.y2 - drawCommand.y1) / 2;
+	drawCommand.cornerRadius = ksr2_clamp(ksr2_float_to_subpixels(cornerRadius), 0, maxCornerRadius);
+
+	ksr2_rect rect = {0};
+	ksr2_get_rounded_rect_draw_command_rect(&rect, &drawCommand);
+
+	if (rect.x1 >= ksr2_min(rect.x2, pSwapChain->width) || rect.y1 >= ksr2_min(rect.y2, pSwapChain->height))
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	if (ksr2_resolve_blend_color(&drawCommand.color, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_rounded_rect_draw_command* pDrawCommand = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_rounded_rect_draw_command), K15_RENDERER_2D_DRAW_COMMAND_ROUNDED_RECT, blendMode);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	drawCommand.header = pDrawCommand->header;
+	*pDrawCommand = drawCommand;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+void ksr2_init_path(ksr2_path* pOutPath, unsigned char* pVerbs, unsigned int verbCapacity, float* pPoints, unsigned int pointCapacity)
+{
+	pOutPath->pVerbs 		= pVerbs;
+	pOutPath->pPoints 		= pPoints;
+	pOutPath->verbCount 	= 0u;
+	pOutPath->pointCount 	= 0u;
+	pOutPath->verbCapacity 	= pVerbs != ksr2_nullptr ? verbCapacity : 0u;
+	pOutPath->pointCapacity = pPoints != ksr2_nullptr ? pointCapacity : 0u;
+}
+
+ksr2_internal ksr2_result ksr2_append_path_verb(ksr2_path* pPath, ksr2_path_verb verb, const float* pPoints, ksr2_u32 pointCount)
+{
+	if (pPath == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	if (pPath->verbCount >= pPath->verbCapacity || pPath->pointCount + pointCount > pPath->pointCapacity)
+	{
+		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+	}
+
+	pPath->pVerbs[pPath->verbCount++] = (unsigned char)verb;
+
+	for (ksr2_u32 pointIndex = 0u; pointIndex < pointCount * 2u; ++pointIndex)
+	{
+		pPath->pPoints[pPath->pointCount * 2u + pointIndex] = pPoints[pointIndex];
+	}
+
+	pPath->pointCount += pointCount;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_path_move_to(ksr2_path* pPath, float x, float y)
+{
+	const float points[2] = {x, y};
+	return ksr2_append_path_verb(pPath, K15_RENDERER_2D_PATH_VERB_MOVE_TO, points, 1u);
+}
+
+ksr2_result ksr2_path_line_to(ksr2_path* pPath, float x, float y)
+{
+	const float points[2] = {x, y};
+	return ksr2_append_path_verb(pPath, K15_RENDERER_2D_PATH_VERB_LINE_TO, points, 1u);
+}
+
+ksr2_result ksr2_path_quad_to(ksr2_path* pPath, float controlX, float controlY, float x, float y)
+{
+	const float points[4] = {controlX, controlY, x, y};
+	return ksr2_append_path_verb(pPath, K15_RENDERER_2D_PATH_VERB_QUAD_TO, points, 2u);
+}
+
+ksr2_result ksr2_path_cubic_to(ksr2_path* pPath, float control1X, float control1Y, float control2X, float control2Y, float x, float y)
+{
+	const float points[6] = {control1X, control1Y, control2X, control2Y, x, y};
+	return ksr2_append_path_verb(pPath, K15_RENDERER_2D_PATH_VERB_CUBIC_TO, points, 3u);
+}
+
+ksr2_result ksr2_path_close(ksr2_path* pPath)
+{
+	return ksr2_append_path_verb(pPath, K15_RENDERER_2D_PATH_VERB_CLOSE, ksr2_nullptr, 0u);
+}
+
+//FK: Points every verb needs, 0xFF for verbs that don't exist
+ksr2_internal ksr2_u32 ksr2_get_path_verb_point_count(ksr2_u8 verb)
+{
+	switch (verb)
+	{
+		case K15_RENDERER_2D_PATH_VERB_MOVE_TO:
+		case K15_RENDERER_2D_PATH_VERB_LINE_TO:
+			return 1u;
+
+		case K15_RENDERER_2D_PATH_VERB_QUAD_TO:
+			return 2u;
+
+		case K15_RENDERER_2D_PATH_VERB_CUBIC_TO:
+			return 3u;
+
+		case K15_RENDERER_2D_PATH_VERB_CLOSE:
+			return 0u;
+
+		default:
+		break;
+	}
+
+	return 0xFFu;
+}
+
+//FK: The arrays of a path belong to the application, make sure the verbs don't read past the points
+ksr2_internal ksr2_b32 ksr2_is_valid_path(const ksr2_path* pPath)
+{
+	if (pPath == ksr2_nullptr || (pPath->verbCount > 0u && pPath->pVerbs == ksr2_nullptr) || (pPath->pointCount > 0u && pPath->pPoints == ksr2_nullptr))
+	{
+		return ksr2_false;
+	}
+
+	size_t pointCount = 0u;
+	for (ksr2_u32 verbIndex = 0u; verbIndex < pPath->verbCount; ++verbIndex)
+	{
+		pointCount += ksr2_get_path_verb_point_count(pPath->pVerbs[verbIndex]);
+	}
+
+	return pointCount <= pPath->pointCount;
+}
+
+//FK: Edges of a path that pass through the rows of a band and the bounds of their parts within the band. pEdges is null 
+//	  while the edges only get counted.
+typedef struct
+{
+	ksr2_path_edge* 	pEdges;
+	ksr2_u32 			edgeCount;
+	ksr2_s32 			minX;
+	ksr2_s32 			minY;
+	ksr2_s32 			maxX;
+	ksr2_s32 			maxY;
+} ksr2_path_band;
+
+//FK: Collects the edges of a path that pass through the rows from y1 to y2 (in subpixels). The rows get split into bands 
+//	  at multiples of K15_RENDERER_2D_PATH_BAND_HEIGHT so that a single walk over the path fills several draw commands.
+typedef struct
+{
+	ksr2_path_band 		bands[K15_RENDERER_2D_PATH_BAND_GROUP_SIZE];
+	ksr2_u32 			bandCount;
+	ksr2_s32 			firstBandIndex;
+	ksr2_s32 			y1;
+	ksr2_s32 			y2;
+} ksr2_path_edge_builder;
+
+ksr2_internal void ksr2_reset_path_edge_builder(ksr2_path_edge_builder* pBuilder)
+{
+	for (ksr2_u32 bandIndex = 0u; bandIndex < pBuilder->bandCount; ++bandIndex)
+	{
+		ksr2_path_band* pBand = pBuilder->bands + bandIndex;
+		pBand->edgeCount 	= 0u;
+		pBand->minX 		= 0x7FFFFFFF;
+		pBand->minY 		= 0x7FFFFFFF;
+		pBand->maxX 		= -0x7FFFFFFF;
+		pBand->maxY 		= -0x7FFFFFFF;
+	}
+}
+
+ksr2_internal void ksr2_init_path_edge_builder(ksr2_path_edge_builder* pOutBuilder, ksr2_s32 y1, ksr2_s32 y2)
+{
+	const ksr2_s32 lastBandIndex = ((y2 - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS) / K15_RENDERER_2D_PATH_BAND_HEIGHT;
+
+	pOutBuilder->firstBandIndex = (y1 >> K15_RENDERER_2D_SUBPIXEL_BITS) / K15_RENDERER_2D_PATH_BAND_HEIGHT;
+	pOutBuilder->y1 			= y1;
+	pOutBuilder->y2 			= y2;
+
+	//FK: rows above the image only occur while the bounds of the whole path get collected
+	pOutBuilder->bandCount = y1 < 0 ? 1u : (ksr2_u32)(lastBandIndex - pOutBuilder->firstBandIndex + 1);
+	ksr2_assert(pOutBuilder->bandCount <= K15_RENDERER_2D_PATH_BAND_GROUP_SIZE);
+
+	for (ksr2_u32 bandIndex = 0u; bandIndex < pOutBuilder->bandCount; ++bandIndex)
+	{
+		pOutBuilder->bands[bandIndex].pEdges = ksr2_nullptr;
+	}
+
+	ksr2_reset_path_edge_builder(pOutBuilder);
+}
+
+ksr2_internal void ksr2_add_path_band_edge(ksr2_path_band* pBand, const ksr2_path_edge* pEdge, double slope, ksr2_s32 topY, ksr2_s32 bottomY)
+{
+	const double topX 		= (double)pEdge->x1 + (double)(topY - pEdge->y1) * slope;
+	const double bottomX 	= (double)pEdge->x1 + (double)(bottomY - pEdge->y1) * slope;
+
+	//FK: a subpixel of slack so that rounding can't move the edge out of the pixels of the draw command
+	pBand->minX = ksr2_min(pBand->minX, ksr2_floor_to_s32(ksr2_min(topX, bottomX)) - 1);
+	pBand->maxX = ksr2_max(pBand->maxX, -ksr2_floor_to_s32(-ksr2_max(topX, bottomX)) + 1);
+	pBand->minY = ksr2_min(pBand->minY, topY);
+	pBand->maxY = ksr2_max(pBand->maxY, bottomY);
+
+	if (pBand->pEdges != ksr2_nullptr)
+	{
+		pBand->pEdges[pBand->edgeCount] = *pEdge;
+	}
+
+	++pBand->edgeCount;
+}
+
+ksr2_internal void ksr2_add_path_edge(ksr2_path_edge_builder* pBuilder, float x1, float y1, float x2, float y2)
+{
+	ksr2_path_edge edge;
+	edge.x1 = ksr2_float_to_subpixels(x1);
+	edge.y1 = ksr2_float_to_subpixels(y1);
+	edge.x2 = ksr2_float_to_subpixels(x2);
+	edge.y2 = ksr2_float_to_subpixels(y2);
+
+	//FK: horizontal edges don't change the winding of any row
+	if (edge.y1 == edge.y2)
+	{
+		return;
+	}
+
+	const ksr2_s32 topY 	= ksr2_max(ksr2_min(edge.y1, edge.y2), pBuilder->y1);
+	const ksr2_s32 bottomY 	= ksr2_min(ksr2_max(edge.y1, edge.y2), pBuilder->y2);
+
+	if (topY >= bottomY)
+	{
+		return;
+	}
+
+	const double slope = (double)(edge.x2 - edge.x1) / (double)(edge.y2 - edge.y1);
+
+	if (pBuilder->bandCount == 1u)
+	{
+		ksr2_add_path_band_edge(pBuilder->bands, &edge, slope, topY, bottomY);
+		return;
+	}
+
+	const ksr2_s32 bandHeight 		= K15_RENDERER_2D_PATH_BAND_HEIGHT << K15_RENDERER_2D_SUBPIXEL_BITS;
+	const ksr2_s32 firstBandIndex 	= (topY >> K15_RENDERER_2D_SUBPIXEL_BITS) / K15_RENDERER_2D_PATH_BAND_HEIGHT;
+	const ksr2_s32 lastBandIndex 	= ((bottomY - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS) / K15_RENDERER_2D_PATH_BAND_HEIGHT;
+
+	for (ksr2_s32 bandIndex = firstBandIndex; bandIndex <= lastBandIndex; ++bandIndex)
+	{
+		const ksr2_s32 bandTopY 	= ksr2_max(topY, bandIndex * bandHeight);
+		const ksr2_s32 bandBottomY 	= ksr2_min(bottomY, (bandIndex + 1) * bandHeight);
+		ksr2_add_path_band_edge(pBuilder->bands + (bandIndex - pBuilder->firstBandIndex), &edge, slope, bandTopY, bandBottomY);
+	}
+}
+
+//FK: Polygons get added counterclockwise, pieces of a stroke that share a side then cancel each other out along it exactly.
+ksr2_internal void ksr2_add_path_polygon(ksr2_path_edge_builder* pBuilder, const float* pPoints, ksr2_u32 pointCount)
+{
+	float doubleArea = 0.0f;
+	for (ksr2_u32 pointIndex = 2u; pointIndex < pointCount; ++pointIndex)
+	{
+		const float* pPrevious 	= pPoints + (pointIndex - 1u) * 2u;
+		const float* pPoint 	= pPoints + pointIndex * 2u;
+		doubleArea += (pPrevious[0] - pPoints[0]) * (pPoint[1] - pPoints[1]) - (pPoint[0] - pPoints[0]) * (pPrevious[1] - pPoints[1]);
+	}
+
+	if (doubleArea == 0.0f)
+	{
+		return;
+	}
+
+	for (ksr2_u32 pointIndex = 0u; pointIndex < pointCount; ++pointIndex)
+	{
+		const float* pPoint 	= pPoints + pointIndex * 2u;
+		const float* pNextPoint = pPoints + ((pointIndex + 1u) % pointCount) * 2u;
+
+		if (doubleArea > 0.0f)
+		{
+			ksr2_add_path_edge(pBuilder, pPoint[0], pPoint[1], pNextPoint[0], pNextPoint[1]);
+		}
+		else
+		{
+			ksr2_add_path_edge(pBuilder, pNextPoint[0], pNextPoint[1], pPoint[0], pPoint[1]);
+		}
+	}
+}
+
+enum
+{
+	K15_RENDERER_2D_MAX_PATH_ARC_SEGMENT_COUNT 		= 128,
+	K15_RENDERER_2D_MAX_PATH_CURVE_SEGMENT_COUNT 	= 1024
+};
+
+//FK: Turns the verbs of a path into edges. Fills get their subpaths closed, strokes get turned into one polygon per line 
+//	  segment, join and cap that all get filled with the nonzero fill rule. halfWidth is 0 for fills.
+typedef struct
+{
+	ksr2_path_edge_builder* pBuilder;
+	float 					halfWidth;
+	float 					miterLimit;
+	ksr2_line_join 			join;
+	ksr2_line_cap 			cap;
+	float 					startX; //FK: of the subpath
+	float 					startY;
+	float 					currentX;
+	float 					currentY;
+	float 					firstDirectionX; //FK: of the first segment of the subpath
+	float 					firstDirectionY;
+	float 					lastDirectionX;
+	float 					lastDirectionY;
+	ksr2_b32 				hasSegment; //FK: any segment of the subpath that has a length
+	ksr2_b32 				hasVerbs; //FK: any verb besides the move to that started the subpath
+} ksr2_path_walker;
+
+//FK: Number of lines that a circular arc of the stroke gets flattened into
+ksr2_internal ksr2_u32 ksr2_get_path_arc_segment_count(float halfWidth, float angle)
+{
+	const float tolerance = K15_RENDERER_2D_PATH_TOLERANCE;
+	const float segmentAngle = tolerance < halfWidth ? 2.0f * acosf(1.0f - tolerance / halfWidth) : 3.14159265f;
+	const float segmentCount = ceilf(fabsf(angle) / segmentAngle);
+
+	return (ksr2_u32)ksr2_clamp(segmentCount, 1.0f, (float)K15_RENDERER_2D_MAX_PATH_ARC_SEGMENT_COUNT);
+}
+
+//FK: Pie that starts at (x, y) + offset and sweeps angle radians around (x, y), its last point is (x, y) + endOffset.
+ksr2_internal void ksr2_add_path_arc(ksr2_path_walker* pWalker, float x, float y, float offsetX, float offsetY, float endOffsetX, float endOffsetY, float angle)
+{
+	float points[(K15_RENDERER_2D_MAX_PATH_ARC_SEGMENT_COUNT + 2) * 2];
+	const ksr2_u32 segmentCount = ksr2_get_path_arc_segment_count(pWalker->halfWidth, angle);
+
+	points[0] = x;
+	points[1] = y;
+	points[2] = x + offsetX;
+	points[3] = y + offsetY;
+
+	for (ksr2_u32 segmentIndex = 1u; segmentIndex < segmentCount; ++segmentIndex)
+	{
+		const float segmentAngle = angle * (float)segmentIndex / (float)segmentCount;
+		const float cosine 	= cosf(segmentAngle);
+		const float sine 	= sinf(segmentAngle);
+
+		points[(segmentIndex + 1u) * 2u + 0u] = x + offsetX * cosine - offsetY * sine;
+		points[(segmentIndex + 1u) * 2u + 1u] = y + offsetX * sine + offsetY * cosine;
+	}
+
+	points[(segmentCount + 1u) * 2u + 0u] = x + endOffsetX;
+	points[(segmentCount + 1u) * 2u + 1u] = y + endOffsetY;
+
+	ksr2_add_path_polygon(pWalker->pBuilder, points, segmentCount + 2u);
+}
+
+//FK: Normal of a direction scaled to half the stroke width, (x, y) + normal is on the left of the segment in image space
+ksr2_internal void ksr2_get_path_normal(float* pOutNormalX, float* pOutNormalY, const ksr2_path_walker* pWalker, float directionX, float directionY)
+{
+	*pOutNormalX = -directionY * pWalker->halfWidth;
+	*pOutNormalY = directionX * pWalker->halfWidth;
+}
+
+//FK: Cap at (x, y) of a subpath that ends in direction
+ksr2_internal void ksr2_add_path_cap(ksr2_path_walker* pWalker, float x, float y, float directionX, float directionY, float normalX, float normalY)
+{
+	if (pWalker->cap == K15_RENDERER_2D_LINE_CAP_SQUARE)
+	{
+		const float extensionX = directionX * pWalker->halfWidth;
+		const float extensionY = directionY * pWalker->halfWidth;
+		const float points[10] = {
+			x, y, 
+			x + normalX, y + normalY, 
+			x + normalX + extensionX, y + normalY + extensionY, 
+			x - normalX + extensionX, y - normalY + extensionY, 
+			x - normalX, y - normalY
+		};
+
+		ksr2_add_path_polygon(pWalker->pBuilder, points, 5u);
+	}
+	else if (pWalker->cap == K15_RENDERER_2D_LINE_CAP_ROUND)
+	{
+		//FK: sweeps from the normal through the direction to the other side
+		const float crossProduct = normalX * directionY - normalY * directionX;
+		ksr2_add_path_arc(pWalker, x, y, normalX, normalY, -normalX, -normalY, crossProduct > 0.0f ? 3.14159265f : -3.14159265f);
+	}
+}
+
+//FK: Join at the current point from the last segment to the one going in direction
+ksr2_internal void ksr2_add_path_join(ksr2_path_walker* pWalker, float directionX, float directionY, ksr2_line_join join)
+{
+	const float x = pWalker->currentX;
+	const float y = pWalker->currentY;
+	const float crossProduct 	= pWalker->lastDirectionX * directionY - pWalker->lastDirectionY * directionX;
+	const float dotProduct 		= pWalker->lastDirectionX * directionX + pWalker->lastDirectionY * directionY;
+
+	if (crossProduct == 0.0f && dotProduct > 0.0f)
+	{
+		return;
+	}
+
+	//FK: the outer side of the join is the one the path turns away from
+	float lastNormalX, lastNormalY, normalX, normalY;
+	ksr2_get_path_normal(&lastNormalX, &lastNormalY, pWalker, pWalker->lastDirectionX, pWalker->lastDirectionY);
+	ksr2_get_path_normal(&normalX, &normalY, pWalker, directionX, directionY);
+
+	if (crossProduct > 0.0f)
+	{
+		lastNormalX = -lastNormalX;
+		lastNormalY = -lastNormalY;
+		normalX 	= -normalX;
+		normalY 	= -normalY;
+	}
+
+	if (join == K15_RENDERER_2D_LINE_JOIN_ROUND)
+	{
+		ksr2_add_path_arc(pWalker, x, y, lastNormalX, lastNormalY, normalX, normalY, atan2f(crossProduct, dotProduct));
+		return;
+	}
+
+	//FK: the miter length relative to the stroke width is 1 / sin(angle between the segments / 2)
+	if (join == K15_RENDERER_2D_LINE_JOIN_MITER && dotProduct > -1.0f && pWalker->miterLimit * sqrtf((1.0f + dotProduct) * 0.5f) >= 1.0f)
+	{
+		const float scale = 1.0f / (1.0f + dotProduct);
+		const float points[8] = {
+			x, y, 
+			x + lastNormalX, y + lastNormalY, 
+			x + (lastNormalX + normalX) * scale, y + (lastNormalY + normalY) * scale, 
+			x + normalX, y + normalY
+		};
+
+		ksr2_add_path_polygon(pWalker->pBuilder, points, 4u);
+		return;
+	}
+
+	const float points[6] = {x, y, x + lastNormalX, y + lastNormalY, x + normalX, y + normalY};
+	ksr2_add_path_polygon(pWalker->pBuilder, points, 3u);
+}
+
+//FK: join is the join at the start of the line
+ksr2_internal void ksr2_walk_path_line(ksr2_path_walker* pWalker, float x, float y, ksr2_line_join join)
+{
+	const float x1 = pWalker->currentX;
+	const float y1 = pWalker->currentY;
+	pWalker->hasVerbs = ksr2_true;
+
+	if (pWalker->halfWidth == 0.0f)
+	{
+		ksr2_add_path_edge(pWalker->pBuilder, x1, y1, x, y);
+		pWalker->currentX = x;
+		pWalker->currentY = y;
+		return;
+	}
+
+	const float length = sqrtf((x - x1) * (x - x1) + (y - y1) * (y - y1));
+
+	if (length == 0.0f || length != length)
+	{
+		return;
+	}
+
+	const float directionX = (x - x1) / length;
+	const float directionY = (y - y1) / length;
+
+	if (pWalker->hasSegment)
+	{
+		ksr2_add_path_join(pWalker, directionX, directionY, join);
+	}
+	else
+	{
+		pWalker->firstDirectionX = directionX;
+		pWalker->firstDirectionY = directionY;
+	}
+
+	float normalX, normalY;
+	ksr2_get_path_normal(&normalX, &normalY, pWalker, directionX, directionY);
+
+	//FK: the centerline points are part of the polygon so that joins and caps share its sides exactly
+	const float points[12] = {
+		x1, y1, 
+		x1 + normalX, y1 + normalY, 
+		x + normalX, y + normalY, 
+		x, y, 
+		x - normalX, y - normalY, 
+		x1 - normalX, y1 - normalY
+	};
+
+	ksr2_add_path_polygon(pWalker->pBuilder, points, 6u);
+
+	pWalker->lastDirectionX = directionX;
+	pWalker->lastDirectionY = directionY;
+	pWalker->currentX 		= x;
+	pWalker->currentY 		= y;
+	pWalker->hasSegment 	= ksr2_true;
+}
+
+//FK: Bezier curve of degree 2 or 3 from the current point, the curve gets flattened into lines with Wang's formula. 
+//	  Their count keeps the lines within K15_RENDERER_2D_PATH_TOLERANCE of the curve.
+ksr2_internal void ksr2_walk_path_curve(ksr2_path_walker* pWalker, const float* pPoints, ksr2_u32 degree)
+{
+	const float x0 = pWalker->currentX;
+	const float y0 = pWalker->currentY;
+	const float* pControl1 	= pPoints;
+	const float* pControl2 	= pPoints + 2u;
+	const float* pEnd 		= pPoints + (degree - 1u) * 2u;
+
+	//FK: longest second difference of the control points
+	float maxLength = 0.0f;
+	const float controlPoints[8] = {x0, y0, pControl1[0], pControl1[1], pControl2[0], pControl2[1], pEnd[0], pEnd[1]};
+	for (ksr2_u32 pointIndex = 0u; pointIndex + 2u <= degree; ++pointIndex)
+	{
+		const float* pPoint = controlPoints + pointIndex * 2u;
+		const float deltaX = pPoint[0] - 2.0f * pPoint[2] + pPoint[4];
+		const float deltaY = pPoint[1] - 2.0f * pPoint[3] + pPoint[5];
+		maxLength = ksr2_max(maxLength, sqrtf(deltaX * deltaX + deltaY * deltaY));
+	}
+
+	const float degreeFactor = (float)(degree * (degree - 1u)) / 8.0f;
+	const float segmentCount = ceilf(sqrtf(degreeFactor * maxLength / K15_RENDERER_2D_PATH_TOLERANCE));
+	const ksr2_u32 lineCount = segmentCount >= 1.0f ? (ksr2_u32)ksr2_min(segmentCount, (float)K15_RENDERER_2D_MAX_PATH_CURVE_SEGMENT_COUNT) : 1u;
+
+	for (ksr2_u32 lineIndex = 1u; lineIndex < lineCount; ++lineIndex)
+	{
+		const float t = (float)lineIndex / (float)lineCount;
+		const float u = 1.0f - t;
+		float x, y;
+
+		if (degree == 2u)
+		{
+			x = u * u * x0 + 2.0f * u * t * pControl1[0] + t * t * pEnd[0];
+			y = u * u * y0 + 2.0f * u * t * pControl1[1] + t * t * pEnd[1];
+		}
+		else
+		{
+			x = u * u * u * x0 + 3.0f * u * u * t * pControl1[0] + 3.0f * u * t * t * pControl2[0] + t * t * t * pEnd[0];
+			y = u * u * u * y0 + 3.0f * u * u * t * pControl1[1] + 3.0f * u * t * t * pControl2[1] + t * t * t * pEnd[1];
+		}
+
+		//FK: within the curve the lines get mitered, the angles between them are tiny
+		ksr2_walk_path_line(pWalker, x, y, lineIndex == 1u ? pWalker->join : K15_RENDERER_2D_LINE_JOIN_MITER);
+	}
+
+	ksr2_walk_path_line(pWalker, pEnd[0], pEnd[1], lineCount == 1u ? pWalker->join : K15_RENDERER_2D_LINE_JOIN_MITER);
+}
+
+//FK: isClosed is set for subpaths that ended with a close verb
+ksr2_internal void ksr2_end_path_subpath(ksr2_path_walker* pWalker, ksr2_b32 isClosed)
+{
+	if (pWalker->halfWidth == 0.0f)
+	{
+		ksr2_add_path_edge(pWalker->pBuilder, pWalker->currentX, pWalker->currentY, pWalker->startX, pWalker->startY);
+	}
+	else if (pWalker->hasSegment && isClosed)
+	{
+		ksr2_walk_path_line(pWalker, pWalker->startX, pWalker->startY, pWalker->join);
+		ksr2_add_path_join(pWalker, pWalker->firstDirectionX, pWalker->firstDirectionY, pWalker->join);
+	}
+	else if (pWalker->hasSegment)
+	{
+		float normalX, normalY;
+		ksr2_get_path_normal(&normalX, &normalY, pWalker, pWalker->firstDirectionX, pWalker->firstDirectionY);
+		ksr2_add_path_cap(pWalker, pWalker->startX, pWalker->startY, -pWalker->firstDirectionX, -pWalker->firstDirectionY, normalX, normalY);
+
+		ksr2_get_path_normal(&normalX, &normalY, pWalker, pWalker->lastDirectionX, pWalker->lastDirectionY);
+		ksr2_add_path_cap(pWalker, pWalker->currentX, pWalker->currentY, pWalker->lastDirectionX, pWalker->lastDirectionY, normalX, normalY);
+	}
+	else if (pWalker->hasVerbs)
+	{
+		//FK: subpaths without length get both caps facing along the x axis
+		ksr2_add_path_cap(pWalker, pWalker->startX, pWalker->startY, -1.0f, 0.0f, 0.0f, pWalker->halfWidth);
+		ksr2_add_path_cap(pWalker, pWalker->startX, pWalker->startY, 1.0f, 0.0f, 0.0f, pWalker->halfWidth);
+	}
+
+	pWalker->currentX 	= pWalker->startX;
+	pWalker->currentY 	= pWalker->startY;
+	pWalker->hasSegment = ksr2_false;
+	pWalker->hasVerbs 	= ksr2_false;
+}
+
+ksr2_internal void ksr2_walk_path(ksr2_path_walker* pWalker, const ksr2_path* pPath)
+{
+	const float* pPoints = pPath->pPoints;
+
+	pWalker->startX 	= 0.0f;
+	pWalker->startY 	= 0.0f;
+	pWalker->currentX 	= 0.0f;
+	pWalker->currentY 	= 0.0f;
+	pWalker->hasSegment = ksr2_false;
+	pWalker->hasVerbs 	= ksr2_false;
+
+	for (ksr2_u32 verbIndex = 0u; verbIndex < pPath->verbCount; ++verbIndex)
+	{
+		switch (pPath->pVerbs[verbIndex])
+		{
+			case K15_RENDERER_2D_PATH_VERB_MOVE_TO:
+				ksr2_end_path_subpath(pWalker, ksr2_false);
+				pWalker->startX 	= pPoints[0];
+				pWalker->startY 	= pPoints[1];
+				pWalker->currentX 	= pPoints[0];
+				pWalker->currentY 	= pPoints[1];
+				pPoints += 2u;
+			break;
+
+			case K15_RENDERER_2D_PATH_VERB_LINE_TO:
+				ksr2_walk_path_line(pWalker, pPoints[0], pPoints[1], pWalker->join);
+				pPoints += 2u;
+			break;
+
+			case K15_RENDERER_2D_PATH_VERB_QUAD_TO:
+				ksr2_walk_path_curve(pWalker, pPoints, 2u);
+				pPoints += 4u;
+			break;
+
+			case K15_RENDERER_2D_PATH_VERB_CUBIC_TO:
+				ksr2_walk_path_curve(pWalker, pPoints, 3u);
+				pPoints += 6u;
+			break;
+
+			case K15_RENDERER_2D_PATH_VERB_CLOSE:
+				pWalker->hasVerbs = ksr2_true;
+				ksr2_end_path_subpath(pWalker, ksr2_true);
+			break;
+		}
+	}
+
+	ksr2_end_path_subpath(pWalker, ksr2_false);
+}
+
+//FK: pStrokeParameters is null for fills. The path gets recorded as bands of K15_RENDERER_2D_PATH_BAND_HEIGHT rows that
+//	  start at multiples of the band height, bands with more edges than fit into a draw command get halved until they fit.
+//	  Every group of K15_RENDERER_2D_PATH_BAND_GROUP_SIZE bands takes one walk over the path to count and one to write.
+ksr2_internal ksr2_result ksr2_draw_path(ksr2_contexthandle handle, const ksr2_path* pPath, ksr2_fill_rule fillRule, const ksr2_stroke_parameters* pStrokeParameters, ksr2_rgba_color color)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || ksr2_is_valid_path(pPath) == ksr2_false || (ksr2_u32)fillRule >= K15_RENDERER_2D_FILL_RULE_COUNT)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_path_edge_builder builder;
+	ksr2_path_walker walker = {0};
+	walker.pBuilder = &builder;
+
+	if (pStrokeParameters != ksr2_nullptr)
+	{
+		if ((ksr2_u32)pStrokeParameters->join > K15_RENDERER_2D_LINE_JOIN_BEVEL || (ksr2_u32)pStrokeParameters->cap > K15_RENDERER_2D_LINE_CAP_SQUARE)
+		{
+			return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		}
+
+		if (!(pStrokeParameters->width > 0.0f))
+		{
+			return K15_RENDERER_2D_RESULT_SUCCESS;
+		}
+
+		walker.halfWidth 	= pStrokeParameters->width * 0.5f;
+		walker.miterLimit 	= pStrokeParameters->miterLimit > 0.0f ? pStrokeParameters->miterLimit : 4.0f;
+		walker.join 		= pStrokeParameters->join;
+		walker.cap 			= pStrokeParameters->cap;
+	}
+
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	ksr2_pixel_color pixelColor = 0u;
+	if (ksr2_resolve_blend_color(&pixelColor, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_swap_chain* pSwapChain = &pCommandList->pContext->swapChain;
+
+	//FK: rows of the whole path
+	ksr2_init_path_edge_builder(&builder, -0x7FFFFFFF, 0x7FFFFFFF);
+	ksr2_walk_path(&walker, pPath);
+
+	const ksr2_path_band* pPathBounds = builder.bands;
+	if (pPathBounds->edgeCount == 0u || pPathBounds->maxX <= 0 || (pPathBounds->minX >> K15_RENDERER_2D_SUBPIXEL_BITS) >= (ksr2_s32)pSwapChain->width)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_s32 endRow = ksr2_min((pPathBounds->maxY + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS, (ksr2_s32)pSwapChain->height);
+	ksr2_s32 row = ksr2_max(pPathBounds->minY >> K15_RENDERER_2D_SUBPIXEL_BITS, 0);
+
+	while (row < endRow)
+	{
+		const ksr2_s32 firstBandIndex = row / K15_RENDERER_2D_PATH_BAND_HEIGHT;
+		ksr2_s32 groupEndRow = ksr2_min((firstBandIndex + K15_RENDERER_2D_PATH_BAND_GROUP_SIZE) * K15_RENDERER_2D_PATH_BAND_HEIGHT, endRow);
+
+		ksr2_init_path_edge_builder(&builder, row << K15_RENDERER_2D_SUBPIXEL_BITS, groupEndRow << K15_RENDERER_2D_SUBPIXEL_BITS);
+		ksr2_walk_path(&walker, pPath);
+
+		if (builder.bands[0].edgeCount > K15_RENDERER_2D_MAX_PATH_EDGE_COUNT)
+		{
+			groupEndRow = ksr2_min((firstBandIndex + 1) * K15_RENDERER_2D_PATH_BAND_HEIGHT, endRow);
+
+			do
+			{
+				if (groupEndRow - row == 1)
+				{
+					return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+				}
+
+				groupEndRow = row + (groupEndRow - row) / 2;
+				ksr2_init_path_edge_builder(&builder, row << K15_RENDERER_2D_SUBPIXEL_BITS, groupEndRow << K15_RENDERER_2D_SUBPIXEL_BITS);
+				ksr2_walk_path(&walker, pPath);
+			} while (builder.bands[0].edgeCount > K15_RENDERER_2D_MAX_PATH_EDGE_COUNT);
+		}
+
+		//FK: the bands that fit into the memory left in the current chunk get written by a single walk, the others get
+		//	  collected again by the next group
+		ksr2_byte* pMemory = ksr2_nullptr;
+		ksr2_u32 capacityInBytes = 0u;
+		ksr2_u32 sizeInBytes = 0u;
+		ksr2_u32 drawCommandCount = 0u;
+		ksr2_u32 bandIndex = 0u;
+
+		for (; bandIndex < builder.bandCount; ++bandIndex)
+		{
+			ksr2_path_band* pBand = builder.bands + bandIndex;
+
+			if (pBand->edgeCount > K15_RENDERER_2D_MAX_PATH_EDGE_COUNT)
+			{
+				break;
+			}
+
+			const ksr2_s32 x1 = pBand->minX >> K15_RENDERER_2D_SUBPIXEL_BITS;
+			const ksr2_s32 x2 = (pBand->maxX + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS;
+
+			if (pBand->edgeCount == 0u || x2 <= 0 || x1 >= (ksr2_s32)pSwapChain->width)
+			{
+				continue;
+			}
+
+			const ksr2_u32 bandSizeInBytes = (ksr2_u32)(sizeof(ksr2_path_draw_command) + pBand->edgeCount * sizeof(ksr2_path_edge));
+
+			if (pMemory == ksr2_nullptr)
+			{
+				ksr2_result result = ksr2_reserve_draw_command_memory(&pMemory, &capacityInBytes, pCommandList, bandSizeInBytes);
+
+				if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+				{
+					return result;
+				}
+			}
+
+			if (sizeInBytes + bandSizeInBytes > capacityInBytes)
+			{
+				break;
+			}
+
+			pBand->pEdges = (ksr2_path_edge*)(pMemory + sizeInBytes + sizeof(ksr2_path_draw_command));
+			sizeInBytes += bandSizeInBytes;
+			++drawCommandCount;
+		}
+
+		if (drawCommandCount > 0u)
+		{
+			ksr2_reset_path_edge_builder(&builder);
+			ksr2_walk_path(&walker, pPath);
+
+			for (ksr2_u32 commandBandIndex = 0u; commandBandIndex < bandIndex; ++commandBandIndex)
+			{
+				const ksr2_path_band* pBand = builder.bands + commandBandIndex;
+
+				if (pBand->pEdges == ksr2_nullptr)
+				{
+					continue;
+				}
+
+				const size_t commandSizeInBytes = sizeof(ksr2_path_draw_command) + pBand->edgeCount * sizeof(ksr2_path_edge);
+				ksr2_path_draw_command* pDrawCommand = (ksr2_path_draw_command*)pBand->pEdges - 1;
+
+				ksr2_init_draw_command_header(&pDrawCommand->header, commandSizeInBytes, K15_RENDERER_2D_DRAW_COMMAND_PATH, blendMode);
+				pDrawCommand->x1 			= (ksr2_u32)ksr2_max(pBand->minX >> K15_RENDERER_2D_SUBPIXEL_BITS, 0);
+				pDrawCommand->y1 			= (ksr2_u32)(pBand->minY >> K15_RENDERER_2D_SUBPIXEL_BITS);
+				pDrawCommand->x2 			= (ksr2_u32)((pBand->maxX + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS);
+				pDrawCommand->y2 			= (ksr2_u32)((pBand->maxY + K15_RENDERER_2D_SUBPIXEL_ONE - 1) >> K15_RENDERER_2D_SUBPIXEL_BITS);
+				pDrawCommand->color 		= pixelColor;
+				pDrawCommand->edgeCount 	= (ksr2_u16)pBand->edgeCount;
+				pDrawCommand->fillRule 		= (ksr2_u8)fillRule;
+				pDrawCommand->padding 		= 0u;
+			}
+
+			ksr2_commit_draw_command_memory(pCommandList, sizeInBytes, drawCommandCount);
+		}
+
+		row = bandIndex == builder.bandCount ? groupEndRow : (firstBandIndex + (ksr2_s32)bandIndex) * K15_RENDERER_2D_PATH_BAND_HEIGHT;
+	}
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_fill_path(ksr2_contexthandle handle, const ksr2_path* pPath, ksr2_fill_rule fillRule, ksr2_rgba_color color)
+{
+	return ksr2_draw_path(handle, pPath, fillRule, ksr2_nullptr, color);
+}
+
+ksr2_result ksr2_stroke_path(ksr2_contexthandle handle, const ksr2_path* pPath, const ksr2_stroke_parameters* pParameters, ksr2_rgba_color color)
+{
+	if (pParameters == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	return ksr2_draw_path(handle, pPath, K15_RENDERER_2D_FILL_RULE_NONZERO, pParameters, color);
+}
+
+ksr2_result ksr2_clear(ksr2_contexthandle handle, ksr2_rgba_color color)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+	if (pContext->recordStartTimeInNs == 0u)
+	{
+		pContext->recordStartTimeInNs = ksr2_get_timestamp_in_ns(pContext);
+	}
+#endif
+
+	const ksr2_pixel_color clearColor = ksr2_convert_color(&pContext->kernels, color);
+
+#ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		//FK: the render thread might be busy with the previous frame, the clear gets handed over by ksr2_blit
+		ksr2_command_list* pRecordCommandList = pContext->pRecordCommandList;
+		ksr2_reset_allocator_back(&pRecordCommandList->allocator);
+		ksr2_reset_draw_command_stream(&pRecordCommandList->drawCommandStream);
+		pRecordCommandList->hasTextDrawCommands = ksr2_false;
+
+		pContext->renderThread.clearImage = ksr2_true;
+		pContext->renderThread.clearColor = clearColor;
+
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+#endif
+
+	//FK: everything that got recorded before would get overwritten anyway
+	ksr2_release_draw_command_stream(pContext);
+	ksr2_reset_allocator_back(&pContext->allocator);
+
+	pContext->clearImage = ksr2_true;
+	pContext->clearColor = clearColor;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_set_blend_mode(ksr2_contexthandle handle, ksr2_blend_mode blendMode)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || (ksr2_u32)blendMode > (ksr2_u32)K15_RENDERER_2D_BLEND_MODE_MULTIPLY)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	pCommandList->blendMode = blendMode;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_create_texture(ksr2_contexthandle handle, const ksr2_texture_parameters* pParameters, ksr2_texturehandle* pOutTextureHandle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pParameters == ksr2_nullptr || pParameters->pPixels == ksr2_nullptr || pOutTextureHandle == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	//FK: the render thread allocates the tile bins from the same allocator
+	ksr2_wait_for_render_thread(pContext);
+
+	const ksr2_u32 width 	= pParameters->width;
+	const ksr2_u32 height 	= pParameters->height;
+	const ksr2_u32 stride 	= pParameters->stride > 0u ? pParameters->stride : width;
+
+	if (width == 0u || height == 0u || width > 0xFFFFu || height > 0xFFFFu || stride < width)
+	{
+		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "invalid texture dimensions passed to ksr2_create_texture.");
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_image_memory_requirements memoryRequirements = {0};
+	ksr2_result result = ksr2_query_image_memory_requirements(&memoryRequirements, width, height, pParameters->format, ksr2_false);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_texture* pTexture = ksr2_nullptr;
+	result = ksr2_allocate_from_linear_allocator_front((void**)&pTexture, &pContext->allocator, sizeof(ksr2_texture) + (size_t)width * height * sizeof(ksr2_pixel_color), ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_init_fourcc(pTexture->fourcc, "KR2T");
+	pTexture->width 				= width;
+	pTexture->height 				= height;
+	pTexture->hasTransparentPixels 	= ksr2_false;
+	pTexture->pPixels 				= (ksr2_pixel_color*)(pTexture + 1);
+
+	//FK: every row gets converted to RGBA, premultiplied and converted to the color format of the swap chain in place
+	const ksr2_pixel_format textureFormat 	= ksr2_get_color_format(pContext->swapChain.format);
+	const ksr2_pixel_color colorKey 		= ksr2_convert_to_pixel_format(pParameters->colorKey, K15_RENDERER_2D_PIXEL_FORMAT_RGBA) & 0xFFFFFF00u;
+	const size_t sourceStrideInBytes 		= (size_t)stride * ksr2_get_pixel_size_in_bytes(pParameters->format);
+	const ksr2_byte* pSourceRow 			= (const ksr2_byte*)pParameters->pPixels;
+	ksr2_pixel_color* pRow 					= pTexture->pPixels;
+
+	for (ksr2_u32 y = 0u; y < height; ++y)
+	{
+		pContext->kernels.convertPixelsToRgba(pRow, pSourceRow, width, pParameters->format);
+		pTexture->hasTransparentPixels |= ksr2_premultiply_span(pRow, width, pParameters->useColorKey, colorKey);
+
+		if (textureFormat != K15_RENDERER_2D_PIXEL_FORMAT_RGBA)
+		{
+			pContext->kernels.convertPixelsFromRgba((ksr2_byte*)pRow, pRow, width, textureFormat);
+		}
+
+		pSourceRow 	+= sourceStrideInBytes;
+		pRow 		+= width;
+	}
+
+	*pOutTextureHandle = (ksr2_texturehandle)pTexture;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_draw_image(ksr2_contexthandle handle, ksr2_texturehandle texture, int srcX, int srcY, int srcWidth, int srcHeight, int dstX, int dstY, unsigned int scale)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_context* pContext = pCommandList->pContext;
+	const ksr2_texture* pTexture = ksr2_texturehandle_to_texture(pContext, texture);
+
+	if (pTexture == ksr2_nullptr || scale == 0u || scale > 0xFFFFu)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	//FK: clip the source rect to the texture, the destination moves along with it
+	if (srcX < 0)
+	{
+		srcWidth 	+= srcX;
+		dstX 		-= srcX * (ksr2_s32)scale;
+		srcX 		= 0;
+	}
+
+	if (srcY < 0)
+	{
+		srcHeight 	+= srcY;
+		dstY 		-= srcY * (ksr2_s32)scale;
+		srcY 		= 0;
+	}
+
+	srcWidth 	= ksr2_min(srcWidth, (ksr2_s32)pTexture->width - srcX);
+	srcHeight 	= ksr2_min(srcHeight, (ksr2_s32)pTexture->height - srcY);
+
+	if (srcWidth <= 0 || srcHeight <= 0)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_s64 dstX2 = (ksr2_s64)dstX + (ksr2_s64)srcWidth * scale;
+	const ksr2_s64 dstY2 = (ksr2_s64)dstY + (ksr2_s64)srcHeight * scale;
+
+	if (dstX >= (ksr2_s32)pContext->swapChain.width || dstY >= (ksr2_s32)pContext->swapChain.height || dstX2 <= 0 || dstY2 <= 0)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	ksr2_blend_mode blendMode = pCommandList->blendMode;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE && pTexture->hasTransparentPixels)
+	{
+		blendMode = K15_RENDERER_2D_BLEND_MODE_ALPHA;
+	}
+	else if (blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA && pTexture->hasTransparentPixels == ksr2_false)
+	{
+		blendMode = K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	}
+
+	ksr2_image_draw_command* pDrawCommand = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_draw_command((void**)&pDrawCommand, pCommandList, sizeof(ksr2_image_draw_command), K15_RENDERER_2D_DRAW_COMMAND_IMAGE, blendMode);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	pDrawCommand->textureOffset = (ksr2_u32)((const ksr2_byte*)pTexture - pContext->allocator.pStartAddress);
+	pDrawCommand->x 			= dstX;
+	pDrawCommand->y 			= dstY;
+	pDrawCommand->sourceX 		= (ksr2_u16)srcX;
+	pDrawCommand->sourceY 		= (ksr2_u16)srcY;
+	pDrawCommand->sourceWidth 	= (ksr2_u16)srcWidth;
+	pDrawCommand->sourceHeight 	= (ksr2_u16)srcHeight;
+	pDrawCommand->scale 		= (ksr2_u16)scale;
+	pDrawCommand->padding 		= 0u;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_create_font(ksr2_contexthandle handle, const ksr2_font_parameters* pParameters, ksr2_fonthandle* pOutFontHandle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pParameters == ksr2_nullptr || pParameters->pPixels == ksr2_nullptr || pOutFontHandle == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_wait_for_render_thread(pContext);
+
+	const ksr2_u32 glyphWidth 		= pParameters->glyphWidth;
+	const ksr2_u32 glyphHeight 		= pParameters->glyphHeight;
+	const ksr2_u32 glyphCount 		= pParameters->glyphCount;
+	const ksr2_u32 glyphsPerRow 	= pParameters->glyphsPerRow > 0u ? pParameters->glyphsPerRow : glyphCount;
+	const ksr2_u32 bitsPerPixel 	= pParameters->bitsPerPixel;
+	const ksr2_u32 slotCount 		= pParameters->glyphCacheSize > 0u ? ksr2_min(pParameters->glyphCacheSize, glyphCount) : glyphCount;
+
+	if (glyphWidth == 0u || glyphHeight == 0u || glyphWidth > 0xFFu || glyphHeight > 0xFFu || glyphCount == 0u || glyphCount > 0xFFFFu ||
+		slotCount > K15_RENDERER_2D_MAX_GLYPH_CACHE_SIZE || (bitsPerPixel != 1u && bitsPerPixel != 8u))
+	{
+		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "invalid font parameters passed to ksr2_create_font.");
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_u32 packedStride = (glyphsPerRow * glyphWidth * bitsPerPixel + 7u) / 8u;
+	const ksr2_u32 stride 		= pParameters->stride > 0u ? pParameters->stride : packedStride;
+
+	if (stride < packedStride)
+	{
+		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "font stride passed to ksr2_create_font is too small.");
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const size_t glyphSizeInBytes = (size_t)glyphWidth * glyphHeight;
+	const size_t fontSizeInBytes = sizeof(ksr2_font) + sizeof(ksr2_glyph_slot) * slotCount + sizeof(ksr2_u16) * glyphCount + glyphSizeInBytes * slotCount;
+
+	ksr2_font* pFont = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front((void**)&pFont, &pContext->allocator, fontSizeInBytes, ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_init_fourcc(pFont->fourcc, "KR2F");
+	pFont->pSourcePixels 			= (const ksr2_u8*)pParameters->pPixels;
+	pFont->sourceStride 			= stride;
+	pFont->sourceBitsPerPixel 		= bitsPerPixel;
+	pFont->glyphsPerRow 			= glyphsPerRow;
+	pFont->glyphWidth 				= glyphWidth;
+	pFont->glyphHeight 				= glyphHeight;
+	pFont->advance 					= pParameters->advance > 0u ? pParameters->advance : glyphWidth;
+	pFont->lineHeight 				= pParameters->lineHeight > 0u ? pParameters->lineHeight : glyphHeight;
+	pFont->firstCharacter 			= pParameters->firstCharacter;
+	pFont->glyphCount 				= glyphCount;
+	pFont->pSlots 					= (ksr2_glyph_slot*)(pFont + 1);
+	pFont->pGlyphSlotIndices 		= (ksr2_u16*)(pFont->pSlots + slotCount);
+	pFont->pAtlas 					= (ksr2_u8*)(pFont->pGlyphSlotIndices + glyphCount);
+	pFont->slotCount 				= slotCount;
+	pFont->usedSlotCount 			= 0u;
+	pFont->nextEvictionSlotIndex 	= 0u;
+
+	pFont->statistics.hitCount 		= 0u;
+	pFont->statistics.missCount 	= 0u;
+	pFont->statistics.evictionCount = 0u;
+
+	for (ksr2_u32 glyphIndex = 0u; glyphIndex < glyphCount; ++glyphIndex)
+	{
+		pFont->pGlyphSlotIndices[glyphIndex] = K15_RENDERER_2D_GLYPH_NOT_CACHED;
+	}
+
+	*pOutFontHandle = (ksr2_fonthandle)pFont;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+void ksr2_get_builtin_font_parameters(ksr2_font_parameters* pOutParameters)
+{
+	ksr2_font_parameters parameters = {0};
+	parameters.pPixels 			= ksr2_builtin_font_pixels;
+	parameters.bitsPerPixel 	= 1u;
+	parameters.stride 			= 1u;
+	parameters.glyphWidth 		= 6u;
+	parameters.glyphHeight 		= 8u;
+	parameters.glyphsPerRow 	= 1u;
+	parameters.firstCharacter 	= 32u;
+	parameters.glyphCount 		= sizeof(ksr2_builtin_font_pixels) / 8u;
+	parameters.lineHeight 		= 10u;
+
+	*pOutParameters = parameters;
+}
+
+//FK: Every line gets split into runs of cached glyphs. Glyphs that are outside of the image or don't have any coverage 
+//	  don't end up in the draw commands. Deferred command lists can't look at the glyph cache, they keep the empty glyphs.
+ksr2_result ksr2_draw_text(ksr2_contexthandle handle, ksr2_fonthandle font, int x, int y, const char* pText, ksr2_rgba_color color)
+{
+	ksr2_command_list* pCommandList = ksr2_handle_to_command_list(handle);
+
+	if (pCommandList == ksr2_nullptr || pText == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_context* pContext = pCommandList->pContext;
+	ksr2_font* pFont = ksr2_fonthandle_to_font(pContext, font);
+
+	if (pFont == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_pixel_color pixelColor = 0u;
+	ksr2_blend_mode blendMode = K15_RENDERER_2D_BLEND_MODE_ALPHA;
+	if (ksr2_resolve_text_color(&pixelColor, &blendMode, pCommandList, color) == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_s64 imageWidth 	= (ksr2_s64)pContext->swapChain.width;
+	const ksr2_s64 imageHeight 	= (ksr2_s64)pContext->swapChain.height;
+
+	ksr2_text_glyph runGlyphs[K15_RENDERER_2D_MAX_TEXT_RUN_GLYPH_COUNT];
+	ksr2_u32 runGlyphCount 	= 0u;
+	ksr2_s64 runX 			= 0;
+	ksr2_s64 penX 			= x;
+	ksr2_s64 lineY 			= y;
+
+	for (const unsigned char* pCharacter = (const unsigned char*)pText; ; ++pCharacter)
+	{
+		const ksr2_u32 character = *pCharacter;
+
+		if (character == '\0' || character == '\n')
+		{
+			ksr2_result result = ksr2_record_text_run(pCommandList, pFont, (ksr2_s32)runX, (ksr2_s32)lineY, runGlyphs, runGlyphCount, pixelColor, blendMode);
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS || character == '\0')
+			{
+				return result;
+			}
+
+			runGlyphCount 	= 0u;
+			penX 			= x;
+			lineY 			+= pFont->lineHeight;
+			continue;
+		}
+
+		const ksr2_s64 glyphX 		= penX;
+		const ksr2_u32 glyphIndex 	= character - pFont->firstCharacter;
+		penX += pFont->advance;
+
+		if (lineY >= imageHeight || lineY + pFont->glyphHeight <= 0 || glyphX >= imageWidth || glyphX + pFont->glyphWidth <= 0 || 
+			character < pFont->firstCharacter || glyphIndex >= pFont->glyphCount)
+		{
+			continue;
+		}
+
+		ksr2_result result = K15_RENDERER_2D_RESULT_SUCCESS;
+
+		//FK: the glyph cache isn't thread safe, glyphs of deferred command lists get cached by ksr2_submit_command_list()
+		if (pCommandList->isDeferred == ksr2_false)
+		{
+			result = ksr2_cache_glyph(pFont, glyphIndex, pContext->frameIndex);
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				ksr2_record_text_run(pCommandList, pFont, (ksr2_s32)runX, (ksr2_s32)lineY, runGlyphs, runGlyphCount, pixelColor, blendMode);
+				return result;
+			}
+
+			if (pFont->pGlyphSlotIndices[glyphIndex] == K15_RENDERER_2D_GLYPH_EMPTY)
+			{
+				continue;
+			}
+		}
+
+		if (runGlyphCount == K15_RENDERER_2D_MAX_TEXT_RUN_GLYPH_COUNT || (runGlyphCount > 0u && glyphX - runX + pFont->glyphWidth > 0xFFFF))
+		{
+			result = ksr2_record_text_run(pCommandList, pFont, (ksr2_s32)runX, (ksr2_s32)lineY, runGlyphs, runGlyphCount, pixelColor, blendMode);
+
+			if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+			{
+				return result;
+			}
+
+			runGlyphCount = 0u;
+		}
+
+		if (runGlyphCount == 0u)
+		{
+			runX = glyphX;
+		}
+
+		runGlyphs[runGlyphCount].glyphIndex = (ksr2_u16)glyphIndex;
+		runGlyphs[runGlyphCount].x 			= (ksr2_u16)(glyphX - runX);
+		++runGlyphCount;
+	}
+}
+
+ksr2_result ksr2_get_glyph_cache_statistics(ksr2_contexthandle handle, ksr2_fonthandle font, ksr2_glyph_cache_statistics* pOutStatistics)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pOutStatistics == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	const ksr2_font* pFont = ksr2_fonthandle_to_font(pContext, font);
+
+	if (pFont == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	*pOutStatistics = pFont->statistics;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+ksr2_result ksr2_create_command_list(ksr2_contexthandle handle, const ksr2_command_list_parameters* pParameters, ksr2_commandlisthandle* pOutCommandListHandle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pParameters == ksr2_nullptr || pParameters->pMemory == ksr2_nullptr || pOutCommandListHandle == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_linear_allocator allocator;
+	ksr2_init_linear_allocator(&allocator, pParameters->pMemory, pParameters->memorySizeInBytes);
+
+	ksr2_command_list* pCommandList = ksr2_nullptr;
+	ksr2_result result = ksr2_allocate_from_linear_allocator_front((void**)&pCommandList, &allocator, sizeof(ksr2_command_list), ksr2_default_alignment);
+
+	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	ksr2_init_fourcc(pCommandList->fourcc, "KR2L");
+	pCommandList->pContext 				= pContext;
+	pCommandList->allocator 			= allocator;
+	pCommandList->blendMode 			= K15_RENDERER_2D_BLEND_MODE_OPAQUE;
+	pCommandList->isDeferred 			= ksr2_true;
+	pCommandList->hasTextDrawCommands 	= ksr2_false;
+	ksr2_reset_draw_command_stream(&pCommandList->drawCommandStream);
+
+	*pOutCommandListHandle = (ksr2_commandlisthandle)pCommandList;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+//FK: The chunks of the command list get linked into the draw command stream of the context, nothing gets copied.
+//	  Draw commands recorded into the context afterwards may use what's left of the last chunk of the command list.
+ksr2_result ksr2_submit_command_list(ksr2_contexthandle handle, ksr2_commandlisthandle commandListHandle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	ksr2_command_list* pCommandList = ksr2_commandlisthandle_to_command_list(commandListHandle);
+
+	if (pContext == ksr2_nullptr || pCommandList == ksr2_nullptr || pCommandList->pContext != pContext || pCommandList->isDeferred == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_draw_command_stream* pSubmittedStream = &pCommandList->drawCommandStream;
+
+	if (pSubmittedStream->pFirstChunk == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+
+	const ksr2_u64 traceBeginTimeInNs = ksr2_trace_begin(pContext);
+	ksr2_result result = K15_RENDERER_2D_RESULT_SUCCESS;
+	ksr2_command_list* pRecordCommandList = pContext->pRecordCommandList;
+
+	if (pRecordCommandList->isDeferred)
+	{
+		//FK: K15_RENDERER_2D_ASYNC_BLIT_FLAG, the glyphs get cached by ksr2_blit once the render thread is done with the glyph cache
+		pRecordCommandList->hasTextDrawCommands |= pCommandList->hasTextDrawCommands;
+	}
+	else if (pCommandList->hasTextDrawCommands)
+	{
+		result = ksr2_cache_draw_command_stream_glyphs(pContext, pSubmittedStream);
+	}
+
+#ifdef K15_RENDERER_2D_TIMESTAMPS
+	if (pContext->recordStartTimeInNs == 0u)
+	{
+		pContext->recordStartTimeInNs = ksr2_get_timestamp_in_ns(pContext);
+	}
+#endif
+
+	ksr2_draw_command_stream* pStream = &pRecordCommandList->drawCommandStream;
+	ksr2_append_draw_command_stream(pStream, pSubmittedStream);
+
+	pContext->drawCommandMemoryHighWaterMarkInBytes = ksr2_max(pContext->drawCommandMemoryHighWaterMarkInBytes, pStream->memorySizeInBytes);
+
+	//FK: the chunks belong to the context until the command list gets reset
+	ksr2_reset_draw_command_stream(pSubmittedStream);
+	pCommandList->hasTextDrawCommands = ksr2_false;
+
+	ksr2_trace_end(pContext, "submit", traceBeginTimeInNs, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+
+	return result;
+}
+
+ksr2_result ksr2_reset_command_list(ksr2_commandlisthandle commandListHandle)
+{
+	ksr2_command_list* pCommandList = ksr2_commandlisthandle_to_command_list(commandListHandle);
+
+	if (pCommandList == ksr2_nullptr || pCommandList->isDeferred == ksr2_false)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+	ksr2_reset_allocator_back(&pCommandList->allocator);
+	ksr2_reset_draw_command_stream(&pCommandList->drawCommandStream);
+	pCommandList->hasTextDrawCommands = ksr2_false;
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+size_t ksr2_get_culled_pixel_count(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return 0u;
+	}
+
+	ksr2_wait_for_render_thread(pContext);
+	return pContext->culledPixelCount;
+}
+
+ksr2_result ksr2_get_frame_stats(ksr2_contexthandle handle, ksr2_frame_stats* pOutStats)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pOutStats == ksr2_nullptr)
+	{
+		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+	}
+
+#ifndef K15_RENDERER_2D_NO_STATS
+#	ifndef K15_RENDERER_2D_NO_THREADS
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		//FK: written by the render thread once it finished a frame
+		ksr2_lock_mutex(&pContext->renderThread.mutex);
+		*pOutStats = pContext->frameStats;
+		ksr2_unlock_mutex(&pContext->renderThread.mutex);
+
+		return K15_RENDERER_2D_RESULT_SUCCESS;
+	}
+#	endif
+
+	*pOutStats = pContext->frameStats;
+#else
+	const ksr2_frame_stats emptyFrameStats = {0};
+	*pOutStats = emptyFrameStats;
+#endif
+
+	return K15_RENDERER_2D_RESULT_SUCCESS;
+}
+
+size_t ksr2_get_draw_command_memory_high_water_mark(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return 0u;
+	}
+
+	return pContext->drawCommandMemoryHighWaterMarkInBytes;
+}
+
+unsigned long long ksr2_begin_trace_event(ksr2_contexthandle handle)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return 0u;
+	}
+
+	return ksr2_trace_begin(pContext);
+}
+
+void ksr2_end_trace_event(ksr2_contexthandle handle, const char* pName, unsigned long long beginTimestamp)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || pName == ksr2_nullptr)
+	{
+		return;
+	}
+
+	ksr2_trace_end(pContext, pName, beginTimestamp, 0u, K15_RENDERER_2D_NO_TRACE_TILE);
+}
+
+typedef struct
+{
+	char*	pBuffer;
+	size_t	capacityInBytes;
+	size_t	sizeInBytes; //FK: keeps counting once the buffer is full
+} ksr2_json_writer;
+
+ksr2_internal void ksr2_write_json_char(ksr2_json_writer* pWriter, char character)
+{
+	if (pWriter->sizeInBytes < pWriter->capacityInBytes)
+	{
+		pWriter->pBuffer[pWriter->sizeInBytes] = character;
+	}
+
+	++pWriter->sizeInBytes;
+}
+
+ksr2_internal void ksr2_write_json_text(ksr2_json_writer* pWriter, const char* pText)
+{
+	while(*pText != 0)
+	{
+		ksr2_write_json_char(pWriter, *pText++);
+	}
+}
+
+ksr2_internal void ksr2_write_json_string(ksr2_json_writer* pWriter, const char* pText)
+{
+	const char* pHexDigits = "0123456789abcdef";
+	ksr2_write_json_char(pWriter, '"');
+
+	for (; *pText != 0; ++pText)
+	{
+		const ksr2_u8 character = (ksr2_u8)*pText;
+
+		if (character == '"' || character == '\\')
+		{
+			ksr2_write_json_char(pWriter, '\\');
+			ksr2_write_json_char(pWriter, (char)character);
+		}
+		else if (character < 0x20u)
+		{
+			ksr2_write_json_text(pWriter, "\\u00");
+			ksr2_write_json_char(pWriter, pHexDigits[character >> 4u]);
+			ksr2_write_json_char(pWriter, pHexDigits[character & 0xFu]);
+		}
+		else
+		{
+			ksr2_write_json_char(pWriter, (char)character);
+		}
+	}
+
+	ksr2_write_json_char(pWriter, '"');
+}
+
+ksr2_internal void ksr2_write_json_u64(ksr2_json_writer* pWriter, ksr2_u64 value)
+{
+	char digits[20];
+	ksr2_u32 digitCount = 0u;
+
+	do
+	{
+		digits[digitCount++] = (char)('0' + value % 10u);
+		value /= 10u;
+	} while(value > 0u);
+
+	while(digitCount > 0u)
+	{
+		ksr2_write_json_char(pWriter, digits[--digitCount]);
+	}
+}
+
+//FK: trace event json uses microseconds
+ksr2_internal void ksr2_write_json_microseconds(ksr2_json_writer* pWriter, ksr2_u64 timeInNs)
+{
+	const ksr2_u32 fraction = (ksr2_u32)(timeInNs % 1000u);
+
+	ksr2_write_json_u64(pWriter, timeInNs / 1000u);
+	ksr2_write_json_char(pWriter, '.');
+	ksr2_write_json_char(pWriter, (char)('0' + fraction / 100u));
+	ksr2_write_json_char(pWriter, (char)('0' + fraction / 10u % 10u));
+	ksr2_write_json_char(pWriter, (char)('0' + fraction % 10u));
+}
+
+size_t ksr2_write_trace_json(ksr2_contexthandle handle, char* pBuffer, size_t bufferSizeInBytes)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr)
+	{
+		return 0u;
+	}
+
+	ksr2_wait_for_render_thread(pContext);
+
+	ksr2_json_writer writer = {0};
+	writer.pBuffer 			= pBuffer;
+	writer.capacityInBytes 	= pBuffer != ksr2_nullptr ? bufferSizeInBytes : 0u;
+
+	ksr2_write_json_text(&writer, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	ksr2_write_json_text(&writer, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"k15 software renderer 2d\"}}");
+
+#ifndef K15_RENDERER_2D_NO_TRACING
+	const ksr2_trace_buffer* pTraceBuffer = &pContext->traceBuffer;
+	ksr2_u32 threadCount = 1u;
+
+#	ifndef K15_RENDERER_2D_NO_THREADS
+	threadCount += pContext->workerPool.workerCount;
+
+	if (pContext->flags & K15_RENDERER_2D_ASYNC_BLIT)
+	{
+		++threadCount;
+	}
+#	endif
+
+	for (ksr2_u32 threadIndex = 0u; threadIndex < threadCount; ++threadIndex)
+	{
+		ksr2_write_json_text(&writer, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+		ksr2_write_json_u64(&writer, threadIndex);
+
+		if (threadIndex == 0u)
+		{
+			ksr2_write_json_text(&writer, ",\"args\":{\"name\":\"blit thread\"}}");
+		}
+#	ifndef K15_RENDERER_2D_NO_THREADS
+		else if (threadIndex > pContext->workerPool.workerCount)
+		{
+			ksr2_write_json_text(&writer, ",\"args\":{\"name\":\"render thread\"}}");
+		}
+#	endif
+		else
+		{
+			ksr2_write_json_text(&writer, ",\"args\":{\"name\":\"worker ");
+			ksr2_write_json_u64(&writer, threadIndex - 1u);
+			ksr2_write_json_text(&writer, "\"}}");
+		}
+	}
+
+	const ksr2_u64 eventCount 		= pTraceBuffer->eventCount;
+	const ksr2_u64 ringEventCount 	= pTraceBuffer->pEvents != ksr2_nullptr ? pTraceBuffer->eventMask + 1u : 0u;
+	const ksr2_u64 firstEventIndex 	= eventCount > ringEventCount ? eventCount - ringEventCount : 0u;
+
+	for (ksr2_u64 eventIndex = firstEventIndex; eventIndex < eventCount; ++eventIndex)
+	{
+		const ksr2_trace_event* pEvent = &pTraceBuffer->pEvents[eventIndex & pTraceBuffer->eventMask];
+
+		ksr2_write_json_text(&writer, ",\n{\"name\":");
+		ksr2_write_json_string(&writer, pEvent->pName);
+		ksr2_write_json_text(&writer, ",\"cat\":\"ksr2\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+		ksr2_write_json_u64(&writer, pEvent->threadIndex);
+		ksr2_write_json_text(&writer, ",\"ts\":");
+		ksr2_write_json_microseconds(&writer, pEvent->startTimeInNs);
+		ksr2_write_json_text(&writer, ",\"dur\":");
+		ksr2_write_json_microseconds(&writer, pEvent->durationInNs);
+		ksr2_write_json_text(&writer, ",\"args\":{\"frame\":");
+		ksr2_write_json_u64(&writer, pEvent->frameIndex);
+
+		if (pEvent->tileIndex != K15_RENDERER_2D_NO_TRACE_TILE)
+		{
+			ksr2_write_json_text(&writer, ",\"tile\":");
+			ksr2_write_json_u64(&writer, pEvent->tileIndex);
+		}
+
+		ksr2_write_json_text(&writer, "}}");
+	}
+#endif //K15_RENDERER_2D_NO_TRACING
+
+	ksr2_write_json_text(&writer, "\n]}\n");
+
+	return writer.sizeInBytes;
+}
+
+unsigned int ksr2_get_damage_list(ksr2_contexthandle handle, const ksr2_damage_rect** ppOutDamageRects)
+{
+	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+
+	if (pContext == ksr2_nullptr || ppOutDamageRects == ksr2_nullptr)
+	{
+		return 0u;
+	}
+
+	ksr2_wait_for_render_thread(pContext);
+
+	*ppOutDamageRects = pContext->dirtyRegionTracker.pDamageRects;
+	return pContext->dirtyRegionTracker.damageRectCount;
+}
+
+#endif // K15_SOFTWARE_RENDERER_2D_IMPLEMENTATION
+#endif // _K15_SOFTWARE_RENDERER_2D_H_
+
+#ifdef K15_RENDERER_2D_KERNEL_PASS
+//FK: Kernels of one CPU level, see K15_RENDERER_2D_KERNEL_PASS in the implementation. Every function and table gets
+//	  K15_RENDERER_2D_KERNEL_SUFFIX appended to its name so that the passes can live in the same translation unit.
+#define ksr2_fill_span ksr2_kernel_name(ksr2_fill_span)
+#define ksr2_fill_span_non_temporal ksr2_kernel_name(ksr2_fill_span_non_temporal)
+#define ksr2_div255_avx2 ksr2_kernel_name(ksr2_div255_avx2)
+#define ksr2_div255_avx512 ksr2_kernel_name(ksr2_div255_avx512)
+#define ksr2_get_pixel_mask_avx512 ksr2_kernel_name(ksr2_get_pixel_mask_avx512)
+#define ksr2_blend_span ksr2_kernel_name(ksr2_blend_span)
+#define ksr2_add_span ksr2_kernel_name(ksr2_add_span)
+#define ksr2_copy_span ksr2_kernel_name(ksr2_copy_span)
+#define ksr2_blend_image_pixels_sse2 ksr2_kernel_name(ksr2_blend_image_pixels_sse2)
+#define ksr2_blend_image_pixels_avx2 ksr2_kernel_name(ksr2_blend_image_pixels_avx2)
+#define ksr2_blend_image_pixels_avx512 ksr2_kernel_name(ksr2_blend_image_pixels_avx512)
+#define ksr2_blend_image_span ksr2_kernel_name(ksr2_blend_image_span)
+#define ksr2_modulate_coverage_span ksr2_kernel_name(ksr2_modulate_coverage_span)
+#define ksr2_get_path_coverage_sse2 ksr2_kernel_name(ksr2_get_path_coverage_sse2)
+#define ksr2_get_path_coverage_avx2 ksr2_kernel_name(ksr2_get_path_coverage_avx2)
+#define ksr2_resolve_coverage_span ksr2_kernel_name(ksr2_resolve_coverage_span)
+#define ksr2_resolve_nonzero_coverage_span ksr2_kernel_name(ksr2_resolve_nonzero_coverage_span)
+#define ksr2_resolve_even_odd_coverage_span ksr2_kernel_name(ksr2_resolve_even_odd_coverage_span)
+#define ksr2_fill_bytes ksr2_kernel_name(ksr2_fill_bytes)
+#define ksr2_fill_bytes_non_temporal ksr2_kernel_name(ksr2_fill_bytes_non_temporal)
+#define ksr2_copy_bytes ksr2_kernel_name(ksr2_copy_bytes)
+#define ksr2_expand_5_bit_sse2 ksr2_kernel_name(ksr2_expand_5_bit_sse2)
+#define ksr2_expand_6_bit_sse2 ksr2_kernel_name(ksr2_expand_6_bit_sse2)
+#define ksr2_unpack_rgb565_sse2 ksr2_kernel_name(ksr2_unpack_rgb565_sse2)
+#define ksr2_pack_rgb565_sse2 ksr2_kernel_name(ksr2_pack_rgb565_sse2)
+#define ksr2_gather_channel_sse2 ksr2_kernel_name(ksr2_gather_channel_sse2)
+#define ksr2_get_luma_sse2 ksr2_kernel_name(ksr2_get_luma_sse2)
+#define ksr2_blend_channel_sse2 ksr2_kernel_name(ksr2_blend_channel_sse2)
+#define ksr2_blend_image_channel_sse2 ksr2_kernel_name(ksr2_blend_image_channel_sse2)
+#define ksr2_swap_red_blue_sse2 ksr2_kernel_name(ksr2_swap_red_blue_sse2)
+#define ksr2_blend_span_16 ksr2_kernel_name(ksr2_blend_span_16)
+#define ksr2_blend_image_span_16 ksr2_kernel_name(ksr2_blend_image_span_16)
+#define ksr2_blend_span_8 ksr2_kernel_name(ksr2_blend_span_8)
+#define ksr2_blend_image_span_8 ksr2_kernel_name(ksr2_blend_image_span_8)
+#define ksr2_convert_pixels_from_rgba ksr2_kernel_name(ksr2_convert_pixels_from_rgba)
+#define ksr2_convert_pixels_to_rgba ksr2_kernel_name(ksr2_convert_pixels_to_rgba)
+#define ksr2_convert_span_from_rgba ksr2_kernel_name(ksr2_convert_span_from_rgba)
+#define ksr2_paint_format_span ksr2_kernel_name(ksr2_paint_format_span)
+#define ksr2_paint_format_image_span ksr2_kernel_name(ksr2_paint_format_image_span)
+#define ksr2_fill_format_span ksr2_kernel_name(ksr2_fill_format_span)
+#define ksr2_paint_span_generic ksr2_kernel_name(ksr2_paint_span_generic)
+#define ksr2_paint_image_span_generic ksr2_kernel_name(ksr2_paint_image_span_generic)
+#define ksr2_fill_span_generic ksr2_kernel_name(ksr2_fill_span_generic)
+#define ksr2_fill_span_non_temporal_generic ksr2_kernel_name(ksr2_fill_span_non_temporal_generic)
+#define ksr2_convert_colors_to_pixel_format ksr2_kernel_name(ksr2_convert_colors_to_pixel_format)
+#define ksr2_pixel_kernel_table ksr2_kernel_name(ksr2_pixel_kernel_table)
+#define ksr2_init_pixel_kernels ksr2_kernel_name(ksr2_init_pixel_kernels)
+
+#ifdef K15_RENDERER_2D_AVX512
+//FK: Lanes of the first min(pixelCount, 16) pixels, the AVX-512 kernels mask the end of a span instead of having a scalar tail.
+ksr2_force_inline __mmask16 ksr2_get_pixel_mask_avx512(ksr2_u32 pixelCount)
+{
+	return pixelCount >= 16u ? (__mmask16)0xFFFFu : (__mmask16)((1u << pixelCount) - 1u);
+}
+#endif
+
+//FK: Span kernels. Pixel pointers are expected to be at least 4 byte aligned.
+ksr2_internal void ksr2_fill_span(ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color)
+{
+	ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+
+#ifdef K15_RENDERER_2D_AVX512
+	if (pixelCount >= 16u)
+	{
+		const __m512i colorVector = _mm512_set1_epi32((int)color);
+
+		_mm512_storeu_si512(pPixels, colorVector);
+		_mm512_storeu_si512(pPixelsEnd - 16u, colorVector);
+
+		__m512i* pVector 			= (__m512i*)(((size_t)pPixels + 64u) & ~(size_t)63u);
+		__m512i* const pVectorEnd 	= (__m512i*)((size_t)pPixelsEnd & ~(size_t)63u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm512_store_si512(pVector++, colorVector);
+		}
+
+		return;
+	}
+
+	//FK: masked out pixels don't get touched
+	_mm512_mask_storeu_epi32(pPixels, ksr2_get_pixel_mask_avx512(pixelCount), _mm512_set1_epi32((int)color));
+	return;
+#endif
+
+#ifdef K15_RENDERER_2D_AVX2
+	if (pixelCount >= 8u)
+	{
+		const __m256i colorVector = _mm256_set1_epi32((int)color);
+
+		//FK: unaligned stores for head and tail, overlapping the aligned body is fine since all pixels get the same value
+		_mm256_storeu_si256((__m256i*)pPixels, colorVector);
+		_mm256_storeu_si256((__m256i*)(pPixelsEnd - 8u), colorVector);
+
+		__m256i* pVector 			= (__m256i*)(((size_t)pPixels + 32u) & ~(size_t)31u);
+		__m256i* const pVectorEnd 	= (__m256i*)((size_t)pPixelsEnd & ~(size_t)31u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm256_store_si256(pVector++, colorVector);
+		}
+
+		return;
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_SSE2
+	if (pixelCount >= 4u)
+	{
+		const __m128i colorVector = _mm_set1_epi32((int)color);
+
+		_mm_storeu_si128((__m128i*)pPixels, colorVector);
+		_mm_storeu_si128((__m128i*)(pPixelsEnd - 4u), colorVector);
+
+		__m128i* pVector 			= (__m128i*)(((size_t)pPixels + 16u) & ~(size_t)15u);
+		__m128i* const pVectorEnd 	= (__m128i*)((size_t)pPixelsEnd & ~(size_t)15u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm_store_si128(pVector++, colorVector);
+		}
+
+		return;
+	}
+#endif
+
+	while(pPixels < pPixelsEnd)
+	{
+		*pPixels++ = color;
+	}
+}
+
+//FK: Same as ksr2_fill_span but bypasses the cache for the aligned body. Call ksr2_end_non_temporal_stores() once done.
+ksr2_internal void ksr2_fill_span_non_temporal(ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color)
+{
+#if defined(K15_RENDERER_2D_AVX512)
+	if (pixelCount >= 16u)
+	{
+		ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+		const __m512i colorVector = _mm512_set1_epi32((int)color);
+
+		_mm512_storeu_si512(pPixels, colorVector);
+		_mm512_storeu_si512(pPixelsEnd - 16u, colorVector);
+
+		__m512i* pVector 			= (__m512i*)(((size_t)pPixels + 64u) & ~(size_t)63u);
+		__m512i* const pVectorEnd 	= (__m512i*)((size_t)pPixelsEnd & ~(size_t)63u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm512_stream_si512(pVector++, colorVector);
+		}
+
+		return;
+	}
+#elif defined(K15_RENDERER_2D_AVX2)
+	if (pixelCount >= 8u)
+	{
+		ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+		const __m256i colorVector = _mm256_set1_epi32((int)color);
+
+		_mm256_storeu_si256((__m256i*)pPixels, colorVector);
+		_mm256_storeu_si256((__m256i*)(pPixelsEnd - 8u), colorVector);
+
+		__m256i* pVector 			= (__m256i*)(((size_t)pPixels + 32u) & ~(size_t)31u);
+		__m256i* const pVectorEnd 	= (__m256i*)((size_t)pPixelsEnd & ~(size_t)31u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm256_stream_si256(pVector++, colorVector);
+		}
+
+		return;
+	}
+#elif defined(K15_RENDERER_2D_SSE2)
+	if (pixelCount >= 4u)
+	{
+		ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+		const __m128i colorVector = _mm_set1_epi32((int)color);
+
+		_mm_storeu_si128((__m128i*)pPixels, colorVector);
+		_mm_storeu_si128((__m128i*)(pPixelsEnd - 4u), colorVector);
+
+		__m128i* pVector 			= (__m128i*)(((size_t)pPixels + 16u) & ~(size_t)15u);
+		__m128i* const pVectorEnd 	= (__m128i*)((size_t)pPixelsEnd & ~(size_t)15u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm_stream_si128(pVector++, colorVector);
+		}
+
+		return;
+	}
+#endif
+
+	ksr2_fill_span(pPixels, pixelCount, color);
+}
+
+
+#ifdef K15_RENDERER_2D_AVX2
+ksr2_internal __m256i ksr2_div255_avx2(__m256i value)
+{
+	value = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+}
+#endif
+
+#ifdef K15_RENDERER_2D_AVX512
+ksr2_internal __m512i ksr2_div255_avx512(__m512i value)
+{
+	value = _mm512_add_epi16(value, _mm512_set1_epi16(128));
+	return _mm512_srli_epi16(_mm512_add_epi16(value, _mm512_srli_epi16(value, 8)), 8);
+}
+#endif
+
+//FK: Channels get widened to 16 bit, scaled, divided by 255, narrowed again and the premultiplied color gets added. 
+//	  Used for alpha and multiply blending.
+ksr2_internal void ksr2_blend_span(ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand)
+{
+	ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+
+#ifdef K15_RENDERER_2D_AVX512
+	{
+		const __m512i zeroVector 	= _mm512_setzero_si512();
+		const __m512i addVector 	= _mm512_set1_epi32((int)pOperand->add);
+		const __m512i scaleVector 	= _mm512_unpacklo_epi8(_mm512_set1_epi32((int)pOperand->scale), zeroVector);
+
+		for (ksr2_u32 pixelIndex = 0u; pixelIndex < pixelCount; pixelIndex += 16u)
+		{
+			const __mmask16 pixelMask = ksr2_get_pixel_mask_avx512(pixelCount - pixelIndex);
+			const __m512i pixelVector = _mm512_maskz_loadu_epi32(pixelMask, pPixels + pixelIndex);
+			const __m512i lowVector = ksr2_div255_avx512(_mm512_mullo_epi16(_mm512_unpacklo_epi8(pixelVector, zeroVector), scaleVector));
+			const __m512i highVector = ksr2_div255_avx512(_mm512_mullo_epi16(_mm512_unpackhi_epi8(pixelVector, zeroVector), scaleVector));
+
+			_mm512_mask_storeu_epi32(pPixels + pixelIndex, pixelMask, _mm512_adds_epu8(_mm512_packus_epi16(lowVector, highVector), addVector));
+		}
+
+		return;
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_AVX2
+	{
+		const __m256i zeroVector 	= _mm256_setzero_si256();
+		const __m256i addVector 	= _mm256_set1_epi32((int)pOperand->add);
+		const __m256i scaleVector 	= _mm256_unpacklo_epi8(_mm256_set1_epi32((int)pOperand->scale), zeroVector);
+
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			const __m256i pixelVector = _mm256_loadu_si256((const __m256i*)pPixels);
+			const __m256i lowVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixelVector, zeroVector), scaleVector));
+			const __m256i highVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixelVector, zeroVector), scaleVector));
+
+			_mm256_storeu_si256((__m256i*)pPixels, _mm256_adds_epu8(_mm256_packus_epi16(lowVector, highVector), addVector));
+			pPixels += 8;
+		}
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i addVector 	= _mm_set1_epi32((int)pOperand->add);
+		const __m128i scaleVector 	= _mm_unpacklo_epi8(_mm_set1_epi32((int)pOperand->scale), zeroVector);
+
+		while(pPixelsEnd - pPixels >= 4)
+		{
+			const __m128i pixelVector = _mm_loadu_si128((const __m128i*)pPixels);
+			const __m128i lowVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixelVector, zeroVector), scaleVector));
+			const __m128i highVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixelVector, zeroVector), scaleVector));
+
+			_mm_storeu_si128((__m128i*)pPixels, _mm_adds_epu8(_mm_packus_epi16(lowVector, highVector), addVector));
+			pPixels += 4;
+		}
+	}
+#endif
+
+	while(pPixels < pPixelsEnd)
+	{
+		*pPixels = ksr2_blend_pixel(*pPixels, pOperand);
+		++pPixels;
+	}
+}
+
+//FK: Additive blending doesn't need to scale the destination, it's just a saturated add.
+ksr2_internal void ksr2_add_span(ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand)
+{
+	ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+
+#ifdef K15_RENDERER_2D_AVX512
+	{
+		const __m512i addVector = _mm512_set1_epi32((int)pOperand->add);
+
+		for (ksr2_u32 pixelIndex = 0u; pixelIndex < pixelCount; pixelIndex += 16u)
+		{
+			const __mmask16 pixelMask = ksr2_get_pixel_mask_avx512(pixelCount - pixelIndex);
+			const __m512i pixelVector = _mm512_maskz_loadu_epi32(pixelMask, pPixels + pixelIndex);
+			_mm512_mask_storeu_epi32(pPixels + pixelIndex, pixelMask, _mm512_adds_epu8(pixelVector, addVector));
+		}
+
+		return;
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_AVX2
+	{
+		const __m256i addVector = _mm256_set1_epi32((int)pOperand->add);
+
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			const __m256i pixelVector = _mm256_loadu_si256((const __m256i*)pPixels);
+			_mm256_storeu_si256((__m256i*)pPixels, _mm256_adds_epu8(pixelVector, addVector));
+			pPixels += 8;
+		}
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const __m128i addVector = _mm_set1_epi32((int)pOperand->add);
+
+		while(pPixelsEnd - pPixels >= 4)
+		{
+			const __m128i pixelVector = _mm_loadu_si128((const __m128i*)pPixels);
+			_mm_storeu_si128((__m128i*)pPixels, _mm_adds_epu8(pixelVector, addVector));
+			pPixels += 4;
+		}
+	}
+#endif
+
+	while(pPixels < pPixelsEnd)
+	{
+		*pPixels = ksr2_blend_pixel(*pPixels, pOperand);
+		++pPixels;
+	}
+}
+
+ksr2_internal void ksr2_copy_span(ksr2_pixel_color* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount)
+{
+	ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+
+#ifdef K15_RENDERER_2D_AVX512
+	for (ksr2_u32 pixelIndex = 0u; pixelIndex < pixelCount; pixelIndex += 16u)
+	{
+		const __mmask16 pixelMask = ksr2_get_pixel_mask_avx512(pixelCount - pixelIndex);
+		_mm512_mask_storeu_epi32(pPixels + pixelIndex, pixelMask, _mm512_maskz_loadu_epi32(pixelMask, pSourcePixels + pixelIndex));
+	}
+
+	return;
+#endif
+
+#ifdef K15_RENDERER_2D_AVX2
+	while(pPixelsEnd - pPixels >= 8)
+	{
+		_mm256_storeu_si256((__m256i*)pPixels, _mm256_loadu_si256((const __m256i*)pSourcePixels));
+		pPixels 		+= 8;
+		pSourcePixels 	+= 8;
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_SSE2
+	while(pPixelsEnd - pPixels >= 4)
+	{
+		_mm_storeu_si128((__m128i*)pPixels, _mm_loadu_si128((const __m128i*)pSourcePixels));
+		pPixels 		+= 4;
+		pSourcePixels 	+= 4;
+	}
+#endif
+
+	while(pPixels < pPixelsEnd)
+	{
+		*pPixels++ = *pSourcePixels++;
+	}
+}
+
+#ifdef K15_RENDERER_2D_SSE2
+ksr2_force_inline __m128i ksr2_blend_image_pixels_sse2(__m128i pixelVector, __m128i sourceVector, ksr2_blend_mode blendMode, __m128i alphaShiftVector)
 {
-	ksr2_linear_allocator allocator 	= {0};
-	allocator.pStartAddress 			= (ksr2_byte*)pBaseAddress;
-	allocator.pEndAddress				= (ksr2_byte*)pBaseAddress + memorySizeInBytes;
-	allocator.memorySizeInBytesStart 	= 0u;
-	allocator.memorySizeInBytesEnd	 	= 0u;
-	allocator.memoryCapacityInBytes 	= memorySizeInBytes;	
-	*pOutAllocator = allocator;
-}
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_ADDITIVE)
+	{
+		return _mm_adds_epu8(pixelVector, sourceVector);
+	}
 
-ksr2_internal void ksr2_set_linear_allocator_front(ksr2_linear_allocator* pAllocator, void* pStartAddress)
-{
-	ksr2_assert(pAllocator != ksr2_nullptr);
-	ksr2_assert(pStartAddress != ksr2_nullptr);
+	const __m128i zeroVector = _mm_setzero_si128();
 
-	pAllocator->memorySizeInBytesStart = ((size_t)pStartAddress - (size_t)pAllocator->pStartAddress);
-	pAllocator->pStartAddress = pStartAddress;
-}
+	//FK: broadcast the alpha of every pixel to all of its channels and invert it
+	__m128i alphaVector = _mm_and_si128(_mm_srl_epi32(sourceVector, alphaShiftVector), _mm_set1_epi32(0xFF));
+	alphaVector = _mm_or_si128(alphaVector, _mm_slli_epi32(alphaVector, 8));
+	alphaVector = _mm_or_si128(alphaVector, _mm_slli_epi32(alphaVector, 16));
+	const __m128i inverseAlphaVector = _mm_xor_si128(alphaVector, _mm_set1_epi32(-1));
 
-ksr2_internal size_t ksr2_get_linear_allocator_capacity(const ksr2_linear_allocator* pAllocator)
-{
-	return pAllocator->memoryCapacityInBytes - (pAllocator->memorySizeInBytesStart + pAllocator->memorySizeInBytesEnd);
+	__m128i addVector 	= sourceVector;
+	__m128i scaleVector = inverseAlphaVector;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_MULTIPLY)
+	{
+		addVector 	= zeroVector;
+		scaleVector = _mm_add_epi8(sourceVector, inverseAlphaVector);
+	}
+
+	const __m128i lowVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixelVector, zeroVector), _mm_unpacklo_epi8(scaleVector, zeroVector)));
+	const __m128i highVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixelVector, zeroVector), _mm_unpackhi_epi8(scaleVector, zeroVector)));
+
+	return _mm_adds_epu8(_mm_packus_epi16(lowVector, highVector), addVector);
 }
+#endif
 
-ksr2_internal ksr2_result ksr2_allocate_from_linear_allocator_front(void** pOutPointer, ksr2_linear_allocator* pAllocator, size_t memorySizeInBytes, size_t alignment)
+#ifdef K15_RENDERER_2D_AVX512
+ksr2_force_inline __m512i ksr2_blend_image_pixels_avx512(__m512i pixelVector, __m512i sourceVector, ksr2_blend_mode blendMode, __m128i alphaShiftVector)
 {
-	ksr2_use_argument(alignment);
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_ADDITIVE)
+	{
+		return _mm512_adds_epu8(pixelVector, sourceVector);
+	}
 
-	const size_t allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+	const __m512i zeroVector = _mm512_setzero_si512();
 
-	if (allocatorCapacityInBytes < memorySizeInBytes)
+	__m512i alphaVector = _mm512_and_si512(_mm512_srl_epi32(sourceVector, alphaShiftVector), _mm512_set1_epi32(0xFF));
+	alphaVector = _mm512_or_si512(alphaVector, _mm512_slli_epi32(alphaVector, 8));
+	alphaVector = _mm512_or_si512(alphaVector, _mm512_slli_epi32(alphaVector, 16));
+	const __m512i inverseAlphaVector = _mm512_xor_si512(alphaVector, _mm512_set1_epi32(-1));
+
+	__m512i addVector 	= sourceVector;
+	__m512i scaleVector = inverseAlphaVector;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_MULTIPLY)
 	{
-		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+		addVector 	= zeroVector;
+		scaleVector = _mm512_add_epi8(sourceVector, inverseAlphaVector);
 	}
 
-	*pOutPointer = (void*)(pAllocator->pStartAddress + pAllocator->memorySizeInBytesStart);
-	pAllocator->memorySizeInBytesStart += memorySizeInBytes;
+	const __m512i lowVector = ksr2_div255_avx512(_mm512_mullo_epi16(_mm512_unpacklo_epi8(pixelVector, zeroVector), _mm512_unpacklo_epi8(scaleVector, zeroVector)));
+	const __m512i highVector = ksr2_div255_avx512(_mm512_mullo_epi16(_mm512_unpackhi_epi8(pixelVector, zeroVector), _mm512_unpackhi_epi8(scaleVector, zeroVector)));
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+	return _mm512_adds_epu8(_mm512_packus_epi16(lowVector, highVector), addVector);
 }
+#endif
 
-ksr2_internal ksr2_result ksr2_allocate_from_linear_allocator_back(void** pOutPointer, ksr2_linear_allocator* pAllocator, size_t memorySizeInBytes, size_t alignment)
+#ifdef K15_RENDERER_2D_AVX2
+ksr2_force_inline __m256i ksr2_blend_image_pixels_avx2(__m256i pixelVector, __m256i sourceVector, ksr2_blend_mode blendMode, __m128i alphaShiftVector)
 {
-	ksr2_use_argument(alignment);
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_ADDITIVE)
+	{
+		return _mm256_adds_epu8(pixelVector, sourceVector);
+	}
 
-	const size_t allocatorCapacityInBytes = ksr2_get_linear_allocator_capacity(pAllocator);
+	const __m256i zeroVector = _mm256_setzero_si256();
 
-	if (allocatorCapacityInBytes < memorySizeInBytes)
+	__m256i alphaVector = _mm256_and_si256(_mm256_srl_epi32(sourceVector, alphaShiftVector), _mm256_set1_epi32(0xFF));
+	alphaVector = _mm256_or_si256(alphaVector, _mm256_slli_epi32(alphaVector, 8));
+	alphaVector = _mm256_or_si256(alphaVector, _mm256_slli_epi32(alphaVector, 16));
+	const __m256i inverseAlphaVector = _mm256_xor_si256(alphaVector, _mm256_set1_epi32(-1));
+
+	__m256i addVector 	= sourceVector;
+	__m256i scaleVector = inverseAlphaVector;
+
+	if (blendMode == K15_RENDERER_2D_BLEND_MODE_MULTIPLY)
 	{
-		return K15_RENDERER_2D_RESULT_OUT_OF_MEMORY;
+		addVector 	= zeroVector;
+		scaleVector = _mm256_add_epi8(sourceVector, inverseAlphaVector);
 	}
 
-	*pOutPointer = (void*)(pAllocator->pEndAddress - pAllocator->memorySizeInBytesEnd - memorySizeInBytes);
-	pAllocator->memorySizeInBytesEnd += memorySizeInBytes;
+	const __m256i lowVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixelVector, zeroVector), _mm256_unpacklo_epi8(scaleVector, zeroVector)));
+	const __m256i highVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixelVector, zeroVector), _mm256_unpackhi_epi8(scaleVector, zeroVector)));
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;	
-}
-ksr2_internal void ksr2_reset_allocator_back(ksr2_linear_allocator* pAllocator)
-{
-	pAllocator->memorySizeInBytesEnd = 0u;
+	return _mm256_adds_epu8(_mm256_packus_epi16(lowVector, highVector), addVector);
 }
+#endif
 
-ksr2_internal size_t ksr2_get_pixel_size_in_bytes(ksr2_pixel_format format)
+//FK: Blends a span of premultiplied image pixels onto the destination, see ksr2_init_image_blend_operand().
+//	  Sprites usually consist of big fully opaque and fully transparent areas, alpha blending skips or copies those.
+ksr2_force_inline void ksr2_blend_image_span(ksr2_pixel_color* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode blendMode, ksr2_u32 alphaShift)
 {
-	return 4u; //FK: decided to have this fixed
-}
+	ksr2_pixel_color* pPixelsEnd = pPixels + pixelCount;
+	const ksr2_b32 checkAlpha = blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA;
 
-ksr2_internal ksr2_result ksr2_query_image_memory_requirements(ksr2_image_memory_requirements* pOutRequirements, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format)
-{
-	ksr2_image_memory_requirements requirements = {0};
-	
-	switch(format)
+#ifdef K15_RENDERER_2D_AVX512
 	{
-		case K15_RENDERER_2D_PIXEL_FORMAT_RGBA:
-			requirements.bitsPerChannel[0] = 8u;
-			requirements.bitsPerChannel[1] = 8u;
-			requirements.bitsPerChannel[2] = 8u;
-			requirements.bitsPerChannel[3] = 8u;
-			requirements.channelCount = 4u;
-			requirements.stride = width;
-			requirements.memorySizeInBytes = height * width * 4u;
-			break;
+		const __m128i alphaShiftVector 	= _mm_cvtsi32_si128((int)alphaShift);
+		const __m512i alphaMaskVector 	= _mm512_set1_epi32((int)(0xFFu << alphaShift));
 
-		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
-			requirements.bitsPerChannel[0] = 8u;
-			requirements.bitsPerChannel[1] = 8u;
-			requirements.bitsPerChannel[2] = 8u;
-			requirements.bitsPerChannel[3] = 8u;
-			requirements.channelCount = 4u;
-			requirements.stride = width;
-			requirements.memorySizeInBytes = height * width * 4u;
-			break;
+		for (ksr2_u32 pixelIndex = 0u; pixelIndex < pixelCount; pixelIndex += 16u)
+		{
+			const __mmask16 pixelMask = ksr2_get_pixel_mask_avx512(pixelCount - pixelIndex);
+			const __m512i sourceVector = _mm512_maskz_loadu_epi32(pixelMask, pSourcePixels + pixelIndex);
+
+			if (checkAlpha)
+			{
+				if (_mm512_test_epi32_mask(sourceVector, sourceVector) == 0)
+				{
+					continue;
+				}
+
+				if (_mm512_mask_cmpeq_epi32_mask(pixelMask, _mm512_and_si512(sourceVector, alphaMaskVector), alphaMaskVector) == pixelMask)
+				{
+					_mm512_mask_storeu_epi32(pPixels + pixelIndex, pixelMask, sourceVector);
+					continue;
+				}
+			}
+
+			const __m512i pixelVector = _mm512_maskz_loadu_epi32(pixelMask, pPixels + pixelIndex);
+			_mm512_mask_storeu_epi32(pPixels + pixelIndex, pixelMask, ksr2_blend_image_pixels_avx512(pixelVector, sourceVector, blendMode, alphaShiftVector));
+		}
 
-		default:
-			return K15_RENDERER_2D_UNKNOWN_PIXEL_FORMAT;
+		return;
 	}
+#endif
 
-	*pOutRequirements = requirements;
-
-	return K15_RENDERER_2D_RESULT_SUCCESS;
-}
+#ifdef K15_RENDERER_2D_AVX2
+	{
+		const __m128i alphaShiftVector 	= _mm_cvtsi32_si128((int)alphaShift);
+		const __m256i alphaMaskVector 	= _mm256_set1_epi32((int)(0xFFu << alphaShift));
 
-ksr2_internal ksr2_result ksr2_allocate_swap_chain_images(void** pImages, ksr2_u32 imageCount, ksr2_linear_allocator* pAllocator, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format)
-{
-	ksr2_image_memory_requirements memoryRequirements = {0};
-	ksr2_result result = ksr2_query_image_memory_requirements(&memoryRequirements, width, height, format);
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			const __m256i sourceVector = _mm256_loadu_si256((const __m256i*)pSourcePixels);
+
+			if (checkAlpha)
+			{
+				if (_mm256_testz_si256(sourceVector, sourceVector))
+				{
+					pPixels 		+= 8;
+					pSourcePixels 	+= 8;
+					continue;
+				}
+
+				if (_mm256_testc_si256(sourceVector, alphaMaskVector))
+				{
+					_mm256_storeu_si256((__m256i*)pPixels, sourceVector);
+					pPixels 		+= 8;
+					pSourcePixels 	+= 8;
+					continue;
+				}
+			}
+
+			const __m256i pixelVector = _mm256_loadu_si256((const __m256i*)pPixels);
+			_mm256_storeu_si256((__m256i*)pPixels, ksr2_blend_image_pixels_avx2(pixelVector, sourceVector, blendMode, alphaShiftVector));
+			pPixels 		+= 8;
+			pSourcePixels 	+= 8;
+		}
+	}
+#endif
 
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+#ifdef K15_RENDERER_2D_SSE2
 	{
-		return result;
+		const __m128i alphaShiftVector 	= _mm_cvtsi32_si128((int)alphaShift);
+		const __m128i alphaMaskVector 	= _mm_set1_epi32((int)(0xFFu << alphaShift));
+		const __m128i zeroVector 		= _mm_setzero_si128();
+
+		while(pPixelsEnd - pPixels >= 4)
+		{
+			const __m128i sourceVector = _mm_loadu_si128((const __m128i*)pSourcePixels);
+
+			if (checkAlpha)
+			{
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(sourceVector, zeroVector)) == 0xFFFF)
+				{
+					pPixels 		+= 4;
+					pSourcePixels 	+= 4;
+					continue;
+				}
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(sourceVector, alphaMaskVector), alphaMaskVector)) == 0xFFFF)
+				{
+					_mm_storeu_si128((__m128i*)pPixels, sourceVector);
+					pPixels 		+= 4;
+					pSourcePixels 	+= 4;
+					continue;
+				}
+			}
+
+			const __m128i pixelVector = _mm_loadu_si128((const __m128i*)pPixels);
+			_mm_storeu_si128((__m128i*)pPixels, ksr2_blend_image_pixels_sse2(pixelVector, sourceVector, blendMode, alphaShiftVector));
+			pPixels 		+= 4;
+			pSourcePixels 	+= 4;
+		}
 	}
+#else
+	ksr2_use_argument(checkAlpha);
+#endif
 
-	result = ksr2_allocate_from_linear_allocator_front(pImages, pAllocator, memoryRequirements.memorySizeInBytes * imageCount, memoryRequirements.alignment);
-	return result;
+	while(pPixels < pPixelsEnd)
+	{
+		ksr2_blend_operand operand;
+		ksr2_init_image_blend_operand(&operand, *pSourcePixels++, blendMode, alphaShift);
+		*pPixels = ksr2_blend_pixel(*pPixels, &operand);
+		++pPixels;
+	}
 }
 
-ksr2_internal void ksr2_destroy_swap_chain_images(ksr2_swap_chain* pSwapChain, ksr2_linear_allocator* pAllocator)
+//FK: Scales the premultiplied color by the coverage of every pixel, the result can be blended like premultiplied image pixels.
+ksr2_internal void ksr2_modulate_coverage_span(ksr2_pixel_color* pOutPixels, const ksr2_u8* pCoverage, ksr2_u32 pixelCount, ksr2_pixel_color color)
 {
-	ksr2_assert(pSwapChain != ksr2_nullptr);
-	ksr2_assert(pAllocator != ksr2_nullptr);
+	ksr2_pixel_color* pPixelsEnd = pOutPixels + pixelCount;
 
-	void* pStartAddress = pSwapChain->pImageStart;
-	
-	ksr2_set_linear_allocator_front(pAllocator, pStartAddress);
-	
-	for (ksr2_u32 imageIndex = 0u; imageIndex < pSwapChain->imageCount; ++imageIndex)
+#ifdef K15_RENDERER_2D_AVX2
 	{
-		pSwapChain->pImages = ksr2_nullptr;
+		const __m256i zeroVector 	= _mm256_setzero_si256();
+		const __m256i colorVector 	= _mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), zeroVector);
+
+		while(pPixelsEnd - pOutPixels >= 8)
+		{
+			//FK: broadcast the coverage of every pixel to all of its channels
+			__m128i coverageVector = _mm_loadl_epi64((const __m128i*)pCoverage);
+			coverageVector = _mm_unpacklo_epi8(coverageVector, coverageVector);
+
+			const __m256i coverageChannels = _mm256_cvtepu16_epi32(coverageVector);
+			const __m256i coverageVector32 = _mm256_or_si256(coverageChannels, _mm256_slli_epi32(coverageChannels, 16));
+
+			const __m256i lowVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(coverageVector32, zeroVector), colorVector));
+			const __m256i highVector = ksr2_div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(coverageVector32, zeroVector), colorVector));
+
+			_mm256_storeu_si256((__m256i*)pOutPixels, _mm256_packus_epi16(lowVector, highVector));
+			pOutPixels 	+= 8;
+			pCoverage 	+= 8;
+		}
 	}
-}
+#endif
 
-ksr2_internal void* ksr2_get_allocator_front_address(ksr2_linear_allocator* pAllocator)
-{
-	ksr2_assert(pAllocator != ksr2_nullptr);
-	return pAllocator->pStartAddress + pAllocator->memorySizeInBytesStart;
-}
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i colorVector 	= _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zeroVector);
 
-ksr2_internal ksr2_result ksr2_init_swap_chain(ksr2_swap_chain* pOutSwapChain, ksr2_linear_allocator* pAllocator, void* pImages, ksr2_u32 imageCount, ksr2_u32 width, ksr2_u32 height, ksr2_pixel_format format)
-{
-	ksr2_swap_chain swapChain = {0};
-	swapChain.imageCount 			= imageCount;
-	swapChain.pImages 				= pImages;
-	swapChain.width 				= width;
-	swapChain.height 				= height;
-	swapChain.format 				= format;
-	swapChain.pImageStart 			= ksr2_get_allocator_front_address(pAllocator);
-	swapChain.pCurrentImage			= pImages;
-	swapChain.imageIndex			= 0;
-	*pOutSwapChain = swapChain;
+		while(pPixelsEnd - pOutPixels >= 4)
+		{
+			//FK: pCoverage isn't aligned
+			const ksr2_u32 coverage = (ksr2_u32)pCoverage[0] | ((ksr2_u32)pCoverage[1] << 8u) | ((ksr2_u32)pCoverage[2] << 16u) | ((ksr2_u32)pCoverage[3] << 24u);
+			__m128i coverageVector = _mm_cvtsi32_si128((int)coverage);
+			coverageVector = _mm_unpacklo_epi8(coverageVector, coverageVector);
+			coverageVector = _mm_unpacklo_epi16(coverageVector, coverageVector);
+
+			const __m128i lowVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(coverageVector, zeroVector), colorVector));
+			const __m128i highVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(coverageVector, zeroVector), colorVector));
+
+			_mm_storeu_si128((__m128i*)pOutPixels, _mm_packus_epi16(lowVector, highVector));
+			pOutPixels 	+= 4;
+			pCoverage 	+= 4;
+		}
+	}
+#endif
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+	while(pOutPixels < pPixelsEnd)
+	{
+		const ksr2_u32 coverage = *pCoverage++;
+		ksr2_pixel_color pixel = 0u;
+
+		for (ksr2_u32 shift = 0u; shift < 32u; shift += 8u)
+		{
+			pixel |= ksr2_div255(((color >> shift) & 0xFFu) * coverage) << shift;
+		}
+
+		*pOutPixels++ = pixel;
+	}
 }
 
-ksr2_internal void ksr2_push_draw_command(ksr2_context* pContext, void* pDrawCommand)
+#ifdef K15_RENDERER_2D_SSE2
+//FK: ksr2_get_path_coverage() of 4 areas, the coverage ends up in the low byte of every lane
+ksr2_force_inline __m128i ksr2_get_path_coverage_sse2(__m128i areaVector, ksr2_fill_rule fillRule)
 {
-	ksr2_draw_command_header* pHeader = (ksr2_draw_command_header*)pDrawCommand;
+	const __m128i oneVector 	= _mm_set1_epi32(K15_RENDERER_2D_FIXED_POINT_ONE);
+	const __m128i signVector 	= _mm_srai_epi32(areaVector, 31);
+	__m128i coverageVector 		= _mm_sub_epi32(_mm_xor_si128(areaVector, signVector), signVector);
+	__m128i foldedVector 		= oneVector;
 
-#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
-	if (ksr2_check_fourcc(pHeader->fourcc, "KR2D") == ksr2_false)
+	if (fillRule == K15_RENDERER_2D_FILL_RULE_EVEN_ODD)
 	{
-		return;
+		coverageVector 	= _mm_and_si128(coverageVector, _mm_set1_epi32(2 * K15_RENDERER_2D_FIXED_POINT_ONE - 1));
+		foldedVector 	= _mm_sub_epi32(_mm_set1_epi32(2 * K15_RENDERER_2D_FIXED_POINT_ONE), coverageVector);
 	}
-#endif
 
-	pHeader->pNext = pContext->pFirstDrawCommand;
-	pContext->pFirstDrawCommand = pHeader;
+	const __m128i aboveOneMask = _mm_cmpgt_epi32(coverageVector, oneVector);
+	coverageVector = _mm_or_si128(_mm_and_si128(aboveOneMask, foldedVector), _mm_andnot_si128(aboveOneMask, coverageVector));
+	coverageVector = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(coverageVector, 8), coverageVector), _mm_set1_epi32(K15_RENDERER_2D_FIXED_POINT_ONE / 2));
 
-	return;
+	return _mm_srli_epi32(coverageVector, K15_RENDERER_2D_FIXED_POINT_BITS);
 }
+#endif
 
-ksr2_internal ksr2_result ksr2_allocate_draw_command(void** pOutDrawCommand, ksr2_context* pContext, size_t sizeInBytes, ksr2_draw_command_type type)
+#ifdef K15_RENDERER_2D_AVX2
+ksr2_force_inline __m256i ksr2_get_path_coverage_avx2(__m256i areaVector, ksr2_fill_rule fillRule)
 {
-	const size_t drawCommandSizeInBytes = sizeof(ksr2_draw_command_header) + sizeInBytes;
-	
-	ksr2_result result = ksr2_allocate_from_linear_allocator_back(pOutDrawCommand, &pContext->allocator, drawCommandSizeInBytes, ksr2_default_alignment);
+	const __m256i oneVector = _mm256_set1_epi32(K15_RENDERER_2D_FIXED_POINT_ONE);
+	__m256i coverageVector 	= _mm256_abs_epi32(areaVector);
+	__m256i foldedVector 	= oneVector;
 
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	if (fillRule == K15_RENDERER_2D_FILL_RULE_EVEN_ODD)
 	{
-		return result;
+		coverageVector 	= _mm256_and_si256(coverageVector, _mm256_set1_epi32(2 * K15_RENDERER_2D_FIXED_POINT_ONE - 1));
+		foldedVector 	= _mm256_sub_epi32(_mm256_set1_epi32(2 * K15_RENDERER_2D_FIXED_POINT_ONE), coverageVector);
 	}
 
-	ksr2_draw_command_header* pHeader = (ksr2_draw_command_header*)(*pOutDrawCommand);
-	
-	ksr2_init_fourcc(pHeader->fourcc, "KR2D");
-	pHeader->type 			= type;
-	pHeader->sizeInBytes 	= sizeInBytes;
-	pHeader->pNext 			= ksr2_nullptr;
+	const __m256i aboveOneMask = _mm256_cmpgt_epi32(coverageVector, oneVector);
+	coverageVector = _mm256_blendv_epi8(coverageVector, foldedVector, aboveOneMask);
+	coverageVector = _mm256_add_epi32(_mm256_sub_epi32(_mm256_slli_epi32(coverageVector, 8), coverageVector), _mm256_set1_epi32(K15_RENDERER_2D_FIXED_POINT_ONE / 2));
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+	return _mm256_srli_epi32(coverageVector, K15_RENDERER_2D_FIXED_POINT_BITS);
 }
+#endif
 
-ksr2_internal ksr2_result ksr2_issue_line_draw_command(ksr2_context* pContext, ksr2_draw_command_header* pHeader)
+//FK: Turns the signed areas of a row of a path into coverage by summing them up from left to right and clears them on the way,
+//	  returns the sum of all of them. Areas are integers so that the prefix sums come out the same on every CPU level.
+ksr2_force_inline ksr2_s32 ksr2_resolve_coverage_span(ksr2_u8* pOutCoverage, ksr2_s32* pAreas, ksr2_u32 count, ksr2_fill_rule fillRule)
 {
-#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
-	if (ksr2_check_fourcc(pHeader->fourcc, "KR2D") == ksr2_false)
+	ksr2_u32 index 	= 0u;
+	ksr2_s32 sum 	= 0;
+
+#ifdef K15_RENDERER_2D_AVX2
+	if (count >= 8u)
 	{
-		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		const __m256i zeroVector 		= _mm256_setzero_si256();
+		const __m256i lastLaneVector 	= _mm256_set1_epi32(7);
+		__m256i sumVector 				= zeroVector;
+
+		for (; index + 8u <= count; index += 8u)
+		{
+			__m256i areaVector = _mm256_loadu_si256((const __m256i*)(pAreas + index));
+			_mm256_storeu_si256((__m256i*)(pAreas + index), zeroVector);
+
+			//FK: prefix sums of both 128 bit lanes, then the sum of the lower lane gets added to the upper one
+			areaVector = _mm256_add_epi32(areaVector, _mm256_slli_si256(areaVector, 4));
+			areaVector = _mm256_add_epi32(areaVector, _mm256_slli_si256(areaVector, 8));
+			areaVector = _mm256_add_epi32(areaVector, _mm256_permute2x128_si256(_mm256_shuffle_epi32(areaVector, 0xFF), areaVector, 0x08));
+			areaVector = _mm256_add_epi32(areaVector, sumVector);
+			sumVector  = _mm256_permutevar8x32_epi32(areaVector, lastLaneVector);
+
+			const __m256i coverageVector 	= ksr2_get_path_coverage_avx2(areaVector, fillRule);
+			const __m128i coverageVector16 	= _mm_packs_epi32(_mm256_castsi256_si128(coverageVector), _mm256_extracti128_si256(coverageVector, 1));
+			_mm_storel_epi64((__m128i*)(pOutCoverage + index), _mm_packus_epi16(coverageVector16, coverageVector16));
+		}
+
+		sum = _mm256_cvtsi256_si32(sumVector);
 	}
 #endif
 
-	ksr2_line_draw_command* pDrawCommand = (ksr2_line_draw_command*)pHeader;
+#ifdef K15_RENDERER_2D_SSE2
+	if (count - index >= 4u)
+	{
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		__m128i sumVector 			= _mm_set1_epi32(sum);
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+		for (; index + 4u <= count; index += 4u)
+		{
+			__m128i areaVector = _mm_loadu_si128((const __m128i*)(pAreas + index));
+			_mm_storeu_si128((__m128i*)(pAreas + index), zeroVector);
+
+			areaVector = _mm_add_epi32(areaVector, _mm_slli_si128(areaVector, 4));
+			areaVector = _mm_add_epi32(areaVector, _mm_slli_si128(areaVector, 8));
+			areaVector = _mm_add_epi32(areaVector, sumVector);
+			sumVector  = _mm_shuffle_epi32(areaVector, 0xFF);
+
+			__m128i coverageVector = ksr2_get_path_coverage_sse2(areaVector, fillRule);
+			coverageVector = _mm_packs_epi32(coverageVector, coverageVector);
+
+			//FK: pOutCoverage isn't aligned, compilers merge these into a single store
+			const ksr2_u32 coverage = (ksr2_u32)_mm_cvtsi128_si32(_mm_packus_epi16(coverageVector, coverageVector));
+			pOutCoverage[index + 0u] = (ksr2_u8)(coverage >> 0u);
+			pOutCoverage[index + 1u] = (ksr2_u8)(coverage >> 8u);
+			pOutCoverage[index + 2u] = (ksr2_u8)(coverage >> 16u);
+			pOutCoverage[index + 3u] = (ksr2_u8)(coverage >> 24u);
+		}
+
+		sum = _mm_cvtsi128_si32(sumVector);
+	}
+#endif
+
+	for (; index < count; ++index)
+	{
+		sum += pAreas[index];
+		pAreas[index] = 0;
+		pOutCoverage[index] = (ksr2_u8)ksr2_get_path_coverage(sum, fillRule);
+	}
 
+	return sum;
 }
 
-ksr2_internal ksr2_result ksr2_issue_filled_rect_draw_command(ksr2_context* pContext, ksr2_draw_command_header* pHeader)
+ksr2_internal ksr2_s32 ksr2_resolve_nonzero_coverage_span(ksr2_u8* pOutCoverage, ksr2_s32* pAreas, ksr2_u32 count)
 {
-#if K15_RENDERER_2D_EXTENSIVE_ARGUMENT_CHECK
-	if (ksr2_check_fourcc(pHeader->fourcc, "KR2D") == ksr2_false)
+	return ksr2_resolve_coverage_span(pOutCoverage, pAreas, count, K15_RENDERER_2D_FILL_RULE_NONZERO);
+}
+
+ksr2_internal ksr2_s32 ksr2_resolve_even_odd_coverage_span(ksr2_u8* pOutCoverage, ksr2_s32* pAreas, ksr2_u32 count)
+{
+	return ksr2_resolve_coverage_span(pOutCoverage, pAreas, count, K15_RENDERER_2D_FILL_RULE_EVEN_ODD);
+}
+
+//FK: Same as ksr2_fill_span for pixels of less than 32 bit, pattern is the value of a pixel repeated to 32 bit. 
+//	  The vector stores can start at any pixel since every pixel gets the same value.
+ksr2_internal void ksr2_fill_bytes(ksr2_byte* pBytes, size_t sizeInBytes, ksr2_u32 pattern, ksr2_u32 pixelSizeInBytes)
+{
+	ksr2_byte* pBytesEnd = pBytes + sizeInBytes;
+
+#ifdef K15_RENDERER_2D_AVX512
+	if (sizeInBytes >= 64u)
 	{
-		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		const __m512i patternVector = _mm512_set1_epi32((int)pattern);
+
+		_mm512_storeu_si512(pBytes, patternVector);
+		_mm512_storeu_si512(pBytesEnd - 64u, patternVector);
+
+		__m512i* pVector 			= (__m512i*)(((size_t)pBytes + 64u) & ~(size_t)63u);
+		__m512i* const pVectorEnd 	= (__m512i*)((size_t)pBytesEnd & ~(size_t)63u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm512_store_si512(pVector++, patternVector);
+		}
+
+		return;
 	}
 #endif
 
-	ksr2_pixel_color* pPixelData = (ksr2_pixel_color*)pContext->swapChain.pCurrentImage;
-	const ksr2_u32 pixelDataStride = pContext->swapChain.width;
-
-	ksr2_filled_rect_draw_command* pDrawCommand = (ksr2_filled_rect_draw_command*)pHeader;
-	for (ksr2_u32 y = pDrawCommand->y1; y < pDrawCommand->y2; ++y)
+#ifdef K15_RENDERER_2D_AVX2
+	if (sizeInBytes >= 32u)
 	{
-		for (ksr2_u32 x = pDrawCommand->x1; x < pDrawCommand->x2; ++x)
+		const __m256i patternVector = _mm256_set1_epi32((int)pattern);
+
+		_mm256_storeu_si256((__m256i*)pBytes, patternVector);
+		_mm256_storeu_si256((__m256i*)(pBytesEnd - 32u), patternVector);
+
+		__m256i* pVector 			= (__m256i*)(((size_t)pBytes + 32u) & ~(size_t)31u);
+		__m256i* const pVectorEnd 	= (__m256i*)((size_t)pBytesEnd & ~(size_t)31u);
+
+		while(pVector < pVectorEnd)
 		{
-			pPixelData[x + y * pixelDataStride] = pDrawCommand->color;
+			_mm256_store_si256(pVector++, patternVector);
 		}
+
+		return;
 	}
+#endif
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+#ifdef K15_RENDERER_2D_SSE2
+	if (sizeInBytes >= 16u)
+	{
+		const __m128i patternVector = _mm_set1_epi32((int)pattern);
 
-}
+		_mm_storeu_si128((__m128i*)pBytes, patternVector);
+		_mm_storeu_si128((__m128i*)(pBytesEnd - 16u), patternVector);
 
-#define ksr2_clamp(v,min,max) ((v) < (min) ? (min) : (v) > (max) ? (max) : (v))
+		__m128i* pVector 			= (__m128i*)(((size_t)pBytes + 16u) & ~(size_t)15u);
+		__m128i* const pVectorEnd 	= (__m128i*)((size_t)pBytesEnd & ~(size_t)15u);
 
-ksr2_rgba_color ksr2_rgba_color_float(float r, float g, float b, float a)
-{
-	ksr2_rgba_color color;
-	color.r = (ksr2_u8)(ksr2_clamp(r, 0.0f, 1.0f) * 255.0f);
-	color.g = (ksr2_u8)(ksr2_clamp(g, 0.0f, 1.0f) * 255.0f);
-	color.b = (ksr2_u8)(ksr2_clamp(b, 0.0f, 1.0f) * 255.0f);
-	color.a = (ksr2_u8)(ksr2_clamp(a, 0.0f, 1.0f) * 255.0f);
+		while(pVector < pVectorEnd)
+		{
+			_mm_store_si128(pVector++, patternVector);
+		}
 
-	return color;
-}
+		return;
+	}
+#endif
 
-ksr2_rgba_color ksr2_rgba_color_uint8(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
-{
-	ksr2_rgba_color color;
-	color.r = r;
-	color.g = g;
-	color.b = b;
-	color.a = a;
+	if (pixelSizeInBytes == 2u)
+	{
+		for (ksr2_u16* pPixels = (ksr2_u16*)pBytes; pPixels < (ksr2_u16*)pBytesEnd; ++pPixels)
+		{
+			*pPixels = (ksr2_u16)pattern;
+		}
 
-	return color;
+		return;
+	}
+
+	while(pBytes < pBytesEnd)
+	{
+		*pBytes++ = (ksr2_byte)pattern;
+	}
 }
 
-ksr2_rgba_color ksr2_rgba_color_uint32(unsigned int rgba)
+ksr2_internal void ksr2_fill_bytes_non_temporal(ksr2_byte* pBytes, size_t sizeInBytes, ksr2_u32 pattern, ksr2_u32 pixelSizeInBytes)
 {
-	ksr2_rgba_color color;
-	color.r = ((rgba >> 24) & 0xFF);
-	color.g = ((rgba >> 16) & 0xFF);
-	color.b = ((rgba >>  8) & 0xFF);
-	color.a = ((rgba >>  0) & 0xFF);
+#if defined(K15_RENDERER_2D_AVX512)
+	if (sizeInBytes >= 64u)
+	{
+		ksr2_byte* pBytesEnd = pBytes + sizeInBytes;
+		const __m512i patternVector = _mm512_set1_epi32((int)pattern);
 
-	return color; 
-}
+		_mm512_storeu_si512(pBytes, patternVector);
+		_mm512_storeu_si512(pBytesEnd - 64u, patternVector);
 
-ksr2_rgba_color ksr2_rgb_color_float(float r, float g, float b)
-{
-	ksr2_rgba_color color;
-	color.r = (ksr2_u8)(ksr2_clamp(r, 0.0f, 1.0f) * 255.0f);
-	color.g = (ksr2_u8)(ksr2_clamp(g, 0.0f, 1.0f) * 255.0f);
-	color.b = (ksr2_u8)(ksr2_clamp(b, 0.0f, 1.0f) * 255.0f);
-	color.a = 255u;
+		__m512i* pVector 			= (__m512i*)(((size_t)pBytes + 64u) & ~(size_t)63u);
+		__m512i* const pVectorEnd 	= (__m512i*)((size_t)pBytesEnd & ~(size_t)63u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm512_stream_si512(pVector++, patternVector);
+		}
+
+		return;
+	}
+#elif defined(K15_RENDERER_2D_AVX2)
+	if (sizeInBytes >= 32u)
+	{
+		ksr2_byte* pBytesEnd = pBytes + sizeInBytes;
+		const __m256i patternVector = _mm256_set1_epi32((int)pattern);
+
+		_mm256_storeu_si256((__m256i*)pBytes, patternVector);
+		_mm256_storeu_si256((__m256i*)(pBytesEnd - 32u), patternVector);
+
+		__m256i* pVector 			= (__m256i*)(((size_t)pBytes + 32u) & ~(size_t)31u);
+		__m256i* const pVectorEnd 	= (__m256i*)((size_t)pBytesEnd & ~(size_t)31u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm256_stream_si256(pVector++, patternVector);
+		}
+
+		return;
+	}
+#elif defined(K15_RENDERER_2D_SSE2)
+	if (sizeInBytes >= 16u)
+	{
+		ksr2_byte* pBytesEnd = pBytes + sizeInBytes;
+		const __m128i patternVector = _mm_set1_epi32((int)pattern);
+
+		_mm_storeu_si128((__m128i*)pBytes, patternVector);
+		_mm_storeu_si128((__m128i*)(pBytesEnd - 16u), patternVector);
+
+		__m128i* pVector 			= (__m128i*)(((size_t)pBytes + 16u) & ~(size_t)15u);
+		__m128i* const pVectorEnd 	= (__m128i*)((size_t)pBytesEnd & ~(size_t)15u);
+
+		while(pVector < pVectorEnd)
+		{
+			_mm_stream_si128(pVector++, patternVector);
+		}
 
-	return color;
-}
+		return;
+	}
+#endif
 
-ksr2_rgba_color ksr2_rgb_color_uint8(unsigned char r, unsigned char g, unsigned char b)
-{
-	ksr2_rgba_color color;
-	color.r = r;
-	color.g = g;
-	color.b = b;
-	color.a = 255u;
-	
-	return color;
+	ksr2_fill_bytes(pBytes, sizeInBytes, pattern, pixelSizeInBytes);
 }
 
-ksr2_rgba_color ksr2_rgb_color_uint32(unsigned int rgb)
+ksr2_internal void ksr2_copy_bytes(ksr2_byte* pBytes, const ksr2_byte* pSourceBytes, size_t sizeInBytes)
 {
-	ksr2_rgba_color color;
-	color.r = ((rgb >> 16) & 0xFF);
-	color.g = ((rgb >>  8) & 0xFF);
-	color.b = ((rgb >>  0) & 0xFF);
-	color.a = 255u;
-	
-	return color;
-}
+	ksr2_byte* pBytesEnd = pBytes + sizeInBytes;
 
-ksr2_rgba_color ksr2_color_red()
-{
-	return ksr2_rgb_color_uint8(0xFF, 0x00, 0x00);
+#ifdef K15_RENDERER_2D_AVX512
+	for (size_t byteIndex = 0u; byteIndex < sizeInBytes; byteIndex += 64u)
+	{
+		const size_t remainingSizeInBytes = sizeInBytes - byteIndex;
+		const __mmask64 byteMask = remainingSizeInBytes >= 64u ? (__mmask64)~0ull : (__mmask64)((1ull << remainingSizeInBytes) - 1u);
+		_mm512_mask_storeu_epi8(pBytes + byteIndex, byteMask, _mm512_maskz_loadu_epi8(byteMask, pSourceBytes + byteIndex));
+	}
+
+	return;
+#endif
+
+#ifdef K15_RENDERER_2D_AVX2
+	while(pBytesEnd - pBytes >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)pBytes, _mm256_loadu_si256((const __m256i*)pSourceBytes));
+		pBytes 			+= 32;
+		pSourceBytes 	+= 32;
+	}
+#endif
+
+#ifdef K15_RENDERER_2D_SSE2
+	while(pBytesEnd - pBytes >= 16)
+	{
+		_mm_storeu_si128((__m128i*)pBytes, _mm_loadu_si128((const __m128i*)pSourceBytes));
+		pBytes 			+= 16;
+		pSourceBytes 	+= 16;
+	}
+#endif
+
+	while(pBytes < pBytesEnd)
+	{
+		*pBytes++ = *pSourceBytes++;
+	}
 }
 
-ksr2_rgba_color ksr2_color_green()
+#ifdef K15_RENDERER_2D_SSE2
+ksr2_internal __m128i ksr2_expand_5_bit_sse2(__m128i value)
 {
-	return ksr2_rgb_color_uint8(0x00, 0xFF, 0x00);
+	return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
 }
 
-ksr2_rgba_color ksr2_color_blue()
+ksr2_internal __m128i ksr2_expand_6_bit_sse2(__m128i value)
 {
-	return ksr2_rgb_color_uint8(0x00, 0x00, 0xFF);
+	return _mm_or_si128(_mm_slli_epi16(value, 2), _mm_srli_epi16(value, 4));
 }
 
-ksr2_rgba_color ksr2_color_yellow()
+//FK: Splits 8 RGB565 pixels into their 8 bit channels, one 16 bit lane per pixel.
+ksr2_internal void ksr2_unpack_rgb565_sse2(__m128i pixelVector, __m128i* pOutRed, __m128i* pOutGreen, __m128i* pOutBlue)
 {
-	return ksr2_rgb_color_uint8(0xFF, 0xFF, 0x00);
+	*pOutRed 	= ksr2_expand_5_bit_sse2(_mm_srli_epi16(pixelVector, 11));
+	*pOutGreen 	= ksr2_expand_6_bit_sse2(_mm_and_si128(_mm_srli_epi16(pixelVector, 5), _mm_set1_epi16(0x3F)));
+	*pOutBlue 	= ksr2_expand_5_bit_sse2(_mm_and_si128(pixelVector, _mm_set1_epi16(0x1F)));
 }
 
-ksr2_rgba_color ksr2_color_magenta()
+ksr2_internal __m128i ksr2_pack_rgb565_sse2(__m128i red, __m128i green, __m128i blue)
 {
-	return ksr2_rgb_color_uint8(0xFF, 0x00, 0xFF);
+	const __m128i redVector 	= _mm_slli_epi16(_mm_srli_epi16(red, 3), 11);
+	const __m128i greenVector 	= _mm_slli_epi16(_mm_srli_epi16(green, 2), 5);
+	return _mm_or_si128(_mm_or_si128(redVector, greenVector), _mm_srli_epi16(blue, 3));
 }
 
-ksr2_rgba_color ksr2_color_cyan()
+//FK: One channel of 8 RGBA pixels (4 per vector) in 16 bit lanes, shift selects the channel.
+ksr2_internal __m128i ksr2_gather_channel_sse2(__m128i firstVector, __m128i secondVector, int shift)
 {
-	return ksr2_rgb_color_uint8(0x00, 0xFF, 0xFF);
+	const __m128i shiftVector 	= _mm_cvtsi32_si128(shift);
+	const __m128i channelMask 	= _mm_set1_epi32(0xFF);
+	return _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(firstVector, shiftVector), channelMask), _mm_and_si128(_mm_srl_epi32(secondVector, shiftVector), channelMask));
 }
 
-ksr2_rgba_color ksr2_color_white()
+ksr2_internal __m128i ksr2_get_luma_sse2(__m128i red, __m128i green, __m128i blue)
 {
-	return ksr2_rgb_color_uint8(0xFF, 0xFF, 0xFF);
+	//FK: the weighted sum doesn't exceed 16 bit
+	__m128i lumaVector = _mm_add_epi16(_mm_mullo_epi16(red, _mm_set1_epi16(77)), _mm_mullo_epi16(green, _mm_set1_epi16(150)));
+	lumaVector = _mm_add_epi16(lumaVector, _mm_add_epi16(_mm_mullo_epi16(blue, _mm_set1_epi16(29)), _mm_set1_epi16(128)));
+	return _mm_srli_epi16(lumaVector, 8);
 }
 
-ksr2_rgba_color ksr2_color_black()
+//FK: saturate(add + channel * scale / 255) for 8 bit values in 16 bit lanes
+ksr2_internal __m128i ksr2_blend_channel_sse2(__m128i channel, __m128i scale, __m128i add)
 {
-	return ksr2_rgb_color_uint8(0x00, 0x00, 0x00);
+	return _mm_min_epi16(_mm_add_epi16(ksr2_div255_sse2(_mm_mullo_epi16(channel, scale)), add), _mm_set1_epi16(0xFF));
 }
 
-ksr2_pixel_color ksr2_convert_to_pixel_format(ksr2_rgba_color color, ksr2_pixel_format format)
+//FK: Blends one channel of premultiplied image pixels, see ksr2_init_image_blend_operand().
+ksr2_force_inline __m128i ksr2_blend_image_channel_sse2(__m128i channel, __m128i sourceChannel, __m128i inverseAlpha, ksr2_blend_mode blendMode)
 {
-	if (format == K15_RENDERER_2D_PIXEL_FORMAT_ARGB)
+	switch(blendMode)
 	{
-			return (ksr2_pixel_color)( (ksr2_u32)color.a << 24u |
-								(ksr2_u32)color.r << 16u |
-								(ksr2_u32)color.g <<  8u |
-								(ksr2_u32)color.b <<  0u );
-	}
+		case K15_RENDERER_2D_BLEND_MODE_ADDITIVE:
+			return _mm_min_epi16(_mm_add_epi16(channel, sourceChannel), _mm_set1_epi16(0xFF));
 
-	return (ksr2_pixel_color)( (ksr2_u32)color.r << 24u |
-							(ksr2_u32)color.g << 16u |
-							(ksr2_u32)color.b <<  8u |
-							(ksr2_u32)color.a <<  0u );
+		case K15_RENDERER_2D_BLEND_MODE_MULTIPLY:
+			return ksr2_div255_sse2(_mm_mullo_epi16(channel, _mm_add_epi16(sourceChannel, inverseAlpha)));
+
+		default:
+			return ksr2_blend_channel_sse2(channel, inverseAlpha, sourceChannel);
+	}
 }
+#endif
 
-ksr2_result ksr2_init_context(const ksr2_context_parameters* pParameters, ksr2_contexthandle* pOutContextHandle)
+//FK: RGB565 kernels, every channel gets expanded to 8 bit, blended like a channel of a 32 bit pixel and rounded down again.
+ksr2_internal void ksr2_blend_span_16(ksr2_u16* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand)
 {
-	ksr2_debug_fnc debugFnc = pParameters != ksr2_nullptr ? pParameters->debugFnc : ksr2_nullptr;
-	
-	if (debugFnc == ksr2_nullptr)
+	ksr2_u16* pPixelsEnd = pPixels + pixelCount;
+
+#ifdef K15_RENDERER_2D_SSE2
 	{
-		debugFnc = ksr2_debug_fnc_stub;
+		const __m128i redScale 		= _mm_set1_epi16((short)(pOperand->scale >> 24u));
+		const __m128i greenScale 	= _mm_set1_epi16((short)((pOperand->scale >> 16u) & 0xFFu));
+		const __m128i blueScale 	= _mm_set1_epi16((short)((pOperand->scale >> 8u) & 0xFFu));
+		const __m128i redAdd 		= _mm_set1_epi16((short)(pOperand->add >> 24u));
+		const __m128i greenAdd 		= _mm_set1_epi16((short)((pOperand->add >> 16u) & 0xFFu));
+		const __m128i blueAdd 		= _mm_set1_epi16((short)((pOperand->add >> 8u) & 0xFFu));
+
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			__m128i red, green, blue;
+			ksr2_unpack_rgb565_sse2(_mm_loadu_si128((const __m128i*)pPixels), &red, &green, &blue);
+
+			red 	= ksr2_blend_channel_sse2(red, redScale, redAdd);
+			green 	= ksr2_blend_channel_sse2(green, greenScale, greenAdd);
+			blue 	= ksr2_blend_channel_sse2(blue, blueScale, blueAdd);
+
+			_mm_storeu_si128((__m128i*)pPixels, ksr2_pack_rgb565_sse2(red, green, blue));
+			pPixels += 8;
+		}
 	}
-	
-	if (pParameters == ksr2_nullptr)
+#endif
+
+	while(pPixels < pPixelsEnd)
 	{
-		debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "pParameter in 'ksr2_init_context' is NULL.\n");
-		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		const ksr2_pixel_color color = ksr2_blend_pixel(ksr2_unpack_pixel(*pPixels, K15_RENDERER_2D_PIXEL_FORMAT_RGB565), pOperand);
+		*pPixels++ = (ksr2_u16)ksr2_pack_pixel(color, K15_RENDERER_2D_PIXEL_FORMAT_RGB565);
 	}
+}
 
-	ksr2_context* pContext = ksr2_nullptr;
-	ksr2_linear_allocator allocator;
-	ksr2_init_linear_allocator(&allocator, pParameters->pMemory, pParameters->memorySizeInBytes);
-	ksr2_u32 contextFlags = 0u;
+//FK: Image pixels are RGBA, see ksr2_get_color_format().
+ksr2_force_inline void ksr2_blend_image_span_16(ksr2_u16* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode blendMode)
+{
+	ksr2_u16* pPixelsEnd = pPixels + pixelCount;
 
-	ksr2_result result = ksr2_allocate_from_linear_allocator_front(&pContext, &allocator, sizeof(ksr2_context), ksr2_default_alignment);
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const ksr2_b32 checkAlpha 	= blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA;
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i alphaVector 	= _mm_set1_epi16(0xFF);
 
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			const __m128i firstSourceVector 	= _mm_loadu_si128((const __m128i*)pSourcePixels);
+			const __m128i secondSourceVector 	= _mm_loadu_si128((const __m128i*)(pSourcePixels + 4));
+
+			const __m128i sourceRed 	= ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 24);
+			const __m128i sourceGreen 	= ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 16);
+			const __m128i sourceBlue 	= ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 8);
+			const __m128i sourceAlpha 	= ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 0);
+
+			if (checkAlpha)
+			{
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_or_si128(firstSourceVector, secondSourceVector), zeroVector)) == 0xFFFF)
+				{
+					pPixels 		+= 8;
+					pSourcePixels 	+= 8;
+					continue;
+				}
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(sourceAlpha, alphaVector)) == 0xFFFF)
+				{
+					_mm_storeu_si128((__m128i*)pPixels, ksr2_pack_rgb565_sse2(sourceRed, sourceGreen, sourceBlue));
+					pPixels 		+= 8;
+					pSourcePixels 	+= 8;
+					continue;
+				}
+			}
+
+			const __m128i inverseAlpha = _mm_xor_si128(sourceAlpha, alphaVector);
+
+			__m128i red, green, blue;
+			ksr2_unpack_rgb565_sse2(_mm_loadu_si128((const __m128i*)pPixels), &red, &green, &blue);
+
+			red 	= ksr2_blend_image_channel_sse2(red, sourceRed, inverseAlpha, blendMode);
+			green 	= ksr2_blend_image_channel_sse2(green, sourceGreen, inverseAlpha, blendMode);
+			blue 	= ksr2_blend_image_channel_sse2(blue, sourceBlue, inverseAlpha, blendMode);
+
+			_mm_storeu_si128((__m128i*)pPixels, ksr2_pack_rgb565_sse2(red, green, blue));
+			pPixels 		+= 8;
+			pSourcePixels 	+= 8;
+		}
+	}
+#endif
+
+	while(pPixels < pPixelsEnd)
 	{
-		//debugFnc(ksr2_invalid_context_handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "Not enough memory. need at least %u bytes for context.\n", sizeof(ksr2_context));
-		return result;
+		ksr2_blend_operand operand;
+		ksr2_init_image_blend_operand(&operand, *pSourcePixels++, blendMode, 0u);
+
+		const ksr2_pixel_color color = ksr2_blend_pixel(ksr2_unpack_pixel(*pPixels, K15_RENDERER_2D_PIXEL_FORMAT_RGB565), &operand);
+		*pPixels++ = (ksr2_u16)ksr2_pack_pixel(color, K15_RENDERER_2D_PIXEL_FORMAT_RGB565);
 	}
+}
 
-	const ksr2_u32 swapChainImageCount = (pParameters->flags & K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG) > 0u ? 2u : 1u;
-	void* pImages = pParameters->pPreAllocatedBackBuffers;
+//FK: A8 and GRAY8 kernels. The operand gets converted to the format once, A8 keeps the alpha channel and GRAY8 the luma of it.
+//	  The luma of an inverse alpha that got broadcast to all channels is the inverse alpha itself.
+ksr2_force_inline void ksr2_blend_span_8(ksr2_u8* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand, ksr2_pixel_format format)
+{
+	ksr2_u8* pPixelsEnd = pPixels + pixelCount;
+	const ksr2_u32 scale 	= ksr2_pack_pixel(pOperand->scale, format);
+	const ksr2_u32 add 		= ksr2_pack_pixel(pOperand->add, format);
 
-	if (pImages == ksr2_nullptr)
+#ifdef K15_RENDERER_2D_SSE2
 	{
-		contextFlags |= K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP;
-
-		result = ksr2_allocate_swap_chain_images(pImages, swapChainImageCount, &allocator, 
-			pParameters->backBufferWidth, pParameters->backBufferHeight, pParameters->backBufferFormat);
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i scaleVector 	= _mm_set1_epi16((short)scale);
+		const __m128i addVector 	= _mm_set1_epi8((char)add);
 
-		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+		while(pPixelsEnd - pPixels >= 16)
 		{
-			return result;
+			const __m128i pixelVector = _mm_loadu_si128((const __m128i*)pPixels);
+			const __m128i lowVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixelVector, zeroVector), scaleVector));
+			const __m128i highVector = ksr2_div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixelVector, zeroVector), scaleVector));
+
+			_mm_storeu_si128((__m128i*)pPixels, _mm_adds_epu8(_mm_packus_epi16(lowVector, highVector), addVector));
+			pPixels += 16;
 		}
 	}
+#endif
 
-	result = ksr2_init_swap_chain(&pContext->swapChain, &allocator, pImages, swapChainImageCount, pParameters->backBufferWidth, pParameters->backBufferHeight, pParameters->backBufferFormat);
-
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	while(pPixels < pPixelsEnd)
 	{
-		return result;
+		const ksr2_u32 value = ksr2_div255(*pPixels * scale) + add;
+		*pPixels++ = (ksr2_u8)(value > 0xFFu ? 0xFFu : value);
 	}
+}
 
-	ksr2_init_fourcc(pContext->fourcc, "KR2C");
+ksr2_force_inline void ksr2_blend_image_span_8(ksr2_u8* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode blendMode, ksr2_pixel_format format)
+{
+	ksr2_u8* pPixelsEnd = pPixels + pixelCount;
 
-	pContext->allocator 		= allocator;
-	pContext->pFirstDrawCommand = ksr2_nullptr;
-	pContext->flags 			= contextFlags;
+#ifdef K15_RENDERER_2D_SSE2
+	{
+		const ksr2_b32 checkAlpha 	= blendMode == K15_RENDERER_2D_BLEND_MODE_ALPHA;
+		const ksr2_b32 useLuma 		= format == K15_RENDERER_2D_PIXEL_FORMAT_GRAY8;
+		const __m128i zeroVector 	= _mm_setzero_si128();
+		const __m128i alphaVector 	= _mm_set1_epi16(0xFF);
 
-	ksr2_contexthandle handle = (ksr2_contexthandle)(pContext);
-	*pOutContextHandle = handle;
+		while(pPixelsEnd - pPixels >= 8)
+		{
+			const __m128i firstSourceVector 	= _mm_loadu_si128((const __m128i*)pSourcePixels);
+			const __m128i secondSourceVector 	= _mm_loadu_si128((const __m128i*)(pSourcePixels + 4));
+			const __m128i sourceAlpha 			= ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 0);
+
+			if (checkAlpha && _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_or_si128(firstSourceVector, secondSourceVector), zeroVector)) == 0xFFFF)
+			{
+				pPixels 		+= 8;
+				pSourcePixels 	+= 8;
+				continue;
+			}
+
+			__m128i sourceValue = sourceAlpha;
+
+			if (useLuma)
+			{
+				sourceValue = ksr2_get_luma_sse2(ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 24), 
+					ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 16), ksr2_gather_channel_sse2(firstSourceVector, secondSourceVector, 8));
+			}
+
+			const __m128i pixelVector = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)pPixels), zeroVector);
+			const __m128i resultVector = ksr2_blend_image_channel_sse2(pixelVector, sourceValue, _mm_xor_si128(sourceAlpha, alphaVector), blendMode);
+
+			_mm_storel_epi64((__m128i*)pPixels, _mm_packus_epi16(resultVector, zeroVector));
+			pPixels 		+= 8;
+			pSourcePixels 	+= 8;
+		}
+	}
+#endif
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+	while(pPixels < pPixelsEnd)
+	{
+		ksr2_blend_operand operand;
+		ksr2_init_image_blend_operand(&operand, *pSourcePixels++, blendMode, 0u);
+
+		const ksr2_u32 value = ksr2_div255(*pPixels * ksr2_pack_pixel(operand.scale, format)) + ksr2_pack_pixel(operand.add, format);
+		*pPixels++ = (ksr2_u8)(value > 0xFFu ? 0xFFu : value);
+	}
 }
 
-void ksr2_destroy_context(ksr2_contexthandle handle)
+#ifdef K15_RENDERER_2D_SSE2
+ksr2_internal __m128i ksr2_swap_red_blue_sse2(__m128i pixelVector)
 {
-	ksr2_assert(handle != ksr2_invalid_context_handle);
+	const __m128i redBlueMask = _mm_set1_epi32((int)0xFF00FF00u);
+	const __m128i swappedVector = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixelVector, 16), _mm_set1_epi32(0xFF00)), _mm_and_si128(_mm_slli_epi32(pixelVector, 16), _mm_set1_epi32((int)0xFF000000u)));
+	return _mm_or_si128(_mm_andnot_si128(redBlueMask, pixelVector), swappedVector);
 }
+#endif
 
-void ksr2_swap_buffers(ksr2_contexthandle handle)
+//FK: RGBA pixels to pixels of the given format, see ksr2_pack_pixel(). pPixels and pOutPixels can be the same for 32 bit formats.
+ksr2_force_inline void ksr2_convert_pixels_from_rgba(ksr2_byte* pOutPixels, const ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_pixel_format format)
 {
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	ksr2_u32 index = 0u;
 
-	if (pContext->swapChain.imageIndex + 1u == pContext->swapChain.imageCount)
+#ifdef K15_RENDERER_2D_SSE2
+	switch(format)
 	{
-		pContext->swapChain.imageIndex = 0u;
-	} 
-	else
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+			for (; index + 4u <= pixelCount; index += 4u)
+			{
+				const __m128i pixelVector = _mm_loadu_si128((const __m128i*)(pPixels + index));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index * 4u), _mm_or_si128(_mm_srli_epi32(pixelVector, 8), _mm_slli_epi32(pixelVector, 24)));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			for (; index + 4u <= pixelCount; index += 4u)
+			{
+				const __m128i pixelVector = _mm_loadu_si128((const __m128i*)(pPixels + index));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index * 4u), ksr2_swap_red_blue_sse2(pixelVector));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				const __m128i firstVector 	= _mm_loadu_si128((const __m128i*)(pPixels + index));
+				const __m128i secondVector 	= _mm_loadu_si128((const __m128i*)(pPixels + index + 4u));
+				const __m128i red 			= ksr2_gather_channel_sse2(firstVector, secondVector, 24);
+				const __m128i green 		= ksr2_gather_channel_sse2(firstVector, secondVector, 16);
+				const __m128i blue 			= ksr2_gather_channel_sse2(firstVector, secondVector, 8);
+				_mm_storeu_si128((__m128i*)(pOutPixels + index * 2u), ksr2_pack_rgb565_sse2(red, green, blue));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				const __m128i alpha = ksr2_gather_channel_sse2(_mm_loadu_si128((const __m128i*)(pPixels + index)), _mm_loadu_si128((const __m128i*)(pPixels + index + 4u)), 0);
+				_mm_storel_epi64((__m128i*)(pOutPixels + index), _mm_packus_epi16(alpha, alpha));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				const __m128i firstVector 	= _mm_loadu_si128((const __m128i*)(pPixels + index));
+				const __m128i secondVector 	= _mm_loadu_si128((const __m128i*)(pPixels + index + 4u));
+				const __m128i luma 			= ksr2_get_luma_sse2(ksr2_gather_channel_sse2(firstVector, secondVector, 24), 
+					ksr2_gather_channel_sse2(firstVector, secondVector, 16), ksr2_gather_channel_sse2(firstVector, secondVector, 8));
+				_mm_storel_epi64((__m128i*)(pOutPixels + index), _mm_packus_epi16(luma, luma));
+			}
+		break;
+
+		default:
+		break;
+	}
+#endif
+
+	switch(ksr2_get_pixel_size_in_bytes(format))
 	{
-		++pContext->swapChain.imageIndex;
+		case 1u:
+			for (; index < pixelCount; ++index)
+			{
+				pOutPixels[index] = (ksr2_u8)ksr2_pack_pixel(pPixels[index], format);
+			}
+		break;
+
+		case 2u:
+			for (; index < pixelCount; ++index)
+			{
+				((ksr2_u16*)pOutPixels)[index] = (ksr2_u16)ksr2_pack_pixel(pPixels[index], format);
+			}
+		break;
+
+		default:
+			for (; index < pixelCount; ++index)
+			{
+				((ksr2_u32*)pOutPixels)[index] = ksr2_pack_pixel(pPixels[index], format);
+			}
+		break;
 	}
-	
-	pContext->swapChain.pCurrentImage = (ksr2_u32*)pContext->swapChain.pImages + (pContext->swapChain.width * pContext->swapChain.height) * pContext->swapChain.imageIndex;
 }
 
-unsigned char* ksr2_get_presenting_image_data(ksr2_contexthandle handle)
+//FK: ksr2_convert_pixels_from_rgba() for the kernel table, the paint kernels inline it instead.
+ksr2_internal void ksr2_convert_span_from_rgba(ksr2_byte* pOutPixels, const ksr2_pixel_color* pPixels, ksr2_u32 pixelCount, ksr2_pixel_format format)
 {
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
-	return (unsigned char*)pContext->swapChain.pCurrentImage;
+	ksr2_convert_pixels_from_rgba(pOutPixels, pPixels, pixelCount, format);
 }
 
-void ksr2_blit(ksr2_contexthandle handle)
+//FK: Pixels of the given format to RGBA pixels, see ksr2_unpack_pixel(). pPixels and pOutPixels can be the same for 32 bit formats.
+ksr2_internal void ksr2_convert_pixels_to_rgba(ksr2_pixel_color* pOutPixels, const ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_format format)
 {
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
-
-	ksr2_draw_command_header* pDrawCommand = pContext->pFirstDrawCommand;
+	ksr2_u32 index = 0u;
 
-	while(pDrawCommand != ksr2_nullptr)
+#ifdef K15_RENDERER_2D_SSE2
+	switch(format)
 	{
-		switch(pDrawCommand->type)
-		{
-			case K15_RENDERER_2D_DRAW_COMMAND_LINE:
-				ksr2_issue_line_draw_command(pContext, pDrawCommand);
-			break;
+		case K15_RENDERER_2D_PIXEL_FORMAT_ARGB:
+			for (; index + 4u <= pixelCount; index += 4u)
+			{
+				const __m128i pixelVector = _mm_loadu_si128((const __m128i*)(pPixels + index * 4u));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_or_si128(_mm_slli_epi32(pixelVector, 8), _mm_srli_epi32(pixelVector, 24)));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_BGRA:
+			for (; index + 4u <= pixelCount; index += 4u)
+			{
+				const __m128i pixelVector = _mm_loadu_si128((const __m128i*)(pPixels + index * 4u));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index), ksr2_swap_red_blue_sse2(pixelVector));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_RGB565:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				__m128i red, green, blue;
+				ksr2_unpack_rgb565_sse2(_mm_loadu_si128((const __m128i*)(pPixels + index * 2u)), &red, &green, &blue);
+
+				//FK: 0xRRGG in the upper and 0xBBAA in the lower 16 bit of every pixel
+				const __m128i redGreen 	= _mm_or_si128(_mm_slli_epi16(red, 8), green);
+				const __m128i blueAlpha = _mm_or_si128(_mm_slli_epi16(blue, 8), _mm_set1_epi16(0xFF));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_unpacklo_epi16(blueAlpha, redGreen));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index + 4u), _mm_unpackhi_epi16(blueAlpha, redGreen));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_A8:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				__m128i alpha = _mm_loadl_epi64((const __m128i*)(pPixels + index));
+				alpha = _mm_unpacklo_epi8(alpha, alpha);
+				_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_unpacklo_epi16(alpha, alpha));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index + 4u), _mm_unpackhi_epi16(alpha, alpha));
+			}
+		break;
+
+		case K15_RENDERER_2D_PIXEL_FORMAT_GRAY8:
+			for (; index + 8u <= pixelCount; index += 8u)
+			{
+				const __m128i luma 		= _mm_loadl_epi64((const __m128i*)(pPixels + index));
+				const __m128i redGreen 	= _mm_unpacklo_epi8(luma, luma);
+				const __m128i blueAlpha = _mm_unpacklo_epi8(_mm_set1_epi8((char)0xFF), luma);
+				_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_unpacklo_epi16(blueAlpha, redGreen));
+				_mm_storeu_si128((__m128i*)(pOutPixels + index + 4u), _mm_unpackhi_epi16(blueAlpha, redGreen));
+			}
+		break;
 
-			case K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT:
-				ksr2_issue_filled_rect_draw_command(pContext, pDrawCommand);
-			break;
+		default:
+		break;
+	}
+#endif
 
-			default:
-				ksr2_assert(ksr2_false);
-			break;
-		}	
+	switch(ksr2_get_pixel_size_in_bytes(format))
+	{
+		case 1u:
+			for (; index < pixelCount; ++index)
+			{
+				pOutPixels[index] = ksr2_unpack_pixel(pPixels[index], format);
+			}
+		break;
+
+		case 2u:
+			for (; index < pixelCount; ++index)
+			{
+				pOutPixels[index] = ksr2_unpack_pixel(((const ksr2_u16*)pPixels)[index], format);
+			}
+		break;
 
-		pDrawCommand = (ksr2_draw_command_header*)pDrawCommand->pNext;
+		default:
+			for (; index < pixelCount; ++index)
+			{
+				pOutPixels[index] = ksr2_unpack_pixel(((const ksr2_u32*)pPixels)[index], format);
+			}
+		break;
 	}
+}
 
-	pContext->pFirstDrawCommand = ksr2_nullptr;
-	ksr2_reset_allocator_back(&pContext->allocator);
+//FK: Kernels of a pixel format and blend mode, colors and image pixels are in the format of ksr2_get_color_format().
+//	  Get inlined into the kernels of every format and blend mode with constant arguments, see K15_RENDERER_2D_DEFINE_PIXEL_KERNELS.
+ksr2_force_inline void ksr2_paint_format_span(ksr2_byte* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand, ksr2_pixel_format format, ksr2_blend_mode blendMode)
+{
+	switch(ksr2_get_pixel_size_in_bytes(format))
+	{
+		case 2u:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_fill_bytes(pPixels, (size_t)pixelCount * 2u, ksr2_pack_pixel(pOperand->add, format) * 0x00010001u, 2u);
+			}
+			else
+			{
+				ksr2_blend_span_16((ksr2_u16*)pPixels, pixelCount, pOperand);
+			}
+		break;
+
+		case 1u:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_fill_bytes(pPixels, pixelCount, ksr2_pack_pixel(pOperand->add, format) * 0x01010101u, 1u);
+			}
+			else
+			{
+				ksr2_blend_span_8(pPixels, pixelCount, pOperand, format);
+			}
+		break;
 
-	return;
+		default:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_fill_span((ksr2_pixel_color*)pPixels, pixelCount, pOperand->add);
+			}
+			else if (blendMode == K15_RENDERER_2D_BLEND_MODE_ADDITIVE)
+			{
+				ksr2_add_span((ksr2_pixel_color*)pPixels, pixelCount, pOperand);
+			}
+			else
+			{
+				ksr2_blend_span((ksr2_pixel_color*)pPixels, pixelCount, pOperand);
+			}
+		break;
+	}
 }
 
-ksr2_result ksr2_resize_swap_chain(ksr2_contexthandle handle, const ksr2_resize_swapchain_parameters* pParameters)
+ksr2_force_inline void ksr2_paint_format_image_span(ksr2_byte* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_pixel_format format, ksr2_blend_mode blendMode)
 {
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
-	if(pContext == ksr2_nullptr)
+	switch(ksr2_get_pixel_size_in_bytes(format))
 	{
-		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		case 2u:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_convert_pixels_from_rgba(pPixels, pSourcePixels, pixelCount, format);
+			}
+			else
+			{
+				ksr2_blend_image_span_16((ksr2_u16*)pPixels, pSourcePixels, pixelCount, blendMode);
+			}
+		break;
+
+		case 1u:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_convert_pixels_from_rgba(pPixels, pSourcePixels, pixelCount, format);
+			}
+			else
+			{
+				ksr2_blend_image_span_8(pPixels, pSourcePixels, pixelCount, blendMode, format);
+			}
+		break;
+
+		default:
+			if (blendMode == K15_RENDERER_2D_BLEND_MODE_OPAQUE)
+			{
+				ksr2_copy_span((ksr2_pixel_color*)pPixels, pSourcePixels, pixelCount);
+			}
+			else
+			{
+				ksr2_blend_image_span((ksr2_pixel_color*)pPixels, pSourcePixels, pixelCount, blendMode, ksr2_get_alpha_shift(format));
+			}
+		break;
 	}
+}
 
-	if ((pContext->flags & K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP) == 0 && pParameters->pPreAllocatedBackBuffers == ksr2_nullptr)
+ksr2_force_inline void ksr2_fill_format_span(ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color, ksr2_pixel_format format, ksr2_b32 nonTemporal)
+{
+	const ksr2_u32 pixelSizeInBytes = (ksr2_u32)ksr2_get_pixel_size_in_bytes(format);
+
+	if (pixelSizeInBytes == 4u && nonTemporal)
 	{
-		pContext->debugFnc(handle, K15_RENDERER_2D_DEBUG_CATEGORY_ERROR, "context was created with pre allocated back buffer, however no pre allocated back buffer was passed for ksr2_resize_swap_chain.");
-		return K15_RENDERER_2D_RESULT_INVALID_ARGUMENT;
+		ksr2_fill_span_non_temporal((ksr2_pixel_color*)pPixels, pixelCount, color);
 	}
-
-	if (pContext->flags & K15_RENDERER_2D_SWAPCHAIN_IMAGE_OWNERSHIP)
+	else if (pixelSizeInBytes == 4u)
 	{
-		ksr2_destroy_swap_chain_images(&pContext->swapChain, &pContext->allocator);
-
-		ksr2_result result = ksr2_allocate_swap_chain_images(pContext->swapChain.pImages, pContext->swapChain.imageCount, &pContext->allocator, pParameters->backBufferWidth, pParameters->backBufferHeight, pContext->swapChain.format);
-
-		if (result != K15_RENDERER_2D_RESULT_SUCCESS)
-		{
-			return result;
-		}
+		ksr2_fill_span((ksr2_pixel_color*)pPixels, pixelCount, color);
 	}
 	else
 	{
-		pContext->swapChain.pImages = pParameters->pPreAllocatedBackBuffers;
+		const ksr2_u32 pattern = ksr2_pack_pixel(color, format) * (pixelSizeInBytes == 2u ? 0x00010001u : 0x01010101u);
+
+		if (nonTemporal)
+		{
+			ksr2_fill_bytes_non_temporal(pPixels, (size_t)pixelCount * pixelSizeInBytes, pattern, pixelSizeInBytes);
+		}
+		else
+		{
+			ksr2_fill_bytes(pPixels, (size_t)pixelCount * pixelSizeInBytes, pattern, pixelSizeInBytes);
+		}
 	}
+}
 
-	pContext->swapChain.width = pParameters->backBufferWidth;
-	pContext->swapChain.height = pParameters->backBufferHeight;
-	pContext->swapChain.pCurrentImage = (ksr2_u32*)pContext->swapChain.pImages + (pContext->swapChain.height * pContext->swapChain.width) * pContext->swapChain.imageIndex;
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+//FK: Generic kernels, the format and blend mode get passed at runtime. Used with K15_RENDERER_2D_GENERIC_KERNELS_FLAG.
+ksr2_internal void ksr2_paint_span_generic(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand)
+{
+	ksr2_paint_format_span(pPixels, pixelCount, pOperand, pTarget->format, pOperand->blendMode);
 }
 
-ksr2_result ksr2_draw_line(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, unsigned int thickness, ksr2_rgba_color color)
+ksr2_internal void ksr2_paint_image_span_generic(const ksr2_render_target* pTarget, ksr2_byte* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode blendMode)
 {
-	if (thickness == 0u)
-	{
-		return K15_RENDERER_2D_RESULT_SUCCESS;
-	}
+	ksr2_paint_format_image_span(pPixels, pSourcePixels, pixelCount, pTarget->format, blendMode);
+}
 
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+ksr2_internal void ksr2_fill_span_generic(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color)
+{
+	ksr2_fill_format_span(pPixels, pixelCount, color, pTarget->format, ksr2_false);
+}
 
-	x1 = ksr2_clamp(x1, 0, (ksr2_s32)pContext->swapChain.width);
-	x2 = ksr2_clamp(x2, 0, (ksr2_s32)pContext->swapChain.width);
-	y1 = ksr2_clamp(y1, 0, (ksr2_s32)pContext->swapChain.height);
-	y2 = ksr2_clamp(y2, 0, (ksr2_s32)pContext->swapChain.height);
+ksr2_internal void ksr2_fill_span_non_temporal_generic(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color)
+{
+	ksr2_fill_format_span(pPixels, pixelCount, color, pTarget->format, ksr2_true);
+}
 
-	if (x1 == x2 || y1 == y2)
-	{
-		return K15_RENDERER_2D_RESULT_SUCCESS;
+//FK: Instantiates the kernels of a blend mode for a pixel format, the arguments the kernel table passes at runtime are unused.
+#define K15_RENDERER_2D_DEFINE_BLEND_MODE_KERNELS(name, format, blendMode) \
+	ksr2_internal void ksr2_kernel_name(ksr2_paint_span_##name)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, const ksr2_blend_operand* pOperand) \
+	{ \
+		ksr2_use_argument(pTarget); \
+		ksr2_paint_format_span(pPixels, pixelCount, pOperand, format, blendMode); \
+	} \
+	ksr2_internal void ksr2_kernel_name(ksr2_paint_image_span_##name)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, const ksr2_pixel_color* pSourcePixels, ksr2_u32 pixelCount, ksr2_blend_mode runtimeBlendMode) \
+	{ \
+		ksr2_use_argument(pTarget); \
+		ksr2_use_argument(runtimeBlendMode); \
+		ksr2_paint_format_image_span(pPixels, pSourcePixels, pixelCount, format, blendMode); \
 	}
 
-	ksr2_line_draw_command* pDrawCommand = ksr2_nullptr;
-	ksr2_result result = ksr2_allocate_draw_command(&pDrawCommand, pContext, sizeof(ksr2_line_draw_command), K15_RENDERER_2D_DRAW_COMMAND_LINE);
-
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
-	{
-		return result;
+//FK: Instantiates all kernels of a pixel format, K15_RENDERER_2D_PIXEL_KERNELS(name) puts them into a ksr2_pixel_kernels.
+#define K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(name, format) \
+	K15_RENDERER_2D_DEFINE_BLEND_MODE_KERNELS(opaque_##name, format, K15_RENDERER_2D_BLEND_MODE_OPAQUE) \
+	K15_RENDERER_2D_DEFINE_BLEND_MODE_KERNELS(alpha_##name, format, K15_RENDERER_2D_BLEND_MODE_ALPHA) \
+	K15_RENDERER_2D_DEFINE_BLEND_MODE_KERNELS(additive_##name, format, K15_RENDERER_2D_BLEND_MODE_ADDITIVE) \
+	K15_RENDERER_2D_DEFINE_BLEND_MODE_KERNELS(multiply_##name, format, K15_RENDERER_2D_BLEND_MODE_MULTIPLY) \
+	ksr2_internal void ksr2_kernel_name(ksr2_fill_span_##name)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color) \
+	{ \
+		ksr2_use_argument(pTarget); \
+		ksr2_fill_format_span(pPixels, pixelCount, color, format, ksr2_false); \
+	} \
+	ksr2_internal void ksr2_kernel_name(ksr2_fill_span_non_temporal_##name)(const ksr2_render_target* pTarget, ksr2_byte* pPixels, ksr2_u32 pixelCount, ksr2_pixel_color color) \
+	{ \
+		ksr2_use_argument(pTarget); \
+		ksr2_fill_format_span(pPixels, pixelCount, color, format, ksr2_true); \
 	}
-	
-	pDrawCommand->x1 		= (ksr2_u32)x1;
-	pDrawCommand->y1 		= (ksr2_u32)y1;
-	pDrawCommand->x2 		= (ksr2_u32)x2;
-	pDrawCommand->y2 		= (ksr2_u32)y2;
-	pDrawCommand->thickness = thickness;
-	pDrawCommand->color 	= ksr2_convert_to_pixel_format(color, pContext->swapChain.format);
 
-	ksr2_push_draw_command(pContext, pDrawCommand);
+#define K15_RENDERER_2D_PIXEL_KERNELS(name, redShift, greenShift, blueShift, alphaShift) \
+	{ \
+		{ksr2_kernel_name(ksr2_paint_span_opaque_##name), ksr2_kernel_name(ksr2_paint_span_alpha_##name), ksr2_kernel_name(ksr2_paint_span_additive_##name), ksr2_kernel_name(ksr2_paint_span_multiply_##name)}, \
+		{ksr2_kernel_name(ksr2_paint_image_span_opaque_##name), ksr2_kernel_name(ksr2_paint_image_span_alpha_##name), ksr2_kernel_name(ksr2_paint_image_span_additive_##name), ksr2_kernel_name(ksr2_paint_image_span_multiply_##name)}, \
+		ksr2_kernel_name(ksr2_fill_span_##name), ksr2_kernel_name(ksr2_fill_span_non_temporal_##name), ksr2_kernel_name(ksr2_convert_colors_##name), \
+		ksr2_copy_bytes, ksr2_modulate_coverage_span, {ksr2_resolve_nonzero_coverage_span, ksr2_resolve_even_odd_coverage_span}, \
+		ksr2_convert_span_from_rgba, ksr2_convert_pixels_to_rgba, \
+		{redShift, greenShift, blueShift, alphaShift} \
+	}
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
-}
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(rgba, 		K15_RENDERER_2D_PIXEL_FORMAT_RGBA)
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(argb, 		K15_RENDERER_2D_PIXEL_FORMAT_ARGB)
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(bgra, 		K15_RENDERER_2D_PIXEL_FORMAT_BGRA)
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(rgb565, 	K15_RENDERER_2D_PIXEL_FORMAT_RGB565)
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(a8, 		K15_RENDERER_2D_PIXEL_FORMAT_A8)
+K15_RENDERER_2D_DEFINE_PIXEL_KERNELS(gray8, 	K15_RENDERER_2D_PIXEL_FORMAT_GRAY8)
 
-ksr2_result ksr2_draw_filled_rect(ksr2_contexthandle handle, int x1, int y1, int x2, int y2, ksr2_rgba_color color)
+//FK: Colors are stored r, g, b, a in memory, so loaded as little endian 32 bit values they are abgr.
+//	  RGBA needs all bytes swapped, ARGB only needs r and b swapped and BGRA is rotated by one byte.
+ksr2_force_inline void ksr2_convert_colors_to_pixel_format(ksr2_pixel_color* pOutPixels, const ksr2_rgba_color* pColors, ksr2_u32 count, ksr2_pixel_format format)
 {
-	ksr2_context* pContext = ksr2_contexthandle_to_context(handle);
+	const ksr2_u32* pValues = (const ksr2_u32*)pColors;
+	ksr2_u32 index = 0u;
+	format = ksr2_get_color_format(format);
 
-	x1 = ksr2_clamp(x1, 0, (ksr2_s32)pContext->swapChain.width);
-	x2 = ksr2_clamp(x2, 0, (ksr2_s32)pContext->swapChain.width);
-	y1 = ksr2_clamp(y1, 0, (ksr2_s32)pContext->swapChain.height);
-	y2 = ksr2_clamp(y2, 0, (ksr2_s32)pContext->swapChain.height);
+#ifdef K15_RENDERER_2D_SSE2
+	if (format == K15_RENDERER_2D_PIXEL_FORMAT_ARGB)
+	{
+		const __m128i greenAlphaMask = _mm_set1_epi32((int)0xFF00FF00u);
+		const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
 
-	if (x1 == x2 || y1 == y2)
+		for (; index + 4u <= count; index += 4u)
+		{
+			const __m128i valueVector = _mm_loadu_si128((const __m128i*)(pValues + index));
+			const __m128i redBlueVector = _mm_and_si128(valueVector, redBlueMask);
+			const __m128i pixelVector = _mm_or_si128(_mm_and_si128(valueVector, greenAlphaMask), _mm_or_si128(_mm_slli_epi32(redBlueVector, 16), _mm_srli_epi32(redBlueVector, 16)));
+			_mm_storeu_si128((__m128i*)(pOutPixels + index), pixelVector);
+		}
+	}
+	else if (format == K15_RENDERER_2D_PIXEL_FORMAT_BGRA)
 	{
-		return K15_RENDERER_2D_RESULT_SUCCESS;
+		for (; index + 4u <= count; index += 4u)
+		{
+			const __m128i valueVector = _mm_loadu_si128((const __m128i*)(pValues + index));
+			_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_or_si128(_mm_slli_epi32(valueVector, 8), _mm_srli_epi32(valueVector, 24)));
+		}
 	}
+	else
+	{
+		const __m128i byteMask = _mm_set1_epi32(0xFF00);
 
-	ksr2_filled_rect_draw_command* pDrawCommand = ksr2_nullptr;
-	ksr2_result result = ksr2_allocate_draw_command(&pDrawCommand, pContext, sizeof(ksr2_filled_rect_draw_command), K15_RENDERER_2D_DRAW_COMMAND_FILLED_RECT);
+		for (; index + 4u <= count; index += 4u)
+		{
+			const __m128i valueVector = _mm_loadu_si128((const __m128i*)(pValues + index));
+			const __m128i outerVector = _mm_or_si128(_mm_slli_epi32(valueVector, 24), _mm_srli_epi32(valueVector, 24));
+			const __m128i innerVector = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(valueVector, byteMask), 8), _mm_and_si128(_mm_srli_epi32(valueVector, 8), byteMask));
+			_mm_storeu_si128((__m128i*)(pOutPixels + index), _mm_or_si128(outerVector, innerVector));
+		}
+	}
+#else
+	ksr2_use_argument(pValues);
+#endif
 
-	if (result != K15_RENDERER_2D_RESULT_SUCCESS)
+	for (; index < count; ++index)
 	{
-		return result;
+		pOutPixels[index] = ksr2_convert_to_pixel_format(pColors[index], format);
 	}
+}
 
-	pDrawCommand->color = ksr2_convert_to_pixel_format(color, pContext->swapChain.format);
-	pDrawCommand->x1 	= (ksr2_u32)x1;
-	pDrawCommand->x2 	= (ksr2_u32)x2;
-	pDrawCommand->y1 	= (ksr2_u32)y1;
-	pDrawCommand->y2 	= (ksr2_u32)y2;
+#define K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(name, format) \
+	ksr2_internal void ksr2_kernel_name(ksr2_convert_colors_##name)(ksr2_pixel_color* pOutPixels, const ksr2_rgba_color* pColors, ksr2_u32 count) \
+	{ \
+		ksr2_convert_colors_to_pixel_format(pOutPixels, pColors, count, format); \
+	}
 
-	ksr2_push_draw_command(pContext, pDrawCommand);
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(rgba, 		K15_RENDERER_2D_PIXEL_FORMAT_RGBA)
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(argb, 		K15_RENDERER_2D_PIXEL_FORMAT_ARGB)
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(bgra, 		K15_RENDERER_2D_PIXEL_FORMAT_BGRA)
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(rgb565, 	K15_RENDERER_2D_PIXEL_FORMAT_RGB565)
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(a8, 		K15_RENDERER_2D_PIXEL_FORMAT_A8)
+K15_RENDERER_2D_DEFINE_CONVERT_COLORS_KERNEL(gray8, 	K15_RENDERER_2D_PIXEL_FORMAT_GRAY8)
+
+//FK: indexed by ksr2_pixel_format, formats with less than 32 bit per pixel use RGBA colors
+ksr2_internal const ksr2_pixel_kernels ksr2_pixel_kernel_table[] = {
+	K15_RENDERER_2D_PIXEL_KERNELS(rgba, 	24u, 16u,  8u,  0u),
+	K15_RENDERER_2D_PIXEL_KERNELS(argb, 	16u,  8u,  0u, 24u),
+	K15_RENDERER_2D_PIXEL_KERNELS(bgra, 	 8u, 16u, 24u,  0u),
+	K15_RENDERER_2D_PIXEL_KERNELS(rgb565, 	24u, 16u,  8u,  0u),
+	K15_RENDERER_2D_PIXEL_KERNELS(a8, 		24u, 16u,  8u,  0u),
+	K15_RENDERER_2D_PIXEL_KERNELS(gray8, 	24u, 16u,  8u,  0u)
+};
 
-	return K15_RENDERER_2D_RESULT_SUCCESS;
+//FK: Binds the kernels of this CPU level for a pixel format.
+ksr2_internal void ksr2_init_pixel_kernels(ksr2_pixel_kernels* pOutKernels, ksr2_pixel_format format, ksr2_u32 flags)
+{
+	*pOutKernels = ksr2_pixel_kernel_table[format];
+
+	if (flags & K15_RENDERER_2D_GENERIC_KERNELS_FLAG)
+	{
+		for (ksr2_u32 blendMode = 0u; blendMode < K15_RENDERER_2D_BLEND_MODE_COUNT; ++blendMode)
+		{
+			pOutKernels->paintSpan[blendMode] 		= ksr2_paint_span_generic;
+			pOutKernels->paintImageSpan[blendMode] 	= ksr2_paint_image_span_generic;
+		}
+
+		pOutKernels->fillSpan 				= ksr2_fill_span_generic;
+		pOutKernels->fillSpanNonTemporal 	= ksr2_fill_span_non_temporal_generic;
+	}
 }
 
-#endif // K15_SOFTWARE_RENDERER_2D_IMPLEMENTATION
-#endif // _K15_SOFTWARE_RENDERER_2D_H_
\ No newline at end of file
+#undef ksr2_fill_span
+#undef ksr2_fill_span_non_temporal
+#undef ksr2_div255_avx2
+#undef ksr2_div255_avx512
+#undef ksr2_get_pixel_mask_avx512
+#undef ksr2_blend_span
+#undef ksr2_add_span
+#undef ksr2_copy_span
+#undef ksr2_blend_image_pixels_sse2
+#undef ksr2_blend_image_pixels_avx2
+#undef ksr2_blend_image_pixels_avx512
+#undef ksr2_blend_image_span
+#undef ksr2_modulate_coverage_span
+#undef ksr2_get_path_coverage_sse2
+#undef ksr2_get_path_coverage_avx2
+#undef ksr2_resolve_coverage_span
+#undef ksr2_resolve_nonzero_coverage_span
+#undef ksr2_resolve_even_odd_coverage_span
+#undef ksr2_fill_bytes
+#undef ksr2_fill_bytes_non_temporal
+#undef ksr2_copy_bytes
+#undef ksr2_expand_5_bit_sse2
+#undef ksr2_expand_6_bit_sse2
+#undef ksr2_unpack_rgb565_sse2
+#undef ksr2_pack_rgb565_sse2
+#undef ksr2_gather_channel_sse2
+#undef ksr2_get_luma_sse2
+#undef ksr2_blend_channel_sse2
+#undef ksr2_blend_image_channel_sse2
+#undef ksr2_swap_red_blue_sse2
+#undef ksr2_blend_span_16
+#undef ksr2_blend_image_span_16
+#undef ksr2_blend_span_8
+#undef ksr2_blend_image_span_8
+#undef ksr2_convert_pixels_from_rgba
+#undef ksr2_convert_pixels_to_rgba
+#undef ksr2_convert_span_from_rgba
+#undef ksr2_paint_format_span
+#undef ksr2_paint_format_image_span
+#undef ksr2_fill_format_span
+#undef ksr2_paint_span_generic
+#undef ksr2_paint_image_span_generic
+#undef ksr2_fill_span_generic
+#undef ksr2_fill_span_non_temporal_generic
+#undef ksr2_convert_colors_to_pixel_format
+#undef ksr2_pixel_kernel_table
+#undef ksr2_init_pixel_kernels
+#endif // K15_RENDERER_2D_KERNEL_PASS
\ No newline at end of file
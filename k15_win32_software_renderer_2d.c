@@ -260,7 +260,7 @@ uint32 getTimeInMilliseconds(LARGE_INTEGER PerformanceFrequency)
 
 void setup()
 {
-	ksr2_context_parameters parameters;
+	ksr2_context_parameters parameters = {0};
 	parameters.backBufferCount 			= 1u;
 	parameters.backBufferFormat 		= K15_RENDERER_2D_PIXEL_FORMAT_ARGB;
 	parameters.backBufferHeight 		= screenHeight;
@@ -280,9 +280,11 @@ void setup()
 
 void drawBackBuffer(HWND hwnd)
 {
+	const unsigned long long presentBeginTimestamp = ksr2_begin_trace_event(softwareRendererContext);
 	HDC deviceContext = GetDC( hwnd );
 	StretchDIBits( deviceContext, 0, 0, screenWidth, screenHeight, 0, 0, screenWidth, screenHeight, 
 		pBackBufferPixels, pBackBufferBitmapInfo, DIB_RGB_COLORS, SRCCOPY );  
+	ksr2_end_trace_event(softwareRendererContext, "present", presentBeginTimestamp);
 
 #ifdef K15_GREYSCALE
 	memset(pBackBufferPixels, 0, screenWidth * screenHeight);
@@ -4,12 +4,17 @@
 #include "k15_software_renderer_2d.h"
 
 #include "stdio.h"
+#include "stdlib.h"
 #include "stddef.h"
 #include "time.h"
 #include "string.h"
 #include "unistd.h"
 #include "malloc.h"
+#include "sys/ipc.h"
+#include "sys/shm.h"
 #include "X11/Xlib.h"
+#include "X11/Xutil.h"
+#include "X11/extensions/XShm.h"
 
 #define K15_FALSE 0
 #define K15_TRUE 1
@@ -20,17 +25,205 @@ typedef unsigned int uint32;
 typedef unsigned short uint16;
 typedef unsigned char uint8;
 
+enum
+{
+	SWAP_CHAIN_IMAGE_COUNT = 2
+};
+
+//FK: The swap chain images of the renderer live in memory that the X server can read directly if MIT-SHM is available,
+//	  so presenting an image doesn't copy it through the X connection. Otherwise every image gets wrapped into an XImage
+//	  once and sent with XPutImage.
+typedef struct
+{
+	XImage* 		pImages[SWAP_CHAIN_IMAGE_COUNT];
+	XShmSegmentInfo shmSegment;
+	void* 			pBackBuffers; //FK: swap chain images, back to back as ksr2_query_back_buffer_requirements() lays them out
+	bool8 			useShm;
+} back_buffers;
+
 Display* mainDisplay = 0;
 Drawable mainDrawable = 0;
 GC mainGC;
-Pixmap backbuffer;
 Atom deleteMessage = 0;
 int nanoSecondsPerFrame = 16000000;
 ksr2_contexthandle renderer;
+ksr2_fonthandle font;
+back_buffers backBufferSets[2]; //FK: XShmCreateImage keeps a pointer to shmSegment, back buffers must not get copied
+back_buffers* pBackBuffers = &backBufferSets[0]; //FK: the set the renderer presents, the other one is used for resizing
+ksr2_pixel_format backBufferFormat = K15_RENDERER_2D_PIXEL_FORMAT_ARGB;
+bool8 shmAttachFailed = K15_FALSE;
+unsigned long long presentTimeInNs = 0u; //FK: of the last frame
 
 int screenWidth = 800;
 int screenHeight = 600;
 
+unsigned long long getTimeInNs()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (unsigned long long)time.tv_sec * 1000000000ull + (unsigned long long)time.tv_nsec;
+}
+
+//FK: XShmAttach fails asynchronously if the X server can't access the segment, e.g. on a remote display
+int shmErrorHandler(Display* p_Display, XErrorEvent* p_Event)
+{
+	shmAttachFailed = K15_TRUE;
+	return 0;
+}
+
+void destroyBackBuffers(back_buffers* p_BackBuffers)
+{
+	for (uint32 imageIndex = 0u; imageIndex < SWAP_CHAIN_IMAGE_COUNT; ++imageIndex)
+	{
+		if (p_BackBuffers->pImages[imageIndex] != 0)
+		{
+			//FK: the pixels belong to the swap chain memory, XDestroyImage would free them
+			p_BackBuffers->pImages[imageIndex]->data = 0;
+			XDestroyImage(p_BackBuffers->pImages[imageIndex]);
+			p_BackBuffers->pImages[imageIndex] = 0;
+		}
+	}
+
+	if (p_BackBuffers->useShm)
+	{
+		XShmDetach(mainDisplay, &p_BackBuffers->shmSegment);
+		XSync(mainDisplay, False);
+		shmdt(p_BackBuffers->shmSegment.shmaddr);
+	}
+	else
+	{
+		free(p_BackBuffers->pBackBuffers);
+	}
+
+	memset(p_BackBuffers, 0, sizeof(back_buffers));
+}
+
+bool8 createShmBackBuffers(back_buffers* p_BackBuffers, Visual* p_Visual, int p_Depth, size_t p_ImageSizeInBytes, unsigned int p_Stride, int p_Height)
+{
+	int majorVersion = 0;
+	int minorVersion = 0;
+	Bool sharedPixmaps = False;
+
+	if (XShmQueryVersion(mainDisplay, &majorVersion, &minorVersion, &sharedPixmaps) == False)
+	{
+		return K15_FALSE;
+	}
+
+	XShmSegmentInfo* pSegment = &p_BackBuffers->shmSegment;
+	pSegment->shmid = shmget(IPC_PRIVATE, p_ImageSizeInBytes * SWAP_CHAIN_IMAGE_COUNT, IPC_CREAT | 0600);
+
+	if (pSegment->shmid < 0)
+	{
+		return K15_FALSE;
+	}
+
+	pSegment->shmaddr 	= (char*)shmat(pSegment->shmid, 0, 0);
+	pSegment->readOnly 	= False;
+
+	if (pSegment->shmaddr == (char*)-1)
+	{
+		shmctl(pSegment->shmid, IPC_RMID, 0);
+		return K15_FALSE;
+	}
+
+	shmAttachFailed = K15_FALSE;
+	XErrorHandler previousErrorHandler = XSetErrorHandler(shmErrorHandler);
+	XShmAttach(mainDisplay, pSegment);
+	XSync(mainDisplay, False);
+	XSetErrorHandler(previousErrorHandler);
+
+	//FK: the segment gets destroyed once the X server and this process detached from it, even if the process crashes
+	shmctl(pSegment->shmid, IPC_RMID, 0);
+
+	if (shmAttachFailed)
+	{
+		shmdt(pSegment->shmaddr);
+		return K15_FALSE;
+	}
+
+	p_BackBuffers->useShm 		= K15_TRUE;
+	p_BackBuffers->pBackBuffers = pSegment->shmaddr;
+
+	for (uint32 imageIndex = 0u; imageIndex < SWAP_CHAIN_IMAGE_COUNT; ++imageIndex)
+	{
+		//FK: the image width is the stride, only the visible part gets presented
+		char* pImageData = pSegment->shmaddr + p_ImageSizeInBytes * imageIndex;
+		p_BackBuffers->pImages[imageIndex] = XShmCreateImage(mainDisplay, p_Visual, p_Depth, ZPixmap, pImageData, pSegment, p_Stride / 4u, p_Height);
+
+		if (p_BackBuffers->pImages[imageIndex] == 0)
+		{
+			destroyBackBuffers(p_BackBuffers);
+			return K15_FALSE;
+		}
+	}
+
+	return K15_TRUE;
+}
+
+bool8 createBackBuffers(back_buffers* p_BackBuffers, int p_Width, int p_Height, bool8 p_TryShm)
+{
+	const int screen = XDefaultScreen(mainDisplay);
+	Visual* pVisual = XDefaultVisual(mainDisplay, screen);
+	const int depth = XDefaultDepth(mainDisplay, screen);
+
+	size_t imageSizeInBytes = 0u;
+	unsigned int stride = 0u;
+	ksr2_query_back_buffer_requirements(p_Width, p_Height, backBufferFormat, 0u, &imageSizeInBytes, &stride);
+
+	memset(p_BackBuffers, 0, sizeof(back_buffers));
+
+	if (p_TryShm && XShmQueryExtension(mainDisplay) && createShmBackBuffers(p_BackBuffers, pVisual, depth, imageSizeInBytes, stride, p_Height))
+	{
+		return K15_TRUE;
+	}
+
+	//FK: aligned_alloc wants the size to be a multiple of the alignment
+	const size_t alignmentMask = K15_RENDERER_2D_IMAGE_ALIGNMENT - 1u;
+	p_BackBuffers->pBackBuffers = aligned_alloc(K15_RENDERER_2D_IMAGE_ALIGNMENT, (imageSizeInBytes * SWAP_CHAIN_IMAGE_COUNT + alignmentMask) & ~alignmentMask);
+
+	if (p_BackBuffers->pBackBuffers == 0)
+	{
+		return K15_FALSE;
+	}
+
+	for (uint32 imageIndex = 0u; imageIndex < SWAP_CHAIN_IMAGE_COUNT; ++imageIndex)
+	{
+		char* pImageData = (char*)p_BackBuffers->pBackBuffers + imageSizeInBytes * imageIndex;
+		p_BackBuffers->pImages[imageIndex] = XCreateImage(mainDisplay, pVisual, depth, ZPixmap, 0, pImageData, p_Width, p_Height, 32, stride);
+
+		if (p_BackBuffers->pImages[imageIndex] == 0)
+		{
+			destroyBackBuffers(p_BackBuffers);
+			return K15_FALSE;
+		}
+	}
+
+	return K15_TRUE;
+}
+
+//FK: ARGB is 0xAARRGGBB in memory order of the host, which is what 24 and 32 bit TrueColor visuals usually use
+bool8 checkVisual()
+{
+	const int screen = XDefaultScreen(mainDisplay);
+	Visual* pVisual = XDefaultVisual(mainDisplay, screen);
+	const int depth = XDefaultDepth(mainDisplay, screen);
+
+	XImage* pImage = XCreateImage(mainDisplay, pVisual, depth, ZPixmap, 0, 0, 1, 1, 32, 0);
+
+	if (pImage == 0)
+	{
+		return K15_FALSE;
+	}
+
+	const uint32 one = 1u;
+	const int hostByteOrder = *(const uint8*)&one == 1u ? LSBFirst : MSBFirst;
+	const bool8 isSupported = pImage->bits_per_pixel == 32 && pImage->byte_order == hostByteOrder && 
+		pVisual->red_mask == 0xFF0000u && pVisual->green_mask == 0xFF00u && pVisual->blue_mask == 0xFFu;
+
+	XDestroyImage(pImage);
+	return isSupported;
+}
+
 void handleKeyPress(XEvent* p_Event)
 {
 }
@@ -53,10 +246,35 @@ void handleMouseMotion(XEvent* p_Event)
 
 void handleWindowResize(XEvent* p_Event)
 {
+	if (p_Event->xconfigure.width == screenWidth && p_Event->xconfigure.height == screenHeight)
+	{
+		return;
+	}
+
+	//FK: the renderer switches to the new images before the old ones get destroyed
+	back_buffers* pResizedBackBuffers = pBackBuffers == &backBufferSets[0] ? &backBufferSets[1] : &backBufferSets[0];
+	if (createBackBuffers(pResizedBackBuffers, p_Event->xconfigure.width, p_Event->xconfigure.height, pBackBuffers->useShm) == K15_FALSE)
+	{
+		printf("Could not resize the back buffers to %dx%d.\n", p_Event->xconfigure.width, p_Event->xconfigure.height);
+		return;
+	}
+
+	ksr2_resize_swapchain_parameters resizeParameters = {0};
+	resizeParameters.pPreAllocatedBackBuffers 	= pResizedBackBuffers->pBackBuffers;
+	resizeParameters.backBufferWidth 			= p_Event->xconfigure.width;
+	resizeParameters.backBufferHeight 			= p_Event->xconfigure.height;
+
+	if (ksr2_resize_swap_chain(renderer, &resizeParameters) != K15_RENDERER_2D_RESULT_SUCCESS)
+	{
+		printf("Could not resize the swap chain to %dx%d.\n", p_Event->xconfigure.width, p_Event->xconfigure.height);
+		destroyBackBuffers(pResizedBackBuffers);
+		return;
+	}
+
+	destroyBackBuffers(pBackBuffers);
+	pBackBuffers 	= pResizedBackBuffers;
 	screenWidth 	= p_Event->xconfigure.width;
 	screenHeight 	= p_Event->xconfigure.height;
-
-	ksr2_resize_swap_chain(renderer, screenWidth, screenHeight, K15_RENDERER_2D_PIXEL_FORMAT_RGB8);
 }
 
 bool8 filterEvent(XEvent* p_Event)
@@ -132,92 +350,164 @@ void setupWindow(Window* p_WindowOut, int p_Width, int p_Height)
 	XMapWindow(mainDisplay, window);
 }
 
-bool8 setup(Window* p_WindowOut)
+bool8 setup(Window* p_WindowOut, bool8 p_TryShm)
 {
-	const size_t rendererMemorySize = ksr2_megabyte(5);
+	XSetErrorHandler(errorHandler);
+	mainDisplay = XOpenDisplay(0);
 
-	ksr2_context_parameters contextParameters;
-	contextParameters.backBufferWidth 	= screenWidth;
-	contextParameters.backBufferHeight 	= screenHeight;
-	contextParameters.backBufferFormat	= K15_RENDERER_2D_PIXEL_FORMAT_RGB8;
-	contextParameters.pMemory			= malloc(rendererMemorySize);
-	contextParameters.memorySizeInBytes	= rendererMemorySize;
-	contextParameters.flags				= K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG;
+	if (mainDisplay == 0)
+	{
+		printf("Could not open the X display.\n");
+		return K15_FALSE;
+	}
 
-	ksr2_result result = ksr2_init_context(&contextParameters, &renderer);
+	if (checkVisual() == K15_FALSE)
+	{
+		printf("The default visual of the X display isn't a 32 bit TrueColor visual with 8 bit red, green and blue channels.\n");
+		return K15_FALSE;
+	}
 
-	XSetErrorHandler(errorHandler);
-	mainDisplay = XOpenDisplay(0);
+	if (createBackBuffers(pBackBuffers, screenWidth, screenHeight, p_TryShm) == K15_FALSE)
+	{
+		printf("Could not create the back buffers.\n");
+		return K15_FALSE;
+	}
+
+	printf("Presenting with %s.\n", pBackBuffers->useShm ? "XShmPutImage" : "XPutImage");
 
-	if (mainDisplay)
+	//FK: the swap chain images live in pBackBuffers, the renderer memory only holds draw commands, tiles and the font
+	const size_t rendererMemorySize = ksr2_megabyte(5);
+
+	ksr2_context_parameters contextParameters = {0};
+	contextParameters.backBufferWidth 			= screenWidth;
+	contextParameters.backBufferHeight 			= screenHeight;
+	contextParameters.backBufferFormat			= backBufferFormat;
+	contextParameters.backBufferCount			= SWAP_CHAIN_IMAGE_COUNT;
+	contextParameters.pPreAllocatedBackBuffers 	= pBackBuffers->pBackBuffers;
+	contextParameters.pMemory					= malloc(rendererMemorySize);
+	contextParameters.memorySizeInBytes			= rendererMemorySize;
+	contextParameters.flags						= K15_RENDERER_2D_DOUBLE_BUFFERED_FLAG;
+
+	if (ksr2_init_context(&contextParameters, &renderer) != K15_RENDERER_2D_RESULT_SUCCESS)
 	{
-		deleteMessage = XInternAtom(mainDisplay, "WM_DELETE_WINDOW", False);
-		setupWindow(p_WindowOut, screenWidth, screenHeight);
-		return K15_TRUE;
+		printf("Could not create the renderer.\n");
+		return K15_FALSE;
 	}
 
-	return K15_FALSE;
+	ksr2_font_parameters fontParameters;
+	ksr2_get_builtin_font_parameters(&fontParameters);
+	ksr2_create_font(renderer, &fontParameters, &font);
+
+	deleteMessage = XInternAtom(mainDisplay, "WM_DELETE_WINDOW", False);
+	setupWindow(p_WindowOut, screenWidth, screenHeight);
+	return K15_TRUE;
 }
 
-void drawDeltaTime(Window* p_MainWindow, long p_DeltaTimeInNs)
+void drawDeltaTime(long p_DeltaTimeInNs)
 {
 	char buffer[256];
 	sprintf(buffer, "Milliseconds:%ld", p_DeltaTimeInNs / 1000000);
 
-	XDrawString(mainDisplay, *p_MainWindow, mainGC, 20, 20, buffer, strlen(buffer));
+	ksr2_draw_text(renderer, font, 20, 20, buffer, ksr2_color_white());
 }
 
 void swapBuffers(Window mainWindow)
 {
-	unsigned char* pBackbuffer = ksr2_get_presenting_image_data(renderer);
-	
-	if (backbuffer != 0)
+	const unsigned long long presentBeginTimestamp = ksr2_begin_trace_event(renderer);
+	const unsigned long long presentStartTimeInNs = getTimeInNs();
+	unsigned char* pImageData = 0;
+	unsigned int imageIndex = 0u;
+
+	if (ksr2_acquire_presentable_image(renderer, &pImageData, &imageIndex) != K15_RENDERER_2D_RESULT_SUCCESS)
 	{
-		XFreePixmap(mainDisplay, backbuffer);
+		return;
 	}
 
-	if (pBackbuffer)
+	XImage* pImage = pBackBuffers->pImages[imageIndex];
+
+	if (pBackBuffers->useShm)
 	{
-		backbuffer = XCreateBitmapFromData(mainDisplay, mainWindow, pBackbuffer, screenWidth, screenHeight);
+		XShmPutImage(mainDisplay, mainWindow, mainGC, pImage, 0, 0, 0, 0, screenWidth, screenHeight, False);
 	}
-
-	if (backbuffer != 0)
+	else
 	{
-		XCopyPlane(mainDisplay, backbuffer, mainWindow, mainGC, 0, 0, screenWidth, screenHeight, 0, 0, 1);
+		XPutImage(mainDisplay, mainWindow, mainGC, pImage, 0, 0, 0, 0, screenWidth, screenHeight);
 	}
 
+	//FK: the X server reads the shared memory image asynchronously, it must not get rendered into before it got presented
+	XSync(mainDisplay, False);
 	ksr2_swap_buffers(renderer);
-	XFlush(mainDisplay);
-	XSync(mainDisplay, mainWindow);
+
+	presentTimeInNs = getTimeInNs() - presentStartTimeInNs;
+	ksr2_end_trace_event(renderer, "present", presentBeginTimestamp);
 }
 
 void doFrame(Window* p_MainWindow, long p_DeltaTimeInNs)
 {
-	XClearWindow(mainDisplay, *p_MainWindow);
-	//drawDeltaTime(p_MainWindow, p_DeltaTimeInNs);
-
+	ksr2_clear(renderer, ksr2_color_black());
 	ksr2_draw_line(renderer, 100, 100, 400, 400, 4, ksr2_color_red());
 	ksr2_draw_line(renderer, 400, 400, 100, 100, 4, ksr2_rgb_color_float(1.0f, 1.0f, 1.0f));
+	drawDeltaTime(p_DeltaTimeInNs);
 	ksr2_blit(renderer);
 	//ksr2_draw_aabb(renderer, 200, 200, 300, 300, 4, ksr2_color_yellow(), ksr2_color_blue());
 
 	swapBuffers(*p_MainWindow);
 }
 
+int compareTimes(const void* p_A, const void* p_B)
+{
+	const unsigned long long a = *(const unsigned long long*)p_A;
+	const unsigned long long b = *(const unsigned long long*)p_B;
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+void printTimes(const char* p_Name, unsigned long long* p_Times, uint32 p_Count)
+{
+	qsort(p_Times, p_Count, sizeof(unsigned long long), compareTimes);
+	printf("%s: median %.3f ms, p99 %.3f ms\n", p_Name, (double)p_Times[(p_Count - 1u) / 2u] / 1000000.0, (double)p_Times[(p_Count * 99u + 99u) / 100u - 1u] / 1000000.0);
+}
+
+//FK: usage: x11_example [--frames count] [--no-shm]
+//	  --frames renders count frames as fast as possible, prints the frame and present times and exits.
+//	  --no-shm presents with XPutImage even if MIT-SHM is available.
 int main(int argc, char** argv)
 {
+	uint32 timedFrameCount = 0u;
+	bool8 tryShm = K15_TRUE;
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strcmp(argv[argIndex], "--no-shm") == 0)
+		{
+			tryShm = K15_FALSE;
+		}
+		else if (strcmp(argv[argIndex], "--frames") == 0 && argIndex + 1 < argc)
+		{
+			timedFrameCount = (uint32)strtoul(argv[++argIndex], 0, 10);
+		}
+		else
+		{
+			printf("usage: %s [--frames count] [--no-shm]\n", argv[0]);
+			return 1;
+		}
+	}
+
 	Window mainWindow;
-	setup(&mainWindow);
+	if (setup(&mainWindow, tryShm) == K15_FALSE)
+	{
+		return 1;
+	}
 
-	struct timespec timeFrameStarted = {0};
-	struct timespec timeFrameEnded = {0};
+	unsigned long long* pFrameTimes 	= timedFrameCount > 0u ? (unsigned long long*)malloc(sizeof(unsigned long long) * timedFrameCount) : 0;
+	unsigned long long* pPresentTimes 	= timedFrameCount > 0u ? (unsigned long long*)malloc(sizeof(unsigned long long) * timedFrameCount) : 0;
+	uint32 frameIndex = 0u;
 	long deltaNs = 0;
 
 	bool8 loopRunning = K15_TRUE;
 	XEvent event = {0};
 	while (loopRunning)
 	{
-		clock_gettime(CLOCK_MONOTONIC, &timeFrameStarted);
+		const unsigned long long frameStartTimeInNs = getTimeInNs();
 		while (XPending(mainDisplay))
 		{
 			XNextEvent(mainDisplay, &event);
@@ -233,16 +523,33 @@ int main(int argc, char** argv)
 
 		doFrame(&mainWindow, deltaNs);
 
-		clock_gettime(CLOCK_MONOTONIC, &timeFrameEnded);
+		deltaNs = (long)(getTimeInNs() - frameStartTimeInNs);
 
-		deltaNs = timeFrameEnded.tv_nsec - timeFrameStarted.tv_nsec;
+		if (timedFrameCount > 0u)
+		{
+			pFrameTimes[frameIndex] 	= (unsigned long long)deltaNs;
+			pPresentTimes[frameIndex] 	= presentTimeInNs;
 
-		if (deltaNs < nanoSecondsPerFrame)
+			if (++frameIndex == timedFrameCount)
+			{
+				printf("%u frames at %dx%d with %s\n", timedFrameCount, screenWidth, screenHeight, pBackBuffers->useShm ? "XShmPutImage" : "XPutImage");
+				printTimes("frame", pFrameTimes, timedFrameCount);
+				printTimes("present", pPresentTimes, timedFrameCount);
+				loopRunning = K15_FALSE;
+			}
+		}
+		else if (deltaNs < nanoSecondsPerFrame)
 		{
 			struct timespec sleepTime = {0, nanoSecondsPerFrame - deltaNs};
 			nanosleep(&sleepTime, 0);
 		}
 	}
 
+	ksr2_destroy_context(renderer);
+	destroyBackBuffers(pBackBuffers);
+	XCloseDisplay(mainDisplay);
+
+	free(pFrameTimes);
+	free(pPresentTimes);
 	return 0;
 }